@@ -140,6 +140,10 @@ int tc_kernel_main(int argc, char *argv[])
 	mqueue_main();
 #endif
 
+#ifdef CONFIG_TC_KERNEL_POOL
+	pool_main();
+#endif
+
 #ifdef CONFIG_TC_KERNEL_PTHREAD
 	pthread_main();
 #endif
@@ -168,6 +172,10 @@ int tc_kernel_main(int argc, char *argv[])
 	timer_main();
 #endif
 
+#ifdef CONFIG_TC_KERNEL_WDOG
+	wdog_main();
+#endif
+
 #ifdef CONFIG_TC_KERNEL_ROUNDROBIN
 	roundrobin_main();
 #endif
@@ -79,6 +79,7 @@ int libc_timer_main(void);
 int libc_unistd_main(void);
 int libc_syslog_main(void);
 int mqueue_main(void);
+int pool_main(void);
 int pthread_main(void);
 int roundrobin_main(void);
 int sched_main(void);
@@ -87,6 +88,7 @@ int signal_main(void);
 int task_main(void);
 int termios_main(void);
 int timer_main(void);
+int wdog_main(void);
 int umm_heap_main(void);
 int tash_heapinfo_main(void);
 int tash_stackmonitor_main(void);
@@ -0,0 +1,299 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_pool.c
+
+/// @brief Test Case Example for Object Pool API
+
+/**************************************************************************
+* Included Files
+**************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <semaphore.h>
+#include <tinyara/arch.h>
+#include <tinyara/wdog.h>
+#include <tinyara/mm/pool.h>
+#include "tc_internal.h"
+#ifndef CONFIG_DISABLE_MQUEUE
+#include "../../../../../os/kernel/mqueue/mqueue.h"
+#endif
+
+/**************************************************************************
+* Private Definitions
+**************************************************************************/
+#define POOL_NAME           "tc_pool"
+#define POOL_OBJSIZE        20
+#define POOL_NOBJECTS       4
+
+#define MQIRQ_NAME          "t_mqirq"
+#define MQIRQ_MESSAGE       "sent by an interrupt handler"
+#define MQIRQ_MSGLEN        (strlen(MQIRQ_MESSAGE) + 1)
+#define MQIRQ_MAXMSGS       (CONFIG_PREALLOC_MQ_MSGS + NUM_INTERRUPT_MSGS)
+
+/**************************************************************************
+* Private Types
+**************************************************************************/
+struct pool_stats_s {
+	const char *name;
+	bool found;
+	struct poolinfo_s info;
+};
+
+/**************************************************************************
+* Private Variables
+**************************************************************************/
+#ifndef CONFIG_DISABLE_MQUEUE
+static mqd_t g_mqirq_fd;
+static sem_t g_mqirq_sem;
+static int g_mqirq_ret;
+static bool g_mqirq_context;
+#endif
+
+/**************************************************************************
+* Private Functions
+**************************************************************************/
+static void pool_getstats(FAR const struct poolinfo_s *info, FAR void *arg)
+{
+	struct pool_stats_s *stats = (struct pool_stats_s *)arg;
+
+	if (strcmp(info->name, stats->name) == 0) {
+		stats->info = *info;
+		stats->found = true;
+	}
+}
+
+static bool pool_findstats(const char *name, struct pool_stats_s *stats)
+{
+	stats->name = name;
+	stats->found = false;
+	pool_foreach(pool_getstats, stats);
+	return stats->found;
+}
+
+#ifndef CONFIG_DISABLE_MQUEUE
+static void mqirq_handler(int argc, uint32_t arg1, ...)
+{
+	/* Watchdog handlers run in the context of the timer interrupt */
+
+	g_mqirq_context = up_interrupt_context();
+	g_mqirq_ret = mq_send(g_mqirq_fd, MQIRQ_MESSAGE, MQIRQ_MSGLEN, 1);
+	sem_post(&g_mqirq_sem);
+}
+#endif
+
+/**
+* @fn                   :tc_pool_pool_create_alloc_free
+* @brief                :Allocate objects of a pool until it is exhausted and free them
+* @scenario             :Create a pool, allocate all of its objects, fail to allocate one more,
+*                        free them, check the statistics of the pool and destroy it
+* @API's covered        :pool_create, pool_alloc, pool_free, pool_nfree, pool_member, pool_foreach, pool_destroy
+* @Preconditions        :none
+* @Postconditions       :none
+* @Return               :void
+*/
+static void tc_pool_pool_create_alloc_free(void)
+{
+	POOL_HANDLE handle;
+	FAR void *objects[POOL_NOBJECTS];
+	FAR void *object;
+	struct pool_stats_s stats;
+	int index;
+
+	handle = pool_create(POOL_NAME, POOL_OBJSIZE, POOL_NOBJECTS);
+	TC_ASSERT_NEQ("pool_create", handle, NULL);
+	TC_ASSERT_EQ_CLEANUP("pool_nfree", pool_nfree(handle), POOL_NOBJECTS, pool_destroy(handle));
+
+	for (index = 0; index < POOL_NOBJECTS; index++) {
+		objects[index] = pool_alloc(handle);
+		TC_ASSERT_NEQ_CLEANUP("pool_alloc", objects[index], NULL, goto cleanup);
+		TC_ASSERT_EQ_CLEANUP("pool_alloc", (uintptr_t)objects[index] & (CONFIG_MM_POOL_ALIGN - 1), 0, index++; goto cleanup);
+		TC_ASSERT_CLEANUP("pool_member", pool_member(handle, objects[index]), index++; goto cleanup);
+		memset(objects[index], 0xa5, POOL_OBJSIZE);
+	}
+
+	/* The pool is exhausted, allocations fail and are counted */
+
+	object = pool_alloc(handle);
+	TC_ASSERT_EQ_CLEANUP("pool_alloc", object, NULL, pool_free(handle, object); goto cleanup);
+	object = pool_alloc(handle);
+	TC_ASSERT_EQ_CLEANUP("pool_alloc", object, NULL, pool_free(handle, object); goto cleanup);
+	TC_ASSERT_EQ_CLEANUP("pool_nfree", pool_nfree(handle), 0, goto cleanup);
+	TC_ASSERT_CLEANUP("pool_member", !pool_member(handle, &stats), goto cleanup);
+
+	pool_free(handle, objects[0]);
+	pool_free(handle, objects[1]);
+	TC_ASSERT_EQ_CLEANUP("pool_nfree", pool_nfree(handle), POOL_NOBJECTS - 2, goto cleanup_half);
+
+	TC_ASSERT_CLEANUP("pool_foreach", pool_findstats(POOL_NAME, &stats), goto cleanup_half);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.nobjects, POOL_NOBJECTS, goto cleanup_half);
+	TC_ASSERT_GEQ_CLEANUP("pool_foreach", stats.info.objsize, POOL_OBJSIZE, goto cleanup_half);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.objsize & (CONFIG_MM_POOL_ALIGN - 1), 0, goto cleanup_half);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.nfree, POOL_NOBJECTS - 2, goto cleanup_half);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.minfree, 0, goto cleanup_half);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.nalloc, POOL_NOBJECTS, goto cleanup_half);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.nfail, 2, goto cleanup_half);
+
+	/* Freed objects are allocated again, the least free count is kept */
+
+	pool_free(handle, objects[2]);
+	pool_free(handle, objects[3]);
+	object = pool_alloc(handle);
+	TC_ASSERT_NEQ_CLEANUP("pool_alloc", object, NULL, pool_destroy(handle));
+	pool_free(handle, object);
+
+	TC_ASSERT_CLEANUP("pool_foreach", pool_findstats(POOL_NAME, &stats), pool_destroy(handle));
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.nfree, POOL_NOBJECTS, pool_destroy(handle));
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.minfree, 0, pool_destroy(handle));
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.nalloc, POOL_NOBJECTS + 1, pool_destroy(handle));
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", stats.info.nfail, 2, pool_destroy(handle));
+
+	pool_destroy(handle);
+	TC_ASSERT("pool_destroy", !pool_findstats(POOL_NAME, &stats));
+
+	TC_SUCCESS_RESULT();
+	return;
+
+cleanup:
+	while (index-- > 0) {
+		pool_free(handle, objects[index]);
+	}
+	pool_destroy(handle);
+	return;
+
+cleanup_half:
+	pool_free(handle, objects[2]);
+	pool_free(handle, objects[3]);
+	pool_destroy(handle);
+}
+
+#ifndef CONFIG_DISABLE_MQUEUE
+/**
+* @fn                   :tc_pool_mq_send_irq
+* @brief                :Send a message from an interrupt handler when the message pool is empty
+* @scenario             :Use up the pool of messages, then send one from a watchdog handler, which
+*                        takes it from the pool reserved for interrupt handlers
+* @API's covered        :mq_send, mq_receive, wd_create, wd_start, pool_nfree, pool_foreach
+* @Preconditions        :none
+* @Postconditions       :none
+* @Return               :void
+*/
+static void tc_pool_mq_send_irq(void)
+{
+	struct mq_attr attr;
+	struct pool_stats_s before;
+	struct pool_stats_s after;
+	char msg[MQIRQ_MSGLEN];
+	unsigned int nsent = 0;
+	WDOG_ID wdog;
+	ssize_t len;
+	int ret;
+
+	attr.mq_maxmsg = MQIRQ_MAXMSGS;
+	attr.mq_msgsize = MQIRQ_MSGLEN;
+	attr.mq_flags = 0;
+
+	g_mqirq_fd = mq_open(MQIRQ_NAME, O_RDWR | O_CREAT | O_NONBLOCK, 0666, &attr);
+	TC_ASSERT_NEQ("mq_open", g_mqirq_fd, (mqd_t)ERROR);
+
+	wdog = wd_create();
+	TC_ASSERT_NEQ_CLEANUP("wd_create", wdog, NULL, goto cleanup_mq);
+
+	TC_ASSERT_CLEANUP("pool_foreach", pool_findstats("mqmsgirq", &before), goto cleanup_wd);
+
+	/* Use up the messages for general use */
+
+	memset(msg, 0, sizeof(msg));
+	while (pool_nfree(g_msgpool) > 0 && nsent < CONFIG_PREALLOC_MQ_MSGS) {
+		ret = mq_send(g_mqirq_fd, msg, sizeof(msg), 1);
+		TC_ASSERT_EQ_CLEANUP("mq_send", ret, OK, goto cleanup_msgs);
+		nsent++;
+	}
+	TC_ASSERT_EQ_CLEANUP("pool_nfree", pool_nfree(g_msgpool), 0, goto cleanup_msgs);
+
+	sem_init(&g_mqirq_sem, 0, 0);
+	g_mqirq_ret = ERROR;
+	g_mqirq_context = false;
+
+	ret = wd_start(wdog, 1, (wdentry_t)mqirq_handler, 0);
+	TC_ASSERT_EQ_CLEANUP("wd_start", ret, OK, sem_destroy(&g_mqirq_sem); goto cleanup_msgs);
+	while (sem_wait(&g_mqirq_sem) != OK) {
+	}
+	sem_destroy(&g_mqirq_sem);
+
+	TC_ASSERT_CLEANUP("wd_start", g_mqirq_context, goto cleanup_msgs);
+	TC_ASSERT_EQ_CLEANUP("mq_send", g_mqirq_ret, OK, goto cleanup_msgs);
+	nsent++;
+
+	TC_ASSERT_CLEANUP("pool_foreach", pool_findstats("mqmsgirq", &after), goto cleanup_msgs);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", after.info.nalloc, before.info.nalloc + 1, goto cleanup_msgs);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", after.info.nfree, before.info.nfree - 1, goto cleanup_msgs);
+
+	/* Messages of the same priority are received in order */
+
+	while (nsent > 1) {
+		len = mq_receive(g_mqirq_fd, msg, sizeof(msg), NULL);
+		TC_ASSERT_EQ_CLEANUP("mq_receive", len, (ssize_t)sizeof(msg), goto cleanup_msgs);
+		nsent--;
+	}
+	len = mq_receive(g_mqirq_fd, msg, sizeof(msg), NULL);
+	TC_ASSERT_EQ_CLEANUP("mq_receive", len, (ssize_t)sizeof(msg), goto cleanup_msgs);
+	nsent--;
+	TC_ASSERT_EQ_CLEANUP("mq_receive", strcmp(msg, MQIRQ_MESSAGE), 0, goto cleanup_wd);
+
+	/* The message went back to the pool reserved for interrupt handlers */
+
+	TC_ASSERT_CLEANUP("pool_foreach", pool_findstats("mqmsgirq", &after), goto cleanup_wd);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", after.info.nfree, before.info.nfree, goto cleanup_wd);
+	TC_ASSERT_EQ_CLEANUP("pool_foreach", after.info.nfail, before.info.nfail, goto cleanup_wd);
+
+	wd_delete(wdog);
+	mq_close(g_mqirq_fd);
+	mq_unlink(MQIRQ_NAME);
+	TC_SUCCESS_RESULT();
+	return;
+
+cleanup_msgs:
+	while (nsent-- > 0) {
+		mq_receive(g_mqirq_fd, msg, sizeof(msg), NULL);
+	}
+cleanup_wd:
+	wd_delete(wdog);
+cleanup_mq:
+	mq_close(g_mqirq_fd);
+	mq_unlink(MQIRQ_NAME);
+}
+#endif
+
+/****************************************************************************
+ * Name: pool
+ ****************************************************************************/
+int pool_main(void)
+{
+	tc_pool_pool_create_alloc_free();
+#ifndef CONFIG_DISABLE_MQUEUE
+	tc_pool_mq_send_irq();
+#endif
+
+	return 0;
+}
@@ -27,6 +27,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <sched.h>
+#include <semaphore.h>
 #include <sys/wait.h>
 #include <sys/types.h>
 #include "tc_internal.h"
@@ -40,6 +42,7 @@
 #define INVALID_PID       -2
 #define PID_IDLE        0
 #define TASK_CANCEL_INVALID  -1
+#define READYTORUN_TASKS 3
 
 pthread_t thread1, thread2;
 
@@ -558,6 +561,159 @@ static void tc_sched_sched_getstreams(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+static sem_t g_readytorun_done;
+static sem_t g_readytorun_gate;
+static volatile int g_readytorun_order[READYTORUN_TASKS];
+static volatile int g_readytorun_count;
+
+static int readytorun_task(int argc, char *argv[])
+{
+	g_readytorun_order[g_readytorun_count++] = atoi(argv[1]);
+	sem_post(&g_readytorun_done);
+	return 0;
+}
+
+static int readytorun_blocked_task(int argc, char *argv[])
+{
+	while (sem_wait(&g_readytorun_gate) != OK) {
+	}
+	return readytorun_task(argc, argv);
+}
+
+static pid_t readytorun_create(main_t entry, int priority, int index)
+{
+	char arg[4];
+	char *argv[2] = { arg, NULL };
+
+	snprintf(arg, sizeof(arg), "%d", index);
+	return task_create("readytorun", priority, TASK_STACKSIZE, entry, argv);
+}
+
+static void readytorun_wait(int ntasks)
+{
+	while (ntasks > 0) {
+		if (sem_wait(&g_readytorun_done) == OK) {
+			ntasks--;
+		}
+	}
+}
+
+/**
+* @fn                   :tc_sched_readytorun_bitmap
+* @brief                :Tasks run by priority, in FIFO order within a priority
+* @scenario             :Ready tasks of one priority, made ready with scheduler locked, and with priority changed
+*                        while ready, blocked or running, run in the order given by the ready-to-run index
+* API's covered         :sched_setparam, sched_lock, sched_unlock
+* Preconditions         :Priority of the caller is at least 4 and below the maximum
+* Postconditions        :none
+* @return               :void
+*/
+static void tc_sched_readytorun_bitmap(void)
+{
+	struct sched_param st_param;
+	pid_t pid[READYTORUN_TASKS];
+	int prio;
+	int ret_chk;
+	int i;
+
+	ret_chk = sched_getparam(0, &st_param);
+	TC_ASSERT_EQ("sched_getparam", ret_chk, OK);
+	prio = st_param.sched_priority;
+	TC_ASSERT_GEQ("sched_getparam", prio - 3, SCHED_PRIORITY_MIN);
+	TC_ASSERT_LT("sched_getparam", prio, SCHED_PRIORITY_MAX);
+
+	sem_init(&g_readytorun_done, 0, 0);
+	sem_init(&g_readytorun_gate, 0, 0);
+
+	/* Tasks of one priority run in the order they were made ready */
+
+	g_readytorun_count = 0;
+	for (i = 0; i < READYTORUN_TASKS; i++) {
+		pid[i] = readytorun_create(readytorun_task, prio - 1, i);
+		TC_ASSERT_GT("task_create", pid[i], 0);
+	}
+	readytorun_wait(READYTORUN_TASKS);
+	for (i = 0; i < READYTORUN_TASKS; i++) {
+		TC_ASSERT_EQ("sched_readytorun", g_readytorun_order[i], i);
+	}
+
+	/* Tasks made ready with scheduler locked are merged in the same order */
+
+	g_readytorun_count = 0;
+	sched_lock();
+	for (i = 0; i < READYTORUN_TASKS; i++) {
+		pid[i] = readytorun_create(readytorun_task, prio + 1, i);
+	}
+	ret_chk = g_readytorun_count;
+	sched_unlock();
+	TC_ASSERT_EQ("sched_lock", ret_chk, 0);
+	TC_ASSERT_EQ("sched_unlock", g_readytorun_count, READYTORUN_TASKS);
+	readytorun_wait(READYTORUN_TASKS);
+	for (i = 0; i < READYTORUN_TASKS; i++) {
+		TC_ASSERT_EQ("sched_unlock", g_readytorun_order[i], i);
+	}
+
+	/* Ready tasks move to their new priority: last one raised, first one lowered */
+
+	g_readytorun_count = 0;
+	for (i = 0; i < READYTORUN_TASKS; i++) {
+		pid[i] = readytorun_create(readytorun_task, prio - 2, i);
+		TC_ASSERT_GT("task_create", pid[i], 0);
+	}
+	st_param.sched_priority = prio - 1;
+	ret_chk = sched_setparam(pid[2], &st_param);
+	TC_ASSERT_EQ("sched_setparam", ret_chk, OK);
+	st_param.sched_priority = prio - 3;
+	ret_chk = sched_setparam(pid[0], &st_param);
+	TC_ASSERT_EQ("sched_setparam", ret_chk, OK);
+	readytorun_wait(READYTORUN_TASKS);
+	TC_ASSERT_EQ("sched_setparam", g_readytorun_order[0], 2);
+	TC_ASSERT_EQ("sched_setparam", g_readytorun_order[1], 1);
+	TC_ASSERT_EQ("sched_setparam", g_readytorun_order[2], 0);
+
+	/* Blocked task is made ready at its new priority, behind tasks already there */
+
+	g_readytorun_count = 0;
+	pid[0] = readytorun_create(readytorun_blocked_task, prio + 1, 0);
+	TC_ASSERT_GT("task_create", pid[0], 0);
+	st_param.sched_priority = prio - 1;
+	ret_chk = sched_setparam(pid[0], &st_param);
+	TC_ASSERT_EQ("sched_setparam", ret_chk, OK);
+	pid[1] = readytorun_create(readytorun_task, prio - 1, 1);
+	TC_ASSERT_GT("task_create", pid[1], 0);
+	sem_post(&g_readytorun_gate);
+	TC_ASSERT_EQ("sched_setparam", g_readytorun_count, 0);
+	readytorun_wait(2);
+	TC_ASSERT_EQ("sched_setparam", g_readytorun_order[0], 1);
+	TC_ASSERT_EQ("sched_setparam", g_readytorun_order[1], 0);
+
+	/* Running task is preempted when lowered below a ready task, and isn't when raised */
+
+	g_readytorun_count = 0;
+	pid[0] = readytorun_create(readytorun_task, prio - 1, 0);
+	TC_ASSERT_GT("task_create", pid[0], 0);
+	st_param.sched_priority = prio - 2;
+	ret_chk = sched_setparam(0, &st_param);
+	i = g_readytorun_count;
+	pid[1] = readytorun_create(readytorun_task, prio - 2, 1);
+	st_param.sched_priority = prio;
+	TC_ASSERT_EQ_CLEANUP("sched_setparam", ret_chk, OK, sched_setparam(0, &st_param));
+	TC_ASSERT_EQ_CLEANUP("sched_setparam", i, 1, sched_setparam(0, &st_param));
+	ret_chk = sched_setparam(0, &st_param);
+	TC_ASSERT_EQ("sched_setparam", ret_chk, OK);
+	TC_ASSERT_GT("task_create", pid[1], 0);
+	TC_ASSERT_EQ("sched_setparam", g_readytorun_count, 1);
+	readytorun_wait(2);
+	TC_ASSERT_EQ("sched_setparam", g_readytorun_order[1], 1);
+
+	sem_destroy(&g_readytorun_gate);
+	sem_destroy(&g_readytorun_done);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 #if !defined(CONFIG_BUILD_PROTECTED)
 /**
  * @fn                   :tc_sched_task_setcancelstate
@@ -705,6 +861,9 @@ int sched_main(void)
 	tc_sched_sched_foreach();
 	tc_sched_sched_lockcount();
 	tc_sched_sched_getstreams();
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+	tc_sched_readytorun_bitmap();
+#endif
 #ifndef CONFIG_BUILD_PROTECTED
 	tc_sched_task_setcancelstate();
 #ifdef CONFIG_CANCELLATION_POINTS
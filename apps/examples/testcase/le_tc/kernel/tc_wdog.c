@@ -0,0 +1,295 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/// @file tc_wdog.c
+
+/// @brief Test Case Example for Watchdog Timer API
+
+/**************************************************************************
+* Included Files
+**************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <tinyara/arch.h>
+#include <tinyara/clock.h>
+#include <tinyara/wdog.h>
+#include "tc_internal.h"
+
+/**************************************************************************
+* Private Definitions
+**************************************************************************/
+/* Delays are chosen around the levels of the timer wheel, of 32 slots each:
+ * a watchdog expiring more than 32 ticks ahead starts at level 1, more than
+ * 32 * 32 ticks ahead at level 2.
+ */
+
+#define WDOG_WHEEL_SLOTS    32
+#define WDOG_LEVEL1         WDOG_WHEEL_SLOTS
+#define WDOG_LEVEL2         (WDOG_WHEEL_SLOTS * WDOG_WHEEL_SLOTS)
+#define WDOG_NTIMERS        6
+
+/**************************************************************************
+* Private Variables
+**************************************************************************/
+static WDOG_ID g_wdog[WDOG_NTIMERS];
+static volatile bool g_wdog_fired[WDOG_NTIMERS];
+static volatile clock_t g_wdog_tick[WDOG_NTIMERS];
+
+/**************************************************************************
+* Private Functions
+**************************************************************************/
+static void wdog_handler(int argc, uint32_t index, ...)
+{
+	g_wdog_tick[index] = clock_systimer();
+	g_wdog_fired[index] = true;
+}
+
+static bool wdog_create(void)
+{
+	int index;
+
+	for (index = 0; index < WDOG_NTIMERS; index++) {
+		g_wdog[index] = wd_create();
+		if (g_wdog[index] == NULL) {
+			while (index-- > 0) {
+				wd_delete(g_wdog[index]);
+			}
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void wdog_delete(void)
+{
+	int index;
+
+	/* Active watchdogs are cancelled as well */
+
+	for (index = 0; index < WDOG_NTIMERS; index++) {
+		wd_delete(g_wdog[index]);
+	}
+}
+
+static int wdog_start(int index, int delay)
+{
+	g_wdog_fired[index] = false;
+	return wd_start(g_wdog[index], delay, (wdentry_t)wdog_handler, 1, (uint32_t)index);
+}
+
+/* First tick more than a period after now, at an offset within the period */
+
+static clock_t wdog_align(clock_t now, clock_t period, clock_t offset)
+{
+	clock_t base = now + period + 1;
+
+	return base + ((offset - base) & (period - 1));
+}
+
+static void wdog_wait(clock_t tick)
+{
+	while ((int32_t)(tick - clock_systimer()) > 0) {
+		usleep(USEC_PER_TICK);
+	}
+}
+
+/* The time remaining may go down by one tick while it is read */
+
+static bool wdog_check_remaining(int index, clock_t expires)
+{
+	clock_t before = clock_systimer();
+	int remaining = wd_gettime(g_wdog[index]);
+	clock_t after = clock_systimer();
+
+	return remaining <= (int32_t)(expires - before) && remaining >= (int32_t)(expires - after);
+}
+
+/**
+* @fn                   :tc_wdog_wd_start_levels
+* @brief                :Watchdogs expire on time whatever the level of the timer wheel they start at
+* @scenario             :Start watchdogs with delays around the bounds of the levels of the wheel on the same tick,
+*                        the ones of upper levels move down before they expire
+* @API's covered        :wd_create, wd_start, wd_delete
+* @Preconditions        :none
+* @Postconditions       :none
+* @Return               :void
+*/
+static void tc_wdog_wd_start_levels(void)
+{
+	static const int delays[WDOG_NTIMERS] = {
+		1, WDOG_LEVEL1, WDOG_LEVEL1 + 1, WDOG_LEVEL2, WDOG_LEVEL2 + 1, WDOG_LEVEL2 + WDOG_LEVEL1 + 1
+	};
+	int ret[WDOG_NTIMERS];
+	irqstate_t flags;
+	clock_t start;
+	int index;
+
+	TC_ASSERT("wd_create", wdog_create());
+
+	flags = irqsave();
+	start = clock_systimer();
+	for (index = 0; index < WDOG_NTIMERS; index++) {
+		ret[index] = wdog_start(index, delays[index]);
+	}
+	irqrestore(flags);
+
+	for (index = 0; index < WDOG_NTIMERS; index++) {
+		TC_ASSERT_EQ_CLEANUP("wd_start", ret[index], OK, wdog_delete());
+	}
+
+	wdog_wait(start + WDOG_LEVEL2 + WDOG_LEVEL1 + 3);
+
+	for (index = 0; index < WDOG_NTIMERS; index++) {
+		TC_ASSERT_CLEANUP("wd_start", g_wdog_fired[index], wdog_delete());
+		TC_ASSERT_GEQ_CLEANUP("wd_start", g_wdog_tick[index] - start, delays[index], wdog_delete());
+		TC_ASSERT_LEQ_CLEANUP("wd_start", g_wdog_tick[index] - start, delays[index] + 1, wdog_delete());
+	}
+
+	wdog_delete();
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_wdog_wd_cancel_levels
+* @brief                :Cancel watchdogs before and after they move to a lower level of the timer wheel
+* @scenario             :Cancel watchdogs of each level right after starting them, then cancel watchdogs
+*                        which moved down from level 1 and from level 2, next to one expiring on the same tick
+* @API's covered        :wd_create, wd_start, wd_cancel, wd_gettime, wd_delete
+* @Preconditions        :none
+* @Postconditions       :none
+* @Return               :void
+*/
+static void tc_wdog_wd_cancel_levels(void)
+{
+	irqstate_t flags;
+	clock_t start;
+	clock_t expires1;
+	clock_t expires2;
+	int ret[3];
+	int index;
+
+	TC_ASSERT("wd_create", wdog_create());
+
+	/* Before moving down: one watchdog at each level */
+
+	TC_ASSERT_EQ_CLEANUP("wd_start", wdog_start(0, WDOG_LEVEL1), OK, wdog_delete());
+	TC_ASSERT_EQ_CLEANUP("wd_start", wdog_start(1, WDOG_LEVEL1 + 1), OK, wdog_delete());
+	TC_ASSERT_EQ_CLEANUP("wd_start", wdog_start(2, WDOG_LEVEL2 + 1), OK, wdog_delete());
+
+	for (index = 0; index < 3; index++) {
+		TC_ASSERT_EQ_CLEANUP("wd_cancel", wd_cancel(g_wdog[index]), OK, wdog_delete());
+		TC_ASSERT_EQ_CLEANUP("wd_gettime", wd_gettime(g_wdog[index]), 0, wdog_delete());
+		TC_ASSERT_EQ_CLEANUP("wd_cancel", wd_cancel(g_wdog[index]), ERROR, wdog_delete());
+	}
+
+	/* After moving down: watchdog 3 moves from level 1 to 0 half a period before
+	 * expiring with watchdog 4, and watchdog 5 from level 2 to 1 and then to 0.
+	 */
+
+	flags = irqsave();
+	start = clock_systimer();
+	expires1 = wdog_align(start, WDOG_LEVEL1, WDOG_LEVEL1 / 2);
+	expires2 = wdog_align(start, WDOG_LEVEL2, WDOG_LEVEL1 + WDOG_LEVEL1 / 2);
+	ret[0] = wdog_start(3, expires1 - start);
+	ret[1] = wdog_start(4, expires1 - start);
+	ret[2] = wdog_start(5, expires2 - start);
+	irqrestore(flags);
+
+	for (index = 0; index < 3; index++) {
+		TC_ASSERT_EQ_CLEANUP("wd_start", ret[index], OK, wdog_delete());
+	}
+
+	wdog_wait(expires1 - WDOG_LEVEL1 / 4);
+	TC_ASSERT_EQ_CLEANUP("wd_cancel", wd_cancel(g_wdog[3]), OK, wdog_delete());
+
+	wdog_wait(expires1 + 2);
+	TC_ASSERT_CLEANUP("wd_cancel", !g_wdog_fired[3], wdog_delete());
+	TC_ASSERT_CLEANUP("wd_cancel", g_wdog_fired[4], wdog_delete());
+	TC_ASSERT_LEQ_CLEANUP("wd_cancel", g_wdog_tick[4] - expires1, 1, wdog_delete());
+
+	wdog_wait(expires2 - WDOG_LEVEL1 / 4);
+	TC_ASSERT_EQ_CLEANUP("wd_cancel", wd_cancel(g_wdog[5]), OK, wdog_delete());
+
+	wdog_wait(expires2 + 2);
+	TC_ASSERT_CLEANUP("wd_cancel", !g_wdog_fired[5], wdog_delete());
+
+	wdog_delete();
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @fn                   :tc_wdog_wd_gettime_levels
+* @brief                :Get the time remaining of a watchdog at each level of the timer wheel
+* @scenario             :Start a watchdog at level 2, check the time remaining after it moves to level 1
+*                        and to level 0, and after it expires
+* @API's covered        :wd_create, wd_start, wd_gettime, wd_delete
+* @Preconditions        :none
+* @Postconditions       :none
+* @Return               :void
+*/
+static void tc_wdog_wd_gettime_levels(void)
+{
+	irqstate_t flags;
+	clock_t start;
+	clock_t expires;
+	int ret;
+
+	TC_ASSERT("wd_create", wdog_create());
+
+	/* It moves to level 1 one and a half period of level 1 before expiring,
+	 * and to level 0 half a period before.
+	 */
+
+	flags = irqsave();
+	start = clock_systimer();
+	expires = wdog_align(start, WDOG_LEVEL2, WDOG_LEVEL1 + WDOG_LEVEL1 / 2);
+	ret = wdog_start(0, expires - start);
+	irqrestore(flags);
+	TC_ASSERT_EQ_CLEANUP("wd_start", ret, OK, wdog_delete());
+
+	TC_ASSERT_CLEANUP("wd_gettime", wdog_check_remaining(0, expires), wdog_delete());
+
+	wdog_wait(expires - WDOG_LEVEL1 - WDOG_LEVEL1 / 4);
+	TC_ASSERT_CLEANUP("wd_gettime", wdog_check_remaining(0, expires), wdog_delete());
+
+	wdog_wait(expires - WDOG_LEVEL1 / 4);
+	TC_ASSERT_CLEANUP("wd_gettime", wdog_check_remaining(0, expires), wdog_delete());
+
+	wdog_wait(expires + 2);
+	TC_ASSERT_CLEANUP("wd_gettime", g_wdog_fired[0], wdog_delete());
+	TC_ASSERT_EQ_CLEANUP("wd_gettime", wd_gettime(g_wdog[0]), 0, wdog_delete());
+
+	wdog_delete();
+	TC_SUCCESS_RESULT();
+}
+
+/****************************************************************************
+ * Name: wdog
+ ****************************************************************************/
+int wdog_main(void)
+{
+	tc_wdog_wd_start_levels();
+	tc_wdog_wd_cancel_levels();
+	tc_wdog_wd_gettime_levels();
+
+	return 0;
+}
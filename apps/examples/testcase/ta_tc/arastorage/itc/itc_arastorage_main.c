@@ -661,6 +661,7 @@ void itc_arastorage_db_print_header_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -712,6 +713,7 @@ void itc_arastorage_db_print_tuple_p(void)
 #else
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
 #endif
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	g_cursor = db_query(g_query);
 	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
@@ -758,6 +760,7 @@ void itc_arastorage_db_print_value_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -808,6 +811,7 @@ void itc_arastorage_cursor_get_count_p(void)
 {
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	int nCount = -1;
 	memset(g_query, 0, QUERY_LENGTH);
@@ -854,6 +858,7 @@ void itc_arastorage_cursor_move_first_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -901,6 +906,7 @@ void itc_arastorage_cursor_move_next_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -948,6 +954,7 @@ void itc_arastorage_cursor_move_prev_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -999,6 +1006,7 @@ void itc_arastorage_cursor_move_last_p(void)
 	int count;
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1048,6 +1056,7 @@ void itc_arastorage_cursor_move_to_p(void)
 	db_result_t ret;
 	tuple_id_t row = 3;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1096,6 +1105,7 @@ void itc_arastorage_cursor_is_first_row_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1130,6 +1140,7 @@ void itc_arastorage_cursor_is_first_row_n(void)
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 0;", g_attribute_set[0],
 		g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
 
+	db_cursor_free(g_cursor);
 	g_cursor = db_query(g_query);
 	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
 	ret = cursor_move_last(g_cursor);
@@ -1159,6 +1170,7 @@ void itc_arastorage_cursor_is_last_row_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1192,6 +1204,7 @@ void itc_arastorage_cursor_is_last_row_n(void)
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 0;", g_attribute_set[0],
 		g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
+	db_cursor_free(g_cursor);
 	g_cursor = db_query(g_query);
 	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
 	ret = cursor_move_first(g_cursor);
@@ -1221,6 +1234,7 @@ void itc_arastorage_cursor_get_attr_type_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	domain_t domain;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1265,6 +1279,7 @@ void itc_arastorage_cursor_get_attr_type_n(void)
 	TC_ASSERT_NEQ("cursor_get_attr_type", domain, DOMAIN_DOUBLE);
 #endif
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1296,6 +1311,7 @@ void itc_arastorage_cursor_get_attr_name_p(void)
 	char *attr_name = NULL;
 	int ret = 0;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1367,6 +1383,7 @@ void itc_arastorage_cursor_get_attr_index_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	attribute_id_t index;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1434,6 +1451,7 @@ void itc_arastorage_cursor_get_int_value_p(void)
 	int value;
 	int ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1489,6 +1507,7 @@ void itc_arastorage_cursor_get_long_value_p(void)
 	long value;
 	int ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1545,6 +1564,7 @@ void itc_arastorage_cursor_get_double_value_p(void)
 	double value;
 	int ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1601,6 +1621,7 @@ void itc_arastorage_cursor_get_string_value_p(void)
 	unsigned char *value = NULL;
 	int ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1656,6 +1677,7 @@ void itc_arastorage_cursor_get_row_p(void)
 	cursor_row_t row;
 	tuple_id_t id = 3;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -1703,6 +1725,7 @@ void itc_arastorage_db_cursor_free_p(void)
 	TC_ASSERT_EQ("ARASTORAGE_STARTUP", g_check, true);
 	db_result_t ret;
 
+	db_cursor_free(g_cursor);
 	g_cursor = NULL;
 	memset(g_query, 0, QUERY_LENGTH);
 	snprintf(g_query, QUERY_LENGTH, "SELECT %s, %s, %s FROM %s WHERE %s > 5;", g_attribute_set[0], g_attribute_set[1], g_attribute_set[2], RELATION_NAME1, g_attribute_set[0]);
@@ -0,0 +1,222 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <arastorage/arastorage.h>
+#include "tc_common.h"
+
+/****************************************************************************
+ * Definitions
+ ****************************************************************************/
+#define RELATION_NAME   "stress"
+#define QUERY_LENGTH    128
+
+#define STRESS_ROWS     CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_STRESS_ROWS
+#define STRESS_THREADS  CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_STRESS_THREADS
+#define STRESS_QUERIES  CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_STRESS_QUERIES
+#define STRESS_STACK    4096
+
+/* Values are a permutation of [0, STRESS_ROWS * 4), spread over the index. */
+#define STRESS_VALUE(i) (((i) * 7919 + 13) % (STRESS_ROWS * 4))
+#define STRESS_RANGE    (STRESS_ROWS / 2)
+
+/****************************************************************************
+ *  Global Variables
+ ****************************************************************************/
+struct stress_reader_s {
+	int id;
+	int queries;
+	int errors;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+static void cleanup(void)
+{
+	db_exec("REMOVE RELATION " RELATION_NAME ";");
+}
+
+static unsigned long stress_now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (unsigned long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Count the rows in (lo, hi) from the values inserted */
+static int stress_expected_count(int lo, int hi)
+{
+	int i;
+	int count = 0;
+
+	for (i = 0; i < STRESS_ROWS; i++) {
+		if (STRESS_VALUE(i) > lo && STRESS_VALUE(i) < hi) {
+			count++;
+		}
+	}
+	return count;
+}
+
+static void *stress_reader(void *arg)
+{
+	struct stress_reader_s *reader = (struct stress_reader_s *)arg;
+	char query[QUERY_LENGTH];
+	db_cursor_t *cursor;
+	int count;
+	int lo;
+	int i;
+
+	for (i = 0; i < STRESS_QUERIES; i++) {
+		/* Readers start at different keys, so they meet on the same buckets */
+		lo = ((i + reader->id * 7) * 997) % (STRESS_ROWS * 3) + 1;
+		snprintf(query, QUERY_LENGTH, "SELECT id, value FROM %s WHERE value > %d AND value < %d;", RELATION_NAME, lo, lo + STRESS_RANGE);
+
+		cursor = db_query(query);
+		count = (cursor != NULL) ? cursor_get_count(cursor) : -1;
+		if (cursor != NULL) {
+			db_cursor_free(cursor);
+		}
+		if (count != stress_expected_count(lo, lo + STRESS_RANGE)) {
+			printf("[%d] %s : %d rows, expected %d\n", reader->id, query, count, stress_expected_count(lo, lo + STRESS_RANGE));
+			reader->errors++;
+		}
+		reader->queries++;
+	}
+	return NULL;
+}
+
+/**
+* @testcase         stress_arastorage_populate
+* @brief            Create the relation and index used by readers
+* @scenario         Create a relation with an int and a long attribute, index the long one
+*                   and insert STRESS_ROWS rows
+* @apicovered       db_init, db_exec
+* @precondition     none
+* @postcondition    none
+*/
+static void stress_arastorage_populate(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	int i;
+
+	res = db_init();
+	TC_ASSERT_EQ("db_init", DB_SUCCESS(res), true);
+
+	cleanup();
+	res = db_exec("CREATE RELATION " RELATION_NAME ";");
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+	res = db_exec("CREATE ATTRIBUTE id DOMAIN int IN " RELATION_NAME ";");
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+	res = db_exec("CREATE ATTRIBUTE value DOMAIN long IN " RELATION_NAME ";");
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+	res = db_exec("CREATE INDEX " RELATION_NAME ".value TYPE bplustree;");
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	for (i = 0; i < STRESS_ROWS; i++) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d, %d) INTO %s;", i, STRESS_VALUE(i), RELATION_NAME);
+		res = db_exec(query);
+		TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         stress_arastorage_concurrent_query
+* @brief            Run range queries over an index from several threads at once
+* @scenario         For 1, 2, 4, ... STRESS_THREADS readers, each reader runs STRESS_QUERIES
+*                   range queries and checks the row count. Throughput is printed per step
+* @apicovered       db_query, cursor_get_count, db_cursor_free
+* @precondition     stress_arastorage_populate
+* @postcondition    none
+*/
+static void stress_arastorage_concurrent_query(void)
+{
+	pthread_t threads[STRESS_THREADS];
+	struct stress_reader_s readers[STRESS_THREADS];
+	pthread_attr_t attr;
+	unsigned long elapsed;
+	int nthreads;
+	int queries;
+	int errors;
+	int ret;
+	int i;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, STRESS_STACK);
+
+	for (nthreads = 1; nthreads <= STRESS_THREADS; nthreads *= 2) {
+		memset(readers, 0, sizeof(readers));
+		elapsed = stress_now_ms();
+		for (i = 0; i < nthreads; i++) {
+			readers[i].id = i;
+			ret = pthread_create(&threads[i], &attr, stress_reader, &readers[i]);
+			TC_ASSERT_EQ("pthread_create", ret, 0);
+		}
+
+		queries = 0;
+		errors = 0;
+		for (i = 0; i < nthreads; i++) {
+			pthread_join(threads[i], NULL);
+			queries += readers[i].queries;
+			errors += readers[i].errors;
+		}
+		elapsed = stress_now_ms() - elapsed;
+
+		printf("readers %d : %d queries in %lu ms, %lu queries/s, %d errors\n", nthreads, queries, elapsed, elapsed ? (unsigned long)queries * 1000 / elapsed : 0, errors);
+		TC_ASSERT_EQ("db_query", errors, 0);
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+int main(int argc, FAR char *argv[])
+#else
+int stress_arastorage_main(int argc, char *argv[])
+#endif
+{
+	if (tc_handler(TC_START, "Arastorage STRESS") == ERROR) {
+		return ERROR;
+	}
+
+	stress_arastorage_populate();
+	stress_arastorage_concurrent_query();
+
+	cleanup();
+	db_deinit();
+
+	(void)tc_handler(TC_END, "Arastorage STRESS");
+
+	return 0;
+}
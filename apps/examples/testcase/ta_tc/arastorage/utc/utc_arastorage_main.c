@@ -23,6 +23,9 @@
 #include <tinyara/config.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
 #include <semaphore.h>
 #include <arastorage/arastorage.h>
 #include <tinyara/fs/fs_utils.h>
@@ -37,12 +40,17 @@
 
 #define RELATION_NAME1  "rel1"
 #define RELATION_NAME2  "rel2"
+#define RELATION_NAME3  "rel3"
 #define INDEX_BPLUS     "bplustree"
 #define INDEX_INLINE    "inline"
 #define QUERY_LENGTH    128
 
 #define DATA_SET_NUM    10
 #define DATA_SET_MULTIPLIER 80
+#define PREFIX_ROW_NUM  100
+#define QUERY_ROW_NUM   25
+#define QUERY_LIMIT     5
+#define QUERY_OFFSET    3
 
 /****************************************************************************
  *  Global Variables
@@ -87,6 +95,104 @@ static void check_query_result(char * query)
 	g_cursor = NULL;
 }
 
+static int get_row_count(char *name)
+{
+	char query[QUERY_LENGTH];
+	db_cursor_t *cursor;
+	int count;
+
+	snprintf(query, QUERY_LENGTH, "SELECT %s FROM %s;", g_attribute_set[0], name);
+	cursor = db_query(query);
+	if (cursor == NULL) {
+		return -1;
+	}
+	count = cursor_get_count(cursor);
+	db_cursor_free(cursor);
+	return count;
+}
+
+/* Count the rows of rel2 with date in (lower, upper), by reading every row or over the index. */
+static int get_date_count(long lower, long upper, bool scan)
+{
+	char query[QUERY_LENGTH];
+	db_cursor_t *cursor;
+	long date;
+	int count;
+
+	if (scan) {
+		snprintf(query, QUERY_LENGTH, "SELECT %s FROM %s;", g_attribute_set[1], RELATION_NAME2);
+	} else {
+		snprintf(query, QUERY_LENGTH, "SELECT %s FROM %s WHERE %s > %ld AND %s < %ld;", g_attribute_set[1], RELATION_NAME2,
+				 g_attribute_set[1], lower, g_attribute_set[1], upper);
+	}
+	cursor = db_query(query);
+	if (cursor == NULL) {
+		return -1;
+	}
+	if (!scan) {
+		count = cursor_get_count(cursor);
+		db_cursor_free(cursor);
+		return count;
+	}
+
+	count = 0;
+	if (DB_SUCCESS(cursor_move_first(cursor))) {
+		do {
+			date = cursor_get_long_value(cursor, 0);
+			if (date > lower && date < upper) {
+				count++;
+			}
+		} while (DB_SUCCESS(cursor_move_next(cursor)));
+	}
+	db_cursor_free(cursor);
+	return count;
+}
+
+/* Insert a row into rel2 from another thread. */
+static void *insert_thread(void *arg)
+{
+	char query[QUERY_LENGTH];
+
+	snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", DATA_SET_NUM * 30, g_arastorage_data_set[0].long_value, RELATION_NAME2);
+	*(db_result_t *)arg = db_exec(query);
+	return NULL;
+}
+
+/* Aggregate the values of rel1 in (lower, upper] by reading every row. */
+static int scan_value_summary(int lower, int upper, long summary[4])
+{
+	char query[QUERY_LENGTH];
+	db_cursor_t *cursor;
+	int value;
+
+	snprintf(query, QUERY_LENGTH, "SELECT %s FROM %s;", g_attribute_set[3], RELATION_NAME1);
+	cursor = db_query(query);
+	if (cursor == NULL) {
+		return -1;
+	}
+
+	/* count, min, max and sum */
+	memset(summary, 0, sizeof(long) * 4);
+	if (DB_SUCCESS(cursor_move_first(cursor))) {
+		do {
+			value = cursor_get_int_value(cursor, 0);
+			if (value <= lower || value > upper) {
+				continue;
+			}
+			if (summary[0] == 0 || value < summary[1]) {
+				summary[1] = value;
+			}
+			if (summary[0] == 0 || value > summary[2]) {
+				summary[2] = value;
+			}
+			summary[3] += value;
+			summary[0]++;
+		} while (DB_SUCCESS(cursor_move_next(cursor)));
+	}
+	db_cursor_free(cursor);
+	return 0;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,6 +209,10 @@ static void cleanup(void)
 	memset(query, 0, QUERY_LENGTH);
 	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME2);
 	db_exec(query);
+
+	memset(query, 0, QUERY_LENGTH);
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	db_exec(query);
 }
 
 /**
@@ -371,6 +481,84 @@ static void utc_arastorage_db_exec_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         utc_arastorage_db_prepare_p
+* @brief            Execute prepared statements
+* @scenario         Insert rows with a prepared INSERT, and check the rows returned by
+*                   a prepared SELECT with a parameter in its condition
+* @apicovered       db_prepare, db_bind_int, db_bind_string, db_step, db_reset, db_finalize
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_prepare_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	unsigned char *value;
+	char query[QUERY_LENGTH];
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "CREATE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE ATTRIBUTE %s DOMAIN int IN %s;", g_attribute_set[0], RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE ATTRIBUTE %s DOMAIN string(32) IN %s;", g_attribute_set[2], RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME3);
+	res = db_prepare(query, &stmt);
+	TC_ASSERT_EQ("db_prepare", DB_SUCCESS(res), true);
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		res = db_bind_int(stmt, 1, i);
+		TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_bind_string(stmt, 2, g_arastorage_data_set[i].string_value);
+		TC_ASSERT_EQ_CLEANUP("db_bind_string", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_step(stmt, NULL);
+		TC_ASSERT_EQ_CLEANUP("db_step", DB_SUCCESS(res), true, db_finalize(stmt));
+	}
+
+	/* Values are cleared, so the statement can't run until they are bound again. */
+	res = db_reset(stmt);
+	TC_ASSERT_EQ_CLEANUP("db_reset", DB_SUCCESS(res), true, db_finalize(stmt));
+	res = db_step(stmt, NULL);
+	TC_ASSERT_EQ_CLEANUP("db_step", DB_ERROR(res), true, db_finalize(stmt));
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s < ?;", g_attribute_set[0], g_attribute_set[2],
+			 RELATION_NAME3, g_attribute_set[0]);
+	res = db_prepare(query, &stmt);
+	TC_ASSERT_EQ("db_prepare", DB_SUCCESS(res), true);
+	for (i = 1; i <= DATA_SET_NUM; i++) {
+		res = db_bind_int(stmt, 1, i);
+		TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_step(stmt, &g_cursor);
+		TC_ASSERT_EQ_CLEANUP("db_step", DB_SUCCESS(res), true, db_finalize(stmt));
+		TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), i, db_cursor_free(g_cursor); db_finalize(stmt));
+
+		res = cursor_move_last(g_cursor);
+		TC_ASSERT_EQ_CLEANUP("cursor_move_last", DB_SUCCESS(res), true, db_cursor_free(g_cursor); db_finalize(stmt));
+		value = cursor_get_string_value(g_cursor, 1);
+		TC_ASSERT_NEQ_CLEANUP("cursor_get_string_value", value, NULL, db_cursor_free(g_cursor); db_finalize(stmt));
+		TC_ASSERT_EQ_CLEANUP("cursor_get_string_value", strcmp((char *)value, g_arastorage_data_set[i - 1].string_value), 0, db_cursor_free(g_cursor); db_finalize(stmt));
+		db_cursor_free(g_cursor);
+	}
+	g_cursor = NULL;
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         utc_arastorage_db_query_p
 * @brief            Query a database
@@ -383,6 +571,9 @@ static void utc_arastorage_db_query_p(void)
 {
 	db_result_t res;
 	char query[QUERY_LENGTH];
+	int ids[QUERY_ROW_NUM];
+	int count;
+	int i;
 
 	/* Select over bplus-tree index */
 #ifdef CONFIG_ARCH_FLOAT_H
@@ -406,6 +597,18 @@ static void utc_arastorage_db_query_p(void)
 	snprintf(query, QUERY_LENGTH, "SELECT COUNT(id) FROM %s WHERE id = 5 OR id = 85;", RELATION_NAME2);
 	check_query_result(query);
 
+	/* Count and max are long values */
+	snprintf(query, QUERY_LENGTH, "SELECT COUNT(id), MAX(id) FROM %s WHERE id = 5 OR id = 85;", RELATION_NAME2);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	res = cursor_move_first(g_cursor);
+	TC_ASSERT_EQ("cursor_move_first", DB_SUCCESS(res), true);
+	TC_ASSERT_EQ("cursor_get_long_value", cursor_get_long_value(g_cursor, 0), 2);
+	TC_ASSERT_EQ("cursor_get_long_value", cursor_get_long_value(g_cursor, 1), 85);
+	res = db_cursor_free(g_cursor);
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+	g_cursor = NULL;
+
 	/* Mean aggregation operation */
 	snprintf(query, QUERY_LENGTH, "SELECT MEAN(id) FROM %s;", RELATION_NAME2);
 	check_query_result(query);
@@ -422,6 +625,45 @@ static void utc_arastorage_db_query_p(void)
 	snprintf(query, QUERY_LENGTH, "SELECT MIN(id) FROM %s;", RELATION_NAME2);
 	check_query_result(query);
 
+	/* Rows of a query, read forwards and then backwards past the rows kept by the cursor */
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE id < %d;", RELATION_NAME2, QUERY_ROW_NUM);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	count = cursor_get_count(g_cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", count, QUERY_ROW_NUM, db_cursor_free(g_cursor));
+	for (i = 0; i < QUERY_ROW_NUM; i++) {
+		res = cursor_move_to(g_cursor, i);
+		TC_ASSERT_EQ_CLEANUP("cursor_move_to", DB_SUCCESS(res), true, db_cursor_free(g_cursor));
+		ids[i] = cursor_get_int_value(g_cursor, 0);
+	}
+	res = cursor_move_last(g_cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_move_last", DB_SUCCESS(res), true, db_cursor_free(g_cursor));
+	for (i = QUERY_ROW_NUM - 1; i > 0; i--) {
+		TC_ASSERT_EQ_CLEANUP("cursor_get_int_value", cursor_get_int_value(g_cursor, 0), ids[i], db_cursor_free(g_cursor));
+		res = cursor_move_prev(g_cursor);
+		TC_ASSERT_EQ_CLEANUP("cursor_move_prev", DB_SUCCESS(res), true, db_cursor_free(g_cursor));
+	}
+	TC_ASSERT_EQ_CLEANUP("cursor_get_int_value", cursor_get_int_value(g_cursor, 0), ids[0], db_cursor_free(g_cursor));
+	res = db_cursor_free(g_cursor);
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+	g_cursor = NULL;
+
+	/* Select with LIMIT and OFFSET, the rows follow the skipped ones */
+	snprintf(query, QUERY_LENGTH, "SELECT id, date FROM %s WHERE id < %d LIMIT %d OFFSET %d;", RELATION_NAME2,
+			 QUERY_ROW_NUM, QUERY_LIMIT, QUERY_OFFSET);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	count = cursor_get_count(g_cursor);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", count, QUERY_LIMIT, db_cursor_free(g_cursor));
+	for (i = 0; i < QUERY_LIMIT; i++) {
+		res = cursor_move_to(g_cursor, i);
+		TC_ASSERT_EQ_CLEANUP("cursor_move_to", DB_SUCCESS(res), true, db_cursor_free(g_cursor));
+		TC_ASSERT_EQ_CLEANUP("cursor_get_int_value", cursor_get_int_value(g_cursor, 0), ids[QUERY_OFFSET + i], db_cursor_free(g_cursor));
+	}
+	res = db_cursor_free(g_cursor);
+	TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+	g_cursor = NULL;
+
 	/* Remove operation */
 	snprintf(query, QUERY_LENGTH, "REMOVE FROM %s WHERE date > 2000 AND date < 8000;", RELATION_NAME2);
 	check_query_result(query);
@@ -440,6 +682,376 @@ static void utc_arastorage_db_query_p(void)
 	TC_SUCCESS_RESULT();
 }
 
+/**
+* @testcase         utc_arastorage_db_query_string_p
+* @brief            Query a relation by a string attribute
+* @scenario         Create a bplus-tree index on a string attribute, and check the rows returned
+*                   by an equality and a range condition on it, and by a condition with a parameter
+* @apicovered       db_exec, db_query, db_prepare, db_bind_string, db_step
+* @precondition     utc_arastorage_db_exec_p
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_string_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+	int i;
+
+	/* Make room in the index pool for the index of fruit. */
+	snprintf(query, QUERY_LENGTH, "REMOVE INDEX %s.%s;", RELATION_NAME1, g_attribute_set[3]);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME1, g_attribute_set[2], INDEX_BPLUS);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, fruit FROM %s WHERE fruit = 'mango';", RELATION_NAME1);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), DATA_SET_MULTIPLIER, db_cursor_free(g_cursor));
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	/* orange and peach */
+	snprintf(query, QUERY_LENGTH, "SELECT id, fruit FROM %s WHERE fruit > 'melon' AND fruit <= 'peach';", RELATION_NAME1);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), DATA_SET_MULTIPLIER * 2, db_cursor_free(g_cursor));
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	snprintf(query, QUERY_LENGTH, "SELECT id, fruit FROM %s WHERE fruit = ?;", RELATION_NAME1);
+	res = db_prepare(query, &stmt);
+	TC_ASSERT_EQ("db_prepare", DB_SUCCESS(res), true);
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		res = db_bind_string(stmt, 1, g_arastorage_data_set[i].string_value);
+		TC_ASSERT_EQ_CLEANUP("db_bind_string", DB_SUCCESS(res), true, db_finalize(stmt));
+		res = db_step(stmt, &g_cursor);
+		TC_ASSERT_EQ_CLEANUP("db_step", DB_SUCCESS(res), true, db_finalize(stmt));
+		TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), DATA_SET_MULTIPLIER, db_cursor_free(g_cursor); db_finalize(stmt));
+		db_cursor_free(g_cursor);
+	}
+	g_cursor = NULL;
+	db_finalize(stmt);
+
+	snprintf(query, QUERY_LENGTH, "REMOVE INDEX %s.%s;", RELATION_NAME1, g_attribute_set[2]);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME1, g_attribute_set[3], INDEX_BPLUS);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/* The string of a row of utc_arastorage_db_query_string_prefix_p. Rows of even
+   numbers have a second string, which shares all the bytes of the index key. */
+static void get_prefix_string(char *str, int num, bool suffix)
+{
+	snprintf(str, 32, suffix ? "dev-%04d-b" : "dev-%04d", num);
+}
+
+/**
+* @testcase         utc_arastorage_db_query_string_prefix_p
+* @brief            Query a string attribute whose values share a long prefix
+* @scenario         Index strings sharing the first 4 bytes, and strings sharing all the bytes
+*                   of the index key, and check the rows returned by an equality and a range
+*                   condition against the ones found by comparing the strings
+* @apicovered       db_exec, db_query, db_prepare, db_bind_string, db_step
+* @precondition     utc_arastorage_db_exec_p
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_string_prefix_p(void)
+{
+	db_result_t res;
+	db_stmt_t *stmt;
+	char query[QUERY_LENGTH];
+	char str[32];
+	int expected;
+	int count;
+	int i;
+	int j;
+
+	/* Make room in the index pool for the index of rel3. */
+	snprintf(query, QUERY_LENGTH, "REMOVE INDEX %s.%s;", RELATION_NAME1, g_attribute_set[3]);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE ATTRIBUTE %s DOMAIN int IN %s;", g_attribute_set[0], RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE ATTRIBUTE %s DOMAIN string(32) IN %s;", g_attribute_set[2], RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME3, g_attribute_set[2], INDEX_BPLUS);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "INSERT (?, ?) INTO %s;", RELATION_NAME3);
+	res = db_prepare(query, &stmt);
+	TC_ASSERT_EQ("db_prepare", DB_SUCCESS(res), true);
+	for (i = 0; i < PREFIX_ROW_NUM; i++) {
+		for (j = 0; j <= (i % 2 == 0); j++) {
+			get_prefix_string(str, i, j);
+			res = db_bind_int(stmt, 1, i);
+			TC_ASSERT_EQ_CLEANUP("db_bind_int", DB_SUCCESS(res), true, db_finalize(stmt));
+			res = db_bind_string(stmt, 2, str);
+			TC_ASSERT_EQ_CLEANUP("db_bind_string", DB_SUCCESS(res), true, db_finalize(stmt));
+			res = db_step(stmt, NULL);
+			TC_ASSERT_EQ_CLEANUP("db_step", DB_SUCCESS(res), true, db_finalize(stmt));
+		}
+	}
+	res = db_finalize(stmt);
+	TC_ASSERT_EQ("db_finalize", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s = 'dev-0042';", g_attribute_set[0], g_attribute_set[2],
+			 RELATION_NAME3, g_attribute_set[2]);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), 1, db_cursor_free(g_cursor));
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
+	expected = 0;
+	for (i = 0; i < PREFIX_ROW_NUM; i++) {
+		for (j = 0; j <= (i % 2 == 0); j++) {
+			get_prefix_string(str, i, j);
+			if (strcmp(str, "dev-0010") > 0 && strcmp(str, "dev-0020") <= 0) {
+				expected++;
+			}
+		}
+	}
+	snprintf(query, QUERY_LENGTH, "SELECT %s, %s FROM %s WHERE %s > 'dev-0010' AND %s <= 'dev-0020';", g_attribute_set[0],
+			 g_attribute_set[2], RELATION_NAME3, g_attribute_set[2], g_attribute_set[2]);
+	g_cursor = db_query(query);
+	TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+	count = cursor_get_count(g_cursor);
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+	TC_ASSERT_EQ("cursor_get_count", count, expected);
+
+	snprintf(query, QUERY_LENGTH, "REMOVE INDEX %s.%s;", RELATION_NAME3, g_attribute_set[2]);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "REMOVE RELATION %s;", RELATION_NAME3);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME1, g_attribute_set[3], INDEX_BPLUS);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_query_aggregate_p
+* @brief            Aggregate values of an attribute with a bplus-tree index
+* @scenario         Check COUNT, MIN, MAX and SUM without a condition and with a range of the
+*                   indexed attribute, which are found from the relation and the keys of the
+*                   index, against the ones found by reading every row
+* @apicovered       db_query, cursor_get_long_value
+* @precondition     utc_arastorage_db_exec_p
+* @postcondition    none
+*/
+static void utc_arastorage_db_query_aggregate_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	long summary[4];
+	int ranges[2][2] = {{INT_MIN, INT_MAX}, {300, 700}};
+	int i;
+	int j;
+
+	for (i = 0; i < 2; i++) {
+		TC_ASSERT_EQ("scan_value_summary", scan_value_summary(ranges[i][0], ranges[i][1], summary), 0);
+		TC_ASSERT_GT("scan_value_summary", summary[0], 0);
+
+		if (i == 0) {
+			snprintf(query, QUERY_LENGTH, "SELECT COUNT(%s), MIN(%s), MAX(%s), SUM(%s) FROM %s;", g_attribute_set[3],
+					 g_attribute_set[3], g_attribute_set[3], g_attribute_set[3], RELATION_NAME1);
+		} else {
+			snprintf(query, QUERY_LENGTH, "SELECT COUNT(%s), MIN(%s), MAX(%s), SUM(%s) FROM %s WHERE %s > %d AND %s <= %d;",
+					 g_attribute_set[3], g_attribute_set[3], g_attribute_set[3], g_attribute_set[3], RELATION_NAME1,
+					 g_attribute_set[3], ranges[i][0], g_attribute_set[3], ranges[i][1]);
+		}
+		g_cursor = db_query(query);
+		TC_ASSERT_NEQ("db_query", g_cursor, NULL);
+		TC_ASSERT_EQ_CLEANUP("cursor_get_count", cursor_get_count(g_cursor), 1, db_cursor_free(g_cursor));
+		res = cursor_move_first(g_cursor);
+		TC_ASSERT_EQ_CLEANUP("cursor_move_first", DB_SUCCESS(res), true, db_cursor_free(g_cursor));
+		for (j = 0; j < 4; j++) {
+			TC_ASSERT_EQ_CLEANUP("cursor_get_long_value", cursor_get_long_value(g_cursor, j), summary[j], db_cursor_free(g_cursor));
+		}
+		res = db_cursor_free(g_cursor);
+		TC_ASSERT_EQ("db_cursor_free", DB_SUCCESS(res), true);
+		g_cursor = NULL;
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_rebuild_index_p
+* @brief            Create and rebuild a bplus-tree index over stored rows
+* @scenario         Create an index on an attribute of a relation with rows, rebuild it, and insert
+*                   rows until its buckets split. Check the rows returned by range conditions on the
+*                   attribute against the ones found by reading every row after each step
+* @apicovered       db_exec, db_query
+* @precondition     utc_arastorage_db_exec_p
+* @postcondition    none
+*/
+static void utc_arastorage_db_rebuild_index_p(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+	long ranges[3][2] = {{-1, 10000}, {0, 2500}, {4000, 8000}};
+	int count;
+	int found;
+	int step;
+	int i;
+
+	snprintf(query, QUERY_LENGTH, "REMOVE INDEX %s.%s;", RELATION_NAME2, g_attribute_set[1]);
+	res = db_exec(query);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+
+	for (step = 0; step < 3; step++) {
+		if (step == 0) {
+			snprintf(query, QUERY_LENGTH, "CREATE INDEX %s.%s TYPE %s;", RELATION_NAME2, g_attribute_set[1], INDEX_BPLUS);
+			res = db_exec(query);
+			TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+		} else if (step == 1) {
+			snprintf(query, QUERY_LENGTH, "REBUILD INDEX %s.%s;", RELATION_NAME2, g_attribute_set[1]);
+			res = db_exec(query);
+			TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+		} else {
+			/* Buckets filled by the bulk load are full, so these split them */
+			for (i = 0; i < DATA_SET_NUM * 20; i++) {
+				snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", DATA_SET_NUM * 40 + i, rand() % 10000, RELATION_NAME2);
+				res = db_exec(query);
+				TC_ASSERT_EQ("db_exec", DB_SUCCESS(res), true);
+			}
+		}
+
+		for (i = 0; i < 3; i++) {
+			count = get_date_count(ranges[i][0], ranges[i][1], true);
+			TC_ASSERT_GT("get_date_count", count, 0);
+			found = get_date_count(ranges[i][0], ranges[i][1], false);
+			TC_ASSERT_EQ("get_date_count", found, count);
+		}
+	}
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_commit_p
+* @brief            Insert rows in a transaction
+* @scenario         Insert rows between db_begin and db_commit, and check they're returned by query
+*                   after commit only. Insert rows between db_begin and db_rollback, and check
+*                   they're not stored, while a row inserted by another thread is stored
+* @apicovered       db_begin, db_commit, db_rollback
+* @precondition     utc_arastorage_db_exec_p
+* @postcondition    none
+*/
+static void utc_arastorage_db_commit_p(void)
+{
+	db_result_t res;
+	db_result_t thread_res;
+	pthread_t tid;
+	char query[QUERY_LENGTH];
+	int count;
+	int i;
+
+	count = get_row_count(RELATION_NAME2);
+	TC_ASSERT_GT("get_row_count", count, 0);
+
+	res = db_begin();
+	TC_ASSERT_EQ("db_begin", DB_SUCCESS(res), true);
+	for (i = 0; i < DATA_SET_NUM; i++) {
+		snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", DATA_SET_NUM * 10 + i, g_arastorage_data_set[i].long_value, RELATION_NAME2);
+		res = db_exec(query);
+		TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, db_rollback());
+	}
+	TC_ASSERT_EQ_CLEANUP("get_row_count", get_row_count(RELATION_NAME2), count, db_rollback());
+	res = db_commit();
+	TC_ASSERT_EQ("db_commit", DB_SUCCESS(res), true);
+	TC_ASSERT_EQ("get_row_count", get_row_count(RELATION_NAME2), count + DATA_SET_NUM);
+
+	res = db_begin();
+	TC_ASSERT_EQ("db_begin", DB_SUCCESS(res), true);
+	snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", DATA_SET_NUM * 20, g_arastorage_data_set[0].long_value, RELATION_NAME2);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, db_rollback());
+	res = db_rollback();
+	TC_ASSERT_EQ("db_rollback", DB_SUCCESS(res), true);
+	TC_ASSERT_EQ("get_row_count", get_row_count(RELATION_NAME2), count + DATA_SET_NUM);
+
+	/* An insert of another thread waits for the transaction instead of joining it */
+	res = db_begin();
+	TC_ASSERT_EQ("db_begin", DB_SUCCESS(res), true);
+	snprintf(query, QUERY_LENGTH, "INSERT (%d, %ld) INTO %s;", DATA_SET_NUM * 20, g_arastorage_data_set[0].long_value, RELATION_NAME2);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", DB_SUCCESS(res), true, db_rollback());
+	thread_res = DB_OK;
+	TC_ASSERT_EQ_CLEANUP("pthread_create", pthread_create(&tid, NULL, insert_thread, &thread_res), 0, db_rollback());
+	usleep(100 * 1000);
+	TC_ASSERT_EQ_CLEANUP("get_row_count", get_row_count(RELATION_NAME2), count + DATA_SET_NUM, db_rollback(); pthread_join(tid, NULL));
+	res = db_rollback();
+	pthread_join(tid, NULL);
+	TC_ASSERT_EQ("db_rollback", DB_SUCCESS(res), true);
+	TC_ASSERT_EQ("db_exec", DB_SUCCESS(thread_res), true);
+	TC_ASSERT_EQ("get_row_count", get_row_count(RELATION_NAME2), count + DATA_SET_NUM + 1);
+
+	TC_SUCCESS_RESULT();
+}
+
+/**
+* @testcase         utc_arastorage_db_commit_n
+* @brief            Commit or roll back without a transaction
+* @scenario         Commit and roll back without db_begin, begin a transaction twice, and
+*                   create a relation in a transaction
+* @apicovered       db_begin, db_commit, db_rollback
+* @precondition     none
+* @postcondition    none
+*/
+static void utc_arastorage_db_commit_n(void)
+{
+	db_result_t res;
+	char query[QUERY_LENGTH];
+
+	res = db_commit();
+	TC_ASSERT_EQ("db_commit", DB_ERROR(res), true);
+
+	res = db_rollback();
+	TC_ASSERT_EQ("db_rollback", DB_ERROR(res), true);
+
+	res = db_begin();
+	TC_ASSERT_EQ("db_begin", DB_SUCCESS(res), true);
+
+	res = db_begin();
+	TC_ASSERT_EQ_CLEANUP("db_begin", DB_ERROR(res), true, db_rollback());
+
+	snprintf(query, QUERY_LENGTH, "CREATE RELATION %s;", RELATION_NAME1);
+	res = db_exec(query);
+	TC_ASSERT_EQ_CLEANUP("db_exec", res, DB_BUSY_ERROR, db_rollback());
+
+	res = db_rollback();
+	TC_ASSERT_EQ("db_rollback", DB_SUCCESS(res), true);
+
+	TC_SUCCESS_RESULT();
+}
+
 /**
 * @testcase         utc_arastorage_db_query_n
 * @brief            Query a database with invalid argument
@@ -1000,6 +1612,10 @@ static void utc_arastorage_cursor_is_first_row_n(void)
 	/* Invalid argument */
 	TC_ASSERT_NEQ("cursor_is_first_row", cursor_is_first_row(NULL), true);
 
+	/* A cursor holds its relation until it's freed. */
+	db_cursor_free(g_cursor);
+	g_cursor = NULL;
+
 	TC_SUCCESS_RESULT();
 }
 
@@ -1448,6 +2064,12 @@ int utc_arastorage_main(int argc, char *argv[])
 	/* Positive TCs */
 	utc_arastorage_db_init_p();
 	utc_arastorage_db_exec_p();
+	utc_arastorage_db_prepare_p();
+	utc_arastorage_db_commit_p();
+	utc_arastorage_db_query_string_p();
+	utc_arastorage_db_query_string_prefix_p();
+	utc_arastorage_db_query_aggregate_p();
+	utc_arastorage_db_rebuild_index_p();
 	utc_arastorage_db_query_p();
 	utc_arastorage_db_get_result_message_p();
 	utc_arastorage_db_print_header_p();
@@ -1479,6 +2101,7 @@ int utc_arastorage_main(int argc, char *argv[])
 	/* Negative TCs */
 	utc_arastorage_db_exec_n();
 	utc_arastorage_db_query_n();
+	utc_arastorage_db_commit_n();
 	utc_arastorage_db_get_result_message_n();
 	utc_arastorage_db_print_header_n();
 	utc_arastorage_db_print_tuple_n();
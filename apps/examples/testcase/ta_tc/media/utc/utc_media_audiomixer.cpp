@@ -0,0 +1,430 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <atomic>
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <media/MediaPlayer.h>
+#include <media/FileInputDataSource.h>
+#include <media/FocusManager.h>
+#include <media/FocusRequest.h>
+#include "../../../../../../framework/src/media/audio/audio_mixer.h"
+#include "tc_common.h"
+
+#define MIXER_RATE 48000
+#define MIXER_CHANNELS 2
+#define MIXER_FRAMES 1024
+/* Gain changes are ramped within a chunk of the mixer */
+#define MIXER_CHUNK 256
+#define MIXER_HALF_GAIN (AUDIO_MIXER_GAIN_UNITY / 2)
+#define MIXER_DUCK_GAIN (AUDIO_MIXER_GAIN_UNITY / 4)
+
+static const char *rawfilepathA = "/mnt/audiomixer_a.raw";
+static const char *rawfilepathB = "/mnt/audiomixer_b.raw";
+
+static int16_t in[MIXER_FRAMES * MIXER_CHANNELS];
+static int16_t out[MIXER_FRAMES * MIXER_CHANNELS];
+
+class FocusListener : public media::FocusChangeListener
+{
+public:
+	FocusListener() : focusChange(media::FOCUS_NONE) {}
+	void onFocusChange(int change) override { focusChange = change; }
+	int focusChange;
+};
+
+class PlaybackObserver : public media::MediaPlayerObserverInterface
+{
+public:
+	PlaybackObserver() : started(0) {}
+	void onPlaybackStarted(media::MediaPlayer &mediaPlayer) override { started++; }
+	void onPlaybackFinished(media::MediaPlayer &mediaPlayer) override {}
+	void onPlaybackError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override {}
+	void onStartError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override {}
+	void onStopError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override {}
+	void onPauseError(media::MediaPlayer &mediaPlayer, media::player_error_t error) override {}
+	void onPlaybackPaused(media::MediaPlayer &mediaPlayer) override {}
+	std::atomic<int> started;
+};
+
+static void fill(int16_t *buf, unsigned int frames, unsigned int channels, const int16_t *frame)
+{
+	for (unsigned int i = 0; i < frames; i++) {
+		for (unsigned int k = 0; k < channels; k++) {
+			*buf++ = frame[k];
+		}
+	}
+}
+
+/* Check that every frame of out equals the frame given */
+static bool check(const int16_t *buf, unsigned int frames, int16_t left, int16_t right)
+{
+	for (unsigned int i = 0; i < frames; i++) {
+		if (buf[i * MIXER_CHANNELS] != left || buf[i * MIXER_CHANNELS + 1] != right) {
+			printf("frame %u : (%d, %d), expected (%d, %d)\n", i, buf[i * MIXER_CHANNELS], buf[i * MIXER_CHANNELS + 1], left, right);
+			return false;
+		}
+	}
+	return true;
+}
+
+static void writePcmFile(const char *path, size_t size)
+{
+	FILE *fp = fopen(path, "w");
+	unsigned char buf[256];
+
+	if (fp == nullptr) {
+		printf("AudioMixer SetUp Failed\n");
+		return;
+	}
+
+	memset(buf, 0, sizeof(buf));
+	while (size > 0) {
+		size_t len = (size < sizeof(buf)) ? size : sizeof(buf);
+		fwrite(buf, 1, len, fp);
+		size -= len;
+	}
+	fclose(fp);
+}
+
+static void SetUp(void)
+{
+	// Half a second of 16kHz mono and 22.05kHz stereo
+	writePcmFile(rawfilepathA, 16000 * 2 / 2);
+	writePcmFile(rawfilepathB, 22050 * 4 / 2);
+}
+
+static void TearDown()
+{
+	remove(rawfilepathA);
+	remove(rawfilepathB);
+}
+
+static void utc_media_AudioMixer_mix_saturation_p(void)
+{
+	int written;
+	unsigned int mixed;
+	audio_mixer_t *mixer = audio_mixer_create(MIXER_RATE, MIXER_CHANNELS, MIXER_FRAMES, SRC_TYPE_POLYPHASE);
+	TC_ASSERT("audio_mixer_create", mixer);
+
+	// Stereo and mono streams in the mixer rate, mono is put to both channels
+	int streamA = audio_mixer_open(mixer, MIXER_RATE, 2);
+	int streamB = audio_mixer_open(mixer, MIXER_RATE, 1);
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamA, 0, audio_mixer_destroy(mixer));
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamB, 0, audio_mixer_destroy(mixer));
+
+	const int16_t frameA[] = { 20000, -20000 };
+	const int16_t frameB[] = { 15000 };
+	const int16_t frameC[] = { -15000 };
+	fill(in, MIXER_CHUNK, 2, frameA);
+	written = audio_mixer_write(mixer, streamA, in, MIXER_CHUNK);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_write", written, MIXER_CHUNK, audio_mixer_destroy(mixer));
+	fill(in, MIXER_CHUNK, 1, frameB);
+	written = audio_mixer_write(mixer, streamB, in, MIXER_CHUNK);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_write", written, MIXER_CHUNK, audio_mixer_destroy(mixer));
+
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_ready", audio_mixer_ready(mixer), MIXER_CHUNK, audio_mixer_destroy(mixer));
+	mixed = audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_mix", mixed, MIXER_CHUNK, audio_mixer_destroy(mixer));
+	TC_ASSERT_CLEANUP("audio_mixer_mix", check(out, MIXER_CHUNK, INT16_MAX, -5000), audio_mixer_destroy(mixer));
+
+	fill(in, MIXER_CHUNK, 2, frameA);
+	audio_mixer_write(mixer, streamA, in, MIXER_CHUNK);
+	fill(in, MIXER_CHUNK, 1, frameC);
+	audio_mixer_write(mixer, streamB, in, MIXER_CHUNK);
+
+	mixed = audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_mix", mixed, MIXER_CHUNK, audio_mixer_destroy(mixer));
+	TC_ASSERT_CLEANUP("audio_mixer_mix", check(out, MIXER_CHUNK, 5000, INT16_MIN), audio_mixer_destroy(mixer));
+
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_underruns", audio_mixer_underruns(mixer, streamA), 0, audio_mixer_destroy(mixer));
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_underruns", audio_mixer_underruns(mixer, streamB), 0, audio_mixer_destroy(mixer));
+
+	audio_mixer_destroy(mixer);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_AudioMixer_mix_resample_p(void)
+{
+	int written;
+	unsigned int mixed;
+	unsigned int queued;
+	audio_mixer_t *mixer = audio_mixer_create(MIXER_RATE, MIXER_CHANNELS, MIXER_FRAMES, SRC_TYPE_POLYPHASE);
+	TC_ASSERT("audio_mixer_create", mixer);
+
+	// Half of the mixer rate and mono, each frame is converted to two stereo frames
+	int streamA = audio_mixer_open(mixer, MIXER_RATE, 2);
+	int streamB = audio_mixer_open(mixer, MIXER_RATE / 2, 1);
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamA, 0, audio_mixer_destroy(mixer));
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamB, 0, audio_mixer_destroy(mixer));
+
+	const int16_t frameA[] = { 1000, 2000 };
+	const int16_t frameB[] = { 0 };
+	fill(in, MIXER_CHUNK, 1, frameB);
+	for (int i = 0; i < 4; i++) {
+		written = audio_mixer_write(mixer, streamB, in, MIXER_CHUNK / 4);
+		TC_ASSERT_EQ_CLEANUP("audio_mixer_write", written, MIXER_CHUNK / 4, audio_mixer_destroy(mixer));
+	}
+
+	// The resampler keeps back the frames of its filter length
+	queued = audio_mixer_queued(mixer, streamB);
+	TC_ASSERT_LEQ_CLEANUP("audio_mixer_queued", queued, MIXER_CHUNK * 2, audio_mixer_destroy(mixer));
+	TC_ASSERT_GT_CLEANUP("audio_mixer_queued", queued, MIXER_CHUNK * 2 - MIXER_CHUNK / 4, audio_mixer_destroy(mixer));
+
+	fill(in, queued, 2, frameA);
+	written = audio_mixer_write(mixer, streamA, in, queued);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_write", written, (int)queued, audio_mixer_destroy(mixer));
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_ready", audio_mixer_ready(mixer), queued, audio_mixer_destroy(mixer));
+	mixed = audio_mixer_mix(mixer, out, queued);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_mix", mixed, queued, audio_mixer_destroy(mixer));
+	TC_ASSERT_CLEANUP("audio_mixer_mix", check(out, queued, 1000, 2000), audio_mixer_destroy(mixer));
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_queued", audio_mixer_queued(mixer, streamB), 0, audio_mixer_destroy(mixer));
+
+	audio_mixer_destroy(mixer);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_AudioMixer_set_gain_p(void)
+{
+	audio_mixer_t *mixer = audio_mixer_create(MIXER_RATE, MIXER_CHANNELS, MIXER_FRAMES, SRC_TYPE_POLYPHASE);
+	TC_ASSERT("audio_mixer_create", mixer);
+
+	int streamA = audio_mixer_open(mixer, MIXER_RATE, 2);
+	int streamB = audio_mixer_open(mixer, MIXER_RATE, 2);
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamA, 0, audio_mixer_destroy(mixer));
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamB, 0, audio_mixer_destroy(mixer));
+
+	audio_mixer_set_gain(mixer, streamA, MIXER_HALF_GAIN);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_get_gain", audio_mixer_get_gain(mixer, streamA), MIXER_HALF_GAIN, audio_mixer_destroy(mixer));
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_get_gain", audio_mixer_get_gain(mixer, streamB), AUDIO_MIXER_GAIN_UNITY, audio_mixer_destroy(mixer));
+
+	const int16_t frameA[] = { 8000, -8000 };
+	const int16_t frameB[] = { 1000, 1000 };
+	fill(in, MIXER_CHUNK * 2, 2, frameA);
+	audio_mixer_write(mixer, streamA, in, MIXER_CHUNK * 2);
+	fill(in, MIXER_CHUNK * 2, 2, frameB);
+	audio_mixer_write(mixer, streamB, in, MIXER_CHUNK * 2);
+
+	// The first chunk ramps the gain of stream A, then it's applied as it is
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	TC_ASSERT_CLEANUP("audio_mixer_mix", check(out, MIXER_CHUNK, 5000, -3000), audio_mixer_destroy(mixer));
+
+	audio_mixer_destroy(mixer);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_AudioMixer_set_ducking_p(void)
+{
+	audio_mixer_t *mixer = audio_mixer_create(MIXER_RATE, MIXER_CHANNELS, MIXER_FRAMES, SRC_TYPE_POLYPHASE);
+	TC_ASSERT("audio_mixer_create", mixer);
+
+	// Streams open when ducking starts are ducked, streams opened later are not
+	int streamA = audio_mixer_open(mixer, MIXER_RATE, 2);
+	audio_mixer_set_ducking(mixer, true, MIXER_DUCK_GAIN);
+	int streamB = audio_mixer_open(mixer, MIXER_RATE, 2);
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamA, 0, audio_mixer_destroy(mixer));
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamB, 0, audio_mixer_destroy(mixer));
+
+	const int16_t frameA[] = { 8000, 8000 };
+	const int16_t frameB[] = { 1000, -1000 };
+	fill(in, MIXER_CHUNK * 4, 2, frameA);
+	audio_mixer_write(mixer, streamA, in, MIXER_CHUNK * 4);
+	fill(in, MIXER_CHUNK * 4, 2, frameB);
+	audio_mixer_write(mixer, streamB, in, MIXER_CHUNK * 4);
+
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	TC_ASSERT_CLEANUP("audio_mixer_set_ducking", check(out, MIXER_CHUNK, 3000, 1000), audio_mixer_destroy(mixer));
+
+	// Gain of stream A is restored when ducking stops
+	audio_mixer_set_ducking(mixer, false, MIXER_DUCK_GAIN);
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	TC_ASSERT_CLEANUP("audio_mixer_set_ducking", check(out, MIXER_CHUNK, 9000, 7000), audio_mixer_destroy(mixer));
+
+	audio_mixer_destroy(mixer);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_AudioMixer_underruns_p(void)
+{
+	audio_mixer_t *mixer = audio_mixer_create(MIXER_RATE, MIXER_CHANNELS, MIXER_FRAMES, SRC_TYPE_POLYPHASE);
+	TC_ASSERT("audio_mixer_create", mixer);
+
+	int streamA = audio_mixer_open(mixer, MIXER_RATE, 2);
+	int streamB = audio_mixer_open(mixer, MIXER_RATE, 2);
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamA, 0, audio_mixer_destroy(mixer));
+	TC_ASSERT_GEQ_CLEANUP("audio_mixer_open", streamB, 0, audio_mixer_destroy(mixer));
+
+	const int16_t frameA[] = { 100, 200 };
+	const int16_t frameB[] = { 10, 20 };
+	fill(in, MIXER_CHUNK * 3, 2, frameA);
+	audio_mixer_write(mixer, streamA, in, MIXER_CHUNK * 3);
+	fill(in, MIXER_CHUNK, 2, frameB);
+	audio_mixer_write(mixer, streamB, in, MIXER_CHUNK);
+
+	// Mixing waits for stream B
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_ready", audio_mixer_ready(mixer), MIXER_CHUNK, audio_mixer_destroy(mixer));
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	TC_ASSERT_CLEANUP("audio_mixer_mix", check(out, MIXER_CHUNK, 110, 220), audio_mixer_destroy(mixer));
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_ready", audio_mixer_ready(mixer), 0, audio_mixer_destroy(mixer));
+
+	// Stream B starved is padded with silence and counted
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	TC_ASSERT_CLEANUP("audio_mixer_mix", check(out, MIXER_CHUNK, 100, 200), audio_mixer_destroy(mixer));
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_underruns", audio_mixer_underruns(mixer, streamA), 0, audio_mixer_destroy(mixer));
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_underruns", audio_mixer_underruns(mixer, streamB), 1, audio_mixer_destroy(mixer));
+
+	// Stream B draining doesn't hold stream A, nor is counted
+	audio_mixer_drain(mixer, streamB);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_ready", audio_mixer_ready(mixer), MIXER_CHUNK, audio_mixer_destroy(mixer));
+	audio_mixer_mix(mixer, out, MIXER_CHUNK);
+	TC_ASSERT_EQ_CLEANUP("audio_mixer_underruns", audio_mixer_underruns(mixer, streamB), 1, audio_mixer_destroy(mixer));
+
+	audio_mixer_destroy(mixer);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FocusManager_requestFocus_duck_p(void)
+{
+	media::FocusManager &fm = media::FocusManager::getFocusManager();
+	auto listenerA = std::make_shared<FocusListener>();
+	auto listenerB = std::make_shared<FocusListener>();
+	auto requestA = media::FocusRequest::Builder().setFocusChangeListener(listenerA).build();
+	auto requestB = media::FocusRequest::Builder()
+						.setFocusChangeListener(listenerB)
+						.setFocusGain(media::FOCUS_GAIN_TRANSIENT_MAY_DUCK)
+						.build();
+
+	int ret = fm.requestFocus(requestA);
+	TC_ASSERT_EQ("utc_media_FocusManager_requestFocus", ret, media::FOCUS_REQUEST_SUCCESS);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FocusManager_requestFocus", listenerA->focusChange, media::FOCUS_GAIN, fm.abandonFocus(requestA));
+
+	// A short sound over A, which may go on at lower volume
+	ret = fm.requestFocus(requestB);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FocusManager_requestFocus", ret, media::FOCUS_REQUEST_SUCCESS, fm.abandonFocus(requestB); fm.abandonFocus(requestA));
+	TC_ASSERT_EQ_CLEANUP("utc_media_FocusManager_requestFocus", listenerA->focusChange, media::FOCUS_LOSS_TRANSIENT_CAN_DUCK, fm.abandonFocus(requestB); fm.abandonFocus(requestA));
+	TC_ASSERT_EQ_CLEANUP("utc_media_FocusManager_requestFocus", listenerB->focusChange, media::FOCUS_GAIN, fm.abandonFocus(requestB); fm.abandonFocus(requestA));
+
+	fm.abandonFocus(requestB);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FocusManager_abandonFocus", listenerA->focusChange, media::FOCUS_GAIN, fm.abandonFocus(requestA));
+
+	fm.abandonFocus(requestA);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FocusManager_requestFocus_duck_n(void)
+{
+	media::FocusManager &fm = media::FocusManager::getFocusManager();
+	auto listenerA = std::make_shared<FocusListener>();
+	auto listenerB = std::make_shared<FocusListener>();
+	auto requestA = media::FocusRequest::Builder().setFocusChangeListener(listenerA).build();
+	auto requestB = media::FocusRequest::Builder().setFocusChangeListener(listenerB).build();
+
+	fm.requestFocus(requestA);
+	fm.requestFocus(requestB);
+
+	// Focus requested without ducking is lost
+	TC_ASSERT_EQ_CLEANUP("utc_media_FocusManager_requestFocus", listenerA->focusChange, media::FOCUS_LOSS, fm.abandonFocus(requestB); fm.abandonFocus(requestA));
+
+	fm.abandonFocus(requestB);
+	fm.abandonFocus(requestA);
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_MediaPlayer_concurrent_p(void)
+{
+	media::MediaPlayer mpA;
+	media::MediaPlayer mpB;
+	auto observer = std::make_shared<PlaybackObserver>();
+	std::unique_ptr<media::stream::FileInputDataSource> sourceA(new media::stream::FileInputDataSource(rawfilepathA));
+	std::unique_ptr<media::stream::FileInputDataSource> sourceB(new media::stream::FileInputDataSource(rawfilepathB));
+	media::player_stats_t stats;
+	media::player_result_t ret;
+	unsigned int periods;
+	uint8_t volume;
+
+	// Streams of different sample rates and channels are mixed together
+	sourceA->setSampleRate(16000);
+	sourceA->setChannels(1);
+	sourceB->setSampleRate(22050);
+	sourceB->setChannels(2);
+
+	mpA.create();
+	mpB.create();
+	mpA.setObserver(observer);
+	mpB.setObserver(observer);
+	mpA.setDataSource(std::move(sourceA));
+	mpB.setDataSource(std::move(sourceB));
+
+	ret = mpA.prepare();
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_prepare", ret, media::PLAYER_OK, mpA.destroy(); mpB.destroy());
+	ret = mpB.prepare();
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_prepare", ret, media::PLAYER_OK, mpA.unprepare(); mpA.destroy(); mpB.destroy());
+
+	mpA.start();
+	mpB.start();
+	for (int i = 0; i < 100 && observer->started < 2; i++) {
+		usleep(10000);
+	}
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_start", observer->started, 2, mpA.stop(); mpB.stop(); mpA.unprepare(); mpB.unprepare(); mpA.destroy(); mpB.destroy());
+
+	// Player A keeps playing while player B plays
+	mpA.getStats(&stats);
+	periods = stats.periods;
+	usleep(100000);
+	mpA.getStats(&stats);
+	TC_ASSERT_GT_CLEANUP("utc_media_MediaPlayer_getStats", stats.periods, periods, mpA.stop(); mpB.stop(); mpA.unprepare(); mpB.unprepare(); mpA.destroy(); mpB.destroy());
+
+	// Volume is the gain of each stream
+	mpA.setVolume(3);
+	mpB.setVolume(7);
+	ret = mpA.getVolume(&volume);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_getVolume", ret, media::PLAYER_OK, mpA.stop(); mpB.stop(); mpA.unprepare(); mpB.unprepare(); mpA.destroy(); mpB.destroy());
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_getVolume", volume, 3, mpA.stop(); mpB.stop(); mpA.unprepare(); mpB.unprepare(); mpA.destroy(); mpB.destroy());
+	ret = mpB.getVolume(&volume);
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_getVolume", ret, media::PLAYER_OK, mpA.stop(); mpB.stop(); mpA.unprepare(); mpB.unprepare(); mpA.destroy(); mpB.destroy());
+	TC_ASSERT_EQ_CLEANUP("utc_media_MediaPlayer_getVolume", volume, 7, mpA.stop(); mpB.stop(); mpA.unprepare(); mpB.unprepare(); mpA.destroy(); mpB.destroy());
+
+	mpA.stop();
+	mpB.stop();
+	mpA.unprepare();
+	mpB.unprepare();
+	mpA.destroy();
+	mpB.destroy();
+	TC_SUCCESS_RESULT();
+}
+
+int utc_media_AudioMixer_main(void)
+{
+	SetUp();
+	utc_media_AudioMixer_mix_saturation_p();
+	utc_media_AudioMixer_mix_resample_p();
+	utc_media_AudioMixer_set_gain_p();
+	utc_media_AudioMixer_set_ducking_p();
+	utc_media_AudioMixer_underruns_p();
+	utc_media_FocusManager_requestFocus_duck_p();
+	utc_media_FocusManager_requestFocus_duck_n();
+	utc_media_MediaPlayer_concurrent_p();
+	TearDown();
+	return 0;
+}
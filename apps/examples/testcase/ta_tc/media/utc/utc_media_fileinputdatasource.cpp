@@ -23,6 +23,54 @@ static const char dummyfilepath[] = "/mnt/fileinputdatasource.raw";
 static const char testData[] = "dummydata";
 static unsigned char *buf;
 
+#ifdef CONFIG_AUDIO_CODEC
+/* MPEG-1 Layer III frames of 128kbps 44100Hz stereo, silent, 1152 samples each */
+static const char mp3filepath[] = "/mnt/fileinputdatasource.mp3";
+static const char mp3indexpath[] = "/mnt/fileinputdatasource.mp3.idx";
+#define MP3_FRAMES 40
+#define MP3_FRAME_SIZE 417
+#define MP3_FRAME_SAMPLES 1152
+#define MP3_SAMPLE_RATE 44100
+#define MP3_BYTES_PER_SAMPLE 4
+#define MP3_DURATION_MSEC (MP3_FRAMES * MP3_FRAME_SAMPLES * 1000 / MP3_SAMPLE_RATE)
+#define MP3_SEEK_MSEC 500
+
+static unsigned char pcm[4096];
+
+static void writeMp3File(void)
+{
+	unsigned char frame[MP3_FRAME_SIZE] = { 0xff, 0xfb, 0x90, 0x00 };
+	FILE *fp = fopen(mp3filepath, "w");
+	for (int i = 0; i < MP3_FRAMES; i++) {
+		fwrite(frame, 1, sizeof(frame), fp);
+	}
+	fclose(fp);
+	remove(mp3indexpath);
+}
+
+static void removeMp3File(void)
+{
+	remove(mp3filepath);
+	remove(mp3indexpath);
+}
+
+static size_t readAll(media::stream::FileInputDataSource &source)
+{
+	size_t total = 0;
+	ssize_t len;
+	while ((len = source.read(pcm, sizeof(pcm))) > 0) {
+		total += (size_t)len;
+	}
+	return total;
+}
+
+static size_t bytesFrom(unsigned int msec)
+{
+	size_t samples = (size_t)MP3_FRAMES * MP3_FRAME_SAMPLES - (size_t)msec * MP3_SAMPLE_RATE / 1000;
+	return samples * MP3_BYTES_PER_SAMPLE;
+}
+#endif
+
 static void SetUp(void)
 {
 	FILE *fp = fopen(dummyfilepath, "w");
@@ -196,6 +244,149 @@ static void utc_media_FileInputDataSource_readAt_n(void)
 	TC_SUCCESS_RESULT();
 }
 
+#ifdef CONFIG_AUDIO_CODEC
+static void utc_media_FileInputDataSource_seekTo_p(void)
+{
+	media::stream::FileInputDataSource source(mp3filepath);
+	size_t len;
+	writeMp3File();
+	source.open();
+
+	// Sample rate is known once a frame is decoded, read the whole stream first.
+	len = readAll(source);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_seekTo", len, bytesFrom(0), source.close(); removeMp3File());
+
+	// Decoding restarts from the frame before the position, samples before it are dropped.
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_seekTo", source.seekTo(MP3_SEEK_MSEC), 0, source.close(); removeMp3File());
+	len = readAll(source);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_seekTo", len, bytesFrom(MP3_SEEK_MSEC), source.close(); removeMp3File());
+
+	// End of stream was reached, seeking must restart the stream.
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_seekTo", source.seekTo(0), 0, source.close(); removeMp3File());
+	len = readAll(source);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_seekTo", len, bytesFrom(0), source.close(); removeMp3File());
+
+	source.close();
+	removeMp3File();
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileInputDataSource_seekTo_n(void)
+{
+	media::stream::FileInputDataSource source(dummyfilepath);
+	source.open();
+
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_seekTo", source.seekTo(MP3_SEEK_MSEC), -1, source.close());
+
+	source.close();
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileInputDataSource_getDuration_p(void)
+{
+	media::stream::FileInputDataSource source(mp3filepath);
+	writeMp3File();
+	source.open();
+	readAll(source);
+
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_getDuration", source.getDuration(), MP3_DURATION_MSEC, source.close(); removeMp3File());
+
+	source.close();
+	removeMp3File();
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileInputDataSource_getDuration_n(void)
+{
+	media::stream::FileInputDataSource source(mp3filepath);
+	writeMp3File();
+	source.open();
+
+	// Unknown until the whole stream is indexed
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_getDuration", source.getDuration(), -1, source.close(); removeMp3File());
+
+	source.close();
+	removeMp3File();
+	TC_SUCCESS_RESULT();
+}
+
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+static void utc_media_FileInputDataSource_getReadAheadStats_p(void)
+{
+	media::stream::FileInputDataSource source(mp3filepath);
+	media::stream::file_readahead_stats_t stats;
+	writeMp3File();
+	source.open();
+	readAll(source);
+
+	// Whole file was read ahead of decoding
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", source.getReadAheadStats(&stats), true, source.close(); removeMp3File());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", stats.bytesPrefetched, MP3_FRAMES * MP3_FRAME_SIZE, source.close(); removeMp3File());
+	TC_ASSERT_GT_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", stats.hits + stats.misses, 0, source.close(); removeMp3File());
+	TC_ASSERT_GEQ_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", stats.depth, 2, source.close(); removeMp3File());
+	TC_ASSERT_LEQ_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", stats.depth, CONFIG_FILE_DATASOURCE_READAHEAD_BLOCKS, source.close(); removeMp3File());
+
+	// Seeking drops blocks read ahead, the file is read again from the new position.
+	unsigned long long prefetched = stats.bytesPrefetched;
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", source.seekTo(MP3_SEEK_MSEC), 0, source.close(); removeMp3File());
+	size_t len = readAll(source);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", len, bytesFrom(MP3_SEEK_MSEC), source.close(); removeMp3File());
+	source.getReadAheadStats(&stats);
+	TC_ASSERT_GT_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", stats.bytesPrefetched, prefetched, source.close(); removeMp3File());
+	TC_ASSERT_LEQ_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", stats.hitRate, 100, source.close(); removeMp3File());
+
+	source.close();
+	removeMp3File();
+	TC_SUCCESS_RESULT();
+}
+#endif
+
+#ifdef CONFIG_MEDIA_FRAME_INDEX_SIDECAR
+static void utc_media_FileInputDataSource_getDuration_sidecar_p(void)
+{
+	writeMp3File();
+	{
+		// Index is saved to the sidecar file on closing
+		media::stream::FileInputDataSource source(mp3filepath);
+		source.open();
+		readAll(source);
+		source.close();
+	}
+
+	media::stream::FileInputDataSource source(mp3filepath);
+	source.open();
+
+	// Known at once from the sidecar file, without decoding
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_getDuration", source.getDuration(), MP3_DURATION_MSEC, source.close(); removeMp3File());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_seekTo", source.seekTo(MP3_SEEK_MSEC), 0, source.close(); removeMp3File());
+	size_t len = readAll(source);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_seekTo", len, bytesFrom(MP3_SEEK_MSEC), source.close(); removeMp3File());
+
+	source.close();
+	removeMp3File();
+	TC_SUCCESS_RESULT();
+}
+#endif
+#endif
+
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+static void utc_media_FileInputDataSource_getReadAheadStats_n(void)
+{
+	media::stream::FileInputDataSource source(dummyfilepath);
+	media::stream::file_readahead_stats_t stats;
+
+	TC_ASSERT_EQ("utc_media_FileInputDataSource_getReadAheadStats", source.getReadAheadStats(&stats), false);
+
+	source.open();
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileInputDataSource_getReadAheadStats", source.getReadAheadStats(nullptr), false, source.close());
+
+	source.close();
+	TC_ASSERT_EQ("utc_media_FileInputDataSource_getReadAheadStats", source.getReadAheadStats(&stats), false);
+
+	TC_SUCCESS_RESULT();
+}
+#endif
+
 int utc_media_FileInputDataSource_main(void)
 {
 	SetUp();
@@ -215,6 +406,21 @@ int utc_media_FileInputDataSource_main(void)
 	utc_media_FileInputDataSource_read_n();
 	utc_media_FileInputDataSource_readAt_p();
 	utc_media_FileInputDataSource_readAt_n();
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	utc_media_FileInputDataSource_getReadAheadStats_n();
+#endif
+#ifdef CONFIG_AUDIO_CODEC
+	utc_media_FileInputDataSource_seekTo_p();
+	utc_media_FileInputDataSource_seekTo_n();
+	utc_media_FileInputDataSource_getDuration_p();
+	utc_media_FileInputDataSource_getDuration_n();
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	utc_media_FileInputDataSource_getReadAheadStats_p();
+#endif
+#ifdef CONFIG_MEDIA_FRAME_INDEX_SIDECAR
+	utc_media_FileInputDataSource_getDuration_sidecar_p();
+#endif
+#endif
 	TearDown();
 	return 0;
 }
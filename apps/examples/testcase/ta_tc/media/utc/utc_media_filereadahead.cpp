@@ -0,0 +1,241 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include "../../../../../../framework/src/media/FileReadAhead.h"
+#include "tc_common.h"
+
+static const char readaheadfilepath[] = "/mnt/filereadahead.raw";
+/* File ends in the middle of a block, seeking goes to the middle of another */
+#define READAHEAD_BLOCK_SIZE 256
+#define READAHEAD_BLOCKS 4
+#define READAHEAD_FILE_SIZE (READAHEAD_BLOCK_SIZE * 10 + 100)
+#define READAHEAD_SEEK_OFFSET (READAHEAD_BLOCK_SIZE * 6 + 30)
+#define READAHEAD_STACKSIZE 2048
+
+using namespace media::stream;
+
+static FILE *fp;
+
+/* Byte at an offset of the file, it differs from the byte a block before */
+static unsigned char fileByte(long offset)
+{
+	return (unsigned char)(offset ^ (offset >> 8));
+}
+
+static void SetUp(void)
+{
+	fp = fopen(readaheadfilepath, "w");
+	for (long i = 0; i < READAHEAD_FILE_SIZE; i++) {
+		fputc(fileByte(i), fp);
+	}
+	fclose(fp);
+
+	fp = fopen(readaheadfilepath, "rb");
+}
+
+static void TearDown(void)
+{
+	fclose(fp);
+	remove(readaheadfilepath);
+}
+
+/* Reads up to the end of file, returns the offset reached or -1 if data differs */
+static long readAll(FileReadAhead &readAhead, long offset)
+{
+	unsigned char *data;
+	ssize_t len;
+
+	// Ask for more than a block, data is returned up to the end of a block.
+	while ((len = readAhead.acquire(&data, READAHEAD_BLOCK_SIZE + 1)) > 0) {
+		for (ssize_t i = 0; i < len; i++) {
+			if (data[i] != fileByte(offset + i)) {
+				return -1;
+			}
+		}
+		readAhead.release((size_t)len);
+		offset += len;
+	}
+
+	return offset;
+}
+
+static void utc_media_FileReadAhead_init_p(void)
+{
+	FileReadAhead readAhead(READAHEAD_BLOCK_SIZE, READAHEAD_BLOCKS, READAHEAD_STACKSIZE);
+
+	TC_ASSERT_EQ("utc_media_FileReadAhead_init", readAhead.init(), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileReadAhead_start_p(void)
+{
+	FileReadAhead readAhead(READAHEAD_BLOCK_SIZE, READAHEAD_BLOCKS, READAHEAD_STACKSIZE);
+	readAhead.init();
+
+	TC_ASSERT_EQ("utc_media_FileReadAhead_start", readAhead.start(fp, 0), true);
+	TC_ASSERT_EQ("utc_media_FileReadAhead_start", readAhead.tell(), 0);
+
+	readAhead.stop();
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileReadAhead_start_n(void)
+{
+	FileReadAhead readAhead(READAHEAD_BLOCK_SIZE, READAHEAD_BLOCKS, READAHEAD_STACKSIZE);
+
+	// Blocks are not allocated yet
+	TC_ASSERT_EQ("utc_media_FileReadAhead_start", readAhead.start(fp, 0), false);
+
+	readAhead.init();
+	TC_ASSERT_EQ("utc_media_FileReadAhead_start", readAhead.start(fp, -1), false);
+
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileReadAhead_acquire_p(void)
+{
+	FileReadAhead readAhead(READAHEAD_BLOCK_SIZE, READAHEAD_BLOCKS, READAHEAD_STACKSIZE);
+	readAhead.init();
+	readAhead.start(fp, 0);
+
+	// File is more blocks than the ring, blocks are reused while reading.
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_acquire", readAll(readAhead, 0), READAHEAD_FILE_SIZE, readAhead.stop());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_acquire", readAhead.tell(), READAHEAD_FILE_SIZE, readAhead.stop());
+
+	// End of file stays until restarted
+	unsigned char *data;
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_acquire", readAhead.acquire(&data, READAHEAD_BLOCK_SIZE), 0, readAhead.stop());
+
+	readAhead.stop();
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileReadAhead_acquire_n(void)
+{
+	FileReadAhead readAhead(READAHEAD_BLOCK_SIZE, READAHEAD_BLOCKS, READAHEAD_STACKSIZE);
+	readAhead.init();
+	unsigned char *data;
+
+	// Not started
+	TC_ASSERT_EQ("utc_media_FileReadAhead_acquire", readAhead.acquire(&data, READAHEAD_BLOCK_SIZE), EOF);
+
+	readAhead.start(fp, 0);
+	readAhead.stop();
+	TC_ASSERT_EQ("utc_media_FileReadAhead_acquire", readAhead.acquire(&data, READAHEAD_BLOCK_SIZE), EOF);
+
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileReadAhead_seek_p(void)
+{
+	FileReadAhead readAhead(READAHEAD_BLOCK_SIZE, READAHEAD_BLOCKS, READAHEAD_STACKSIZE);
+	readAhead.init();
+	readAhead.start(fp, 0);
+
+	unsigned char *data;
+	ssize_t len = readAhead.acquire(&data, 10);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_seek", len, 10, readAhead.stop());
+	readAhead.release((size_t)len);
+
+	// Blocks read ahead are dropped, reading restarts in the middle of a block.
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_seek", readAhead.start(fp, READAHEAD_SEEK_OFFSET), true, readAhead.stop());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_seek", readAhead.tell(), READAHEAD_SEEK_OFFSET, readAhead.stop());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_seek", readAll(readAhead, READAHEAD_SEEK_OFFSET), READAHEAD_FILE_SIZE, readAhead.stop());
+
+	// End of file was reached, seeking must restart reading.
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_seek", readAhead.start(fp, 0), true, readAhead.stop());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_seek", readAll(readAhead, 0), READAHEAD_FILE_SIZE, readAhead.stop());
+
+	// Seeking to the end of file gives end of file at once.
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_seek", readAhead.start(fp, READAHEAD_FILE_SIZE), true, readAhead.stop());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_seek", readAhead.acquire(&data, READAHEAD_BLOCK_SIZE), 0, readAhead.stop());
+
+	readAhead.stop();
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileReadAhead_setDepth_p(void)
+{
+	FileReadAhead readAhead(READAHEAD_BLOCK_SIZE, READAHEAD_BLOCKS, READAHEAD_STACKSIZE);
+	readAhead.init();
+	file_readahead_stats_t stats;
+
+	// All blocks by default
+	readAhead.getStats(&stats);
+	TC_ASSERT_EQ("utc_media_FileReadAhead_setDepth", stats.depth, READAHEAD_BLOCKS);
+
+	// At least 2 blocks, one is consumed while the other is read.
+	readAhead.setDepth(1);
+	readAhead.getStats(&stats);
+	TC_ASSERT_EQ("utc_media_FileReadAhead_setDepth", stats.depth, 2);
+
+	readAhead.setDepth(READAHEAD_BLOCKS + 1);
+	readAhead.getStats(&stats);
+	TC_ASSERT_EQ("utc_media_FileReadAhead_setDepth", stats.depth, READAHEAD_BLOCKS);
+
+	// Reading works the same with fewer blocks ahead
+	readAhead.setDepth(2);
+	readAhead.start(fp, 0);
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_setDepth", readAll(readAhead, 0), READAHEAD_FILE_SIZE, readAhead.stop());
+
+	readAhead.stop();
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_FileReadAhead_getStats_p(void)
+{
+	FileReadAhead readAhead(READAHEAD_BLOCK_SIZE, READAHEAD_BLOCKS, READAHEAD_STACKSIZE);
+	readAhead.init();
+	file_readahead_stats_t stats;
+
+	readAhead.getStats(&stats);
+	TC_ASSERT_EQ("utc_media_FileReadAhead_getStats", stats.bytesPrefetched, 0);
+	TC_ASSERT_EQ("utc_media_FileReadAhead_getStats", stats.hits + stats.misses, 0);
+	TC_ASSERT_EQ("utc_media_FileReadAhead_getStats", stats.hitRate, 0);
+
+	readAhead.start(fp, 0);
+	readAll(readAhead, 0);
+	readAhead.getStats(&stats);
+
+	// Whole file was read ahead, each acquire() is either a hit or a miss.
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_getStats", stats.bytesPrefetched, READAHEAD_FILE_SIZE, readAhead.stop());
+	TC_ASSERT_GEQ_CLEANUP("utc_media_FileReadAhead_getStats", stats.hits + stats.misses, READAHEAD_FILE_SIZE / READAHEAD_BLOCK_SIZE + 1, readAhead.stop());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_getStats", stats.hitRate, stats.hits * 100 / (stats.hits + stats.misses), readAhead.stop());
+	TC_ASSERT_EQ_CLEANUP("utc_media_FileReadAhead_getStats", stats.depth, READAHEAD_BLOCKS, readAhead.stop());
+
+	readAhead.stop();
+	TC_SUCCESS_RESULT();
+}
+
+int utc_media_FileReadAhead_main(void)
+{
+	SetUp();
+	utc_media_FileReadAhead_init_p();
+	utc_media_FileReadAhead_start_p();
+	utc_media_FileReadAhead_start_n();
+	utc_media_FileReadAhead_acquire_p();
+	utc_media_FileReadAhead_acquire_n();
+	utc_media_FileReadAhead_seek_p();
+	utc_media_FileReadAhead_setDepth_p();
+	utc_media_FileReadAhead_getStats_p();
+	TearDown();
+	return 0;
+}
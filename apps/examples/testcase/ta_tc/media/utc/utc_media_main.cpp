@@ -45,6 +45,13 @@ int gtest_run(int *argc, char **argv)
 #ifdef CONFIG_MEDIA_PLAYER
 int utc_media_MediaPlayer_main(void);
 int utc_media_FileInputDataSource_main(void);
+int utc_media_StreamBuffer_main(void);
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+int utc_media_FileReadAhead_main(void);
+#endif
+#ifdef CONFIG_AUDIO_MIXER
+int utc_media_AudioMixer_main(void);
+#endif
 #endif
 #ifdef CONFIG_MEDIA_RECORDER
 int utc_media_mediarecorder_main(void);
@@ -73,6 +80,13 @@ int utc_media_main(int argc, char *argv[])
 #ifdef CONFIG_MEDIA_PLAYER
 	utc_media_MediaPlayer_main();
 	utc_media_FileInputDataSource_main();
+	utc_media_StreamBuffer_main();
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	utc_media_FileReadAhead_main();
+#endif
+#ifdef CONFIG_AUDIO_MIXER
+	utc_media_AudioMixer_main();
+#endif
 #endif
 #ifdef CONFIG_MEDIA_RECORDER
 	utc_media_mediarecorder_main();
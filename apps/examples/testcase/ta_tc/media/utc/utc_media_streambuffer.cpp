@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <memory>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "../../../../../../framework/src/media/StreamBuffer.h"
+#include "../../../../../../framework/src/media/StreamBufferReader.h"
+#include "../../../../../../framework/src/media/StreamBufferWriter.h"
+#include "../../../../../../framework/src/media/utils/rb.h"
+#include "tc_common.h"
+
+#define STREAM_BUFFER_SIZE 1024
+#define STREAM_THRESHOLD 256
+#define STREAM_TOTAL (64 * 1024)
+/* Chunk sizes cycle through these, so reads and writes wrap around at different positions */
+#define STREAM_CHUNK_MAX 700
+#define STREAM_CHUNK_STEP 37
+
+using namespace media::stream;
+
+struct stream_writer_s {
+	std::shared_ptr<StreamBufferWriter> writer;
+	size_t written;
+};
+
+/* Byte at a position of the stream, its period is longer than the stream */
+static unsigned char streamByte(size_t pos)
+{
+	return (unsigned char)(pos ^ (pos >> 8) ^ (pos >> 16));
+}
+
+static size_t chunkSize(size_t pos)
+{
+	return 1 + (pos * STREAM_CHUNK_STEP) % STREAM_CHUNK_MAX;
+}
+
+/* Writes the whole stream, by write() and by acquire()/commit() in turn */
+static void *writerMain(void *arg)
+{
+	auto ctx = static_cast<struct stream_writer_s *>(arg);
+	unsigned char buf[STREAM_CHUNK_MAX];
+	bool acquire = false;
+
+	while (ctx->written < STREAM_TOTAL) {
+		size_t size = chunkSize(ctx->written);
+		if (size > STREAM_TOTAL - ctx->written) {
+			size = STREAM_TOTAL - ctx->written;
+		}
+
+		if (acquire) {
+			rb_span_t span;
+			size_t len = ctx->writer->acquire(&span, size);
+			if (len == 0) {
+				break;
+			}
+			for (int i = 0; i < 2; i++) {
+				for (size_t j = 0; j < span.len[i]; j++) {
+					((unsigned char *)span.ptr[i])[j] = streamByte(ctx->written++);
+				}
+			}
+			ctx->writer->commit(len);
+		} else {
+			for (size_t i = 0; i < size; i++) {
+				buf[i] = streamByte(ctx->written + i);
+			}
+			size_t len = ctx->writer->write(buf, size);
+			if (len == 0) {
+				break;
+			}
+			ctx->written += len;
+		}
+		acquire = !acquire;
+	}
+
+	ctx->writer->setEndOfStream();
+	return NULL;
+}
+
+/* Reads up to the end position or the end of stream, returns the position reached.
+ * Data is read by read() and by acquire()/commit() in turn, and checked byte by byte.
+ */
+static size_t readStream(StreamBufferReader &reader, size_t pos, size_t end)
+{
+	unsigned char buf[STREAM_CHUNK_MAX];
+	bool acquire = false;
+
+	while (pos < end) {
+		size_t size = chunkSize(pos + 1);
+		if (size > end - pos) {
+			size = end - pos;
+		}
+
+		size_t len;
+		if (acquire) {
+			rb_span_t span;
+			len = reader.acquire(&span, size);
+			size_t checked = 0;
+			for (int i = 0; i < 2; i++) {
+				for (size_t j = 0; j < span.len[i] && checked < len; j++, checked++) {
+					if (((unsigned char *)span.ptr[i])[j] != streamByte(pos + checked)) {
+						return pos + checked;
+					}
+				}
+			}
+			reader.commit(len);
+		} else {
+			len = reader.read(buf, size);
+			for (size_t i = 0; i < len; i++) {
+				if (buf[i] != streamByte(pos + i)) {
+					return pos + i;
+				}
+			}
+		}
+
+		if (len == 0) {
+			// End of stream
+			break;
+		}
+		pos += len;
+		acquire = !acquire;
+	}
+
+	return pos;
+}
+
+static void utc_media_StreamBuffer_lockfree_p(void)
+{
+	auto streamBuffer = StreamBuffer::Builder().setBufferSize(STREAM_BUFFER_SIZE).setThreshold(STREAM_THRESHOLD).build();
+	TC_ASSERT("utc_media_StreamBuffer_lockfree", streamBuffer);
+
+	StreamBufferReader reader(streamBuffer);
+	struct stream_writer_s ctx;
+	ctx.writer = std::make_shared<StreamBufferWriter>(streamBuffer);
+	ctx.written = 0;
+
+	// One reader and one writer attached, the ring is accessed without lock
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree", streamBuffer->isLockFree(), true);
+
+	pthread_t writer;
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree", pthread_create(&writer, NULL, writerMain, &ctx), 0);
+
+	size_t pos = readStream(reader, 0, STREAM_TOTAL);
+	// End of stream must be seen after all data
+	size_t more = readStream(reader, pos, STREAM_TOTAL + 1);
+	// Writer stops if reading failed
+	ctx.writer->setEndOfStream();
+	pthread_join(writer, NULL);
+
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree", ctx.written, STREAM_TOTAL);
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree", pos, STREAM_TOTAL);
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree", more, STREAM_TOTAL);
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree", reader.isEndOfStream(), true);
+
+	TC_SUCCESS_RESULT();
+}
+
+static void utc_media_StreamBuffer_lockfree_switch_p(void)
+{
+	auto streamBuffer = StreamBuffer::Builder().setBufferSize(STREAM_BUFFER_SIZE).setThreshold(STREAM_THRESHOLD).build();
+	TC_ASSERT("utc_media_StreamBuffer_lockfree_switch", streamBuffer);
+
+	StreamBufferReader reader(streamBuffer);
+	struct stream_writer_s ctx;
+	ctx.writer = std::make_shared<StreamBufferWriter>(streamBuffer);
+	ctx.written = 0;
+
+	pthread_t writer;
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree_switch", pthread_create(&writer, NULL, writerMain, &ctx), 0);
+
+	// Lock-free while the writer is running
+	size_t pos = readStream(reader, 0, STREAM_TOTAL / 3);
+
+	// A second reader switches the buffer to locked mode on the fly
+	auto second = std::make_shared<StreamBufferReader>(streamBuffer);
+	bool locked = !streamBuffer->isLockFree();
+	if (pos == STREAM_TOTAL / 3) {
+		pos = readStream(reader, pos, STREAM_TOTAL * 2 / 3);
+	}
+
+	// And back to lock-free once it's detached
+	second = nullptr;
+	bool lockFree = streamBuffer->isLockFree();
+	if (pos == STREAM_TOTAL * 2 / 3) {
+		pos = readStream(reader, pos, STREAM_TOTAL + 1);
+	}
+	ctx.writer->setEndOfStream();
+	pthread_join(writer, NULL);
+
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree_switch", locked, true);
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree_switch", lockFree, true);
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree_switch", ctx.written, STREAM_TOTAL);
+	TC_ASSERT_EQ("utc_media_StreamBuffer_lockfree_switch", pos, STREAM_TOTAL);
+
+	TC_SUCCESS_RESULT();
+}
+
+int utc_media_StreamBuffer_main(void)
+{
+	utc_media_StreamBuffer_lockfree_p();
+	utc_media_StreamBuffer_lockfree_switch_p();
+	return 0;
+}
@@ -30,7 +30,7 @@
 #if defined(CONFIG_TASH) && !defined(CONFIG_BUILTIN_APPS)
 #include <apps/shell/tash.h>
 #else
-#if defined(CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_UTC) || defined(CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_ITC)
+#if defined(CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_UTC) || defined(CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_ITC) || defined(CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_STRESS)
 #define TC_ARASTORAGE_STACK       4096
 #endif
 #if defined(CONFIG_EXAMPLES_TESTCASE_AUDIO_UTC) || defined(CONFIG_EXAMPLES_TESTCASE_AUDIO_ITC)
@@ -96,6 +96,7 @@ extern int tc_tcp_tls_main(int agrc, char *agrv[]);
 /* TinyAra Public API Test Case as ta_tc */
 extern int utc_arastorage_main(int argc, char *argv[]);
 extern int itc_arastorage_main(int argc, char *argv[]);
+extern int stress_arastorage_main(int argc, char *argv[]);
 extern int utc_audio_main(int argc, char *argv[]);
 extern int itc_audio_main(int argc, char *argv[]);
 extern int utc_dm_main(int argc, char *argv[]);
@@ -126,6 +127,9 @@ static const tash_cmdlist_t tc_cmds[] = {
 #ifdef CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_ITC
 	{"arastorage_itc", itc_arastorage_main, TASH_EXECMD_ASYNC},
 #endif
+#ifdef CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_STRESS
+	{"arastorage_stress", stress_arastorage_main, TASH_EXECMD_ASYNC},
+#endif
 #ifdef CONFIG_EXAMPLES_TESTCASE_AUDIO_UTC
 	{"audio_utc", utc_audio_main, TASH_EXECMD_ASYNC},
 #endif
@@ -262,6 +266,12 @@ int tc_main(int argc, char *argv[])
 		printf("Arastorage itc is not started, err = %d\n", pid);
 	}
 #endif
+#ifdef CONFIG_EXAMPLES_TESTCASE_ARASTORAGE_STRESS
+	pid = task_create("arastoragestress", SCHED_PRIORITY_DEFAULT, TC_ARASTORAGE_STACK, stress_arastorage_main, argv);
+	if (pid < 0) {
+		printf("Arastorage stress is not started, err = %d\n", pid);
+	}
+#endif
 #ifdef CONFIG_EXAMPLES_TESTCASE_AUDIO_UTC
 	pid = task_create("audioutc", SCHED_PRIORITY_DEFAULT, TC_AUDIO_STACK, utc_audio_main, argv);
 	if (pid < 0) {
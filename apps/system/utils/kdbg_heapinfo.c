@@ -54,6 +54,9 @@ static void kdbg_heapinfo_task(FAR struct tcb_s *tcb, FAR void *arg)
 		printf(" | %5d", node->size);
 	}
 	printf(" | %9d | %9d", tcb->curr_alloc_size, tcb->peak_alloc_size);
+#ifdef CONFIG_MM_TASK_CACHE
+	printf(" | %6u", tcb->tcache ? (unsigned int)tcb->tcache->cached : 0);
+#endif
 
 	/* Show task name and arguments */
 #if CONFIG_TASK_NAME_SIZE > 0
@@ -128,12 +131,20 @@ int kdbg_heapinfo(int argc, char **args)
 #if defined(CONFIG_SCHED_HAVE_PARENT) && !defined(HAVE_GROUP_MEMBERS)
 	printf("%5s | ", "PPID");
 #endif
-	printf("%5s | %9s | %9s | %s\n", "STACK", "CURR_HEAP", "PEAK_HEAP", "NAME");
+	printf("%5s | %9s | %9s | ", "STACK", "CURR_HEAP", "PEAK_HEAP");
+#ifdef CONFIG_MM_TASK_CACHE
+	printf("%6s | ", "CACHED");
+#endif
+	printf("%s\n", "NAME");
 	printf("----|");
 #if defined(CONFIG_SCHED_HAVE_PARENT) && !defined(HAVE_GROUP_MEMBERS)
 	printf("-------|");
 #endif
-	printf("-------|-----------|-----------|----------\n");
+	printf("-------|-----------|-----------|");
+#ifdef CONFIG_MM_TASK_CACHE
+	printf("--------|");
+#endif
+	printf("----------\n");
 	sched_foreach(kdbg_heapinfo_task, NULL);
 
 #ifdef CONFIG_HEAPINFO_USER_GROUP
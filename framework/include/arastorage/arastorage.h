@@ -172,6 +172,9 @@ typedef struct _db_handle_s db_handle_t;
 struct _db_cursor_s;
 typedef struct _db_cursor_s db_cursor_t;
 
+struct _db_stmt_s;
+typedef struct _db_stmt_s db_stmt_t;
+
 typedef int db_storage_id_t;
 
 typedef uint32_t cursor_row_t;
@@ -185,8 +188,6 @@ typedef uint8_t attribute_id_t;
 ****************************************************************************/
 typedef int (*db_output_function_t)(const char *, ...);
 
-static db_output_function_t output = printf;
-
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -215,6 +216,13 @@ db_result_t db_deinit(void);
 * @brief create or remove relations, attributes and indexes in arastorage
 *
 * @details @b #include <arastorage/arastorage.h>
+* "REBUILD INDEX relation.attribute;" builds the index of an attribute again
+* from the tuples of relation, with buckets packed full.
+* A bplustree index may be created on int, long and string attributes. Strings
+* are indexed by their first 8 bytes, so WHERE conditions on longer common
+* prefixes scan every tuple sharing the prefix. Keys are 8 bytes long, so
+* bplustree indexes made by versions with 4 byte keys have to be rebuilt with
+* REBUILD INDEX.
 * @param[in] format query sentence
 * @return On success, DB_OK is returned. On failure, a negative value is returned.
 * @since TizenRT v1.0
@@ -222,16 +230,149 @@ db_result_t db_deinit(void);
 */
 db_result_t db_exec(char *format);
 
+/**
+* @brief begin a transaction of inserts
+*
+* @details @b #include <arastorage/arastorage.h>
+* Rows inserted by db_exec() or db_step() until db_commit() are kept in RAM,
+* and they're not returned by queries before commit. Statements other than
+* INSERT fail with DB_BUSY_ERROR while a transaction is active. There is one
+* transaction for the database, owned by the thread which began it. Statements
+* of other threads which change the database and db_begin() wait until it's
+* committed or rolled back, queries don't.
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_begin(void);
+
+/**
+* @brief commit the transaction begun by db_begin()
+*
+* @details @b #include <arastorage/arastorage.h>
+* Rows of the transaction are appended to the write-ahead log with one write
+* and one fsync, then stored to their relations and indexes. Once it returns
+* DB_OK, rows are kept over a power loss, and restored by db_init().
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+*	  If the log couldn't be written, the transaction is rolled back.
+* @since TizenRT v2.0
+*/
+db_result_t db_commit(void);
+
+/**
+* @brief discard rows inserted in the transaction begun by db_begin()
+*
+* @details @b #include <arastorage/arastorage.h>
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_rollback(void);
+
 /**
 * @brief process query of arastorage
 *
 * @details @b #include <arastorage/arastorage.h>
+* Rows of a SELECT are read as the returned cursor moves, the cursor holds the
+* relation until it's freed. So REMOVE RELATION and REMOVE FROM on the relation
+* return DB_BUSY_ERROR while a cursor is open, and cursors must be freed before
+* db_deinit(). The number of rows can be limited as
+* "SELECT id FROM sensor WHERE id > 10 LIMIT 20 OFFSET 40;", an aggregated
+* result has one row regardless of LIMIT. COUNT, SUM, MIN and MAX are long
+* values and MEAN is a double value. They are taken from a bplustree index
+* without reading rows when the condition is only a range of the attribute.
+* A COUNT of all rows is the cardinality of the relation.
 * @param[in] format query sentence
 * @return On success, a pointer to db_cursor_t is returned. On failure, a NULL is returned.
 * @since TizenRT v1.0
 */
 db_cursor_t *db_query(char *format);
 
+/**
+* @brief parse a query sentence once to execute it repeatedly with db_step()
+*
+* @details @b #include <arastorage/arastorage.h>
+* Values in the query may be given as '?' parameters, e.g. "INSERT (?, ?) INTO sensor;"
+* or "SELECT id FROM sensor WHERE time > ?;". Parameters are numbered from 1 in
+* the order they appear, and must be bound with db_bind_*() before db_step().
+* Parameters in a WHERE condition take integer or string values.
+* @param[in] format query sentence
+* @param[out] stmt a pointer to the prepared statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_prepare(char *format, db_stmt_t **stmt);
+
+/**
+* @brief bind an integer value to a parameter of prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* The value is taken as an integer written in the query sentence, so it's
+* stored to both DOMAIN_INT and DOMAIN_LONG attributes.
+* @param[in] stmt a pointer to the prepared statement
+* @param[in] index index of parameter, starting from 1
+* @param[in] value value of parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_bind_int(db_stmt_t *stmt, int index, int value);
+
+/**
+* @brief bind a long value to a parameter of prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to the prepared statement
+* @param[in] index index of parameter, starting from 1
+* @param[in] value value of parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_bind_long(db_stmt_t *stmt, int index, long value);
+
+/**
+* @brief bind a string value to a parameter of prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* The string is copied, so it may be freed after binding.
+* @param[in] stmt a pointer to the prepared statement
+* @param[in] index index of parameter, starting from 1
+* @param[in] value value of parameter
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_bind_string(db_stmt_t *stmt, int index, const char *value);
+
+/**
+* @brief execute prepared statement with the values bound
+*
+* @details @b #include <arastorage/arastorage.h>
+* Bound values are kept, so only changed ones need to be bound again before next step.
+* @param[in] stmt a pointer to the prepared statement
+* @param[out] cursor a pointer to the cursor of query result. It's required for
+*	  SELECT and REMOVE FROM statements, and ignored for others.
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_step(db_stmt_t *stmt, db_cursor_t **cursor);
+
+/**
+* @brief clear values bound to prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to the prepared statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_reset(db_stmt_t *stmt);
+
+/**
+* @brief free prepared statement
+*
+* @details @b #include <arastorage/arastorage.h>
+* @param[in] stmt a pointer to the prepared statement
+* @return On success, DB_OK is returned. On failure, a negative value is returned.
+* @since TizenRT v2.0
+*/
+db_result_t db_finalize(db_stmt_t *stmt);
+
 /**
 * @brief free allocated cursor data, it should be called before application terminated
 *
@@ -297,6 +438,7 @@ db_result_t cursor_move_first(db_cursor_t *cursor);
 * @brief move current position of cursor to last row
 *
 * @details @b #include <arastorage/arastorage.h>
+* All the rows of the query are read to find the last one.
 * @param[in] cursor a pointer to cursor
 * @return On success, DB_OK is returned. On failure, DB_CURSOR_ERROR is returned.
 * @since TizenRT v1.0
@@ -317,6 +459,11 @@ db_result_t cursor_move_next(db_cursor_t *cursor);
 * @brief move current position of cursor to previous row
 *
 * @details @b #include <arastorage/arastorage.h>
+* The cursor keeps the last CONFIG_ARASTORAGE_CURSOR_WINDOW rows it selected,
+* and the query is run again from the first row to move back past them.
+* Iterating n rows backwards from the last one selects about
+* n * n / (2 * CONFIG_ARASTORAGE_CURSOR_WINDOW) rows, so iterate forwards
+* when the result is large.
 * @param[in] cursor a pointer to cursor
 * @return On success, DB_OK is returned. On failure, DB_CURSOR_ERROR is returned.
 * @since TizenRT v1.0
@@ -327,6 +474,8 @@ db_result_t cursor_move_prev(db_cursor_t *cursor);
 * @brief move current position of cursor to specific row
 *
 * @details @b #include <arastorage/arastorage.h>
+* The query is run again from the first row to move back past the last
+* CONFIG_ARASTORAGE_CURSOR_WINDOW rows selected.
 * @param[in] cursor a pointer to cursor
 * @param[in] row_id index of row
 * @return On success, DB_OK is returned. On failure, DB_CURSOR_ERROR is returned.
@@ -368,6 +517,7 @@ cursor_row_t cursor_get_row(db_cursor_t *cursor);
 * @brief get the number of rows of cursor
 *
 * @details @b #include <arastorage/arastorage.h>
+* All the rows of the query are read to count them, current row is kept.
 * @param[in] cursor a pointer to cursor
 * @return On success, the number of rows is returned. On failure, INVALID_CURSOR_VALUE is returned.
 * @since TizenRT v1.0
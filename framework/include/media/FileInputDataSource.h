@@ -29,10 +29,36 @@
 #ifndef __MEDIA_FILEINPUTDATASOURCE_H
 #define __MEDIA_FILEINPUTDATASOURCE_H
 
+#include <tinyara/config.h>
 #include <media/InputDataSource.h>
 
 namespace media {
 namespace stream {
+
+/**
+ * @brief read-ahead statistics of the FileInputDataSource
+ * @details @b #include <media/FileInputDataSource.h>
+ * @since TizenRT v2.0
+ */
+struct file_readahead_stats_s {
+	/** Number of bytes read from the file ahead of decoding */
+	unsigned long long bytesPrefetched;
+	/** Time spent waiting for the file to be read in microseconds */
+	unsigned long long stallUs;
+	/** Number of reads served from blocks read ahead */
+	unsigned int hits;
+	/** Number of reads which had to wait for the file */
+	unsigned int misses;
+	/** Hits in percent of all reads */
+	unsigned int hitRate;
+	/** Number of blocks kept read ahead */
+	unsigned int depth;
+};
+
+typedef struct file_readahead_stats_s file_readahead_stats_t;
+
+class FileReadAhead;
+
 /**
  * @class
  * @brief This class is file input data structure
@@ -106,12 +132,31 @@ public:
 	 */
 	int seek(long offset, int origin) override;
 
+	/**
+	 * @brief Gets the read-ahead statistics
+	 * @details @b #include <media/FileInputDataSource.h>
+	 * @param[out] stats The statistics of reading the file
+	 * @return False if read-ahead is not enabled or the file is not open, else True
+	 * @since TizenRT v2.0
+	 */
+	bool getReadAheadStats(file_readahead_stats_t *stats);
+
 protected:
 	ssize_t onStreamBufferWritable() override;
 
 private:
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	void startReadAhead(long offset);
+	ssize_t readFromReadAhead();
+#endif
+
 	std::string mDataPath;
 	FILE *mFp;
+	size_t mFileSize;
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	std::shared_ptr<FileReadAhead> mReadAhead;
+	unsigned int mBitrate;
+#endif
 };
 } // namespace stream
 } // namespace media
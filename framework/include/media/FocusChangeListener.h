@@ -33,6 +33,10 @@ namespace media {
 static const int FOCUS_NONE = 0;
 static const int FOCUS_GAIN = 1;
 static const int FOCUS_LOSS = -1;
+/* Requested by short sounds which may play over others at lower volume */
+static const int FOCUS_GAIN_TRANSIENT_MAY_DUCK = 3;
+/* Focus is lost for a while, playback may go on at lower volume */
+static const int FOCUS_LOSS_TRANSIENT_CAN_DUCK = -3;
 
 class FocusChangeListener
 {
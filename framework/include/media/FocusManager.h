@@ -52,20 +52,24 @@ private:
 	class FocusRequester
 	{
 	public:
-		FocusRequester(std::string id, std::shared_ptr<FocusChangeListener> listener);
+		FocusRequester(std::string id, std::shared_ptr<FocusChangeListener> listener, int focusGain);
 		bool hasSameId(std::string id);
+		int getFocusGain();
 		void notify(int focusChange);
 
 	private:
 		std::string mId;
 		std::shared_ptr<FocusChangeListener> mListener;
+		int mFocusGain;
 	};
 
-	FocusManager() = default;
+	FocusManager() : mDucking(false) {}
 	virtual ~FocusManager() = default;
 	void removeFocusElement(std::string id);
+	void updateDucking();
 	std::list<std::shared_ptr<FocusRequester>> mFocusList;
 	std::mutex mFocusLock;
+	bool mDucking;
 };
 } // namespace media
 
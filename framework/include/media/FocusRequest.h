@@ -42,20 +42,24 @@ public:
 	public:
 		Builder();
 		Builder &setFocusChangeListener(std::shared_ptr<FocusChangeListener> listener);
+		Builder &setFocusGain(int focusGain);
 		std::shared_ptr<FocusRequest> build();
 
 	private:
 		std::string mId;
 		std::shared_ptr<FocusChangeListener> mListener;
+		int mFocusGain;
 	};
 
-	FocusRequest(std::string id, std::shared_ptr<FocusChangeListener> listener);
+	FocusRequest(std::string id, std::shared_ptr<FocusChangeListener> listener, int focusGain = FOCUS_GAIN);
 	std::string getId();
 	std::shared_ptr<FocusChangeListener> getListener();
+	int getFocusGain();
 
 private:
 	std::string mId;
 	std::shared_ptr<FocusChangeListener> mListener;
+	int mFocusGain;
 };
 } // namespace media
 #endif
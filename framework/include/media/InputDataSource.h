@@ -31,10 +31,15 @@
 
 #include <fstream>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <pthread.h>
 #include <media/DataSource.h>
 #include <media/BufferObserverInterface.h>
 
+struct rb_span_s;
+
 namespace media {
 class Decoder;
 class MediaPlayerImpl;
@@ -113,6 +118,54 @@ public:
 	 */
 	virtual int readAt(long offset, int origin, unsigned char *buf, size_t size);
 
+	/**
+	 * @brief Moves the stream to the given time position
+	 * @details @b #include <media/InputDataSource.h>
+	 * Decoding restarts from the nearest frame recorded in frame index, which is
+	 * built while decoding, or loaded from an index file.
+	 * Only compressed audio with a decoder is supported.
+	 * @param[in] msec The time position in milliseconds
+	 * @return if failed, it returns -1, else 0 returns
+	 * @since TizenRT v2.0
+	 */
+	int seekTo(unsigned int msec);
+
+	/**
+	 * @brief Gets the duration of the stream
+	 * @details @b #include <media/InputDataSource.h>
+	 * @return duration in milliseconds, or -1 if it's unknown until the whole stream is indexed
+	 * @since TizenRT v2.0
+	 */
+	int getDuration();
+
+	/**
+	 * @brief Gets contiguous regions of the stream data without copying
+	 * @details @b #include <media/InputDataSource.h>
+	 * @param[out] span The regions of data acquired, the second one is used on wrap-around
+	 * @param[in] size The size of data desired
+	 * @return size of data acquired, 0 in case of end of stream
+	 * @since TizenRT v2.0
+	 */
+	ssize_t acquire(struct rb_span_s *span, size_t size);
+
+	/**
+	 * @brief Releases the data consumed from the regions got by acquire()
+	 * @details @b #include <media/InputDataSource.h>
+	 * @param[in] size The size of data consumed
+	 * @since TizenRT v2.0
+	 */
+	void release(size_t size);
+
+	/**
+	 * @brief Checks whether data desired can be read without blocking
+	 * @details @b #include <media/InputDataSource.h>
+	 * If it's not ready, the player is woken up once the data is buffered.
+	 * @param[in] size The size of data desired
+	 * @return true if enough data is buffered, or end of stream is reached
+	 * @since TizenRT v2.0
+	 */
+	bool isReady(size_t size);
+
 	/**
 	 * @brief Register current player to get data souce state and other informations.
 	 * @details @b #include <media/InputDataSource.h>
@@ -138,6 +191,10 @@ protected:
 	void registerDecoder(audio_type_t audioType, unsigned int channels, unsigned int sampleRate);
 	void unregisterDecoder();
 	size_t getDecodeFrames(unsigned char *buf, size_t *size);
+	void completeFrameIndex();
+	unsigned int getBitrate();
+	bool loadFrameIndex(const std::string &path, size_t sourceSize);
+	bool saveFrameIndex(const std::string &path, size_t sourceSize);
 
 	void setStreamBuffer(std::shared_ptr<StreamBuffer>);
 	std::shared_ptr<StreamBuffer> getStreamBuffer() { return mStreamBuffer; }
@@ -155,15 +212,20 @@ private:
 	std::shared_ptr<StreamBufferWriter> mBufferWriter;
 	std::weak_ptr<MediaPlayerImpl> mPlayer;
 
-	buffer_state_t mState;
+	std::atomic<buffer_state_t> mState;
+	std::atomic<size_t> mReadyLevel;
 	size_t mTotalBytes;
 	bool mIsWorkerAlive;
 	pthread_t mWorker;
 	std::mutex mMutex;
 	std::condition_variable mCondv;
+	std::mutex mSyncMtx;
+	std::condition_variable mSyncCv;
 
+	void seekToPosition(unsigned int msec, int &ret);
 	void sleepWorker();
 	void wakenWorker();
+	void notifyReady();
 	static void *workerMain(void *arg);
 };
 
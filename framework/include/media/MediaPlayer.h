@@ -57,6 +57,30 @@ typedef enum player_error_e player_error_t;
 const int PLAYER_OK = PLAYER_ERROR_NONE;
 typedef int player_result_t;
 
+/**
+ * @brief playback statistics of the MediaPlayer
+ * @details @b #include <media/MediaPlayer.h>
+ * @since TizenRT v2.0
+ */
+struct player_stats_s {
+	/** Number of periods written to the output device */
+	unsigned int periods;
+	/** Duration of the last period in microseconds */
+	unsigned int periodUs;
+	/** Time left until the output device runs out of data in microseconds, negative if it's missed */
+	long long deadlineUs;
+	/** Number of periods written after the output device ran out of data */
+	unsigned int deviceUnderruns;
+	/** Number of times the input data was not ready for the next period */
+	unsigned int inputUnderruns;
+	/** Number of times the player worker was scheduled for playback */
+	unsigned int wakeups;
+	/** Time spent by the player worker producing periods in microseconds */
+	unsigned long long busyUs;
+};
+
+typedef struct player_stats_s player_stats_t;
+
 class MediaPlayerImpl;
 
 /**
@@ -166,6 +190,16 @@ public:
 	 */
 	player_result_t setVolume(uint8_t);
 
+	/**
+	 * @brief Gets the playback statistics
+	 * @details @b #include <media/MediaPlayer.h>
+	 * This function is a synchronous api
+	 * @param[out] stats The statistics of the current playback
+	 * @return The result of the getStats operation
+	 * @since TizenRT v2.0
+	 */
+	player_result_t getStats(player_stats_t *stats);
+
 	/**
 	 * @brief Sets the DataSource of input data
 	 * @details @b #include <media/MediaPlayer.h>
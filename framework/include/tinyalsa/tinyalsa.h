@@ -462,6 +462,8 @@ int pcm_wait(struct pcm *pcm, int timeout);
 * @brief Returns the number of frames ready to be written or read
 *
 * @details @b #include <tinyalsa/tinyalsa.h>
+* For a PCM opened without @ref PCM_MMAP, only @ref PCM_OUT is supported,
+* and the number of frames which can be written without blocking is returned.
 * @param[in] pcm A PCM handle
 * @returns On success, positive number is returned. On failure, a negative number returned
 * @since TizenRT v2.0 PRE
@@ -91,12 +91,17 @@
 #define AQL_TYPE_SELECT                    (AQL_OP_TYPE_QUERY | 0x00000009)
 #define AQL_TYPE_REMOVE_TUPLES             (AQL_OP_TYPE_QUERY | 0x0000000A)
 
+#define AQL_TYPE_REBUILD_INDEX             (AQL_OP_TYPE_EXEC | 0x0000000B)
+
 #define AQL_TYPE_MASK                      (AQL_OP_TYPE_MASK | AQL_DATA_TYPE_MASK)
 
 #define AQL_FLAG_AGGREGATE              1
 #define AQL_FLAG_SELECT_ALL             2
 #define AQL_FLAG_ASSIGN                 4
 
+/* The limit of a selection without a LIMIT clause. */
+#define AQL_NO_LIMIT                    ((tuple_id_t)-1)
+
 #define AQL_CLEAR(adt)                  aql_clear(adt)
 #define AQL_SET_TYPE(adt, type)  (((adt))->optype = (type))
 #define AQL_GET_OP_TYPE(optype)  ((optype) & (AQL_OP_TYPE_MASK))
@@ -126,6 +131,8 @@
 #define AQL_SET_CONDITION(adt, cond)    ((adt)->lvm_instance = (cond))
 #define AQL_ADD_VALUE(adt, domain, value)                               \
 	aql_add_value((adt), (domain), (value))
+#define AQL_ADD_PARAMETER(adt, type)    aql_add_parameter((adt), (type))
+#define AQL_PARAMETER_COUNT(adt)        ((adt)->parameter_count)
 
 /****************************************************************************
 * Public Type Definitions
@@ -177,22 +184,26 @@ enum token_e {
 	WHERE,
 	COUNT,
 	INDEX,
+	LIMIT,
 	INSERT,
 	SELECT,
 	REMOVE,
-	CREATE,
-	MEDIAN,						/* 40 */
+	CREATE,						/* 40 */
+	MEDIAN,
 	DOMAIN,
 	STRING,
 	INLINE,
 	REMAIN,
+	OFFSET,
 
 	PROJECT,
+	REBUILD,
 
 	RELATION,
 
 	ATTRIBUTE,
-	BPLUSTREE,					/* 48 */
+	BPLUSTREE,					/* 51 */
+	PARAMETER,
 
 	INTEGER_VALUE = 251,
 	FLOAT_VALUE = 252,
@@ -233,17 +244,34 @@ struct aql_attribute_s {
 };
 typedef struct aql_attribute_s aql_attribute_t;
 
+/* A '?' placeholder, bound to a value before each execution of a prepared statement. */
+enum aql_parameter_type_e {
+	AQL_PARAMETER_VALUE = 1,	/* index is the position in values[] */
+	AQL_PARAMETER_OPERAND = 2	/* operand of the condition, index is unused */
+};
+typedef enum aql_parameter_type_e aql_parameter_type_t;
+
+struct aql_parameter_s {
+	uint8_t type;
+	uint8_t index;
+};
+typedef struct aql_parameter_s aql_parameter_t;
+
 struct aql_adt_s {
 	char relations[AQL_RELATION_LIMIT][RELATION_NAME_LENGTH + 1];
 	aql_attribute_t attributes[AQL_ATTRIBUTE_LIMIT];
 	aql_aggregator_t aggregators[AQL_ATTRIBUTE_LIMIT];
 	attribute_value_t values[AQL_ATTRIBUTE_LIMIT];
+	aql_parameter_t parameters[AQL_PARAMETER_LIMIT];
 	index_type_t index_type;
 	uint8_t relation_count;
 	uint8_t attribute_count;
 	uint8_t value_count;
+	uint8_t parameter_count;
 	uint32_t optype;
 	uint8_t flags;
+	tuple_id_t limit;
+	tuple_id_t offset;
 	void *lvm_instance;
 };
 typedef struct aql_adt_s aql_adt_t;
@@ -260,5 +288,8 @@ void aql_add_relation(aql_adt_t *adt, char *rel);
 aql_status_t aql_parse(aql_adt_t *adt, char *query_string);
 db_result_t aql_add_attribute(aql_adt_t *adt, char *name, domain_t domain, unsigned element_size, int processed_only);
 db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value);
+int aql_add_parameter(aql_adt_t *adt, aql_parameter_type_t type);
+void aql_plan_cache_clear(void);
+db_result_t aql_release_handle(db_handle_t *handle);
 
 #endif							/* !AQL_H */
@@ -84,7 +84,10 @@ void aql_clear(aql_adt_t *adt)
 	adt->relation_count = 0;
 	adt->attribute_count = 0;
 	adt->value_count = 0;
+	adt->parameter_count = 0;
 	adt->flags = 0;
+	adt->limit = AQL_NO_LIMIT;
+	adt->offset = 0;
 	memset(adt->aggregators, 0, sizeof(adt->aggregators));
 }
 
@@ -93,7 +96,7 @@ void aql_add_relation(aql_adt_t *adt, char *rel)
 	if (adt->relation_count < AQL_RELATION_LIMIT - 1) {
 		int len;
 		len = strlen(rel) + 1;
-		snprintf(adt->relations[adt->relation_count++], len, "%s\0", rel);
+		snprintf(adt->relations[adt->relation_count++], len, "%s", rel);
 	}
 }
 
@@ -160,3 +163,27 @@ db_result_t aql_add_value(aql_adt_t *adt, domain_t domain, void *value_ptr)
 
 	return DB_OK;
 }
+
+int aql_add_parameter(aql_adt_t *adt, aql_parameter_type_t type)
+{
+	aql_parameter_t *param;
+
+	if (adt->parameter_count == AQL_PARAMETER_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	param = &adt->parameters[adt->parameter_count];
+	param->type = type;
+	param->index = 0;
+
+	if (type == AQL_PARAMETER_VALUE) {
+		/* Keep the place of the value, it's filled on binding. */
+		if (adt->value_count == AQL_ATTRIBUTE_LIMIT) {
+			return DB_LIMIT_ERROR;
+		}
+		param->index = adt->value_count;
+		adt->values[adt->value_count++].domain = DOMAIN_UNSPECIFIED;
+	}
+
+	return adt->parameter_count++;
+}
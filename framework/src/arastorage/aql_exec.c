@@ -62,16 +62,262 @@
 #include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #include "db_debug.h"
 #include "storage.h"
 #include "relation.h"
 #include "result.h"
 #include "aql.h"
+#include "lvm.h"
+#include "transaction.h"
+
+/****************************************************************************
+* Private Types
+****************************************************************************/
+/*
+ * A parsed query. The adt keeps the condition program of the query with '?'
+ * operands unbound, each execution runs on a copy with the values bound.
+ * Plans are shared by the plan cache and statements, and freed on last put.
+ */
+struct aql_plan_s {
+	struct aql_plan_s *next;
+	int refs;
+	aql_adt_t adt;
+	char query[];
+};
+typedef struct aql_plan_s aql_plan_t;
+
+struct _db_stmt_s {
+	aql_plan_t *plan;
+	attribute_value_t params[AQL_PARAMETER_LIMIT];
+	uint32_t bound;
+};
+
+/****************************************************************************
+* Private Variables
+****************************************************************************/
+/* Cached plans, the most recently used first. */
+static aql_plan_t *g_plan_cache;
+static int g_plan_cache_count;
+static pthread_mutex_t g_plan_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Guards the relation catalog. Queries take it to set up and tear down, and
+ * run without it while selecting rows, so reader threads proceed in parallel.
+ */
+static pthread_mutex_t g_db_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Signalled with g_db_lock when a transaction ends. */
+static pthread_cond_t g_txn_cond = PTHREAD_COND_INITIALIZER;
 
 /****************************************************************************
 * Private Functions
 ****************************************************************************/
+/*
+ * Wait with g_db_lock held until the transaction of another thread ends.
+ * Rows of a transaction take their ids when they are inserted, so others
+ * must not change the relations before it's committed or rolled back.
+ */
+static void aql_wait_transaction(void)
+{
+	while (transaction_active() && !transaction_owned()) {
+		pthread_cond_wait(&g_txn_cond, &g_db_lock);
+	}
+}
+
+static void aql_end_transaction(void)
+{
+	if (!transaction_active()) {
+		pthread_cond_broadcast(&g_txn_cond);
+	}
+}
+
+db_result_t aql_get_parse_result(char *format, aql_adt_t *adt)
+{
+	if (format == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (AQL_ERROR(aql_parse(adt, format))) {
+		return DB_PARSING_ERROR;
+	}
+	return DB_OK;
+
+}
+
+relation_t *aql_get_relation(aql_adt_t *adt)
+{
+	int first_rel_arg;
+
+	/* If the ASSIGN flag is set, the first relation in the array is
+	   the desired result relation. */
+	first_rel_arg = ! !(adt->flags & AQL_FLAG_ASSIGN);
+	return relation_load(adt->relations[first_rel_arg]);
+}
+
+static void aql_plan_free(aql_plan_t *plan)
+{
+	int i;
+
+	/* Strings given in the query text are allocated by the parser. */
+	for (i = 0; i < plan->adt.value_count; i++) {
+		if (plan->adt.values[i].domain == DOMAIN_STRING) {
+			free(VALUE_STRING(&plan->adt.values[i]));
+		}
+	}
+	if (plan->adt.lvm_instance != NULL) {
+		free(plan->adt.lvm_instance);
+	}
+	free(plan);
+}
+
+static void aql_plan_put(aql_plan_t *plan)
+{
+	int refs;
+
+	pthread_mutex_lock(&g_plan_cache_lock);
+	refs = --plan->refs;
+	pthread_mutex_unlock(&g_plan_cache_lock);
+
+	if (refs == 0) {
+		aql_plan_free(plan);
+	}
+}
+
+static aql_plan_t *aql_plan_get(char *format)
+{
+	aql_plan_t *plan;
+	aql_plan_t **prev;
+	aql_plan_t *evicted;
+	size_t len;
+
+	if (format == NULL) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&g_plan_cache_lock);
+	for (prev = &g_plan_cache; (plan = *prev) != NULL; prev = &plan->next) {
+		if (strcmp(plan->query, format) == 0) {
+			/* Move it to the front. */
+			*prev = plan->next;
+			plan->next = g_plan_cache;
+			g_plan_cache = plan;
+			plan->refs++;
+			pthread_mutex_unlock(&g_plan_cache_lock);
+			DB_LOG_D("DB: plan cache hit \"%s\"\n", format);
+			return plan;
+		}
+	}
+	pthread_mutex_unlock(&g_plan_cache_lock);
+
+	len = strlen(format);
+	plan = (aql_plan_t *)malloc(sizeof(aql_plan_t) + len + 1);
+	if (plan == NULL) {
+		DB_LOG_E("DB: Failed to allocate plan\n");
+		return NULL;
+	}
+	memcpy(plan->query, format, len + 1);
+	plan->next = NULL;
+	plan->refs = 1;
+
+	if (DB_ERROR(aql_get_parse_result(plan->query, &plan->adt))) {
+		DB_LOG_E("DB : Parsing Error : \"%s\"\n", format);
+		aql_plan_free(plan);
+		return NULL;
+	}
+
+	if (AQL_PLAN_CACHE_SIZE <= 0) {
+		return plan;
+	}
+
+	evicted = NULL;
+	pthread_mutex_lock(&g_plan_cache_lock);
+	plan->refs++;
+	plan->next = g_plan_cache;
+	g_plan_cache = plan;
+	if (++g_plan_cache_count > AQL_PLAN_CACHE_SIZE) {
+		for (prev = &g_plan_cache; (*prev)->next != NULL; prev = &(*prev)->next) {
+		}
+		evicted = *prev;
+		*prev = NULL;
+		g_plan_cache_count--;
+		if (--evicted->refs > 0) {
+			/* Still used by a statement. */
+			evicted = NULL;
+		}
+	}
+	pthread_mutex_unlock(&g_plan_cache_lock);
+
+	if (evicted != NULL) {
+		aql_plan_free(evicted);
+	}
+
+	return plan;
+}
+
+/*
+ * Copy the parsed query of plan to adt with the parameters bound.
+ * The condition program of adt is allocated, it's freed with the query handle.
+ */
+static db_result_t aql_plan_bind(aql_plan_t *plan, attribute_value_t *params, uint32_t bound, aql_adt_t *adt)
+{
+	int i;
+	aql_parameter_t *param;
+	lvm_instance_t *lvm;
+	lvm_status_t status;
+
+	for (i = 0; i < AQL_PARAMETER_COUNT(&plan->adt); i++) {
+		if (!(bound & (1 << i))) {
+			DB_LOG_E("DB: Parameter %d isn't bound\n", i + 1);
+			return DB_ARGUMENT_ERROR;
+		}
+	}
+
+	memcpy(adt, &plan->adt, sizeof(aql_adt_t));
+	AQL_SET_CONDITION(adt, NULL);
+
+	for (i = 0; i < AQL_PARAMETER_COUNT(&plan->adt); i++) {
+		param = &plan->adt.parameters[i];
+		if (param->type == AQL_PARAMETER_VALUE) {
+			adt->values[param->index] = params[i];
+		}
+	}
+
+	if (plan->adt.lvm_instance == NULL) {
+		return DB_OK;
+	}
+
+	lvm = (lvm_instance_t *)malloc(sizeof(lvm_instance_t));
+	if (lvm == NULL) {
+		DB_LOG_E("DB: Failed to malloc lvm instance\n");
+		return DB_ALLOCATION_ERROR;
+	}
+	memcpy(lvm, plan->adt.lvm_instance, sizeof(lvm_instance_t));
+
+	for (i = 0; i < AQL_PARAMETER_COUNT(&plan->adt); i++) {
+		param = &plan->adt.parameters[i];
+		if (param->type != AQL_PARAMETER_OPERAND) {
+			continue;
+		}
+		if (params[i].domain == DOMAIN_STRING) {
+			status = lvm_bind_string(lvm, i, (char *)VALUE_STRING(&params[i]));
+		} else if (params[i].domain == DOMAIN_INT) {
+			status = lvm_bind_parameter(lvm, i, VALUE_LONG(&params[i]));
+		} else {
+			DB_LOG_E("DB: Parameter %d of condition must be an integer or a string\n", i + 1);
+			free(lvm);
+			return DB_TYPE_ERROR;
+		}
+		if (LVM_ERROR(status)) {
+			free(lvm);
+			return DB_IMPLEMENTATION_ERROR;
+		}
+	}
+	AQL_SET_CONDITION(adt, lvm);
+
+	return DB_OK;
+}
+
 db_result_t aql_init_handle(db_handle_t **handle)
 {
 	*handle = NULL;
@@ -102,11 +348,18 @@ db_result_t aql_deinit_handle(db_handle_t **handle)
 		if (DB_ERROR(res)) {
 			return res;
 		}
+		if ((*handle)->result_rel->dir == DB_MEMORY) {
+			relation_remove((*handle)->result_rel, 1);
+		}
 	}
 	if ((*handle)->tuple != NULL) {
 		free((*handle)->tuple);
 		(*handle)->tuple = NULL;
 	}
+	if ((*handle)->index_rows != NULL) {
+		free((*handle)->index_rows);
+		(*handle)->index_rows = NULL;
+	}
 	if ((*handle)->lvm_instance != NULL) {
 		free((*handle)->lvm_instance);
 		(*handle)->lvm_instance = NULL;
@@ -115,61 +368,47 @@ db_result_t aql_deinit_handle(db_handle_t **handle)
 		free((*handle)->attr_map);
 		(*handle)->attr_map = NULL;
 	}
+	storage_scan_deinit(&(*handle)->scan);
 	free(*handle);
 	*handle = NULL;
 	DB_LOG_D("deinit handle!\n");
 	return res;
 }
 
-/****************************************************************************
-* Public Functions
-****************************************************************************/
-db_result_t aql_get_parse_result(char *format, aql_adt_t *adt)
+/* Free the handle of a query which is given to a cursor. */
+db_result_t aql_release_handle(db_handle_t *handle)
 {
-	if (format == NULL) {
-		return DB_ARGUMENT_ERROR;
-	}
-	if (AQL_ERROR(aql_parse(adt, format))) {
-		return DB_PARSING_ERROR;
-	}
-	return DB_OK;
-
-}
-
-relation_t *aql_get_relation(aql_adt_t *adt)
-{
-	int first_rel_arg;
+	db_result_t res;
 
-	/* If the ASSIGN flag is set, the first relation in the array is
-	   the desired result relation. */
-	first_rel_arg = ! !(adt->flags & AQL_FLAG_ASSIGN);
-	return relation_load(adt->relations[first_rel_arg]);
+	pthread_mutex_lock(&g_db_lock);
+	res = aql_deinit_handle(&handle);
+	pthread_mutex_unlock(&g_db_lock);
+	return res;
 }
 
-db_result_t db_exec(char *format)
+static db_result_t aql_exec_locked(aql_adt_t *adt)
 {
 	db_result_t res;
-	aql_adt_t adt;
 	relation_t *rel = NULL;
 	aql_attribute_t *attr;
 	attribute_t *relattr = NULL;
 	uint32_t optype;
-	res = aql_get_parse_result(format, &adt);
-
-	if (DB_ERROR(res)) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n", res);
-		return DB_PARSING_ERROR;
-	}
 
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
-	if (optype == AQL_OP_TYPE_QUERY) {
-		DB_LOG_E("DB : AQL OP TYPE Error \n");
-		return DB_ARGUMENT_ERROR;
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
+	if (optype != AQL_TYPE_INSERT) {
+		if (transaction_active()) {
+			DB_LOG_E("DB : Only INSERT is allowed in a transaction\n");
+			return DB_BUSY_ERROR;
+		}
+		/* Committed inserts must not be replayed over a changed relation */
+		res = transaction_checkpoint();
+		if (DB_ERROR(res)) {
+			return res;
+		}
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
 	if (optype != AQL_TYPE_CREATE_RELATION) {
-		rel = aql_get_relation(&adt);
+		rel = aql_get_relation(adt);
 		if (rel == NULL) {
 			DB_LOG_E("DB : get relation Failed\n");
 			return DB_RELATIONAL_ERROR;
@@ -180,27 +419,27 @@ db_result_t db_exec(char *format)
 
 	switch (optype) {
 	case AQL_TYPE_CREATE_ATTRIBUTE:
-		attr = &(adt.attributes[0]);
+		attr = &(adt->attributes[0]);
 		if (relation_attribute_add(rel, DB_STORAGE, attr->name, attr->domain, attr->element_size) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_CREATE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr == NULL) {
 			res = DB_NAME_ERROR;
 			break;
 		}
-		res = index_create(AQL_GET_INDEX_TYPE(&adt), rel, relattr);
+		res = index_create(AQL_GET_INDEX_TYPE(adt), rel, relattr);
 		break;
 	case AQL_TYPE_CREATE_RELATION:
-		if (relation_create(adt.relations[0], DB_STORAGE) != NULL) {
+		if (relation_create(adt->relations[0], DB_STORAGE) != NULL) {
 			res = DB_OK;
 		}
 		break;
 	case AQL_TYPE_INSERT:
 		if (relation_cardinality(rel) < DB_TUPLE_LIMIT) {
-			res = relation_insert(rel, adt.values);
+			res = relation_insert(rel, adt->values);
 			if (DB_SUCCESS(res)) {
 				res = DB_OK;
 			}
@@ -209,10 +448,10 @@ db_result_t db_exec(char *format)
 		}
 		break;
 	case AQL_TYPE_REMOVE_ATTRIBUTE:
-		res = relation_attribute_remove(rel, adt.attributes[0].name);
+		res = relation_attribute_remove(rel, adt->attributes[0].name);
 		break;
 	case AQL_TYPE_REMOVE_INDEX:
-		relattr = relation_attribute_get(rel, adt.attributes[0].name);
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
 		if (relattr != NULL) {
 			index_load(rel, relattr);
 			if (relattr->index != NULL) {
@@ -227,6 +466,20 @@ db_result_t db_exec(char *format)
 	case AQL_TYPE_REMOVE_RELATION:
 		res = relation_remove(rel, 1);
 		break;
+	case AQL_TYPE_REBUILD_INDEX:
+		relattr = relation_attribute_get(rel, adt->attributes[0].name);
+		if (relattr == NULL) {
+			res = DB_NAME_ERROR;
+			break;
+		}
+		index_load(rel, relattr);
+		if (relattr->index == NULL) {
+			DB_LOG_E("DB: The attribute %s isn't indexed\n", relattr->name);
+			res = DB_INDEX_ERROR;
+			break;
+		}
+		res = index_rebuild_attribute(rel, relattr);
+		break;
 	default:
 		break;
 	}
@@ -236,9 +489,23 @@ db_result_t db_exec(char *format)
 	return res;
 }
 
-db_cursor_t *db_query(char *format)
+static db_result_t aql_exec(aql_adt_t *adt)
 {
-	aql_adt_t adt;
+	db_result_t res;
+
+	pthread_mutex_lock(&g_db_lock);
+	aql_wait_transaction();
+	res = aql_exec_locked(adt);
+	pthread_mutex_unlock(&g_db_lock);
+	return res;
+}
+
+/*
+ * The condition program of adt is taken by the query handle and freed with it.
+ */
+static db_cursor_t *aql_query(aql_adt_t *adt)
+{
+	db_result_t res;
 	relation_t *rel;
 	uint32_t optype;
 	db_handle_t *handler;
@@ -247,15 +514,11 @@ db_cursor_t *db_query(char *format)
 
 	handler = NULL;
 	cursor = NULL;
+	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(adt));
 
-	if (DB_ERROR(aql_get_parse_result(format, &adt))) {
-		DB_LOG_E("DB : Parsing Error in db_create : %d\n");
-		return NULL;
-	}
-	optype = AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt));
-	if (optype != AQL_OP_TYPE_QUERY) {
-		DB_LOG_E("DB : AQL OP TYPE Error \n");
-		return NULL;
+	pthread_mutex_lock(&g_db_lock);
+	if (optype == AQL_TYPE_REMOVE_TUPLES) {
+		aql_wait_transaction();
 	}
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 	if (DB_SUCCESS(storage_flush_insert_buffer())) {
@@ -263,35 +526,57 @@ db_cursor_t *db_query(char *format)
 	}
 #endif
 
-	rel = aql_get_relation(&adt);
+	rel = aql_get_relation(adt);
 	if (rel == NULL) {
+		pthread_mutex_unlock(&g_db_lock);
+		free(adt->lvm_instance);
 		return NULL;
 	}
 
-	optype = AQL_GET_EXEC_TYPE(AQL_GET_TYPE(&adt));
+	if (optype == AQL_TYPE_REMOVE_TUPLES && (transaction_active() || DB_ERROR(transaction_checkpoint()))) {
+		DB_LOG_E("DB : Failed to remove tuples with transaction log\n");
+		free(adt->lvm_instance);
+		goto errout;
+	}
+
 	switch (optype) {
 	case AQL_TYPE_REMOVE_TUPLES:
 		/* Overwrite the attribute array with a full copy of the original
 		   relation's attributes. */
-		adt.attribute_count = 0;
+		adt->attribute_count = 0;
 		for (attr_ptr = list_head(rel->attributes); attr_ptr != NULL; attr_ptr = attr_ptr->next) {
-			AQL_ADD_ATTRIBUTE(&adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
+			AQL_ADD_ATTRIBUTE(adt, attr_ptr->name, DOMAIN_UNSPECIFIED, 0);
 		}
 	/* FALLTHROUGH */
 	case AQL_TYPE_SELECT:
 		if (DB_ERROR(aql_init_handle(&handler))) {
 			DB_LOG_E("DB: Init handle failed\n");
+			free(adt->lvm_instance);
 			goto errout;
 		}
-		if (DB_ERROR(relation_select(&handler, rel, &adt))) {
+		/* The relation is released with the handle from now on. */
+		res = relation_select(&handler, rel, adt);
+		rel = NULL;
+		if (DB_ERROR(res)) {
 			DB_LOG_E("DB: Failed relation_select\n");
 			goto errout;
 		}
-		cursor = relation_process_result(handler);
+		/* A selection into memory reads the relation only, it runs unlocked. */
+		if (handler->result_rel->dir == DB_MEMORY) {
+			pthread_mutex_unlock(&g_db_lock);
+			cursor = relation_process_result(handler);
+			pthread_mutex_lock(&g_db_lock);
+		} else {
+			cursor = relation_process_result(handler);
+		}
 		if (cursor == NULL) {
 			DB_LOG_E("DB: Failed to process cursor tuples\n");
 			goto errout;
 		}
+		if (optype == AQL_TYPE_SELECT) {
+			/* The cursor selects the rows with the handle as it moves. */
+			handler = NULL;
+		}
 		break;
 	case AQL_TYPE_FLUSH:
 	//TODO flush operation will be implemented later
@@ -300,11 +585,12 @@ db_cursor_t *db_query(char *format)
 	}
 
 	if (rel != NULL) {
-		if (handler == NULL || !(handler->flags & DB_HANDLE_FLAG_PROCESSING)) {
-			relation_release(rel);
-		}
+		relation_release(rel);
 	}
-	aql_deinit_handle(&handler);
+	if (handler != NULL) {
+		aql_deinit_handle(&handler);
+	}
+	pthread_mutex_unlock(&g_db_lock);
 
 	return cursor;
 
@@ -314,6 +600,261 @@ errout:
 	}
 
 	aql_deinit_handle(&handler);
+	pthread_mutex_unlock(&g_db_lock);
 
 	return NULL;
 }
+
+static db_result_t aql_stmt_bind(db_stmt_t *stmt, int index, attribute_value_t *value)
+{
+	attribute_value_t *param;
+
+	if (stmt == NULL || index < 1 || index > AQL_PARAMETER_COUNT(&stmt->plan->adt)) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	param = &stmt->params[index - 1];
+	if ((stmt->bound & (1 << (index - 1))) && param->domain == DOMAIN_STRING) {
+		free(VALUE_STRING(param));
+	}
+	*param = *value;
+	stmt->bound |= 1 << (index - 1);
+
+	return DB_OK;
+}
+
+/****************************************************************************
+* Public Functions
+****************************************************************************/
+db_result_t db_exec(char *format)
+{
+	db_result_t res;
+	aql_plan_t *plan;
+	aql_adt_t adt;
+
+	plan = aql_plan_get(format);
+	if (plan == NULL) {
+		return DB_PARSING_ERROR;
+	}
+
+	if (AQL_GET_OP_TYPE(AQL_GET_TYPE(&plan->adt)) == AQL_OP_TYPE_QUERY) {
+		DB_LOG_E("DB : AQL OP TYPE Error \n");
+		aql_plan_put(plan);
+		return DB_ARGUMENT_ERROR;
+	}
+
+	res = aql_plan_bind(plan, NULL, 0, &adt);
+	if (DB_SUCCESS(res)) {
+		res = aql_exec(&adt);
+		free(adt.lvm_instance);
+	}
+	aql_plan_put(plan);
+
+	return res;
+}
+
+db_cursor_t *db_query(char *format)
+{
+	aql_plan_t *plan;
+	aql_adt_t adt;
+	db_cursor_t *cursor;
+
+	plan = aql_plan_get(format);
+	if (plan == NULL) {
+		return NULL;
+	}
+
+	cursor = NULL;
+	if (AQL_GET_OP_TYPE(AQL_GET_TYPE(&plan->adt)) != AQL_OP_TYPE_QUERY) {
+		DB_LOG_E("DB : AQL OP TYPE Error \n");
+	} else if (DB_SUCCESS(aql_plan_bind(plan, NULL, 0, &adt))) {
+		cursor = aql_query(&adt);
+	}
+	aql_plan_put(plan);
+
+	return cursor;
+}
+
+db_result_t db_begin(void)
+{
+	db_result_t res;
+
+	pthread_mutex_lock(&g_db_lock);
+	aql_wait_transaction();
+	res = transaction_begin();
+	pthread_mutex_unlock(&g_db_lock);
+	return res;
+}
+
+db_result_t db_commit(void)
+{
+	db_result_t res;
+
+	pthread_mutex_lock(&g_db_lock);
+	res = transaction_commit();
+	aql_end_transaction();
+	pthread_mutex_unlock(&g_db_lock);
+	return res;
+}
+
+db_result_t db_rollback(void)
+{
+	db_result_t res;
+
+	pthread_mutex_lock(&g_db_lock);
+	res = transaction_rollback();
+	aql_end_transaction();
+	pthread_mutex_unlock(&g_db_lock);
+	return res;
+}
+
+db_result_t db_prepare(char *format, db_stmt_t **stmt)
+{
+	aql_plan_t *plan;
+
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+	*stmt = NULL;
+
+	plan = aql_plan_get(format);
+	if (plan == NULL) {
+		return DB_PARSING_ERROR;
+	}
+
+	*stmt = (db_stmt_t *)malloc(sizeof(db_stmt_t));
+	if (*stmt == NULL) {
+		aql_plan_put(plan);
+		return DB_ALLOCATION_ERROR;
+	}
+	memset(*stmt, 0, sizeof(db_stmt_t));
+	(*stmt)->plan = plan;
+
+	return DB_OK;
+}
+
+db_result_t db_bind_int(db_stmt_t *stmt, int index, int value)
+{
+	return db_bind_long(stmt, index, (long)value);
+}
+
+db_result_t db_bind_long(db_stmt_t *stmt, int index, long value)
+{
+	attribute_value_t param;
+
+	/* Same as an integer written in the query text. */
+	param.domain = DOMAIN_INT;
+	VALUE_LONG(&param) = value;
+
+	return aql_stmt_bind(stmt, index, &param);
+}
+
+db_result_t db_bind_string(db_stmt_t *stmt, int index, const char *value)
+{
+	attribute_value_t param;
+	db_result_t res;
+	size_t len;
+
+	if (value == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	len = strlen(value);
+	if (len >= DB_MAX_ELEMENT_SIZE) {
+		return DB_LIMIT_ERROR;
+	}
+
+	/* Storing a string copies the whole element of attribute. */
+	param.domain = DOMAIN_STRING;
+	VALUE_STRING(&param) = (unsigned char *)malloc(DB_MAX_ELEMENT_SIZE);
+	if (VALUE_STRING(&param) == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	memset(VALUE_STRING(&param), 0, DB_MAX_ELEMENT_SIZE);
+	memcpy(VALUE_STRING(&param), value, len);
+
+	res = aql_stmt_bind(stmt, index, &param);
+	if (DB_ERROR(res)) {
+		free(VALUE_STRING(&param));
+	}
+
+	return res;
+}
+
+db_result_t db_step(db_stmt_t *stmt, db_cursor_t **cursor)
+{
+	db_result_t res;
+	aql_adt_t adt;
+
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	if (AQL_GET_OP_TYPE(AQL_GET_TYPE(&stmt->plan->adt)) == AQL_OP_TYPE_QUERY && cursor == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	res = aql_plan_bind(stmt->plan, stmt->params, stmt->bound, &adt);
+	if (DB_ERROR(res)) {
+		return res;
+	}
+
+	if (AQL_GET_OP_TYPE(AQL_GET_TYPE(&adt)) == AQL_OP_TYPE_QUERY) {
+		*cursor = aql_query(&adt);
+		return (*cursor != NULL) ? DB_OK : DB_RELATIONAL_ERROR;
+	}
+
+	res = aql_exec(&adt);
+	free(adt.lvm_instance);
+
+	return res;
+}
+
+db_result_t db_reset(db_stmt_t *stmt)
+{
+	int i;
+
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	for (i = 0; i < AQL_PARAMETER_LIMIT; i++) {
+		if ((stmt->bound & (1 << i)) && stmt->params[i].domain == DOMAIN_STRING) {
+			free(VALUE_STRING(&stmt->params[i]));
+		}
+	}
+	stmt->bound = 0;
+
+	return DB_OK;
+}
+
+db_result_t db_finalize(db_stmt_t *stmt)
+{
+	if (stmt == NULL) {
+		return DB_ARGUMENT_ERROR;
+	}
+
+	db_reset(stmt);
+	aql_plan_put(stmt->plan);
+	free(stmt);
+
+	return DB_OK;
+}
+
+void aql_plan_cache_clear(void)
+{
+	aql_plan_t *plan;
+	aql_plan_t *next;
+
+	pthread_mutex_lock(&g_plan_cache_lock);
+	plan = g_plan_cache;
+	g_plan_cache = NULL;
+	g_plan_cache_count = 0;
+	pthread_mutex_unlock(&g_plan_cache_lock);
+
+	/* Plans still used by statements are freed on finalizing them. */
+	for (; plan != NULL; plan = next) {
+		next = plan->next;
+		aql_plan_put(plan);
+	}
+}
@@ -261,6 +261,11 @@ PARSER(values)
 	case INTEGER_VALUE:
 		AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE);
 		break;
+	case PARAMETER:
+		if (AQL_ADD_PARAMETER(adt, AQL_PARAMETER_VALUE) < 0) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -278,6 +283,7 @@ PARSER(values)
 PARSER(operand)
 {
 	lvm_instance_t *p;
+	int id;
 
 	p = adt->lvm_instance;
 
@@ -290,6 +296,9 @@ PARSER(operand)
 		AQL_ADD_PROCESSING_ATTRIBUTE(adt, VALUE);
 		break;
 	case STRING_VALUE:
+		if (LVM_ERROR(lvm_set_string(p, VALUE))) {
+			RETURN(SYNTAX_ERROR);
+		}
 		break;
 	case FLOAT_VALUE:
 		break;
@@ -298,6 +307,12 @@ PARSER(operand)
 			RETURN(SYNTAX_ERROR);
 		}
 		break;
+	case PARAMETER:
+		id = AQL_ADD_PARAMETER(adt, AQL_PARAMETER_OPERAND);
+		if (id < 0 || LVM_ERROR(lvm_set_parameter(p, id))) {
+			RETURN(SYNTAX_ERROR);
+		}
+		break;
 	default:
 		RETURN(SYNTAX_ERROR);
 	}
@@ -478,6 +493,23 @@ PARSER(where)
 	return STATUS_OK;
 }
 
+PARSER(limit)
+{
+	CONSUME(INTEGER_VALUE);
+	adt->limit = (tuple_id_t)*(long *)lexer->value;
+
+	NEXT;
+	if (TOKEN != OFFSET) {
+		REWIND;
+		RETURN(STATUS_OK);
+	}
+
+	CONSUME(INTEGER_VALUE);
+	adt->offset = (tuple_id_t)*(long *)lexer->value;
+
+	return STATUS_OK;
+}
+
 PARSER(select)
 {
 	lvm_instance_t *lvm;
@@ -517,12 +549,22 @@ PARSER(select)
 			AQL_SET_CONDITION(adt, NULL);
 			RETURN(SYNTAX_ERROR);
 		}
-	} else {
+		NEXT;
+	} else if (TOKEN != LIMIT) {
 		REWIND;
 		RETURN(STATUS_OK);
 	}
 
-	CONSUME(END);
+	if (TOKEN == LIMIT) {
+		if (!PARSE(limit)) {
+			RETURN(SYNTAX_ERROR);
+		}
+		NEXT;
+	}
+
+	if (TOKEN != END) {
+		RETURN(SYNTAX_ERROR);
+	}
 
 	return STATUS_OK;
 }
@@ -631,6 +673,7 @@ PARSER(remove_from)
 
 	if (!PARSE(where)) {
 		free(lvm);
+		AQL_SET_CONDITION(adt, NULL);
 		RETURN(SYNTAX_ERROR);
 	}
 
@@ -695,6 +738,26 @@ PARSER(remove)
 	RETURN(STATUS_OK);
 }
 
+PARSER(rebuild)
+{
+	CONSUME(INDEX);
+
+	AQL_SET_TYPE(adt, AQL_TYPE_REBUILD_INDEX);
+
+	CONSUME(IDENTIFIER);
+	AQL_ADD_RELATION(adt, VALUE);
+
+	CONSUME(DOT);
+	CONSUME(IDENTIFIER);
+
+	DB_LOG_V("rebuild index: %s\n", VALUE);
+	AQL_ADD_ATTRIBUTE(adt, VALUE, DOMAIN_UNSPECIFIED, 0);
+
+	CONSUME(END);
+
+	RETURN(STATUS_OK);
+}
+
 PARSER_TOKEN(index_type)
 {
 	NEXT;
@@ -902,6 +965,9 @@ aql_status_t aql_parse(aql_adt_t *adt, char *input_string)
 		case REMOVE:
 			result = parse_remove(adt, &lex);
 			break;
+		case REBUILD:
+			result = parse_rebuild(adt, &lex);
+			break;
 		case INSERT:
 			result = parse_insert(adt, &lex);
 			break;
@@ -66,8 +66,14 @@
 #include "db_debug.h"
 #include "result.h"
 #include "aql.h"
+#include "transaction.h"
 #include <arastorage/arastorage.h>
 
+/****************************************************************************
+* Private Variables
+****************************************************************************/
+static db_output_function_t output = printf;
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -88,14 +94,16 @@ db_result_t db_init(void)
 		return res;
 	}
 #endif
-	return res;
+	return transaction_init();
 }
 
 db_result_t db_deinit()
 {
+	transaction_deinit();
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 	storage_write_buffer_deinit();
 #endif
+	aql_plan_cache_clear();
 	relation_deinit();
 	index_deinit();
 	return DB_OK;
@@ -189,7 +197,7 @@ db_result_t db_print_tuple(db_cursor_t *cursor)
 	output("Row %lu:\t", (unsigned long)cursor->current_cursor_row);
 
 	for (column = 0; column < cursor->attribute_count; column++) {
-		if (DB_ERROR(cursor_get_value_storage(&value, cursor, column))) {
+		if (DB_ERROR(cursor_get_row_value(&value, cursor, column))) {
 			return DB_CURSOR_ERROR;
 		}
 		switch (value.domain) {
@@ -230,7 +238,7 @@ db_result_t db_print_value(db_cursor_t *cursor, int attr_index)
 
 	output("Row %lu:\t", (unsigned long)cursor->current_cursor_row);
 
-	if (DB_ERROR(cursor_get_value_storage(&value, cursor, attr_index))) {
+	if (DB_ERROR(cursor_get_row_value(&value, cursor, attr_index))) {
 		return DB_CURSOR_ERROR;
 	}
 
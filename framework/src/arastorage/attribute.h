@@ -72,9 +72,20 @@
 #define ATTRIBUTE_FLAG_PRIMARY_KEY      0x4
 #define ATTRIBUTE_FLAG_UNIQUE           0x8
 
+/* The internal domain of a value which is an index key, such as a bound of
+   the range derived from a condition. It's never the domain of an attribute. */
+#define DOMAIN_KEY                      0x10
+
+#define DB_KEY_MAX                      INT64_MAX
+#define DB_KEY_MIN                      INT64_MIN
+
 /****************************************************************************
 * Public Type Definitions
 ****************************************************************************/
+/* The key of a value in an index. Integers are their own keys and strings
+   are keyed by their leading bytes. */
+typedef int64_t db_key_t;
+
 struct attribute_s {
 	struct attribute_s *next;
 	void *index;
@@ -94,6 +105,7 @@ struct attribute_value_s {
 		long long_value;
 		double double_value;
 		unsigned char *string_value;
+		db_key_t key_value;
 	} u;
 	domain_t domain;
 };
@@ -104,5 +116,6 @@ typedef struct attribute_value_s attribute_value_t;
 #define VALUE_INT(value)    (value)->u.int_value
 #define VALUE_DOUBLE(value) (value)->u.double_value
 #define VALUE_STRING(value) (value)->u.string_value
+#define VALUE_KEY(value)    (value)->u.key_value
 
 #endif							/* ATTRIBUTES_H */
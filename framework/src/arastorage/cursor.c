@@ -27,14 +27,79 @@
 #include "result.h"
 #include "db_debug.h"
 #include "storage.h"
-#include "memb.h"
 #include "relation.h"
+#include "aql.h"
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+
+/* Select the next row of the query, it's kept in the tuple of the handle. */
+static db_result_t cursor_fetch(db_cursor_t *cursor)
+{
+	db_result_t res;
+
+	if (cursor->flags & CURSOR_FLAG_FINISHED) {
+		return DB_FINISHED;
+	}
+
+	while (cursor->handle != NULL && db_processing_status(cursor->handle)) {
+		res = relation_process(&cursor->handle);
+		if (DB_ERROR(res)) {
+			DB_LOG_E("DB: Failed to process tuples : %d\n", res);
+			return res;
+		}
+		if (res == DB_GOT_ROW) {
+			memcpy(cursor->window + (cursor->handle_rows % DB_CURSOR_WINDOW) * cursor->row_length, cursor->handle->tuple, cursor->row_length);
+			cursor->handle_rows++;
+			if (cursor->handle_rows > cursor->cursor_rows) {
+				cursor->cursor_rows = cursor->handle_rows;
+			}
+			return DB_GOT_ROW;
+		} else if (res == DB_FINISHED) {
+			break;
+		}
+	}
+
+	DB_LOG_V("DB: Processing tuples is done!\n");
+	cursor->flags |= CURSOR_FLAG_FINISHED;
+	cursor->cursor_rows = cursor->handle_rows;
+	return DB_FINISHED;
+}
+
+/* Copy the row selected last to the tuple of cursor. */
+static void cursor_take_row(db_cursor_t *cursor)
+{
+	memcpy(cursor->tuple, cursor->handle->tuple, cursor->row_length);
+	cursor->tuple_row = cursor->handle_rows - 1;
+}
+
+/* Read a row of the cursor which has no query handle from storage. */
+static db_result_t cursor_read_row(db_cursor_t *cursor, tuple_id_t row_id)
+{
+	db_storage_id_t fd;
+	db_result_t res;
+
+	fd = storage_open(cursor->name, O_RDONLY);
+	if (fd < 0) {
+		DB_LOG_E("failed to open storage %s\n", cursor->name);
+		return DB_CURSOR_ERROR;
+	}
+	res = storage_read_from(fd, cursor->tuple, (unsigned long)row_id * cursor->row_length, cursor->row_length);
+	storage_close(fd);
+	if (DB_ERROR(res)) {
+		return DB_CURSOR_ERROR;
+	}
+
+	cursor->tuple_row = row_id;
+	return DB_OK;
+}
 
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
 
-/* Update current cursor id and storage id. */
+/* Move the cursor to a row, selecting the rows up to it. */
 db_result_t cursor_move_to(db_cursor_t *cursor, tuple_id_t row_id)
 {
 	if (IS_EMPTY_CURSOR(cursor)) {
@@ -42,49 +107,81 @@ db_result_t cursor_move_to(db_cursor_t *cursor, tuple_id_t row_id)
 		return DB_CURSOR_ERROR;
 	}
 
-	if (row_id >= DB_CURSOR_RESULT_ENTRY || row_id >= cursor->cursor_rows) {
+	if (row_id >= DB_TUPLE_LIMIT || ((cursor->flags & CURSOR_FLAG_FINISHED) && row_id >= cursor->cursor_rows)) {
 		DB_LOG_E("invalid row id\n");
 		return DB_CURSOR_ERROR;
 	}
 
-	int i, index, pos;
-	int cnt = 0;
+	if (row_id == cursor->tuple_row) {
+		cursor->current_cursor_row = row_id;
+		return DB_OK;
+	}
 
-	/* search (row_id)th set tuple id */
-	for (i = 0; i < cursor->total_rows; i++) {
-		index = GET_INDEX(i);
-		pos = GET_POS(i);
+	if (cursor->handle == NULL) {
+		if (DB_ERROR(cursor_read_row(cursor, row_id))) {
+			return DB_CURSOR_ERROR;
+		}
+		cursor->current_cursor_row = row_id;
+		return DB_OK;
+	}
 
-		if (BIT_CHECK(cursor->row_arr[index], pos)) {
-			if (cnt == row_id) {
-				cursor->current_cursor_row = row_id;
-				cursor->current_storage_row = i;
-				DB_LOG_D("set current cursor id = %d, storage id = %d\n", cursor->current_cursor_row, cursor->current_storage_row);
-				return DB_OK;
-			}
-			cnt++;
+	/* Rows selected lately are in the window. */
+	if (row_id < cursor->handle_rows && row_id + DB_CURSOR_WINDOW >= cursor->handle_rows) {
+		memcpy(cursor->tuple, cursor->window + (row_id % DB_CURSOR_WINDOW) * cursor->row_length, cursor->row_length);
+		cursor->tuple_row = row_id;
+		cursor->current_cursor_row = row_id;
+		return DB_OK;
+	}
+
+	/* The handle holds the selection state up to the row selected last
+	   only, select the rows again to move further backwards. */
+	if (row_id + 1 < cursor->handle_rows || (row_id + 1 == cursor->handle_rows && (cursor->flags & CURSOR_FLAG_FINISHED))) {
+		DB_LOG_D("DB: Rewind the cursor to move to row %lu\n", (unsigned long)row_id);
+		relation_process_rewind(cursor->handle);
+		cursor->handle_rows = 0;
+		cursor->flags &= ~CURSOR_FLAG_FINISHED;
+	}
+
+	while (cursor->handle_rows <= row_id) {
+		if (cursor_fetch(cursor) != DB_GOT_ROW) {
+			DB_LOG_D("DB: No row %lu in the cursor\n", (unsigned long)row_id);
+			return DB_CURSOR_ERROR;
 		}
 	}
-	return DB_CURSOR_ERROR;
+
+	cursor_take_row(cursor);
+	cursor->current_cursor_row = row_id;
+	DB_LOG_D("set current cursor id = %d\n", cursor->current_cursor_row);
+
+	return DB_OK;
 }
 
-/* Search the first set tuple id and update storage id corresponding it. */
+/* Move the cursor to the first row. */
 db_result_t cursor_move_first(db_cursor_t *cursor)
 {
 	return cursor_move_to(cursor, 0);
 }
 
-/* Search the last set tuple id and update storage id corresponding it. */
+/* Move the cursor to the last row, all the rows are selected. */
 db_result_t cursor_move_last(db_cursor_t *cursor)
 {
-	if (!cursor) {
+	if (IS_EMPTY_CURSOR(cursor)) {
+		return DB_CURSOR_ERROR;
+	}
+
+	/* Keep each row on the way so that the last one needs no rewind. */
+	while (cursor->handle != NULL && cursor_fetch(cursor) == DB_GOT_ROW) {
+		cursor_take_row(cursor);
+	}
+
+	if (!(cursor->flags & CURSOR_FLAG_FINISHED)) {
 		return DB_CURSOR_ERROR;
 	}
 
 	return cursor_move_to(cursor, cursor->cursor_rows - 1);
 }
 
-/* Search next set tuple id and update storage id corresponding it. */
+/* Move the cursor to the next row. */
 db_result_t cursor_move_next(db_cursor_t *cursor)
 {
 	if (!cursor) {
@@ -94,7 +191,7 @@ db_result_t cursor_move_next(db_cursor_t *cursor)
 	return cursor_move_to(cursor, cursor->current_cursor_row + 1);
 }
 
-/* Search previous set tuple id and update storage id corresponding it. */
+/* Move the cursor to the previous row. */
 db_result_t cursor_move_prev(db_cursor_t *cursor)
 {
 	if (!cursor) {
@@ -116,84 +213,39 @@ cursor_row_t cursor_get_row(db_cursor_t *cursor)
 /* Check whether cursor is pointing the first row*/
 bool cursor_is_first_row(db_cursor_t *cursor)
 {
-	int i, index, pos;
-
-	if (cursor == NULL) {
-		return false;
-	}
-	//check whether pointing cursor id is correct
-	if (cursor->current_cursor_row != 0) {
+	if (IS_INVALID_CURSOR_ROW(cursor)) {
 		return false;
 	}
-	//check whether pointing storage row id is true
-	for (i = 0; i < cursor->total_rows; i++) {
-		index = GET_INDEX(i);
-		pos = GET_POS(i);
 
-		if (BIT_CHECK(cursor->row_arr[index], pos)) {
-			if (i == cursor->current_storage_row) {
-				return true;
-			}
-			return false;
-		}
-	}
-	return false;
+	return cursor->current_cursor_row == 0;
 }
 
 /* Check whether cursor is pointing the last row*/
 bool cursor_is_last_row(db_cursor_t *cursor)
 {
-	if (cursor == NULL) {
+	if (IS_INVALID_CURSOR_ROW(cursor)) {
 		return false;
 	}
-	//check whether pointing cursor id is correct
-	if (cursor->current_cursor_row != cursor->cursor_rows - 1) {
+
+	if (cursor->current_cursor_row + 1 < cursor->cursor_rows) {
 		return false;
 	}
-	//check whether pointing storage row id is true
-	int i, index, pos;
-
-	for (i = cursor->total_rows - 1; i >= 0; i--) {
-		index = GET_INDEX(i);
-		pos = GET_POS(i);
 
-		if (BIT_CHECK(cursor->row_arr[index], pos)) {
-			if (i == cursor->current_storage_row) {
-				return true;
-			}
-			return false;
-		}
-	}
-	return false;
+	/* The current row is the last one selected, check there is no more. */
+	return cursor_fetch(cursor) == DB_FINISHED;
 }
 
-db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id)
+/* Get the number of tuples in a cursor, all the rows are selected. */
+cursor_row_t cursor_get_count(db_cursor_t *cursor)
 {
-	if (cursor == NULL) {
-		DB_LOG_E("cursor is null\n");
-		return DB_CURSOR_ERROR;
+	if (IS_EMPTY_CURSOR(cursor)) {
+		return INVALID_CURSOR_VALUE;
 	}
 
-	if (tuple_id >= DB_CURSOR_RESULT_ENTRY || tuple_id >= cursor->total_rows) {
-		DB_LOG_E("invalid tuple id error\n");
-		return DB_CURSOR_ERROR;
+	while (cursor_fetch(cursor) == DB_GOT_ROW) {
 	}
 
-	int index = GET_INDEX(tuple_id);
-	int pos = GET_POS(tuple_id);
-
-	BIT_SET(cursor->row_arr[index], pos);
-	cursor->cursor_rows++;
-
-	DB_LOG_D("cursor data added successfully : id %d, cardinality %d\n", tuple_id, cursor->cursor_rows);
-
-	return DB_OK;
-}
-
-/* Get the number of tuples in a cursor */
-cursor_row_t cursor_get_count(db_cursor_t *cursor)
-{
-	if (IS_EMPTY_CURSOR(cursor)) {
+	if (!(cursor->flags & CURSOR_FLAG_FINISHED)) {
 		return INVALID_CURSOR_VALUE;
 	}
 
@@ -247,45 +299,26 @@ attribute_id_t cursor_get_attr_index(db_cursor_t *cursor, const char *attr_name)
 	return INVALID_CURSOR_VALUE;
 }
 
-db_result_t cursor_get_value_storage(attribute_value_t *value, db_cursor_t *cursor, unsigned col)
+/* Get a value of the current row. */
+db_result_t cursor_get_row_value(attribute_value_t *value, db_cursor_t *cursor, unsigned col)
 {
-	int fd, offset;
 	attribute_t attr;
-	unsigned char *buf;
 
-	if (col >= cursor->attribute_count) {
-		DB_LOG_E("DB: Requested value (%d) is out of bounds; max = (%d)\n", col, cursor->attribute_count);
+	if (IS_INVALID_CURSOR_ROW(cursor)) {
+		DB_LOG_E("invalid cursor row id\n");
 		return DB_CURSOR_ERROR;
 	}
 
-	if (IS_INVALID_STORAGE_ROW(cursor)) {
-		DB_LOG_E("invalid storage row id\n");
+	if (col >= cursor->attribute_count) {
+		DB_LOG_E("DB: Requested value (%d) is out of bounds; max = (%d)\n", col, cursor->attribute_count);
 		return DB_CURSOR_ERROR;
 	}
 
-	buf = cursor->tuple;
-
 	memcpy(attr.name, cursor->attr_map[col].name, sizeof(attr.name));
 	attr.domain = cursor->attr_map[col].domain;
 	attr.element_size = cursor->attr_map[col].data_size;
 
-	if (cursor->attr_map[col].valuetype == AGGREGATE_VALUE) {
-		/* If the type of value is aggregate value, we don't need to read storage.
-		 Because aggregate result is already calculated and stored in buffer. */
-		buf += cursor->attr_map[col].offset;
-	} else {
-		/* Otherwise, Read tuple value from storage. */
-		offset = cursor->current_storage_row * cursor->storage_row_length + cursor->attr_map[col].offset;
-		fd = storage_open(cursor->name, O_RDONLY);
-		if (fd < 0) {
-			DB_LOG_E("failed to open storage %s\n", cursor->name);
-			return DB_CURSOR_ERROR;
-		}
-		storage_read_from(fd, buf, offset, attr.element_size);
-		storage_close(fd);
-	}
-
-	return db_phy_to_value(value, &attr, buf);
+	return db_phy_to_value(value, &attr, cursor->tuple + cursor->attr_map[col].offset);
 }
 
 db_result_t cursor_get_value(db_cursor_t *cursor, int attr_index, attribute_value_t *value, domain_t domain)
@@ -300,8 +333,8 @@ db_result_t cursor_get_value(db_cursor_t *cursor, int attr_index, attribute_valu
 		return DB_CURSOR_ERROR;
 	}
 
-	if (DB_ERROR(cursor_get_value_storage(value, cursor, attr_index))) {
-		DB_LOG_E("Failed to get value from storage\n");
+	if (DB_ERROR(cursor_get_row_value(value, cursor, attr_index))) {
+		DB_LOG_E("Failed to get value from cursor\n");
 		return DB_CURSOR_ERROR;
 	}
 
@@ -362,82 +395,78 @@ unsigned char *cursor_get_string_value(db_cursor_t *cursor, int attr_index)
 	return (unsigned char *)VALUE_STRING(&value);
 }
 
-db_result_t cursor_data_set(db_cursor_t *cursor, source_dest_map_t *attr_map, attribute_id_t attribute_count)
+/*
+ * Initialize a cursor for the rows of the result relation. The rows are laid
+ * out as the attributes of the relation, aggregated values included.
+ */
+db_result_t cursor_init(db_cursor_t *cursor, relation_t *rel)
 {
-	source_dest_map_t *attr_map_ptr;
-	int i;
+	attribute_t *attr;
+	cursor_data_map_t *map;
+	unsigned offset;
 
-	if (cursor == NULL) {
-		DB_LOG_E("DB: Invalid cursor\n");
+	if (cursor == NULL || rel == NULL) {
 		return DB_CURSOR_ERROR;
 	}
 
-	if (attr_map == NULL) {
-		DB_LOG_E("DB: Invalid attribute map\n");
-		return DB_ARGUMENT_ERROR;
+	memset(cursor, 0, sizeof(db_cursor_t));
+	cursor->current_cursor_row = INVALID_CURSOR_VALUE;
+	cursor->tuple_row = INVALID_CURSOR_VALUE;
+
+	if (rel->attribute_count > AQL_ATTRIBUTE_LIMIT) {
+		DB_LOG_E("DB: Too many attributes in the result: %d\n", rel->attribute_count);
+		return DB_CURSOR_ERROR;
 	}
 
-	attr_map_ptr = attr_map;
+	cursor->tuple = (unsigned char *)calloc(1, rel->row_length + 1);
+	if (cursor->tuple == NULL) {
+		DB_LOG_E("DB: Failed to malloc cursor tuple\n");
+		return DB_ALLOCATION_ERROR;
+	}
 
-	for (i = 0; i < attribute_count; i++) {
-		memset(cursor->attr_map[i].name, 0, sizeof(cursor->attr_map[i].name));
-		memcpy(cursor->attr_map[i].name, attr_map_ptr->to_attr->name, sizeof(attr_map_ptr->to_attr->name));
-		cursor->attr_map[i].domain = attr_map_ptr->to_attr->domain;
-		cursor->attr_map[i].valuetype = attr_map_ptr->valuetype;
-		if (cursor->attr_map[i].valuetype == AGGREGATE_VALUE) {
-			cursor->attr_map[i].data_size = attr_map_ptr->to_attr->element_size;
-			cursor->attr_map[i].offset = attr_map_ptr->to_offset;
-		} else {
-			cursor->attr_map[i].data_size = attr_map_ptr->from_attr->element_size;
-			cursor->attr_map[i].offset = attr_map_ptr->from_offset;
-		}
-		attr_map_ptr++;
+	offset = 0;
+	map = cursor->attr_map;
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		memcpy(map->name, attr->name, sizeof(map->name));
+		map->domain = attr->domain;
+		map->valuetype = attr->aggregator != 0 ? AGGREGATE_VALUE : NORMAL_VALUE;
+		map->data_size = attr->element_size;
+		map->offset = offset;
+		offset += attr->element_size;
+		map++;
 	}
 
-	cursor->attribute_count = attribute_count;
+	cursor->attribute_count = rel->attribute_count;
+	cursor->row_length = rel->row_length;
+	memcpy(cursor->name, rel->tuple_filename, sizeof(rel->tuple_filename));
+	memcpy(cursor->rel_name, rel->name, sizeof(rel->name));
 
 	return DB_OK;
 }
 
-void cursor_clean_data(db_cursor_t *cursor)
+/*
+ * Give the query handle to the cursor, which selects the rows as it moves.
+ * The first row is selected to know whether the cursor is empty.
+ */
+db_result_t cursor_attach(db_cursor_t *cursor, db_handle_t *handle)
 {
-	memset(cursor->name, 0, sizeof(cursor->name));
-	cursor->current_cursor_row = -1;
-	cursor->current_storage_row = -1;
-	cursor->cursor_rows = 0;
-	cursor->total_rows = 0;
-	cursor->attribute_count = 0;
-	cursor->storage_row_length = 0;
-	if (cursor->row_arr != NULL) {
-		free(cursor->row_arr);
-	}
-	cursor->row_arr = NULL;
-}
+	db_result_t res;
 
-db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel)
-{
-	int arr_size;
-	if (*cursor == NULL) {
-		return DB_CURSOR_ERROR;
+	cursor->window = (unsigned char *)malloc(DB_CURSOR_WINDOW * cursor->row_length);
+	if (cursor->window == NULL) {
+		DB_LOG_E("DB: Failed to malloc cursor window\n");
+		return DB_ALLOCATION_ERROR;
 	}
+	cursor->handle = handle;
+	memcpy(cursor->rel_name, handle->rel->name, sizeof(cursor->rel_name));
 
-	cursor_clean_data(*cursor);
-
-	arr_size = GET_CURSOR_DATA_ARR_SIZE(rel->cardinality);
-	if (arr_size > DB_CURSOR_LIMIT) {
-		return DB_CURSOR_ERROR;
+	res = cursor_fetch(cursor);
+	if (DB_ERROR(res)) {
+		return res;
 	}
-
-	(*cursor)->row_arr = (uint32_t *)malloc(sizeof(uint32_t) * arr_size);
-	if ((*cursor)->row_arr == NULL) {
-		return DB_CURSOR_ERROR;
+	if (res == DB_GOT_ROW) {
+		cursor_take_row(cursor);
 	}
-	memset((*cursor)->row_arr, 0, arr_size * sizeof(uint32_t));
-	(*cursor)->total_rows = rel->cardinality;
-
-	(*cursor)->storage_row_length = rel->row_length;
-	memcpy((*cursor)->name, rel->tuple_filename, sizeof(rel->tuple_filename));
-	memcpy((*cursor)->rel_name, rel->name, sizeof(rel->name));
 
 	return DB_OK;
 }
@@ -447,9 +476,17 @@ db_result_t cursor_deinit(db_cursor_t *cursor)
 	if (cursor == NULL) {
 		return DB_CURSOR_ERROR;
 	}
-	if (cursor->row_arr) {
-		free(cursor->row_arr);
-		cursor->row_arr = NULL;
+	if (cursor->handle != NULL) {
+		aql_release_handle(cursor->handle);
+		cursor->handle = NULL;
+	}
+	if (cursor->tuple != NULL) {
+		free(cursor->tuple);
+		cursor->tuple = NULL;
+	}
+	if (cursor->window != NULL) {
+		free(cursor->window);
+		cursor->window = NULL;
 	}
 	free(cursor);
 	return DB_OK;
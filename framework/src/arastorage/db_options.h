@@ -127,6 +127,20 @@
 #define AQL_ATTRIBUTE_LIMIT             6
 #endif							/* AQL_ATTRIBUTE_LIMIT */
 
+/* The maximum number of '?' parameters in a prepared statement. */
+#ifndef AQL_PARAMETER_LIMIT
+#define AQL_PARAMETER_LIMIT             AQL_ATTRIBUTE_LIMIT
+#endif							/* AQL_PARAMETER_LIMIT */
+
+/* The number of parsed queries kept by query text, 0 disables the cache. */
+#ifndef AQL_PLAN_CACHE_SIZE
+#ifdef CONFIG_ARASTORAGE_PLAN_CACHE_SIZE
+#define AQL_PLAN_CACHE_SIZE             CONFIG_ARASTORAGE_PLAN_CACHE_SIZE
+#else
+#define AQL_PLAN_CACHE_SIZE             0
+#endif
+#endif							/* AQL_PLAN_CACHE_SIZE */
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -168,16 +182,6 @@
 #define DB_TUPLE_LIMIT          2000
 #endif							/* DB_TUPLE_LIMIT */
 
-/* The number of int array in a cursor. */
-#ifndef DB_CURSOR_LIMIT
-#define DB_CURSOR_LIMIT          ((DB_TUPLE_LIMIT / (sizeof(uint32_t)*8)) + 1)
-#endif							/* DB_CURSOR_LIMIT */
-
-/* The maximum number of tuples in a cursor. */
-#ifndef DB_CURSOR_RESULT_ENTRY
-#define DB_CURSOR_RESULT_ENTRY          ((DB_CURSOR_LIMIT) * (sizeof(uint32_t)*8))
-#endif							/* DB_CURSOR_RESULT_ENTRY */
-
 /* The name of the intermediate "result" relation file, which is used
    for presenting the result of a query to a user. */
 #ifndef RESULT_RELATION
@@ -208,6 +212,29 @@
 #define TEMP_FILE_SUFFIX ".tmp"
 
 #define TEMP_FILE_SUFFIX_LENGTH 4
+
+/* The name of the write-ahead log of transactions. */
+#ifndef TRANSACTION_LOG_NAME
+#define TRANSACTION_LOG_NAME "db-wal"
+#endif							/* TRANSACTION_LOG_NAME */
+
+/* The maximum size of the rows inserted in a transaction, with their headers. */
+#ifndef DB_TRANSACTION_BUFFER_SIZE
+#ifdef CONFIG_ARASTORAGE_TRANSACTION_BUFFER_SIZE
+#define DB_TRANSACTION_BUFFER_SIZE      CONFIG_ARASTORAGE_TRANSACTION_BUFFER_SIZE
+#else
+#define DB_TRANSACTION_BUFFER_SIZE      2048
+#endif
+#endif							/* DB_TRANSACTION_BUFFER_SIZE */
+
+/* The size of the write-ahead log which triggers a checkpoint. */
+#ifndef DB_TRANSACTION_LOG_LIMIT
+#ifdef CONFIG_ARASTORAGE_TRANSACTION_LOG_LIMIT
+#define DB_TRANSACTION_LOG_LIMIT        CONFIG_ARASTORAGE_TRANSACTION_LOG_LIMIT
+#else
+#define DB_TRANSACTION_LOG_LIMIT        16384
+#endif
+#endif							/* DB_TRANSACTION_LOG_LIMIT */
 /*----------------------------------------------------------------------------*/
 
 /* Index options. */
@@ -226,9 +253,73 @@
 #define DB_HEAP_CACHE_LIMIT             6
 #endif							/* DB_HEAP_CACHE_LIMIT */
 
+/* The size of each read of a sequential scan over tuples. */
+#ifndef DB_SCAN_BLOCK_SIZE
+#ifdef CONFIG_ARASTORAGE_SCAN_BLOCK_SIZE
+#define DB_SCAN_BLOCK_SIZE              CONFIG_ARASTORAGE_SCAN_BLOCK_SIZE
+#else
+#define DB_SCAN_BLOCK_SIZE              1024
+#endif
+#endif							/* DB_SCAN_BLOCK_SIZE */
+
+/* The number of B+tree nodes cached, spread over partitions with a lock each. */
 #ifndef DB_TREE_CACHE_LIMIT
-#define DB_TREE_CACHE_LIMIT             10
+#ifdef CONFIG_ARASTORAGE_TREE_CACHE_SIZE
+#define DB_TREE_CACHE_LIMIT             CONFIG_ARASTORAGE_TREE_CACHE_SIZE
+#else
+#define DB_TREE_CACHE_LIMIT             16
 #endif
+#endif							/* DB_TREE_CACHE_LIMIT */
+
+#ifndef DB_TREE_CACHE_PARTITIONS
+#ifdef CONFIG_ARASTORAGE_TREE_CACHE_PARTITIONS
+#define DB_TREE_CACHE_PARTITIONS        CONFIG_ARASTORAGE_TREE_CACHE_PARTITIONS
+#else
+#define DB_TREE_CACHE_PARTITIONS        2
+#endif
+#endif							/* DB_TREE_CACHE_PARTITIONS */
+
+/* Each partition holds from 8 to 254 nodes, so adjust the partitions to the cache size. */
+#if DB_TREE_CACHE_PARTITIONS > DB_TREE_CACHE_LIMIT / 8
+#undef DB_TREE_CACHE_PARTITIONS
+#define DB_TREE_CACHE_PARTITIONS        (DB_TREE_CACHE_LIMIT / 8)
+#elif DB_TREE_CACHE_LIMIT / DB_TREE_CACHE_PARTITIONS > 254
+#undef DB_TREE_CACHE_PARTITIONS
+#define DB_TREE_CACHE_PARTITIONS        ((DB_TREE_CACHE_LIMIT + 253) / 254)
+#endif
+
+/* The memory to sort index entries in when an index is bulk loaded. */
+#ifndef DB_INDEX_SORT_MEMORY
+#ifdef CONFIG_ARASTORAGE_INDEX_SORT_MEMORY
+#define DB_INDEX_SORT_MEMORY            CONFIG_ARASTORAGE_INDEX_SORT_MEMORY
+#else
+#define DB_INDEX_SORT_MEMORY            2048
+#endif
+#endif							/* DB_INDEX_SORT_MEMORY */
+
+/* Runs are merged from blocks of 16 entries of 16 bytes, at least 3 at once. */
+#if DB_INDEX_SORT_MEMORY < 1024
+#undef DB_INDEX_SORT_MEMORY
+#define DB_INDEX_SORT_MEMORY            1024
+#endif
+
+/* The number of rows selected last that a cursor keeps to move backwards. */
+#ifndef DB_CURSOR_WINDOW
+#ifdef CONFIG_ARASTORAGE_CURSOR_WINDOW
+#define DB_CURSOR_WINDOW                CONFIG_ARASTORAGE_CURSOR_WINDOW
+#else
+#define DB_CURSOR_WINDOW                8
+#endif
+#endif							/* DB_CURSOR_WINDOW */
+
+/* The names of the temporary files of index entries sorted in runs. */
+#ifndef INDEX_SORT_FILE_NAME
+#define INDEX_SORT_FILE_NAME "db-sort"
+#endif							/* INDEX_SORT_FILE_NAME */
+
+#ifndef INDEX_MERGE_FILE_NAME
+#define INDEX_MERGE_FILE_NAME "db-merge"
+#endif							/* INDEX_MERGE_FILE_NAME */
 
 #ifdef DB_WIP
 #undef DB_WIP						/* DB WORK IN PROGRESS */
@@ -249,6 +340,12 @@
 #define LVM_MAX_VARIABLE_ID             AQL_ATTRIBUTE_LIMIT - 1
 #endif							/* LVM_MAX_VARIABLE_ID */
 
+/* The maximum number of string constants in a condition. Each of them
+   takes DB_MAX_ELEMENT_SIZE bytes in the LVM instance. */
+#ifndef LVM_MAX_STRING_ID
+#define LVM_MAX_STRING_ID               2
+#endif							/* LVM_MAX_STRING_ID */
+
 /* Specify whether floats should be used or not inside the LVM. */
 #ifndef LVM_USE_FLOATS
 #define LVM_USE_FLOATS                  DB_FEATURE_FLOATS
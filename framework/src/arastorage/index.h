@@ -68,6 +68,11 @@
 #define INDEX_API_INLINE        0x04
 #define INDEX_API_COMPLETE      0x08
 #define INDEX_API_RANGE_QUERIES 0x10
+#define INDEX_API_STRING_KEYS   0x20
+
+#define INDEX_SUMMARY_MIN       0x01
+#define INDEX_SUMMARY_MAX       0x02
+#define INDEX_SUMMARY_ALL       0x04
 
 /****************************************************************************
 * Public Type Definitions
@@ -106,9 +111,36 @@ struct index_iterator_s {
 	attribute_value_t max_value;
 	tuple_id_t next_item_no;
 	tuple_id_t found_items;
+	/* State kept by the index between calls of get_next, so that any number
+	 * of iterators can be open on the same index at once.
+	 */
+	union {
+		struct {
+			tuple_id_t start;
+			tuple_id_t end;
+		} range;				/* Inline index: the range of tuple ids found */
+		struct {
+			void *bucket;
+			uint16_t bucket_id;
+			uint8_t start;
+			uint8_t end;
+		} bucket;				/* B+tree index: the position in the current bucket */
+	} cache;
 };
 typedef struct index_iterator_s index_iterator_t;
 
+/* Aggregates of the keys in a range of an index. The count and the sum are
+ * computed with INDEX_SUMMARY_ALL only, otherwise a zero count tells that no
+ * key is in the range.
+ */
+struct index_summary_s {
+	tuple_id_t count;
+	long min;
+	long max;
+	double sum;
+};
+typedef struct index_summary_s index_summary_t;
+
 struct index_api_s {
 	index_type_t type;
 	uint8_t flags;
@@ -119,10 +151,32 @@ struct index_api_s {
 	db_result_t(*insert)(index_t *, attribute_value_t *, tuple_id_t);
 	db_result_t(*delete)(index_t *, attribute_value_t *);
 	tuple_id_t(*get_next)(index_iterator_t *, uint8_t);
+	db_result_t(*flush)(index_t *);
+	db_result_t(*bulk_load)(index_t *);
+	void (*release_iterator)(index_iterator_t *);
+	db_result_t(*summarize)(index_t *, attribute_value_t *, attribute_value_t *, uint8_t, index_summary_t *);
 };
 
 typedef struct index_api_s index_api_t;
 
+#ifdef CONFIG_ARASTORAGE_CACHE_STATS
+/* Lookups of the B+tree node and bucket caches. The counters are updated
+ * under the lock of the cache looked up only, so they are approximate while
+ * several indexes are used at the same time.
+ */
+struct index_cache_stats_s {
+	unsigned long node_hits;
+	unsigned long node_misses;
+	unsigned long bucket_hits;
+	unsigned long bucket_misses;
+};
+
+extern struct index_cache_stats_s g_index_cache_stats;
+#define INDEX_CACHE_STAT(counter) (g_index_cache_stats.counter++)
+#else
+#define INDEX_CACHE_STAT(counter)
+#endif
+
 /****************************************************************************
 * Public Variables
 ****************************************************************************/
@@ -137,10 +191,15 @@ db_result_t index_create(index_type_t, relation_t *, attribute_t *);
 db_result_t index_destroy(index_t *);
 db_result_t index_load(relation_t *, attribute_t *);
 db_result_t index_release(index_t *);
+db_result_t index_flush(void);
+db_result_t index_rebuild(relation_t *);
+db_result_t index_rebuild_attribute(relation_t *, attribute_t *);
 db_result_t index_insert(index_t *, attribute_value_t *, tuple_id_t);
 db_result_t index_delete(index_t *, attribute_value_t *);
 db_result_t index_get_iterator(index_iterator_t *, index_t *, attribute_value_t *, attribute_value_t *);
 tuple_id_t index_get_next(index_iterator_t *, uint8_t);
+void index_release_iterator(index_iterator_t *);
+db_result_t index_summarize(index_t *, attribute_value_t *, attribute_value_t *, uint8_t, index_summary_t *);
 int index_exists(attribute_t *);
 db_result_t index_deinit(void);
 #endif							/* !INDEX_H */
@@ -54,6 +54,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <pthread.h>
+#include <sched.h>
 #include <time.h>
 #include <sys/types.h>
 
@@ -75,12 +76,24 @@
 #define NODE_DEPTH      2
 #define LEAF_NODES      pow(BRANCH_FACTOR, NODE_DEPTH)
 #define EMPTY_NODE(node)        (node)->val[BRANCH_FACTOR-1] == 0
-#define KEY_MAX INT_MAX
+#define KEY_MAX DB_KEY_MAX
 #define ROW_XOR 0xf6U
 #define NODE_STATE_VALID 1
 #define NODE_STATE_LOCK 2
 #define NODE_STATE_DIRTY 4
 #define ROOT_NODE_PARENT 255
+#define TREE_CACHE_NONE 0xff
+#define TREE_CACHE_PARTITION_SIZE (DB_TREE_CACHE_LIMIT / DB_TREE_CACHE_PARTITIONS)
+
+/* Entries read from each run at once while merging runs in bulk loading */
+#define BULK_MERGE_BLOCK 16
+#define BULK_SORT_PAIRS (DB_INDEX_SORT_MEMORY / sizeof(pair_t))
+#define BULK_FAN_IN (BULK_SORT_PAIRS / BULK_MERGE_BLOCK - 1)
+
+/* Nodes pinned along an insertion path must fit in a partition */
+#if TREE_CACHE_PARTITION_SIZE < 8 || TREE_CACHE_PARTITION_SIZE >= TREE_CACHE_NONE
+#error "Each partition of the tree node cache must hold from 8 to 254 nodes"
+#endif
 
 /* The total number of states possible of a node */
 #define NODE_STATES 255
@@ -129,13 +142,13 @@
  * Private Types
  ****************************************************************************/
 struct key_value_pair_s {
-	int key;
+	db_key_t key;
 	uint16_t value;
 };
 typedef struct key_value_pair_s pair_t;
 
 struct tree_node_s {
-	int val[BRANCH_FACTOR];
+	db_key_t val[BRANCH_FACTOR];
 	uint16_t id[BRANCH_FACTOR];
 	uint16_t is_leaf;
 };
@@ -144,7 +157,7 @@ typedef struct tree_node_s tree_node_t;
 struct bucket_s {
 	pair_t pairs[BUCKET_SIZE];
 	uint8_t next_free_slot;
-	int info[3];
+	db_key_t info[3];
 };
 typedef struct bucket_s bucket_t;
 
@@ -171,6 +184,21 @@ struct bucket_cache_s {
 /* A Tree Cache Entry */
 struct tree_cache_s {
 	tree_node_t node;
+	uint8_t id;					/* Node id, meaningful only in a valid entry */
+	uint8_t node_state;
+	uint8_t pins;				/* Number of users of the node, a pinned entry is never evicted */
+	uint8_t referenced;			/* Second chance bit of the clock eviction */
+	uint8_t hash_next;			/* Next entry in the same hash chain */
+};
+
+/* A partition of Tree Cache. Nodes are spread over partitions by id,
+ * so lookups of nodes in different partitions don't contend on a lock.
+ */
+struct tree_cache_partition_s {
+	struct tree_cache_s cache_t[TREE_CACHE_PARTITION_SIZE];
+	uint8_t hash[TREE_CACHE_PARTITION_SIZE];	/* Heads of hash chains */
+	uint8_t hand;				/* Clock hand, the next entry to consider for eviction */
+	pthread_mutex_t lock;
 };
 
 /* Bucket Cache Structure */
@@ -182,9 +210,7 @@ typedef struct {
 
 /* Tree Cache Structure */
 typedef struct {
-	struct tree_cache_s cache_t[DB_TREE_CACHE_LIMIT];
-	queue_t in_cache;
-	uint8_t num;
+	struct tree_cache_partition_s part[DB_TREE_CACHE_PARTITIONS];
 } tree_cache_t;
 
 typedef enum {
@@ -225,7 +251,8 @@ enum tree_result_e {
 	TREE_LOCK_ERROR = -3,
 	TREE_READ_FAIL = -2,
 	TREE_INSERT_FAIL = -1,
-	TREE_OK = 0
+	TREE_OK = 0,
+	TREE_BUSY = 1				/* Locked by another task, try again */
 };
 typedef enum bsplit_status_e bsplit_status_t;
 typedef enum cache_result_e cache_result_t;
@@ -243,13 +270,41 @@ struct tree_s {
 	uint8_t levels;				/*  The depth of the bplus-tree including the buckets  */
 	tree_cache_t *node_cache;	/*  Structure to maintain node cache  */
 	bucket_cache_t *buck_cache;	/*   Structure to maintain bucket cache  */
-	pthread_mutex_t node_cache_lock;	/*  Maintains concurrency control over Node Cache  */
+	pthread_mutex_t node_cache_lock;	/*  Unused, partitions of Node Cache have their own locks. Kept for the layout of the index file  */
 	pthread_mutex_t buck_cache_lock;	/*  Maintains concurrency control over Bucket Cache  */
 	pthread_mutex_t bucket_lock;	/*  Maintains serialisability over in RAM Tree Structure  */
 	struct rw_lock_s tree_lock;	/*  A Reader Writer Lock used to maintain consistency in tree structure */
 };
 typedef struct tree_s tree_t;
 
+/* A sorted run of index entries in the sort file of bulk loading */
+struct bulk_run_s {
+	unsigned long next;			/* The next entry of the run to read */
+	unsigned long end;			/* The entry following the run */
+	pair_t *block;				/* Entries read from the run */
+	int pos;
+	int count;
+};
+
+/* State of building a tree bottom-up from sorted index entries */
+struct bulk_load_s {
+	tree_t *tree;
+	bucket_t bucket;			/* The bucket being filled */
+	uint16_t ids[CONFIG_BUCKETS_LIMIT];	/* Children of the level being built */
+	db_key_t bounds[CONFIG_BUCKETS_LIMIT];	/* The largest key under each child */
+	int count;					/* Number of children */
+	pair_t *pairs;				/* Sort buffer of DB_INDEX_SORT_MEMORY bytes */
+	struct bulk_run_s runs[BULK_FAN_IN];
+	unsigned long written;		/* Entries written to the output file of a merge */
+};
+
+/****************************************************************************
+ * Public variables
+ ****************************************************************************/
+#ifdef CONFIG_ARASTORAGE_CACHE_STATS
+struct index_cache_stats_s g_index_cache_stats;
+#endif
+
 /****************************************************************************
  * Private variables
  ****************************************************************************/
@@ -258,22 +313,26 @@ static int base_offset = 0;
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
-static int transform_key(int);
+static db_key_t transform_key(attribute_value_t *);
 static tree_node_t *tree_read(tree_t *, int);
 static int tree_write(tree_t *, int, tree_node_t *);
-static tree_result_t tree_insert(tree_t *, int);
-static pair_t *tree_find(tree_t *, int key);
-tree_result_t insert_item_btree(tree_t *, int, int);
+static tree_result_t tree_insert(tree_t *, db_key_t);
+static tree_result_t tree_find(tree_t *, db_key_t key, pair_t **);
+tree_result_t insert_item_btree(tree_t *, db_key_t, int);
 
-static bucket_t *bucket_read(tree_t *, int);
+static bucket_t *bucket_read(tree_t *, int, tree_result_t *);
 static int bucket_write(tree_t *, int, bucket_t *);
-static bsplit_status_t bucket_split(tree_t *, int, int, pair_t *);
+static bsplit_status_t bucket_split(tree_t *, db_key_t, int, pair_t *);
 static cache_result_t cache_bucket_append(tree_t *, int, pair_t *);
 static cache_result_t cache_write_bucket(tree_t *, int, bucket_t *);
 
 static cache_result_t modify_cache(tree_t *, int, cache_type_t, op_type_t);
 static cache_result_t cache_write_node(tree_t *, int, tree_node_t *);
 static cache_result_t cache_replace_node(tree_t *, int, tree_node_t *);
+static tree_cache_t *node_cache_alloc(void);
+static void node_cache_free(tree_cache_t *);
+static void node_cache_flush(tree_t *);
+static cache_result_t node_cache_modify(tree_t *, int, op_type_t);
 
 static db_result_t create(index_t *);
 static db_result_t destroy(index_t *);
@@ -282,6 +341,10 @@ static db_result_t release(index_t *);
 static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
 static db_result_t delete(index_t *, attribute_value_t *);
 static tuple_id_t get_next(index_iterator_t *, uint8_t);
+static db_result_t flush(index_t *);
+static db_result_t bulk_load(index_t *);
+static void release_iterator(index_iterator_t *);
+static db_result_t summarize(index_t *, attribute_value_t *, attribute_value_t *, uint8_t, index_summary_t *);
 
 #ifdef DB_WIP
 static db_result_t vacuum(tree_t *, relation_t *);
@@ -295,14 +358,18 @@ static int db_flush(tree_t *, relation_t *);
 
 index_api_t index_bplustree = {
 	INDEX_BPLUSTREE,
-	INDEX_API_EXTERNAL | INDEX_API_RANGE_QUERIES,
+	INDEX_API_EXTERNAL | INDEX_API_RANGE_QUERIES | INDEX_API_STRING_KEYS,
 	create,
 	destroy,
 	load,
 	release,
 	insert,
 	delete,
-	get_next
+	get_next,
+	flush,
+	bulk_load,
+	release_iterator,
+	summarize
 };
 
 /****************************************************************************
@@ -353,7 +420,7 @@ static db_result_t create(index_t *index)
 	}
 
 	/* Generating the file to store the tree structure */
-	snprintf(tree_filename, HEAP_FILE_LENGTH, "%s.%x\0", HEAP_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(tree_filename, HEAP_FILE_LENGTH, "%s.%x", HEAP_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 
 	result = storage_generate_file(tree_filename);
 	if (result == DB_INDEX_ERROR) {
@@ -366,7 +433,7 @@ static db_result_t create(index_t *index)
 	DB_LOG_D("DB: Generated the tree file \"%s\" using %lu bytes of space\n", index->descriptor_file, (unsigned long)CONFIG_NODE_LIMIT * sizeof(tree_node_t));
 
 	/* Generating bucket file to store <key, tuple_id> pair */
-	snprintf(bucket_filename, BUCKET_FILE_LENGTH, "%s.%x\0", BUCKET_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(bucket_filename, BUCKET_FILE_LENGTH, "%s.%x", BUCKET_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 
 	result = storage_generate_file(bucket_filename);
 	if (result == DB_INDEX_ERROR) {
@@ -416,36 +483,12 @@ static db_result_t create(index_t *index)
 	memset(&tree->lock_buckets, 0, sizeof(tree->lock_buckets));
 
 	/* Allocating node cache and initialising it */
-	tree->node_cache = malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
+	tree->node_cache = node_cache_alloc();
+	if (tree->node_cache == NULL) {
 		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
 		result = DB_ALLOCATION_ERROR;
 		storage_remove(tree_filename);
 		storage_remove(bucket_filename);
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
 		free(tree);
 		return result;
 	}
@@ -474,9 +517,7 @@ static db_result_t create(index_t *index)
 	if (success != 7) {
 		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
 		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
-		free(tree->node_cache);
+		node_cache_free(tree->node_cache);
 		storage_remove(tree_filename);
 		storage_remove(bucket_filename);
 		if (success & 1) {
@@ -516,7 +557,8 @@ static db_result_t destroy(index_t *index)
 	db_storage_id_t fd;
 	size_t r;
 	char bucket_file[DB_MAX_FILENAME_LENGTH];
-	if (DB_ERROR(release(index))) {
+	/* An index which isn't loaded is destroyed from its files only */
+	if (index->opaque_data != NULL && DB_ERROR(release(index))) {
 		return DB_INDEX_ERROR;
 	}
 	fd = storage_open(index->descriptor_file, O_RDWR);
@@ -570,34 +612,10 @@ static db_result_t load(index_t *index)
 	}
 	storage_close(fd);
 
-	tree->node_cache = malloc(sizeof(tree_cache_t));
-	if (tree->node_cache != NULL) {
-		success |= 1;
-		qnode_t *head = (qnode_t *)malloc(sizeof(qnode_t));
-		if (head != NULL) {
-			success |= 2;
-			tree->node_cache->in_cache.head = head;
-			qnode_t *end = (qnode_t *)malloc(sizeof(qnode_t));
-			if (end != NULL) {
-				success |= 4;
-				head->prev = NULL;
-				end->next = NULL;
-				head->next = end;
-				end->prev = head;
-				tree->node_cache->in_cache.tail = end;
-				tree->node_cache->num = 0;
-			}
-		}
-	}
-	if (success != 7) {
+	tree->node_cache = node_cache_alloc();
+	if (tree->node_cache == NULL) {
 		DB_LOG_E("FAILED TO ALLOCATE NODE CACHE\n");
 		result = DB_ALLOCATION_ERROR;
-		if (success & 1) {
-			if (success & 2) {
-				free(tree->node_cache->in_cache.head);
-			}
-			free(tree->node_cache);
-		}
 		free(tree);
 		return result;
 	}
@@ -626,9 +644,7 @@ static db_result_t load(index_t *index)
 	if (success != 7) {
 		DB_LOG_E("FAILED TO ALLOCATE BUCKET CACHE\n");
 		result = DB_ALLOCATION_ERROR;
-		free(tree->node_cache->in_cache.tail);
-		free(tree->node_cache->in_cache.head);
-		free(tree->node_cache);
+		node_cache_free(tree->node_cache);
 		if (success & 1) {
 			if (success & 2) {
 				free(tree->buck_cache->in_cache.head);
@@ -661,9 +677,6 @@ static db_result_t release(index_t *index)
 	if (tree->node_cache == NULL || tree->buck_cache == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	if ((tree->node_cache->in_cache.tail == NULL) || (tree->node_cache->in_cache.head == NULL)) {
-		return DB_ALLOCATION_ERROR;
-	}
 	if ((tree->buck_cache->in_cache.tail == NULL) || (tree->buck_cache->in_cache.head == NULL)) {
 		return DB_ALLOCATION_ERROR;
 	}
@@ -682,27 +695,60 @@ static db_result_t release(index_t *index)
 		}
 	}
 	free(tree->buck_cache->in_cache.tail);
-	tmp_node = tree->node_cache->in_cache.head->next;
-	free(tmp_node->prev);
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-		}
-		tmp_node = tmp_node->next;
-		if (tmp_node->prev) {
-			free(tmp_node->prev);
-		}
-	}
-	free(tree->node_cache->in_cache.tail);
+	node_cache_flush(tree);
 	storage_close(tree->bucket_storage);
 	storage_close(tree->tree_storage);
 
-	free(tree->node_cache);
+	node_cache_free(tree->node_cache);
 	free(tree->buck_cache);
 	free(tree);
 	return DB_OK;
 }
 
+/****************************************************************************
+ * Name: flush
+ *
+ * Description: Writes the tree structure and the dirty buckets and nodes in
+ *              cache to flash, and syncs the files. The cache stays valid.
+ *
+ ****************************************************************************/
+static db_result_t flush(index_t *index)
+{
+	tree_t *tree;
+	qnode_t *tmp_node;
+	db_result_t result = DB_OK;
+
+	tree = index->opaque_data;
+	if (tree == NULL || tree->node_cache == NULL || tree->buck_cache == NULL) {
+		return DB_OK;
+	}
+
+	if (DB_ERROR(storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t)))) {
+		result = DB_STORAGE_ERROR;
+	}
+
+	pthread_mutex_lock(&(tree->buck_cache_lock));
+	tmp_node = tree->buck_cache->in_cache.head->next;
+	while (tmp_node != tree->buck_cache->in_cache.tail) {
+		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
+			if (bucket_write(tree, tmp_node->id, &(tree->buck_cache->cache_t[tmp_node->pos].bucket))) {
+				UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
+			} else {
+				result = DB_STORAGE_ERROR;
+			}
+		}
+		tmp_node = tmp_node->next;
+	}
+	pthread_mutex_unlock(&(tree->buck_cache_lock));
+
+	node_cache_flush(tree);
+
+	if (DB_ERROR(storage_sync(tree->tree_storage)) || DB_ERROR(storage_sync(tree->bucket_storage))) {
+		result = DB_STORAGE_ERROR;
+	}
+	return result;
+}
+
 /****************************************************************************
  * Name: insert
  *
@@ -714,10 +760,10 @@ static db_result_t release(index_t *index)
 static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t value)
 {
 	tree_t *tree;
-	long long_key;
+	db_key_t int_key;
 
 	tree = (tree_t *)index->opaque_data;
-	long_key = db_value_to_long(key);
+	int_key = transform_key(key);
 
 #ifdef CONFIG_ARASTORAGE_ENABLE_FLUSHING
 	if ((tree->inserted) >= DB_TUPLES_LIMIT) {
@@ -725,8 +771,8 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 		value = value - DB_TUPLES_LIMIT / 2;
 	}
 #endif
-	if (insert_item_btree(tree, (int)long_key, (int)value) == TREE_INSERT_FAIL) {
-		DB_LOG_E("DB: Failed to insert key %ld into a bplus-tree index\n", long_key);
+	if (insert_item_btree(tree, int_key, (int)value) == TREE_INSERT_FAIL) {
+		DB_LOG_E("DB: Failed to insert key %lld into a bplus-tree index\n", (long long)int_key);
 		return DB_INDEX_ERROR;
 	}
 
@@ -749,14 +795,7 @@ static db_result_t insert(index_t *index, attribute_value_t *key, tuple_id_t val
 		}
 		tmp_node = tmp_node->next;
 	}
-	tmp_node = tree->node_cache->in_cache.head->next;
-	while (tmp_node != tree->node_cache->in_cache.tail) {
-		if ((tmp_node->node_state & NODE_STATE_DIRTY) && (tmp_node->node_state & NODE_STATE_VALID)) {
-			tree_write(tree, tmp_node->id, &(tree->node_cache->cache_t[tmp_node->pos].node));
-			UNSET_NODE_STATE(tmp_node, NODE_STATE_DIRTY);
-		}
-		tmp_node = tmp_node->next;
-	}
+	node_cache_flush(tree);
 #endif
 	return DB_OK;
 }
@@ -784,6 +823,35 @@ static uint16_t next_bucket(tree_t *tree, bucket_t *bucket)
 	return next_bucket;
 }
 
+/****************************************************************************
+ * Name: read_locked_bucket
+ *
+ * Description: Reads a bucket locked in lock_buckets by an iteration, which
+ *              holds the read lock of the tree. It waits while the bucket
+ *              cache is locked by other tasks. When the bucket can't be read,
+ *              the bucket and the tree are unlocked and NULL is returned.
+ *
+ ****************************************************************************/
+static bucket_t *read_locked_bucket(tree_t *tree, uint16_t bucket_id)
+{
+	bucket_t *bucket;
+	tree_result_t status;
+
+	while ((bucket = bucket_read(tree, bucket_id, &status)) == NULL) {
+		if (status != TREE_BUSY) {
+			DB_LOG_E("DB: Failed to read bucket %d\n", bucket_id);
+			pthread_mutex_lock(&(tree->bucket_lock));
+			tree->lock_buckets[bucket_id] = 0;
+			pthread_mutex_unlock(&(tree->bucket_lock));
+			rw_unlock_read(&(tree->tree_lock));
+			return NULL;
+		}
+		DB_LOG_D("BUCKET CACHE FULL SPINNING\n");
+		sched_yield();
+	}
+	return bucket;
+}
+
 /****************************************************************************
  * Name: get_next
  *
@@ -793,141 +861,731 @@ static uint16_t next_bucket(tree_t *tree, bucket_t *bucket)
  ****************************************************************************/
 static tuple_id_t get_next(index_iterator_t *iterator, uint8_t matched_condition)
 {
-
-	/* This cache holds a pointer to a bucket in the main cache and other
-	 * information required to iterate over the bucket
-	 */
-	struct iteration_cache {
-		index_iterator_t *index_iterator;
-		uint16_t bucket_id;
-		bucket_t *bucket;
-		tuple_id_t found_items;
-		uint8_t start;
-		uint8_t end;
-	};
 	int i;
-	static struct iteration_cache cache;
-	int key_max;
-	int key_min;
+	db_key_t key_max;
+	db_key_t key_min;
 	tree_t *tree;
-	key_min = *(int *)&iterator->min_value;
-	key_max = *(int *)&iterator->max_value;
+	bucket_t *bucket;
+	uint16_t next_id;
+	pair_t *path;
+	tree_result_t status;
+
+	/* The iterator holds the bucket being iterated, pinned in the bucket cache,
+	 * and the range of its key-value pairs which are not visited yet.
+	 */
+	key_min = transform_key(&iterator->min_value);
+	key_max = transform_key(&iterator->max_value);
 	tree = (tree_t *)iterator->index->opaque_data;
 
-	/* To initialize the iterator_cache */
+	/* To initialize the iteration */
 	if (iterator->next_item_no == 0) {	/* removed the condition of iterator inequality */
 		if (iterator->found_items == 0) {
-			rw_lock_write(&(tree->tree_lock));
-			pair_t *path = tree_find(tree, key_min);
-			if (path == NULL) {
+			/* The first bucket may be locked by another iterator or an insertion */
+			while (true) {
+				rw_lock_read(&(tree->tree_lock));
+				status = tree_find(tree, key_min, &path);
+				if (status != TREE_BUSY) {
+					break;
+				}
+				rw_unlock_read(&(tree->tree_lock));
+				DB_LOG_D("BUCKET ALREADY LOCKED IN GET NEXT SPINNING\n");
+				sched_yield();
+			}
+			if (status != TREE_OK) {
+				DB_LOG_E("DB: Failed to find the first bucket of iteration\n");
+				rw_unlock_read(&(tree->tree_lock));
 				return INVALID_TUPLE;
 			}
-			uint16_t bucket_id = path[tree->levels].key;
+			iterator->cache.bucket.bucket_id = path[tree->levels].key;
 			free(path);
-			/* TODO
-			 * Absent of non-cast return handling, should be taken care in the definition
-			 */
-			cache.bucket = bucket_read(tree, bucket_id);
-			cache.bucket_id = bucket_id;
-			cache.start = 0;
-			cache.end = cache.bucket->next_free_slot;
+			bucket = read_locked_bucket(tree, iterator->cache.bucket.bucket_id);
+			if (bucket == NULL) {
+				return INVALID_TUPLE;
+			}
+			iterator->cache.bucket.bucket = bucket;
+			iterator->cache.bucket.start = 0;
+			iterator->cache.bucket.end = bucket->next_free_slot;
 		}
 	}
+	bucket = (bucket_t *)iterator->cache.bucket.bucket;
 
 	/* Iterate over the key-value pairs in the bucket and find the ones which satisfy the condition */
-	for (i = cache.start; i < cache.end; i++) {
-		if ((key_min <= cache.bucket->pairs[i].key) && (cache.bucket->pairs[i].key <= key_max)) {
+	for (i = iterator->cache.bucket.start; i < iterator->cache.bucket.end; i++) {
+		if ((key_min <= bucket->pairs[i].key) && (bucket->pairs[i].key <= key_max)) {
 			iterator->found_items++;
 			iterator->next_item_no = iterator->found_items;
 
 			/* matched condition is FALSE when the query is for remove tuples */
 			if (matched_condition == FALSE) {
-				tuple_id_t tmp = cache.bucket->pairs[i].value;
-				if (cache.end > (i + 1)) {
-					cache.bucket->pairs[i] = cache.bucket->pairs[cache.end - 1];
+				tuple_id_t tmp = bucket->pairs[i].value;
+				if (iterator->cache.bucket.end > (i + 1)) {
+					bucket->pairs[i] = bucket->pairs[iterator->cache.bucket.end - 1];
 
 					/* Start Bucket chaining */
 					int iter = 0;
-					uint16_t new_min = cache.bucket->info[1];
-					uint16_t new_max = cache.bucket->info[2];
-					for (; iter < cache.bucket->next_free_slot - 1; iter++) {
-						new_min = min(cache.bucket->pairs[iter].key, new_min);
-						new_max = max(cache.bucket->pairs[iter].key, new_max);
+					db_key_t new_min = bucket->info[1];
+					db_key_t new_max = bucket->info[2];
+					for (; iter < bucket->next_free_slot - 1; iter++) {
+						new_min = min(bucket->pairs[iter].key, new_min);
+						new_max = max(bucket->pairs[iter].key, new_max);
 					}
-					cache.bucket->info[1] = new_min;
-					cache.bucket->info[2] = new_max;
+					bucket->info[1] = new_min;
+					bucket->info[2] = new_max;
 					/* End of Bucket chaining */
 				}
-
-				cache.bucket->next_free_slot--;
-				tree->deleted++;
-				cache.end--;
-				cache.start = i;
-				return tmp;
-			} else {
-				cache.start = i + 1;
+
+				bucket->next_free_slot--;
+				tree->deleted++;
+				iterator->cache.bucket.end--;
+				iterator->cache.bucket.start = i;
+				return tmp;
+			} else {
+				iterator->cache.bucket.start = i + 1;
+			}
+			return bucket->pairs[i].value;
+		}
+	}
+
+	/* The bucket may be evicted once it's unlocked, find the next one before */
+	next_id = next_bucket(tree, bucket);
+
+	/* case when delete query comes */
+	if (matched_condition == FALSE) {
+		modify_cache(tree, iterator->cache.bucket.bucket_id, BUCKET, INVALIDATE);
+		cache_write_bucket(tree, iterator->cache.bucket.bucket_id, bucket);
+#ifdef DB_WIP
+		if ((int)((double)(tree->deleted) * 100 / tree->inserted) >= VACUUM_THRESHOLD) {
+			vacuum(tree, iterator->index->rel);
+		}
+#endif
+	} else {
+		modify_cache(tree, iterator->cache.bucket.bucket_id, BUCKET, UNLOCK);
+	}
+	pthread_mutex_lock(&(tree->bucket_lock));
+	tree->lock_buckets[iterator->cache.bucket.bucket_id] = 0;
+	iterator->cache.bucket.bucket_id = next_id;
+	iterator->cache.bucket.bucket = NULL;
+	if (iterator->cache.bucket.bucket_id == (uint16_t)-1) {
+		if (iterator->found_items == 0) {
+			iterator->next_item_no = 0;
+		} else {
+			iterator->next_item_no = 1;
+		}
+		pthread_mutex_unlock(&(tree->bucket_lock));
+		rw_unlock_read(&(tree->tree_lock));
+		return INVALID_TUPLE;
+	}
+	while (tree->lock_buckets[iterator->cache.bucket.bucket_id] == 1) {
+		pthread_mutex_unlock(&(tree->bucket_lock));
+		DB_LOG_D("BUCKET ALREADY LOCKED IN GET NEXT SPINNING\n");
+		sched_yield();
+		pthread_mutex_lock(&(tree->bucket_lock));
+	}
+	tree->lock_buckets[iterator->cache.bucket.bucket_id] = 1;
+	pthread_mutex_unlock(&(tree->bucket_lock));
+
+	bucket = read_locked_bucket(tree, iterator->cache.bucket.bucket_id);
+	if (bucket == NULL) {
+		if (iterator->found_items == 0) {
+			iterator->next_item_no = 0;
+		} else {
+			iterator->next_item_no = 1;
+		}
+		return INVALID_TUPLE;
+	}
+	iterator->cache.bucket.bucket = bucket;
+	iterator->cache.bucket.start = 0;
+	iterator->cache.bucket.end = bucket->next_free_slot;
+	if (bucket->info[1] > key_max) {
+		modify_cache(tree, iterator->cache.bucket.bucket_id, BUCKET, UNLOCK);
+		if (iterator->found_items == 0) {
+			iterator->next_item_no = 0;
+		} else {
+			iterator->next_item_no = 1;
+		}
+		pthread_mutex_lock(&(tree->bucket_lock));
+		tree->lock_buckets[iterator->cache.bucket.bucket_id] = 0;
+		pthread_mutex_unlock(&(tree->bucket_lock));
+		iterator->cache.bucket.bucket = NULL;
+		rw_unlock_read(&(tree->tree_lock));
+		return INVALID_TUPLE;
+
+	}
+	iterator->next_item_no = 1;
+	return get_next(iterator, matched_condition);
+}
+
+/****************************************************************************
+ * Name: release_iterator
+ *
+ * Description: Ends an iteration before get_next has returned the last item.
+ *              The bucket pinned by the iterator is unlocked and the read
+ *              lock of the tree is dropped, as get_next does at the end.
+ *
+ ****************************************************************************/
+static void release_iterator(index_iterator_t *iterator)
+{
+	tree_t *tree;
+
+	if (iterator->cache.bucket.bucket == NULL) {
+		return;
+	}
+
+	tree = (tree_t *)iterator->index->opaque_data;
+	modify_cache(tree, iterator->cache.bucket.bucket_id, BUCKET, UNLOCK);
+	pthread_mutex_lock(&(tree->bucket_lock));
+	tree->lock_buckets[iterator->cache.bucket.bucket_id] = 0;
+	pthread_mutex_unlock(&(tree->bucket_lock));
+	iterator->cache.bucket.bucket = NULL;
+	rw_unlock_read(&(tree->tree_lock));
+}
+
+
+
+/****************************************************************************
+ * Name: summarize_buckets
+ *
+ * Description: Helper function for summarize.
+ *              Aggregates the keys in the range [key_min, key_max] from the
+ *              bucket where start_key belongs, in increasing order of keys.
+ *              With first_only, it stops at the first bucket having a key in
+ *              the range. Buckets are locked one at a time as get_next does.
+ *
+ ****************************************************************************/
+static db_result_t summarize_buckets(tree_t *tree, db_key_t start_key, db_key_t key_min, db_key_t key_max, bool first_only, index_summary_t *summary)
+{
+	int i;
+	bool found;
+	bool first;
+	bucket_t *bucket;
+	uint16_t bucket_id;
+	uint16_t next_id;
+	pair_t *path;
+	tree_result_t status;
+
+	while (true) {
+		rw_lock_read(&(tree->tree_lock));
+		status = tree_find(tree, start_key, &path);
+		if (status != TREE_BUSY) {
+			break;
+		}
+		rw_unlock_read(&(tree->tree_lock));
+		sched_yield();
+	}
+	if (status != TREE_OK) {
+		rw_unlock_read(&(tree->tree_lock));
+		return DB_INDEX_ERROR;
+	}
+	bucket_id = path[tree->levels].key;
+	free(path);
+
+	first = true;
+	while (true) {
+		bucket = read_locked_bucket(tree, bucket_id);
+		if (bucket == NULL) {
+			return DB_STORAGE_ERROR;
+		}
+
+		/* Keys of the following buckets are not less than the least key of this one */
+		found = false;
+		if (first || bucket->info[1] <= key_max) {
+			for (i = 0; i < bucket->next_free_slot; i++) {
+				if (bucket->pairs[i].key < key_min || bucket->pairs[i].key > key_max) {
+					continue;
+				}
+				if (summary->count == 0 || bucket->pairs[i].key < summary->min) {
+					summary->min = (long)bucket->pairs[i].key;
+				}
+				if (summary->count == 0 || bucket->pairs[i].key > summary->max) {
+					summary->max = (long)bucket->pairs[i].key;
+				}
+				summary->sum += bucket->pairs[i].key;
+				summary->count++;
+				found = true;
+			}
+			next_id = next_bucket(tree, bucket);
+		} else {
+			next_id = (uint16_t)-1;
+		}
+		first = false;
+
+		modify_cache(tree, bucket_id, BUCKET, UNLOCK);
+		pthread_mutex_lock(&(tree->bucket_lock));
+		tree->lock_buckets[bucket_id] = 0;
+		if (next_id == (uint16_t)-1 || (first_only && found)) {
+			pthread_mutex_unlock(&(tree->bucket_lock));
+			break;
+		}
+		while (tree->lock_buckets[next_id] == 1) {
+			pthread_mutex_unlock(&(tree->bucket_lock));
+			sched_yield();
+			pthread_mutex_lock(&(tree->bucket_lock));
+		}
+		tree->lock_buckets[next_id] = 1;
+		pthread_mutex_unlock(&(tree->bucket_lock));
+		bucket_id = next_id;
+	}
+
+	rw_unlock_read(&(tree->tree_lock));
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: summarize
+ *
+ * Description: Aggregates the keys in a range for the aggregation queries,
+ *              no row is read. The least key is in the first bucket having
+ *              a key in the range, and the greatest one is found from the
+ *              bucket of the upper bound of the range, so only a few buckets
+ *              are read unless all keys are counted.
+ *
+ ****************************************************************************/
+static db_result_t summarize(index_t *index, attribute_value_t *min_value, attribute_value_t *max_value, uint8_t flags, index_summary_t *summary)
+{
+	db_key_t key_min;
+	db_key_t key_max;
+	tree_t *tree;
+	index_summary_t upper;
+	db_result_t result;
+
+	key_min = transform_key(min_value);
+	key_max = transform_key(max_value);
+	tree = (tree_t *)index->opaque_data;
+
+	memset(summary, 0, sizeof(index_summary_t));
+	if (flags & INDEX_SUMMARY_ALL) {
+		return summarize_buckets(tree, key_min, key_min, key_max, false, summary);
+	}
+
+	if (flags & INDEX_SUMMARY_MIN) {
+		result = summarize_buckets(tree, key_min, key_min, key_max, true, summary);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+		if (summary->count == 0) {
+			/* No key in the range */
+			return DB_OK;
+		}
+	}
+
+	if (flags & INDEX_SUMMARY_MAX) {
+		memset(&upper, 0, sizeof(index_summary_t));
+		result = summarize_buckets(tree, key_max, key_min, key_max, false, &upper);
+		if (!DB_ERROR(result) && upper.count == 0) {
+			/* Keys in the range are all in the buckets before */
+			result = summarize_buckets(tree, key_min, key_min, key_max, false, &upper);
+		}
+		if (DB_ERROR(result)) {
+			return result;
+		}
+		summary->max = upper.max;
+		if (summary->count == 0) {
+			summary->count = upper.count;
+		}
+	}
+
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: compare_entry
+ *
+ * Description: Comparator to sort the index entries by key and tuple id
+ *
+ ****************************************************************************/
+static int compare_entry(const void *p1, const void *p2)
+{
+	const pair_t *a = (const pair_t *)p1;
+	const pair_t *b = (const pair_t *)p2;
+
+	if (a->key != b->key) {
+		return a->key < b->key ? -1 : 1;
+	}
+	return (int)a->value - (int)b->value;
+}
+
+/****************************************************************************
+ * Name: bulk_write_bucket
+ *
+ * Description: Writes the bucket filled by bulk loading next to the ones
+ *              written before, and adds it to the children of leaf nodes.
+ *              Buckets are chained in the order of their ids.
+ *
+ ****************************************************************************/
+static db_result_t bulk_write_bucket(struct bulk_load_s *bulk, bool last)
+{
+	tree_t *tree = bulk->tree;
+	bucket_t *bucket = &bulk->bucket;
+	int id = tree->off_buckets;
+
+	if (id >= CONFIG_BUCKETS_LIMIT - 1) {
+		DB_LOG_E("TREE FULL !");
+		return DB_LIMIT_ERROR;
+	}
+
+	bucket->info[0] = last ? CONFIG_BUCKETS_LIMIT - 1 : id + 1;
+	if (bucket->next_free_slot > 0) {
+		bucket->info[1] = bucket->pairs[0].key;
+		bucket->info[2] = bucket->pairs[bucket->next_free_slot - 1].key;
+	} else {
+		bucket->info[1] = KEY_MAX;
+		bucket->info[2] = 0;
+	}
+	if (!bucket_write(tree, id, bucket)) {
+		return DB_STORAGE_ERROR;
+	}
+	tree->off_buckets++;
+
+	bulk->ids[bulk->count] = id;
+	bulk->bounds[bulk->count] = bucket->info[2];
+	bulk->count++;
+	bucket->next_free_slot = 0;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: bulk_add
+ *
+ * Description: Appends sorted index entries to the bucket being filled.
+ *              A full bucket is written when the next entry comes, so the
+ *              last bucket is known when it is written.
+ *
+ ****************************************************************************/
+static db_result_t bulk_add(struct bulk_load_s *bulk, pair_t *pairs, int count)
+{
+	db_result_t result;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (bulk->bucket.next_free_slot == BUCKET_SIZE) {
+			result = bulk_write_bucket(bulk, false);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+		}
+		bulk->bucket.pairs[bulk->bucket.next_free_slot++] = pairs[i];
+	}
+	bulk->tree->inserted += count;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: bulk_write_nodes
+ *
+ * Description: Builds the node levels over the buckets written, from leaf
+ *              nodes up to the root. Children are spread evenly over the
+ *              fewest nodes holding them, and a node is written once.
+ *              As in a tree grown by insertions, the rightmost leaf ends
+ *              with the key KEY_MAX and the id of no bucket.
+ *
+ ****************************************************************************/
+static db_result_t bulk_write_nodes(struct bulk_load_s *bulk)
+{
+	tree_t *tree = bulk->tree;
+	tree_node_t node;
+	int nodes;
+	int child;
+	int n;
+	int i;
+	int j;
+
+	bulk->bounds[bulk->count - 1] = KEY_MAX;
+	bulk->ids[bulk->count] = CONFIG_BUCKETS_LIMIT - 1;
+	bulk->bounds[bulk->count] = KEY_MAX;
+	bulk->count++;
+
+	memset(&node, 0, sizeof(tree_node_t));
+	node.is_leaf = 1;
+	tree->levels = 1;
+	do {
+		nodes = (bulk->count + BRANCH_FACTOR - 1) / BRANCH_FACTOR;
+		child = 0;
+		for (i = 0; i < nodes; i++) {
+			n = bulk->count / nodes + (i < bulk->count % nodes ? 1 : 0);
+			for (j = 0; j < n; j++) {
+				node.id[j] = bulk->ids[child + j];
+				if (j < n - 1) {
+					node.val[j] = bulk->bounds[child + j];
+				}
+			}
+			node.val[BRANCH_FACTOR - 1] = n - 1;
+
+			if (tree->off_nodes >= CONFIG_NODE_LIMIT) {
+				DB_LOG_E("TREE FULL !");
+				return DB_LIMIT_ERROR;
+			}
+			if (!tree_write(tree, tree->off_nodes, &node)) {
+				return DB_STORAGE_ERROR;
+			}
+
+			/* The node takes the place of its children for the level above */
+			bulk->ids[i] = tree->off_nodes++;
+			bulk->bounds[i] = bulk->bounds[child + n - 1];
+			child += n;
+		}
+		bulk->count = nodes;
+		node.is_leaf = 0;
+		tree->levels++;
+	} while (bulk->count > 1);
+
+	tree->root = bulk->ids[0];
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: bulk_output
+ *
+ * Description: Passes the entries merged to the next run in the output file,
+ *              or to the buckets by the last merge.
+ *
+ ****************************************************************************/
+static db_result_t bulk_output(struct bulk_load_s *bulk, db_storage_id_t out, pair_t *pairs, int count)
+{
+	if (out < 0) {
+		return bulk_add(bulk, pairs, count);
+	}
+	if (DB_ERROR(storage_write_to(out, pairs, bulk->written * sizeof(pair_t), count * sizeof(pair_t)))) {
+		return DB_STORAGE_ERROR;
+	}
+	bulk->written += count;
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: bulk_merge
+ *
+ * Description: Merges up to BULK_FAN_IN consecutive runs of the input file.
+ *              The sort buffer is shared by a block of each run and a block
+ *              of output.
+ *
+ ****************************************************************************/
+static db_result_t bulk_merge(struct bulk_load_s *bulk, db_storage_id_t in, db_storage_id_t out, unsigned long first, int nruns, unsigned long length, unsigned long total)
+{
+	struct bulk_run_s *run;
+	struct bulk_run_s *best;
+	pair_t *merged;
+	db_result_t result;
+	int nmerged;
+	int i;
+
+	for (i = 0; i < nruns; i++) {
+		run = &bulk->runs[i];
+		/* The last group may have fewer runs, and a shorter last run */
+		run->next = min(first + i * length, total);
+		run->end = min(run->next + length, total);
+		run->block = bulk->pairs + i * BULK_MERGE_BLOCK;
+		run->pos = 0;
+		run->count = 0;
+	}
+	merged = bulk->pairs + BULK_FAN_IN * BULK_MERGE_BLOCK;
+	nmerged = 0;
+
+	while (true) {
+		best = NULL;
+		for (i = 0; i < nruns; i++) {
+			run = &bulk->runs[i];
+			if (run->pos == run->count) {
+				if (run->next == run->end) {
+					continue;
+				}
+				run->count = min(run->end - run->next, (unsigned long)BULK_MERGE_BLOCK);
+				if (DB_ERROR(storage_read_from(in, run->block, run->next * sizeof(pair_t), run->count * sizeof(pair_t)))) {
+					return DB_STORAGE_ERROR;
+				}
+				run->next += run->count;
+				run->pos = 0;
+			}
+			if (best == NULL || compare_entry(&run->block[run->pos], &best->block[best->pos]) < 0) {
+				best = run;
+			}
+		}
+		if (best == NULL) {
+			break;
+		}
+		merged[nmerged++] = best->block[best->pos++];
+		if (nmerged == BULK_MERGE_BLOCK) {
+			result = bulk_output(bulk, out, merged, nmerged);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+			nmerged = 0;
+		}
+	}
+	return nmerged > 0 ? bulk_output(bulk, out, merged, nmerged) : DB_OK;
+}
+
+/****************************************************************************
+ * Name: bulk_sort
+ *
+ * Description: Reads the index entries of all tuples in a sequential scan
+ *              and passes them sorted to the buckets. Entries which don't
+ *              fit in the sort buffer are sorted in runs of its size in the
+ *              sort file, and the runs are merged BULK_FAN_IN at once, from
+ *              one file to the other, until they can be merged in one pass.
+ *
+ ****************************************************************************/
+static db_result_t bulk_sort(struct bulk_load_s *bulk, index_t *index)
+{
+	db_storage_id_t fd[2] = { INVALID_STORAGE_ID, INVALID_STORAGE_ID };
+	storage_scan_t scan;
+	storage_row_t row;
+	attribute_value_t value;
+	db_result_t result;
+	tuple_id_t tuple_id;
+	unsigned long total;
+	unsigned long length;
+	unsigned long first;
+	int nruns;
+	int filled;
+	int in;
+
+	memset(&scan, 0, sizeof(scan));
+	total = 0;
+	nruns = 0;
+	filled = 0;
+	for (tuple_id = 0;; tuple_id++) {
+		result = storage_scan_get_row(&scan, index->rel, tuple_id, &row);
+		if (result == DB_FINISHED) {
+			break;
+		}
+		if (DB_ERROR(result) || DB_ERROR(relation_get_value(index->rel, index->attr, row, &value))) {
+			DB_LOG_E("DB: Failed to get a row in relation %s!\n", index->rel->name);
+			result = DB_STORAGE_ERROR;
+			goto end;
+		}
+		bulk->pairs[filled].key = transform_key(&value);
+		bulk->pairs[filled].value = (uint16_t)tuple_id;
+		filled++;
+
+		if (filled == BULK_SORT_PAIRS) {
+			if (fd[0] < 0) {
+				fd[0] = storage_open(INDEX_SORT_FILE_NAME, O_RDWR | O_CREAT | O_TRUNC);
+				if (fd[0] < 0) {
+					result = DB_STORAGE_ERROR;
+					goto end;
+				}
 			}
-			return cache.bucket->pairs[i].value;
+			qsort(bulk->pairs, filled, sizeof(pair_t), compare_entry);
+			if (DB_ERROR(storage_write_to(fd[0], bulk->pairs, total * sizeof(pair_t), filled * sizeof(pair_t)))) {
+				result = DB_STORAGE_ERROR;
+				goto end;
+			}
+			total += filled;
+			nruns++;
+			filled = 0;
 		}
 	}
+	storage_scan_deinit(&scan);
 
-	/* case when delete query comes */
-	if (matched_condition == FALSE) {
-		modify_cache(tree, cache.bucket_id, BUCKET, INVALIDATE);
-		cache_write_bucket(tree, cache.bucket_id, cache.bucket);
-#ifdef DB_WIP
-		if ((int)((double)(tree->deleted) * 100 / tree->inserted) >= VACUUM_THRESHOLD) {
-			vacuum(tree, iterator->index->rel);
-		}
-#endif
-	} else {
-		modify_cache(tree, cache.bucket_id, BUCKET, UNLOCK);
+	qsort(bulk->pairs, filled, sizeof(pair_t), compare_entry);
+	if (nruns == 0) {
+		/* All entries fit in the sort buffer */
+		return bulk_add(bulk, bulk->pairs, filled);
 	}
-	pthread_mutex_lock(&(tree->bucket_lock));
-	tree->lock_buckets[cache.bucket_id] = 0;
-	cache.bucket_id = next_bucket(tree, cache.bucket);
-	if (cache.bucket_id == (uint16_t)-1) {
-		if (iterator->found_items == 0) {
-			iterator->next_item_no = 0;
-		} else {
-			iterator->next_item_no = 1;
+	if (filled > 0) {
+		if (DB_ERROR(storage_write_to(fd[0], bulk->pairs, total * sizeof(pair_t), filled * sizeof(pair_t)))) {
+			result = DB_STORAGE_ERROR;
+			goto end;
 		}
-		pthread_mutex_unlock(&(tree->bucket_lock));
-		rw_unlock_write(&(tree->tree_lock));
-		return INVALID_TUPLE;
+		total += filled;
+		nruns++;
+	}
+	DB_LOG_D("DB: Sorted %lu index entries in %d runs\n", total, nruns);
+
+	in = 0;
+	length = BULK_SORT_PAIRS;
+	while (nruns > BULK_FAN_IN) {
+		if (fd[1] < 0) {
+			fd[1] = storage_open(INDEX_MERGE_FILE_NAME, O_RDWR | O_CREAT | O_TRUNC);
+			if (fd[1] < 0) {
+				result = DB_STORAGE_ERROR;
+				goto end;
+			}
+		}
+		bulk->written = 0;
+		for (first = 0; first < total; first += length * BULK_FAN_IN) {
+			result = bulk_merge(bulk, fd[in], fd[1 - in], first, BULK_FAN_IN, length, total);
+			if (DB_ERROR(result)) {
+				goto end;
+			}
+		}
+		length *= BULK_FAN_IN;
+		nruns = (nruns + BULK_FAN_IN - 1) / BULK_FAN_IN;
+		in = 1 - in;
 	}
-	while (tree->lock_buckets[cache.bucket_id] == 1) {
-		pthread_mutex_unlock(&(tree->bucket_lock));
-		DB_LOG_D("BUCKET ALREADY LOCKED IN GET NEXT SPINNING\n");
-		pthread_mutex_lock(&(tree->bucket_lock));
+	result = bulk_merge(bulk, fd[in], INVALID_STORAGE_ID, 0, nruns, length, total);
+
+end:
+	storage_scan_deinit(&scan);
+	if (fd[0] >= 0) {
+		storage_close(fd[0]);
+		storage_remove(INDEX_SORT_FILE_NAME);
 	}
-	tree->lock_buckets[cache.bucket_id] = 1;
-	pthread_mutex_unlock(&(tree->bucket_lock));
+	if (fd[1] >= 0) {
+		storage_close(fd[1]);
+		storage_remove(INDEX_MERGE_FILE_NAME);
+	}
+	return result;
+}
 
-	cache.start = 0;
-	cache.end = cache.bucket->next_free_slot;
+/****************************************************************************
+ * Name: bulk_load
+ *
+ * Description: Builds the index of a populated relation, in place of the
+ *              empty tree made by create. Instead of inserting the tuples
+ *              one by one, the index entries are sorted, packed in full
+ *              buckets written in order, and the nodes are built bottom-up,
+ *              so each bucket and node is written once.
+ *
+ ****************************************************************************/
+static db_result_t bulk_load(index_t *index)
+{
+	tree_t *tree;
+	struct bulk_load_s *bulk;
+	db_result_t result;
 
-	/* TODO
-	 * Absent of non-cast return handling, should be taken care in the definition
-	 */
-	cache.bucket = bucket_read(tree, cache.bucket_id);
-	if (cache.bucket->info[1] > key_max) {
-		modify_cache(tree, cache.bucket_id, BUCKET, UNLOCK);
-		if (iterator->found_items == 0) {
-			iterator->next_item_no = 0;
-		} else {
-			iterator->next_item_no = 1;
-		}
-		pthread_mutex_unlock(&(tree->bucket_lock));
-		rw_unlock_write(&(tree->tree_lock));
-		return INVALID_TUPLE;
+	tree = (tree_t *)index->opaque_data;
+	if (tree == NULL) {
+		return DB_INDEX_ERROR;
+	}
 
+	bulk = (struct bulk_load_s *)malloc(sizeof(struct bulk_load_s));
+	if (bulk == NULL) {
+		return DB_ALLOCATION_ERROR;
 	}
-	iterator->next_item_no = 1;
-	return get_next(iterator, matched_condition);
-}
+	bulk->pairs = (pair_t *)malloc(BULK_SORT_PAIRS * sizeof(pair_t));
+	if (bulk->pairs == NULL) {
+		free(bulk);
+		return DB_ALLOCATION_ERROR;
+	}
+	bulk->tree = tree;
+	bulk->bucket.next_free_slot = 0;
+	bulk->count = 0;
+
+	/* Drop the root of the empty tree, the nodes are written past the cache */
+	modify_cache(tree, tree->root, NODE, INVALIDATE);
+	tree->off_nodes = 0;
+	tree->off_buckets = 0;
+	tree->inserted = 0;
 
+	result = bulk_sort(bulk, index);
+	if (DB_SUCCESS(result)) {
+		result = bulk_write_bucket(bulk, true);
+	}
+	if (DB_SUCCESS(result)) {
+		result = bulk_write_nodes(bulk);
+	}
+	if (DB_SUCCESS(result) && DB_ERROR(storage_write_to(tree->tree_storage, tree, 0, sizeof(tree_t)))) {
+		result = DB_STORAGE_ERROR;
+	}
+	if (DB_SUCCESS(result)) {
+		DB_LOG_D("DB: Bulk loaded %d entries in %d buckets and %d nodes\n", tree->inserted, tree->off_buckets, tree->off_nodes);
+	}
 
+	free(bulk->pairs);
+	free(bulk);
+	return result;
+}
 
 #ifdef DB_WIP
 /****************************************************************************
@@ -961,7 +1619,7 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
 	offset += sizeof(rel->name);
 
 	/* Generate new tuple file */
-	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 	result = storage_generate_file(tuple_path);
 	if (result == DB_STORAGE_ERROR) {
 		storage_close(fd);
@@ -990,7 +1648,7 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
 
 	/* Iterate over all the buckets to read the tuples from storage and put them in new tuple file */
 	for (id = 0; id < tree->off_buckets; id++) {
-		bucket_t *bucket = bucket_read(tree, id);
+		bucket_t *bucket = bucket_read(tree, id, NULL);
 		int num;
 		for (num = 0; num < bucket->next_free_slot; num++) {
 			tuple_id_t tup;
@@ -1013,6 +1671,220 @@ static db_result_t vacuum(tree_t *tree, relation_t *rel)
 }
 #endif
 
+/****************************************************************************
+ * Name: node_cache_alloc
+ *
+ * Description: Allocates the node cache with all of its entries free
+ *
+ ****************************************************************************/
+static tree_cache_t *node_cache_alloc(void)
+{
+	tree_cache_t *node_cache;
+	int i;
+
+	node_cache = (tree_cache_t *)malloc(sizeof(tree_cache_t));
+	if (node_cache == NULL) {
+		return NULL;
+	}
+	memset(node_cache, 0, sizeof(tree_cache_t));
+	for (i = 0; i < DB_TREE_CACHE_PARTITIONS; i++) {
+		memset(node_cache->part[i].hash, TREE_CACHE_NONE, sizeof(node_cache->part[i].hash));
+		pthread_mutex_init(&(node_cache->part[i].lock), NULL);
+	}
+	return node_cache;
+}
+
+/****************************************************************************
+ * Name: node_cache_free
+ *
+ * Description: Frees the node cache. Dirty entries are not written.
+ *
+ ****************************************************************************/
+static void node_cache_free(tree_cache_t *node_cache)
+{
+	int i;
+
+	for (i = 0; i < DB_TREE_CACHE_PARTITIONS; i++) {
+		pthread_mutex_destroy(&(node_cache->part[i].lock));
+	}
+	free(node_cache);
+}
+
+/****************************************************************************
+ * Name: node_cache_flush
+ *
+ * Description: Writes all dirty entries of the node cache to the flash
+ *
+ ****************************************************************************/
+static void node_cache_flush(tree_t *tree)
+{
+	struct tree_cache_partition_s *part;
+	struct tree_cache_s *entry;
+	int i;
+	int j;
+
+	for (i = 0; i < DB_TREE_CACHE_PARTITIONS; i++) {
+		part = &(tree->node_cache->part[i]);
+		pthread_mutex_lock(&(part->lock));
+		for (j = 0; j < TREE_CACHE_PARTITION_SIZE; j++) {
+			entry = &(part->cache_t[j]);
+			if ((entry->node_state & NODE_STATE_DIRTY) && (entry->node_state & NODE_STATE_VALID)) {
+				tree_write(tree, entry->id, &(entry->node));
+				UNSET_NODE_STATE(entry, NODE_STATE_DIRTY);
+			}
+		}
+		pthread_mutex_unlock(&(part->lock));
+	}
+}
+
+/****************************************************************************
+ * Name: node_cache_partition
+ *
+ * Description: Returns the partition of node cache which holds the node
+ *
+ ****************************************************************************/
+static inline struct tree_cache_partition_s *node_cache_partition(tree_t *tree, int id)
+{
+	return &(tree->node_cache->part[id % DB_TREE_CACHE_PARTITIONS]);
+}
+
+static inline int node_cache_hash(int id)
+{
+	return (id / DB_TREE_CACHE_PARTITIONS) % TREE_CACHE_PARTITION_SIZE;
+}
+
+/****************************************************************************
+ * Name: node_cache_lookup
+ *
+ * Description: Finds the entry of a node in its hash chain.
+ *              Lock of the partition should be held by the caller.
+ *
+ ****************************************************************************/
+static struct tree_cache_s *node_cache_lookup(struct tree_cache_partition_s *part, int id)
+{
+	uint8_t pos;
+
+	for (pos = part->hash[node_cache_hash(id)]; pos != TREE_CACHE_NONE; pos = part->cache_t[pos].hash_next) {
+		if (part->cache_t[pos].id == id) {
+			return &(part->cache_t[pos]);
+		}
+	}
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: node_cache_insert
+ *
+ * Description: Links a free entry to the hash chain of the node.
+ *              Lock of the partition should be held by the caller.
+ *
+ ****************************************************************************/
+static void node_cache_insert(struct tree_cache_partition_s *part, struct tree_cache_s *entry, int id)
+{
+	uint8_t *head = &(part->hash[node_cache_hash(id)]);
+
+	entry->id = id;
+	entry->node_state = NODE_STATE_VALID;
+	entry->pins = 0;
+	entry->referenced = 1;
+	entry->hash_next = *head;
+	*head = (uint8_t)(entry - part->cache_t);
+}
+
+/****************************************************************************
+ * Name: node_cache_remove
+ *
+ * Description: Unlinks an entry from its hash chain and makes it free.
+ *              Lock of the partition should be held by the caller.
+ *
+ ****************************************************************************/
+static void node_cache_remove(struct tree_cache_partition_s *part, struct tree_cache_s *entry)
+{
+	uint8_t *link = &(part->hash[node_cache_hash(entry->id)]);
+	uint8_t pos = (uint8_t)(entry - part->cache_t);
+
+	while (*link != TREE_CACHE_NONE) {
+		if (*link == pos) {
+			*link = entry->hash_next;
+			break;
+		}
+		link = &(part->cache_t[*link].hash_next);
+	}
+	entry->node_state = 0;
+	entry->pins = 0;
+	entry->hash_next = TREE_CACHE_NONE;
+}
+
+/****************************************************************************
+ * Name: node_cache_evict
+ *
+ * Description: Finds a free entry in the partition. When there is none,
+ *              an unpinned entry is evicted by the clock algorithm: the hand
+ *              sweeps over the entries and takes the first one which isn't
+ *              referenced since the last sweep. Dirty entries are written
+ *              before reuse. Returns NULL when all entries are pinned.
+ *              Lock of the partition should be held by the caller.
+ *
+ ****************************************************************************/
+static struct tree_cache_s *node_cache_evict(tree_t *tree, struct tree_cache_partition_s *part)
+{
+	struct tree_cache_s *entry;
+	int i;
+
+	/* Two sweeps at most, the first one may only clear the reference bits */
+	for (i = 0; i < 2 * TREE_CACHE_PARTITION_SIZE; i++) {
+		entry = &(part->cache_t[part->hand]);
+		part->hand = (part->hand + 1) % TREE_CACHE_PARTITION_SIZE;
+		if (!(entry->node_state & NODE_STATE_VALID)) {
+			return entry;
+		}
+		if (entry->pins > 0) {
+			continue;
+		}
+		if (entry->referenced) {
+			entry->referenced = 0;
+			continue;
+		}
+		if (entry->node_state & NODE_STATE_DIRTY) {
+			tree_write(tree, entry->id, &(entry->node));
+		}
+		node_cache_remove(part, entry);
+		return entry;
+	}
+	return NULL;
+}
+
+/****************************************************************************
+ * Name: node_cache_modify
+ *
+ * Description: Marks a node cache entry dirty, unpins or invalidates it
+ *
+ ****************************************************************************/
+static cache_result_t node_cache_modify(tree_t *tree, int id, op_type_t op)
+{
+	struct tree_cache_partition_s *part = node_cache_partition(tree, id);
+	struct tree_cache_s *entry;
+
+	pthread_mutex_lock(&(part->lock));
+	entry = node_cache_lookup(part, id);
+	if (entry == NULL) {
+		pthread_mutex_unlock(&(part->lock));
+		DB_LOG_E("PANIC CACHE OPERATION FOR A NON EXISTENT ENTRY\n");
+		return CACHE_NOT_EXIST;
+	}
+	if (op == UNLOCK) {
+		if (entry->pins > 0) {
+			entry->pins--;
+		}
+	} else if (op == DIRTY) {
+		SET_NODE_STATE(entry, NODE_STATE_DIRTY);
+	} else {
+		node_cache_remove(part, entry);
+	}
+	pthread_mutex_unlock(&(part->lock));
+	return CACHE_OK;
+}
+
 /****************************************************************************
  * Name: modify_cache
  *
@@ -1025,14 +1897,11 @@ static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_
 	qnode_t *temp;
 	qnode_t *end;
 	if (cache == NODE) {
-		pthread_mutex_lock(&(tree->node_cache_lock));
-		temp = tree->node_cache->in_cache.tail->prev;
-		end = tree->node_cache->in_cache.head;
-	} else {
-		pthread_mutex_lock(&(tree->buck_cache_lock));
-		temp = tree->buck_cache->in_cache.tail->prev;
-		end = tree->buck_cache->in_cache.head;
+		return node_cache_modify(tree, id, op);
 	}
+	pthread_mutex_lock(&(tree->buck_cache_lock));
+	temp = tree->buck_cache->in_cache.tail->prev;
+	end = tree->buck_cache->in_cache.head;
 	while (temp != end) {
 		if ((temp->id == id) && (temp->node_state & NODE_STATE_VALID)) {
 			if (op == UNLOCK) {
@@ -1042,25 +1911,17 @@ static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_
 			} else {
 				UNSET_NODE_STATE(temp, NODE_STATE_VALID | NODE_STATE_DIRTY | NODE_STATE_LOCK);
 				REMOVE_ENTRY(temp);
-				if (cache == NODE) {
-					PLACE_AT_HEAD(temp, tree->node_cache);
-				} else {
-					PLACE_AT_HEAD(temp, tree->buck_cache);
-				}
+				PLACE_AT_HEAD(temp, tree->buck_cache);
 			}
 			break;
 		}
 		temp = temp->prev;
 	}
+	pthread_mutex_unlock(&(tree->buck_cache_lock));
 	if (temp == end) {
 		DB_LOG_E("PANIC CACHE OPERATION FOR A NON EXISTENT ENTRY\n");
 		return CACHE_NOT_EXIST;
 	}
-	if (cache == NODE) {
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-	} else {
-		pthread_mutex_unlock(&(tree->buck_cache_lock));
-	}
 	return CACHE_OK;
 }
 
@@ -1073,49 +1934,27 @@ static cache_result_t modify_cache(tree_t *tree, int id, cache_type_t cache, op_
  ****************************************************************************/
 static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
+	struct tree_cache_partition_s *part = node_cache_partition(tree, id);
+	struct tree_cache_s *entry;
 
-	qnode_t *new_node = (qnode_t *)malloc(sizeof(qnode_t));
-	if (new_node == NULL) {
-		DB_LOG_E("Failed allocation of node\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return CACHE_ALLOCATION_ERROR;
-	}
+	pthread_mutex_lock(&(part->lock));
 
-	if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-		new_node->pos = tree->node_cache->num++;
-	} else {
-		qnode_t *iter_node;
-		iter_node = tree->node_cache->in_cache.head->next;
-		while ((iter_node->node_state & NODE_STATE_LOCK) && iter_node != tree->node_cache->in_cache.tail) {
-			iter_node = iter_node->next;
-		}
-		if (iter_node == tree->node_cache->in_cache.tail) {
-			free(new_node);
+	entry = node_cache_lookup(part, id);
+	if (entry == NULL) {
+		entry = node_cache_evict(tree, part);
+		if (entry == NULL) {
 			DB_LOG_E("NO SLOT AVAIABLE IN CACHE\n");
-			pthread_mutex_unlock(&(tree->node_cache_lock));
+			pthread_mutex_unlock(&(part->lock));
 			return CACHE_FULL;
 		}
-		if ((iter_node->node_state & NODE_STATE_DIRTY) && (iter_node->node_state & NODE_STATE_DIRTY)) {
-			tree_write(tree, iter_node->id, &(tree->node_cache->cache_t[iter_node->pos].node));
-		}
-		new_node->pos = iter_node->pos;
-		/* iter_node is the node which has to be evicted from cache.
-		 * It is removed the queue maintaining the LRU status.
-		 */
-		REMOVE_ENTRY(iter_node);
-		free(iter_node);
+		node_cache_insert(part, entry, id);
 	}
+	SET_NODE_STATE(entry, NODE_STATE_DIRTY);
+	entry->referenced = 1;
 
-	PLACE_AT_TAIL(new_node, tree->node_cache);
-	new_node->id = id;
-	UNSET_NODE_STATE(new_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(new_node, NODE_STATE_VALID);
-	SET_NODE_STATE(new_node, NODE_STATE_DIRTY);
-
-	memcpy(&(tree->node_cache->cache_t[new_node->pos].node), node, sizeof(tree_node_t));
+	memcpy(&(entry->node), node, sizeof(tree_node_t));
 
-	pthread_mutex_unlock(&(tree->node_cache_lock));
+	pthread_mutex_unlock(&(part->lock));
 
 	return CACHE_OK;
 }
@@ -1129,25 +1968,23 @@ static cache_result_t cache_write_node(tree_t *tree, int id, tree_node_t *node)
  ****************************************************************************/
 static cache_result_t cache_replace_node(tree_t *tree, int id, tree_node_t *node)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
+	struct tree_cache_partition_s *part = node_cache_partition(tree, id);
+	struct tree_cache_s *entry;
 
-	qnode_t *replace_node;
-	replace_node = tree->node_cache->in_cache.head->next;
+	pthread_mutex_lock(&(part->lock));
 
-	while ((replace_node->id != id) && (replace_node != tree->node_cache->in_cache.tail)) {
-		replace_node = replace_node->next;
-	}
-	if (replace_node == tree->node_cache->in_cache.tail || !(replace_node->node_state & NODE_STATE_LOCK)) {
+	entry = node_cache_lookup(part, id);
+	if (entry == NULL || entry->pins == 0) {
 		DB_LOG_E("PANIC REPLACE FOR NON_EXISTENT OR NON_LOCKED ENTRY\n");
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+		pthread_mutex_unlock(&(part->lock));
 		return CACHE_NOT_EXIST;
 	}
-	UNSET_NODE_STATE(replace_node, NODE_STATE_LOCK);
-	SET_NODE_STATE(replace_node, NODE_STATE_VALID | NODE_STATE_DIRTY);
+	entry->pins--;
+	SET_NODE_STATE(entry, NODE_STATE_DIRTY);
 
-	memcpy(&(tree->node_cache->cache_t[replace_node->pos].node), node, sizeof(tree_node_t));
+	memcpy(&(entry->node), node, sizeof(tree_node_t));
 
-	pthread_mutex_unlock(&(tree->node_cache_lock));
+	pthread_mutex_unlock(&(part->lock));
 
 	return CACHE_OK;
 }
@@ -1206,91 +2043,59 @@ static cache_result_t cache_write_bucket(tree_t *tree, int id, bucket_t *bucket)
 /****************************************************************************
  * Name: transform_key
  *
- * Description: Routine to tranform key to a type acceptable by index.
- *              Different data types of keys can be supported.
- *              some codes will be added in future.
+ * Description: Routine to tranform a value to the key of the index.
+ *              Strings are keyed by their first DB_STRING_KEY_LENGTH bytes,
+ *              so strings sharing a longer prefix collide and the condition
+ *              of the query tells them apart.
  *
  ****************************************************************************/
-static int transform_key(int key)
+static db_key_t transform_key(attribute_value_t *value)
 {
-	return key;
+	return db_value_to_key(value);
 }
 
 /****************************************************************************
  * Name: tree_read
  *
- * Description: Fetches nodes from the flash and suitably evicts the nodes
- *              from cache, in case the cache is full
+ * Description: Fetches nodes from the cache and reads them from the flash
+ *              when they aren't cached, evicting a node if the cache is full.
+ *              The node returned is pinned until it is unlocked through
+ *              modify_cache or replaced. A node can be pinned by several
+ *              readers, writers exclude them with the tree lock.
  *
  ****************************************************************************/
-static tree_node_t *tree_read(tree_t *tree, int bucket_id)
+static tree_node_t *tree_read(tree_t *tree, int id)
 {
-	pthread_mutex_lock(&(tree->node_cache_lock));
+	struct tree_cache_partition_s *part = node_cache_partition(tree, id);
+	struct tree_cache_s *entry;
 
-	bool found = false;
-	qnode_t *iter = (tree->node_cache->in_cache.tail)->prev;
+	pthread_mutex_lock(&(part->lock));
 
-	while (iter != (tree->node_cache->in_cache.head)) {
-		if (bucket_id == iter->id && (iter->node_state & NODE_STATE_VALID)) {
-			found = true;
-			break;
-		}
-		iter = iter->prev;
-	}
-	if (found) {
-		/* Case when node is found in the cache */
-		if (iter->node_state & NODE_STATE_LOCK) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
-			return NULL;
-		}
-		SET_NODE_STATE(iter, NODE_STATE_LOCK);
-		REMOVE_ENTRY(iter);
-		PLACE_AT_TAIL(iter, tree->node_cache);
-		pthread_mutex_unlock(&(tree->node_cache_lock));
-		return &(tree->node_cache->cache_t[iter->pos].node);
-	} else {
-		qnode_t *new_node = (qnode_t *)malloc(sizeof(qnode_t));
-		if (new_node == NULL) {
-			pthread_mutex_unlock(&(tree->node_cache_lock));
+	entry = node_cache_lookup(part, id);
+	if (entry == NULL) {
+		INDEX_CACHE_STAT(node_misses);
+		entry = node_cache_evict(tree, part);
+		if (entry == NULL) {
+			pthread_mutex_unlock(&(part->lock));
 			return NULL;
 		}
-		if (tree->node_cache->num < DB_TREE_CACHE_LIMIT) {
-			new_node->pos = tree->node_cache->num++;
-		} else {
-			/* Case when the least recently used node needs to be evicted to make place for new node */
-			qnode_t *replace_node = tree->node_cache->in_cache.head->next;
-			while ((replace_node->node_state & NODE_STATE_LOCK) && replace_node != tree->node_cache->in_cache.tail) {
-				replace_node = replace_node->next;
-			}
-			if (replace_node == tree->node_cache->in_cache.tail) {
-				free(new_node);
-				pthread_mutex_unlock(&(tree->node_cache_lock));
-				return NULL;
-			}
-			if ((replace_node->node_state & NODE_STATE_DIRTY) && (replace_node->node_state & NODE_STATE_VALID)) {
-				tree_write(tree, replace_node->id, &(tree->node_cache->cache_t[replace_node->pos].node));
-			}
-			new_node->pos = replace_node->pos;
-			REMOVE_ENTRY(replace_node);
-			free(replace_node);
-		}
-		/* Adjusting the pointers */
-		PLACE_AT_TAIL(new_node, tree->node_cache);
-		new_node->id = bucket_id;
-		SET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID | NODE_STATE_DIRTY);
 
 		/* Reading from flash */
-		if (DB_ERROR(storage_read_from(tree->tree_storage, &(tree->node_cache->cache_t[new_node->pos].node), base_offset + (unsigned long)bucket_id * sizeof(tree_node_t), sizeof(tree_node_t)))) {
-			DB_LOG_E("PANIC TREE READ FAILED AT NODE ID %d\n", new_node->id);
-			UNSET_NODE_STATE(new_node, NODE_STATE_LOCK | NODE_STATE_VALID);
-			pthread_mutex_unlock(&(tree->node_cache_lock));
+		if (DB_ERROR(storage_read_from(tree->tree_storage, &(entry->node), base_offset + (unsigned long)id * sizeof(tree_node_t), sizeof(tree_node_t)))) {
+			DB_LOG_E("PANIC TREE READ FAILED AT NODE ID %d\n", id);
+			pthread_mutex_unlock(&(part->lock));
 			return NULL;
 		}
+		node_cache_insert(part, entry, id);
+	} else {
+		INDEX_CACHE_STAT(node_hits);
+	}
+	entry->pins++;
+	entry->referenced = 1;
 
-		pthread_mutex_unlock(&(tree->node_cache_lock));
+	pthread_mutex_unlock(&(part->lock));
 
-		return &(tree->node_cache->cache_t[new_node->pos].node);
-	}
+	return &(entry->node);
 }
 
 /****************************************************************************
@@ -1332,7 +2137,7 @@ static int bucket_write(tree_t *tree, int pos, bucket_t *bucket)
  *              value max(uint16_t) and two buckets
  *
  ****************************************************************************/
-static tree_result_t tree_insert(tree_t *tree, int max)
+static tree_result_t tree_insert(tree_t *tree, db_key_t max)
 {
 	int i = tree->off_nodes;
 	tree_node_t *node;
@@ -1362,21 +2167,23 @@ static tree_result_t tree_insert(tree_t *tree, int max)
  * Name: tree_find
  *
  * Description: Traverses the bplus tree to find the appropriate bucket
- *              for an insertion
+ *              for an insertion. On TREE_OK the path to the bucket is
+ *              returned and the bucket is locked. TREE_BUSY is returned
+ *              when the bucket is locked by another task.
  *
  ****************************************************************************/
-static pair_t *tree_find(tree_t *tree, int key)
+static tree_result_t tree_find(tree_t *tree, db_key_t key, pair_t **result)
 {
-	int hashed_key;
+	db_key_t hashed_key;
 	uint8_t id;
 	tree_node_t *node;
 	int index;
-	hashed_key = transform_key(key);
+	hashed_key = key;
 	bool iset;
 	int j;
 	pair_t *path = malloc(sizeof(pair_t) * ((tree->levels) + 1));
 	if (path == NULL) {
-		return NULL;
+		return TREE_READ_FAIL;
 	}
 	uint8_t tree_level = 1;
 	path[0].key = ROOT_NODE_PARENT;
@@ -1390,7 +2197,7 @@ static pair_t *tree_find(tree_t *tree, int key)
 		node = tree_read(tree, id);
 		if (node == NULL) {
 			free(path);
-			return NULL;
+			return TREE_READ_FAIL;
 		}
 		index = id;
 		iset = false;
@@ -1414,17 +2221,19 @@ static pair_t *tree_find(tree_t *tree, int key)
 				pthread_mutex_unlock(&(tree->bucket_lock));
 				modify_cache(tree, id, NODE, UNLOCK);
 				free(path);
-				return NULL;
+				return TREE_BUSY;
 			} else {
 				tree->lock_buckets[node->id[index]] = 1;
 				pthread_mutex_unlock(&(tree->bucket_lock));
 			}
-			modify_cache(tree, id, NODE, UNLOCK);
+			/* The node may be evicted once it's unlocked */
 			path[tree_level].key = id;
 			path[tree_level].value = index;
 			tree_level++;
 			path[tree_level].key = node->id[index];
-			return path;
+			modify_cache(tree, id, NODE, UNLOCK);
+			*result = path;
+			return TREE_OK;
 		} else {
 			path[tree_level].key = id;
 			if (iset) {
@@ -1439,7 +2248,7 @@ static pair_t *tree_find(tree_t *tree, int key)
 		}
 	}
 	free(path);
-	return NULL;
+	return TREE_READ_FAIL;
 }
 
 
@@ -1459,24 +2268,24 @@ void tree_print(tree_t *tree, int id)
 	DB_LOG_D("Node %d:", id);
 	if (node->is_leaf) {
 		for (i = 0; i < node->val[BRANCH_FACTOR - 1]; i++) {
-			DB_LOG_V(" Key: %d\n", node->val[i]);
-			bucket = bucket_read(tree, node->id[i]);
+			DB_LOG_V(" Key: %lld\n", (long long)node->val[i]);
+			bucket = bucket_read(tree, node->id[i], NULL);
 			DB_LOG_V("Bucket id:%d\n", node->id[i]);
 			for (j = 0; j < bucket->next_free_slot; j++) {
-				DB_LOG_V("Key %d, Value %d\n", bucket->pairs[j].key, bucket->pairs[j].value);
+				DB_LOG_V("Key %lld, Value %d\n", (long long)bucket->pairs[j].key, bucket->pairs[j].value);
 			}
 			modify_cache(tree, node->id[i], BUCKET, UNLOCK);
 		}
-		bucket = bucket_read(tree, node->id[node->val[BRANCH_FACTOR - 1]]);
+		bucket = bucket_read(tree, node->id[node->val[BRANCH_FACTOR - 1]], NULL);
 		DB_LOG_D("Bucket id:%d\n", node->id[node->val[BRANCH_FACTOR - 1]]);
 		for (j = 0; j < bucket->next_free_slot; j++) {
-			DB_LOG_V("Key %d, Value %d\n", bucket->pairs[j].key, bucket->pairs[j].value);
+			DB_LOG_V("Key %lld, Value %d\n", (long long)bucket->pairs[j].key, bucket->pairs[j].value);
 		}
 		modify_cache(tree, node->id[node->val[BRANCH_FACTOR - 1]], BUCKET, UNLOCK);
 
 	} else {
 		for (i = 0; i < node->val[BRANCH_FACTOR - 1]; i++) {
-			DB_LOG_V("Key: %d\n", node->val[i]);
+			DB_LOG_V("Key: %lld\n", (long long)node->val[i]);
 			tree_print(tree, node->id[i]);
 		}
 		tree_print(tree, node->id[node->val[BRANCH_FACTOR - 1]]);
@@ -1491,11 +2300,17 @@ void tree_print(tree_t *tree, int id)
  *
  * Description: Reads buckets from the cache and fetches them from flash
  *              when the entry does not exist in cache.
- *              Also evicts the suitable entries from cache when cache is full
+ *              Also evicts the suitable entries from cache when cache is full.
+ *              When NULL is returned, status tells whether the bucket or the
+ *              whole cache is locked by other tasks, if it's not NULL.
  *
  ****************************************************************************/
-static bucket_t *bucket_read(tree_t *tree, int bucket_id)
+static bucket_t *bucket_read(tree_t *tree, int bucket_id, tree_result_t *status)
 {
+	if (status != NULL) {
+		*status = TREE_BUSY;
+	}
+
 	pthread_mutex_lock(&(tree->buck_cache_lock));
 
 	bool found = false;
@@ -1517,13 +2332,18 @@ static bucket_t *bucket_read(tree_t *tree, int bucket_id)
 		SET_NODE_STATE(iter, NODE_STATE_LOCK);
 		REMOVE_ENTRY(iter);
 		PLACE_AT_TAIL(iter, tree->buck_cache);
+		INDEX_CACHE_STAT(bucket_hits);
 		pthread_mutex_unlock(&(tree->buck_cache_lock));
 		return &(tree->buck_cache->cache_t[iter->pos].bucket);
 	} else {
 		/* Bucket has to be read from flash into the cache */
+		INDEX_CACHE_STAT(bucket_misses);
 		qnode_t *new_node = (qnode_t *)malloc(sizeof(qnode_t));
 		if (new_node == NULL) {
 			pthread_mutex_unlock(&(tree->buck_cache_lock));
+			if (status != NULL) {
+				*status = TREE_READ_FAIL;
+			}
 			return NULL;
 		}
 		if (tree->buck_cache->num < DB_HEAP_CACHE_LIMIT) {
@@ -1558,6 +2378,9 @@ static bucket_t *bucket_read(tree_t *tree, int bucket_id)
 			DB_LOG_E("PANIC BUCKET READ FAILED AT ID %d\n", bucket_id);
 			UNSET_NODE_STATE(new_node, (NODE_STATE_LOCK | NODE_STATE_VALID));
 			pthread_mutex_unlock(&(tree->buck_cache_lock));
+			if (status != NULL) {
+				*status = TREE_READ_FAIL;
+			}
 			return NULL;
 		}
 		pthread_mutex_unlock(&(tree->buck_cache_lock));
@@ -1573,7 +2396,7 @@ static bucket_t *bucket_read(tree_t *tree, int bucket_id)
  ****************************************************************************/
 static cache_result_t cache_bucket_append(tree_t *tree, int bucket_id, pair_t *pair)
 {
-	bucket_t *bucket_tmp = bucket_read(tree, bucket_id);
+	bucket_t *bucket_tmp = bucket_read(tree, bucket_id, NULL);
 	if (bucket_tmp == NULL) {
 		return CACHE_NOT_EXIST;
 	}
@@ -1610,7 +2433,7 @@ static cache_result_t cache_bucket_append(tree_t *tree, int bucket_id, pair_t *p
  *              i.e. higher nodes are split then the lower nodes are split.
  *
  ****************************************************************************/
-static tsplit_status_t tree_split(tree_t *tree, int key, int id, pair_t *path, int level)
+static tsplit_status_t tree_split(tree_t *tree, db_key_t key, int id, pair_t *path, int level)
 {
 	if (level < 0 || level > (tree->levels - 1)) {
 		DB_LOG_E("PANIC: Tree level out of bounds\n");
@@ -1678,7 +2501,7 @@ static tsplit_status_t tree_split(tree_t *tree, int key, int id, pair_t *path, i
 		int res;
 		int nid = tree->off_nodes++;
 		/* Create dummy arrays to facilitate splitting */
-		int key_arr[BRANCH_FACTOR];
+		db_key_t key_arr[BRANCH_FACTOR];
 		int ids_arr[BRANCH_FACTOR + 1];
 
 		if (tree->off_nodes > CONFIG_NODE_LIMIT) {
@@ -1740,9 +2563,9 @@ static tsplit_status_t tree_split(tree_t *tree, int key, int id, pair_t *path, i
  *              the insertion process of an index entry
  *
  ****************************************************************************/
-static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *path)
+static bsplit_status_t bucket_split(tree_t *tree, db_key_t key, int value, pair_t *path)
 {
-	int median;
+	db_key_t median;
 	bucket_t *bucket;
 	uint16_t bucket_id = path[tree->levels].key;
 	int i;
@@ -1754,7 +2577,7 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
 	/* TODO
 	 * Absent of non-cast return handling, should be taken care in the definition
 	 */
-	bucket = bucket_read(tree, bucket_id);
+	bucket = bucket_read(tree, bucket_id, NULL);
 
 	/* Sort the key-value pairs in the bucket according to the keys and pick the median */
 	pair_t bucket_tuples[BUCKET_SIZE + 1];
@@ -1816,28 +2639,30 @@ static bsplit_status_t bucket_split(tree_t *tree, int key, int value, pair_t *pa
  *              routines defined above.
  *
  ****************************************************************************/
-tree_result_t insert_item_btree(tree_t *tree, int key, int value)
+tree_result_t insert_item_btree(tree_t *tree, db_key_t key, int value)
 {
 	int bucket_id;
 	pair_t *path;
 	bucket_t *tmp_bucket;
+	tree_result_t status;
 	int num_entries_bucket = 0;
 start:
 	bucket_id = -1;
 	pair_t pair;
 	while (bucket_id < 0) {
 		rw_lock_read(&(tree->tree_lock));
-		path = tree_find(tree, key);
-		if (path == NULL) {
-			rw_unlock_read(&(tree->tree_lock));
+		status = tree_find(tree, key, &path);
+		rw_unlock_read(&(tree->tree_lock));
+		if (status == TREE_BUSY) {
 			continue;
+		} else if (status != TREE_OK) {
+			return TREE_INSERT_FAIL;
 		}
 		bucket_id = path[tree->levels].key;
-		rw_unlock_read(&(tree->tree_lock));
 	}
 	pair.key = key;
 	pair.value = value;
-	tmp_bucket = bucket_read(tree, bucket_id);
+	tmp_bucket = bucket_read(tree, bucket_id, NULL);
 	num_entries_bucket = tmp_bucket->next_free_slot;
 	modify_cache(tree, bucket_id, BUCKET, UNLOCK);
 
@@ -1925,7 +2750,7 @@ static int db_flush(tree_t *tree, relation_t *rel)
 	offset += sizeof(rel->name);
 
 	/* Create a new tuple file */
-	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+	snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 	result = storage_generate_file(tuple_path);
 	if (result == DB_STORAGE_ERROR) {
 		storage_close(fd);
@@ -1959,7 +2784,7 @@ static int db_flush(tree_t *tree, relation_t *rel)
 		/* TODO
 		 * Absent of non-cast return handling, should be taken care in the definition
 		 */
-		bucket_t *bucket = bucket_read(tree, id);
+		bucket_t *bucket = bucket_read(tree, id, NULL);
 
 		int num, ind;
 		int num_entries = bucket->next_free_slot;
@@ -1970,7 +2795,7 @@ static int db_flush(tree_t *tree, relation_t *rel)
 			if (tup >= flush_threshold) {
 				storage_get_row(&old_rel, &tup, temp);
 				storage_put_row(rel, temp, FALSE);
-				uint16_t tmp_key = bucket->pairs[num].key;
+				db_key_t tmp_key = bucket->pairs[num].key;
 				bucket->pairs[ind].key = tmp_key;
 				bucket->pairs[ind].value = num_tuples;
 				num_tuples++;
@@ -1982,8 +2807,8 @@ static int db_flush(tree_t *tree, relation_t *rel)
 		}
 		/* Start Bucket chaining */
 		int iter = 0;
-		uint16_t new_min = bucket->info[1];
-		uint16_t new_max = bucket->info[2];
+		db_key_t new_min = bucket->info[1];
+		db_key_t new_max = bucket->info[2];
 		for (; iter < bucket->next_free_slot; iter++) {
 			new_min = min(bucket->pairs[iter].key, new_min);
 			new_max = max(bucket->pairs[iter].key, new_max);
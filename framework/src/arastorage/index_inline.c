@@ -88,11 +88,12 @@ struct search_handle {
 struct search_handle handle;
 
 /*
- * The create, destroy, load, release, insert, and delete operations
- * of the index API always succeed because the index does not store
- * items separately from the row file. The four former operations share
- * the same signature, and are thus implemented by the null_op function
- * to save space.
+ * The create, destroy, load, release, insert, delete, flush, and bulk load
+ * operations of the index API always succeed because the index does not store
+ * items separately from the row file. The operations having the same
+ * signature as create are implemented by the null_op function to save
+ * space. An iterator holds no resources, so there is nothing to release.
+ * Keys are not summarized, aggregates read the rows.
  */
 index_api_t index_inline = {
 	INDEX_INLINE,
@@ -103,33 +104,37 @@ index_api_t index_inline = {
 	null_op,
 	insert,
 	delete,
-	get_next
+	get_next,
+	null_op,
+	null_op,
+	NULL,
+	NULL
 };
 
 /****************************************************************************
 * Private Functions
 ****************************************************************************/
-static attribute_value_t *get_value(tuple_id_t *index, relation_t *rel, attribute_t *attr)
+static attribute_value_t *get_value(tuple_id_t *index, relation_t *rel, attribute_t *attr, attribute_value_t *value)
 {
 	unsigned char row[rel->row_length];
-	static attribute_value_t value;
 
 	if (DB_ERROR(storage_get_row(rel, index, row))) {
 		return NULL;
 	}
 
-	if (DB_ERROR(relation_get_value(rel, attr, row, &value))) {
+	if (DB_ERROR(relation_get_value(rel, attr, row, value))) {
 		DB_LOG_E("DB: Unable to retrieve a value from tuple %ld\n", (long)(*index));
 		return NULL;
 	}
 
-	return &value;
+	return value;
 }
 
 static tuple_id_t binary_search(index_iterator_t *index_iterator, attribute_value_t *target_value, int exact_match)
 {
 	relation_t *rel;
 	attribute_t *attr;
+	attribute_value_t value;
 	attribute_value_t *cmp_value;
 	tuple_id_t min;
 	tuple_id_t max;
@@ -148,7 +153,7 @@ static tuple_id_t binary_search(index_iterator_t *index_iterator, attribute_valu
 	do {
 		center = min + ((max - min) / 2);
 
-		cmp_value = get_value(&center, rel, attr);
+		cmp_value = get_value(&center, rel, attr, &value);
 		if (cmp_value == NULL) {
 			DB_LOG_E("DB: Failed to get the center value, index = %ld\n", (long)center);
 			return INVALID_TUPLE;
@@ -213,8 +218,8 @@ static db_result_t delete(index_t *index, attribute_value_t *value)
 
 static tuple_id_t get_next(index_iterator_t *iterator, uint8_t inverse_condition)
 {
-	static tuple_id_t cached_start;
-	static tuple_id_t cached_end;
+	tuple_id_t *cached_start = &iterator->cache.range.start;
+	tuple_id_t *cached_end = &iterator->cache.range.end;
 
 	if (iterator->next_item_no == 0) {
 		/*
@@ -222,16 +227,16 @@ static tuple_id_t get_next(index_iterator_t *iterator, uint8_t inverse_condition
 		 * access the first item in the iteration. The first and last tuple
 		 * id:s of the result get cached for subsequent iterations.
 		 */
-		if (DB_ERROR(range_search(iterator, &cached_start, &cached_end))) {
-			cached_start = 0;
-			cached_end = 0;
+		if (DB_ERROR(range_search(iterator, cached_start, cached_end))) {
+			*cached_start = 0;
+			*cached_end = 0;
 			return INVALID_TUPLE;
 		}
-		DB_LOG_D("DB: Cached the tuple range (%ld,%ld)\n", (long)cached_start, (long)cached_end);
+		DB_LOG_D("DB: Cached the tuple range (%ld,%ld)\n", (long)*cached_start, (long)*cached_end);
 		++iterator->next_item_no;
-		return cached_start;
-	} else if (cached_start + iterator->next_item_no <= cached_end) {
-		return cached_start + iterator->next_item_no++;
+		return *cached_start;
+	} else if (*cached_start + iterator->next_item_no <= *cached_end) {
+		return *cached_start + iterator->next_item_no++;
 	}
 
 	return INVALID_TUPLE;
@@ -139,17 +139,20 @@ db_result_t index_create(index_type_t index_type, relation_t *rel, attribute_t *
 		return DB_INDEX_ERROR;
 	}
 
-	if (attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) {
-		DB_LOG_E("DB: Cannot create an index for a non-number attribute!\n");
-		return DB_INDEX_ERROR;
-	}
-
 	api = find_index_api(index_type);
 	if (api == NULL) {
 		DB_LOG_E("DB: No API for index type %d\n", (int)index_type);
 		return DB_INDEX_ERROR;
 	}
 
+	if (attr->domain == DOMAIN_STRING && !(api->flags & INDEX_API_STRING_KEYS)) {
+		DB_LOG_E("DB: Index type %d cannot index the string attribute %s\n", (int)index_type, attr->name);
+		return DB_INDEX_ERROR;
+	} else if (attr->domain != DOMAIN_STRING && attr->domain != DOMAIN_INT && attr->domain != DOMAIN_LONG) {
+		DB_LOG_E("DB: Cannot create an index for a non-number attribute!\n");
+		return DB_INDEX_ERROR;
+	}
+
 	index = memb_alloc(&index_memb);
 	if (index == NULL) {
 		DB_LOG_E("DB: Failed to allocate an index\n");
@@ -244,7 +247,10 @@ db_result_t index_load(relation_t *rel, attribute_t *attr)
 			index = (index_t *)((char *)index_memb.mem + (i * index_memb.size));
 			if ((strcmp(index->rel->name, rel->name) == 0) && strcmp(index->attr->name, attr->name) == 0) {
 				found = true;
-				index_memb.count[i]++;
+				/* Count each attribute once, the index is loaded for every query */
+				if (attr->index != index) {
+					index_memb.count[i]++;
+				}
 				attr->index = index;
 				index->rel = rel;
 				index->attr = attr;
@@ -301,6 +307,87 @@ db_result_t index_release(index_t *index)
 	return DB_OK;
 }
 
+/****************************************************************************
+ * Name: index_flush
+ *
+ * Description: Write the cached data of all loaded indexes to storage and
+ *   sync them, so the indexes on storage are consistent with the relations.
+ *
+ ****************************************************************************/
+db_result_t index_flush(void)
+{
+	db_result_t result = DB_OK;
+	index_t *index;
+
+	for (index = list_head(indices); index != NULL; index = index->next) {
+		if (index->api->flush != NULL && DB_ERROR(index->api->flush(index))) {
+			DB_LOG_E("DB: Failed to flush index on %s.%s\n", index->rel->name, index->attr->name);
+			result = DB_INDEX_ERROR;
+		}
+	}
+	return result;
+}
+
+/****************************************************************************
+ * Name: index_rebuild_attribute
+ *
+ * Description: Create the index of an attribute again from the rows of its
+ *   relation. Files of an index which isn't loaded are removed without
+ *   reading the tree, as they may be written partly before a power loss.
+ *   An attribute which isn't indexed is left as it is.
+ *
+ ****************************************************************************/
+db_result_t index_rebuild_attribute(relation_t *rel, attribute_t *attr)
+{
+	index_type_t type;
+	index_t index;
+
+	if (attr->index != NULL) {
+		type = ((index_t *)attr->index)->type;
+		if (DB_ERROR(index_destroy(attr->index))) {
+			return DB_INDEX_ERROR;
+		}
+	} else {
+		if (DB_ERROR(storage_get_index(&index, rel, attr))) {
+			/* The attribute isn't indexed */
+			return DB_OK;
+		}
+		type = index.type;
+		index.rel = rel;
+		index.attr = attr;
+		index.api = find_index_api(type);
+		index.opaque_data = NULL;
+		if (index.api == NULL || (index.api->flags & INDEX_API_INLINE)) {
+			/* Inline indexes use the rows of relation */
+			return DB_OK;
+		}
+		if (DB_ERROR(index.api->destroy(&index)) || DB_ERROR(storage_remove(index.descriptor_file)) || DB_ERROR(storage_remove_index(rel, attr))) {
+			return DB_INDEX_ERROR;
+		}
+	}
+	DB_LOG_D("DB: Rebuild index over %s.%s\n", rel->name, attr->name);
+	return index_create(type, rel, attr);
+}
+
+/****************************************************************************
+ * Name: index_rebuild
+ *
+ * Description: Create the indexes of a relation again from its rows.
+ *
+ ****************************************************************************/
+db_result_t index_rebuild(relation_t *rel)
+{
+	db_result_t result = DB_OK;
+	attribute_t *attr;
+
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if (DB_ERROR(index_rebuild_attribute(rel, attr))) {
+			result = DB_INDEX_ERROR;
+		}
+	}
+	return result;
+}
+
 db_result_t index_insert(index_t *index, attribute_value_t *value, tuple_id_t tuple_id)
 {
 	return index->api->insert(index, value, tuple_id);
@@ -365,16 +452,18 @@ db_result_t index_get_iterator(index_iterator_t *iterator, index_t *index, attri
 	iterator->min_value = *min_value;
 	iterator->max_value = *max_value;
 	iterator->next_item_no = 0;
+	iterator->found_items = 0;
+	memset(&iterator->cache, 0, sizeof(iterator->cache));
 
-	DB_LOG_D("DB: Acquired an index iterator for %s.%s over the range (%ld,%ld)\n", index->rel->name, index->attr->name, min_value->u.long_value, max_value->u.long_value);
+	DB_LOG_D("DB: Acquired an index iterator for %s.%s over the range (%ld,%ld)\n", index->rel->name, index->attr->name, min, max);
 
 	return DB_OK;
 }
 
 tuple_id_t index_get_next(index_iterator_t *iterator, uint8_t matched_condition)
 {
-	long min;
-	long max;
+	db_key_t min;
+	db_key_t max;
 
 	if (iterator->index == NULL) {
 		/* This attribute is not indexed. */
@@ -382,8 +471,8 @@ tuple_id_t index_get_next(index_iterator_t *iterator, uint8_t matched_condition)
 	}
 
 	if ((iterator->index->attr->flags & ATTRIBUTE_FLAG_UNIQUE) && iterator->next_item_no == 1) {
-		min = db_value_to_long(&iterator->min_value);
-		max = db_value_to_long(&iterator->max_value);
+		min = db_value_to_key(&iterator->min_value);
+		max = db_value_to_key(&iterator->max_value);
 		if (min == max) {
 			/*
 			 * We stop if this is an equivalence search on an attribute
@@ -397,6 +486,26 @@ tuple_id_t index_get_next(index_iterator_t *iterator, uint8_t matched_condition)
 	return iterator->index->api->get_next(iterator, matched_condition);
 }
 
+/* Release the resources held by an iterator which is not iterated to the end. */
+void index_release_iterator(index_iterator_t *iterator)
+{
+	if (iterator->index == NULL || iterator->index->api->release_iterator == NULL) {
+		return;
+	}
+
+	iterator->index->api->release_iterator(iterator);
+}
+
+/* Aggregate the keys of an index in a range without reading the rows. */
+db_result_t index_summarize(index_t *index, attribute_value_t *min_value, attribute_value_t *max_value, uint8_t flags, index_summary_t *summary)
+{
+	if (index->state != INDEX_READY || index->api->summarize == NULL) {
+		return DB_INDEX_ERROR;
+	}
+
+	return index->api->summarize(index, min_value, max_value, flags, summary);
+}
+
 /****************************************************************************
 * Private Functions
 ****************************************************************************/
@@ -444,6 +553,14 @@ db_result_t db_indexing(relation_t *rel)
 		return DB_INDEX_ERROR;
 	}
 
+	if (index->api->bulk_load != NULL) {
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+		storage_flush_insert_buffer();
+#endif
+		DB_LOG_D("DB: Bulk loading the index for %s.%s...\n", index->rel->name, index->attr->name);
+		return index->api->bulk_load(index);
+	}
+
 	row = NULL;
 	row = (storage_row_t)malloc(sizeof(char) * rel->row_length + 1);
 	if (row == NULL) {
@@ -62,6 +62,7 @@
 #include "aql.h"
 #include "db_debug.h"
 #include "lvm.h"
+#include "result.h"
 #include "db_options.h"
 
 /****************************************************************************
@@ -82,7 +83,7 @@ static void print_derivations(variable_t *variables, derivation_t *d)
 	int i;
 	for (i = 0; i < LVM_MAX_VARIABLE_ID; i++) {
 		if (d[i].derived) {
-			DB_LOG_V("%s is constrained to (%ld,%ld)\n", variables[i].name, d[i].min.l, d[i].max.l);
+			DB_LOG_V("%s is constrained to (%lld,%lld)\n", variables[i].name, (long long)d[i].min, (long long)d[i].max);
 		}
 	}
 }
@@ -142,6 +143,25 @@ static long operand_to_long(lvm_instance_t *p, operand_t *operand)
 	}
 }
 
+/*
+ * Strings are only compared with each other, so the caller checks the
+ * operands for a string before converting them to long values.
+ */
+static char *operand_to_string(lvm_instance_t *p, operand_t *operand)
+{
+	switch (operand->type) {
+	case LVM_STRING:
+		return p->strings[operand->value.id];
+	case LVM_VARIABLE:
+		if (p->variables[operand->value.id].type == LVM_STRING) {
+			return p->variables[operand->value.id].value.s;
+		}
+		return NULL;
+	default:
+		return NULL;
+	}
+}
+
 static lvm_status_t eval_expr(lvm_instance_t *p, operator_t op, operand_t *result)
 {
 	int i;
@@ -168,6 +188,9 @@ static lvm_status_t eval_expr(lvm_instance_t *p, operator_t op, operand_t *resul
 		default:
 			return SEMANTIC_ERROR;
 		}
+		if (operand_to_string(p, &operand[i]) != NULL) {
+			return TYPE_ERROR;
+		}
 		value[i] = operand_to_long(p, &operand[i]);
 	}
 
@@ -201,7 +224,8 @@ static int eval_logic(lvm_instance_t *p, operator_t *op)
 {
 	int i;
 	int r;
-	operand_t operand;
+	operand_t operand[2];
+	char *string[2];
 	long result[2];
 	node_type_t type;
 	operator_t *operator;
@@ -237,18 +261,28 @@ static int eval_logic(lvm_instance_t *p, operator_t *op)
 		switch (type) {
 		case LVM_ARITH_OP:
 			operator = get_operator(p);
-			r = eval_expr(p, *operator, &operand);
+			r = eval_expr(p, *operator, &operand[i]);
 			if (LVM_ERROR(r)) {
 				return r;
 			}
 			break;
 		case LVM_OPERAND:
-			get_operand(p, &operand);
+			get_operand(p, &operand[i]);
 			break;
 		default:
 			return SEMANTIC_ERROR;
 		}
-		result[i] = operand_to_long(p, &operand);
+		string[i] = operand_to_string(p, &operand[i]);
+		result[i] = operand_to_long(p, &operand[i]);
+	}
+
+	if (string[0] != NULL || string[1] != NULL) {
+		if (string[0] == NULL || string[1] == NULL) {
+			return TYPE_ERROR;
+		}
+		/* Compare the strings through the sign of strcmp. */
+		result[0] = strcmp(string[0], string[1]);
+		result[1] = 0;
 	}
 
 	l1 = result[0];
@@ -280,6 +314,7 @@ void lvm_reset(lvm_instance_t *p)
 	p->end = 0;
 	p->ip = 0;
 	p->error = 0;
+	p->string_count = 0;
 	memset(p->code, 0, sizeof(p->code));
 	memset(p->variables, 0, sizeof(p->variables));
 	memset(p->derivations, 0, sizeof(p->derivations));
@@ -431,13 +466,22 @@ lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op)
 
 lvm_status_t lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value)
 {
-	operand_value_t operand_value;
+	operand_value_t operand_value = { 0 };
+	variable_id_t id;
 
 	/* Update the internal state of the PLE. */
 	if (attr->domain == DOMAIN_INT) {
 		operand_value.l = value[0] << 8 | value[1];
 	} else if (attr->domain == DOMAIN_LONG) {
-		operand_value.l = (uint32_t)value[0] << 24 | (uint32_t)value[1] << 16 | (uint32_t)value[2] << 8 | value[3];
+		operand_value.l = (int32_t)((uint32_t)value[0] << 24 | (uint32_t)value[1] << 16 | (uint32_t)value[2] << 8 | value[3]);
+	} else if (attr->domain == DOMAIN_STRING) {
+		/* Stored strings are terminated within the element of the row. */
+		id = lookup(p, attr->name);
+		if (id == LVM_MAX_VARIABLE_ID) {
+			return INVALID_IDENTIFIER;
+		}
+		p->variables[id].type = LVM_STRING;
+		operand_value.s = (char *)value;
 	}
 
 	return lvm_set_variable_value(p, attr->name, operand_value);
@@ -453,6 +497,117 @@ lvm_status_t lvm_set_long(lvm_instance_t *p, long l)
 	return lvm_set_operand(p, &op);
 }
 
+/*
+ * String operands refer to a copy of the string in the instance so that
+ * every operand in the code has the same size.
+ */
+static lvm_status_t store_string(lvm_instance_t *p, char *s, operand_t *op)
+{
+	if (p->string_count == LVM_MAX_STRING_ID || strlen(s) >= DB_MAX_ELEMENT_SIZE) {
+		DB_LOG_E("DB: Cannot store string operand \"%s\"\n", s);
+		return VARIABLE_LIMIT_REACHED;
+	}
+
+	op->type = LVM_STRING;
+	op->value.id = p->string_count++;
+	strncpy(p->strings[op->value.id], s, DB_MAX_ELEMENT_SIZE);
+
+	return LVM_TRUE;
+}
+
+lvm_status_t lvm_set_string(lvm_instance_t *p, char *s)
+{
+	operand_t op;
+	lvm_status_t result;
+
+	result = store_string(p, s, &op);
+	if (LVM_ERROR(result)) {
+		return result;
+	}
+
+	return lvm_set_operand(p, &op);
+}
+
+lvm_status_t lvm_set_parameter(lvm_instance_t *p, variable_id_t id)
+{
+	operand_t op;
+
+	op.type = LVM_PARAMETER;
+	op.value.id = id;
+
+	return lvm_set_operand(p, &op);
+}
+
+/*
+ * Replace the parameter operands of id with a long value. Operands are moved
+ * while operators are placed in prefix order, so they're looked up by id
+ * instead of the offsets where they were set.
+ */
+lvm_status_t lvm_bind_parameter(lvm_instance_t *p, variable_id_t id, long l)
+{
+	lvm_ip_t ip;
+	node_type_t type;
+	operand_t operand;
+	lvm_status_t result;
+
+	result = INVALID_IDENTIFIER;
+
+	for (ip = 0; ip < p->end;) {
+		memcpy(&type, p->code + ip, sizeof(type));
+		ip += sizeof(type);
+		if (type != LVM_OPERAND) {
+			ip += sizeof(operator_t);
+			continue;
+		}
+
+		memcpy(&operand, p->code + ip, sizeof(operand));
+		if (operand.type == LVM_PARAMETER && operand.value.id == id) {
+			operand.type = LVM_LONG;
+			operand.value.l = l;
+			memcpy(p->code + ip, &operand, sizeof(operand));
+			result = LVM_TRUE;
+		}
+		ip += sizeof(operand);
+	}
+
+	return result;
+}
+
+/* Replace the parameter operands of id with a string. */
+lvm_status_t lvm_bind_string(lvm_instance_t *p, variable_id_t id, char *s)
+{
+	lvm_ip_t ip;
+	node_type_t type;
+	operand_t operand;
+	operand_t string;
+	lvm_status_t result;
+
+	result = store_string(p, s, &string);
+	if (LVM_ERROR(result)) {
+		return result;
+	}
+
+	result = INVALID_IDENTIFIER;
+
+	for (ip = 0; ip < p->end;) {
+		memcpy(&type, p->code + ip, sizeof(type));
+		ip += sizeof(type);
+		if (type != LVM_OPERAND) {
+			ip += sizeof(operator_t);
+			continue;
+		}
+
+		memcpy(&operand, p->code + ip, sizeof(operand));
+		if (operand.type == LVM_PARAMETER && operand.value.id == id) {
+			memcpy(p->code + ip, &string, sizeof(string));
+			result = LVM_TRUE;
+		}
+		ip += sizeof(operand);
+	}
+
+	return result;
+}
+
 lvm_status_t lvm_register_variable(lvm_instance_t *p, char *name, operand_type_t type)
 {
 	variable_id_t id;
@@ -510,24 +665,24 @@ static void create_intersection(derivation_t *result, derivation_t *d1, derivati
 		if (!d1[i].derived && !d2[i].derived) {
 			continue;
 		} else if (d1[i].derived && !d2[i].derived) {
-			result[i].min.l = d1[i].min.l;
-			result[i].max.l = d1[i].max.l;
+			result[i].min = d1[i].min;
+			result[i].max = d1[i].max;
 		} else if (!d1[i].derived && d2[i].derived) {
-			result[i].min.l = d2[i].min.l;
-			result[i].max.l = d2[i].max.l;
+			result[i].min = d2[i].min;
+			result[i].max = d2[i].max;
 		} else {
 			/* Both derivations have been made; create an
 			   intersection of the ranges. */
-			if (d1[i].min.l > d2[i].min.l) {
-				result[i].min.l = d1[i].min.l;
+			if (d1[i].min > d2[i].min) {
+				result[i].min = d1[i].min;
 			} else {
-				result[i].min.l = d2[i].min.l;
+				result[i].min = d2[i].min;
 			}
 
-			if (d1[i].max.l < d2[i].max.l) {
-				result[i].max.l = d1[i].max.l;
+			if (d1[i].max < d2[i].max) {
+				result[i].max = d1[i].max;
 			} else {
-				result[i].max.l = d2[i].max.l;
+				result[i].max = d2[i].max;
 			}
 		}
 		result[i].derived = 1;
@@ -543,24 +698,24 @@ static void create_union(derivation_t *result, derivation_t *d1, derivation_t *d
 		if (!d1[i].derived && !d2[i].derived) {
 			continue;
 		} else if (d1[i].derived && !d2[i].derived) {
-			result[i].min.l = d1[i].min.l;
-			result[i].max.l = d1[i].max.l;
+			result[i].min = d1[i].min;
+			result[i].max = d1[i].max;
 		} else if (!d1[i].derived && d2[i].derived) {
-			result[i].min.l = d2[i].min.l;
-			result[i].max.l = d2[i].max.l;
+			result[i].min = d2[i].min;
+			result[i].max = d2[i].max;
 		} else {
 			/* Both derivations have been made; create a
 			   union of the ranges. */
-			if (d1[i].min.l > d2[i].min.l) {
-				result[i].min.l = d2[i].min.l;
+			if (d1[i].min > d2[i].min) {
+				result[i].min = d2[i].min;
 			} else {
-				result[i].min.l = d1[i].min.l;
+				result[i].min = d1[i].min;
 			}
 
-			if (d1[i].max.l < d2[i].max.l) {
-				result[i].max.l = d2[i].max.l;
+			if (d1[i].max < d2[i].max) {
+				result[i].max = d2[i].max;
 			} else {
-				result[i].max.l = d1[i].max.l;
+				result[i].max = d1[i].max;
 			}
 		}
 		result[i].derived = 1;
@@ -576,7 +731,10 @@ static int derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
 	operand_t operand[2];
 	int i;
 	int variable_id;
+	operator_t op;
+	operand_t *constant;
 	operand_value_t *value;
+	db_key_t key;
 	derivation_t *derivation;
 
 	type = get_type(p);
@@ -636,45 +794,63 @@ static int derive_relation(lvm_instance_t *p, derivation_t *local_derivations)
 			return DERIVATION_ERROR;
 		}
 		variable_id = operand[0].value.id;
-		value = &operand[1].value;
+		constant = &operand[1];
 	} else {
 		variable_id = operand[1].value.id;
-		value = &operand[0].value;
+		constant = &operand[0];
 	}
 
 	if (variable_id >= LVM_MAX_VARIABLE_ID) {
 		return DERIVATION_ERROR;
 	}
 
-	DB_LOG_D("variable id %d, value %ld\n", variable_id, *(long *)value);
+	value = &constant->value;
+	op = *operator;
+	if (constant->type == LVM_STRING) {
+		/*
+		 * Strings are indexed by their prefix key. Strings sharing the
+		 * prefix have the same key, so strict bounds are widened to
+		 * inclusive ones, and the condition filters out the rest.
+		 */
+		key = db_string_to_key((unsigned char *)p->strings[value->id]);
+		if (op == LVM_GE) {
+			op = LVM_GEQ;
+		} else if (op == LVM_LE) {
+			op = LVM_LEQ;
+		}
+	} else {
+		key = value->l;
+	}
+
+	DB_LOG_D("variable id %d, value %lld\n", variable_id, (long long)key);
 
 	derivation = local_derivations + variable_id;
 	/* Default values. */
-	derivation->max.l = DB_LONG_MAX;
-	derivation->min.l = DB_LONG_MIN;
+	derivation->max = DB_KEY_MAX;
+	derivation->min = DB_KEY_MIN;
 
-	switch (*operator) {
+	switch (op) {
 	case LVM_EQ:
-		derivation->max = *value;
-		derivation->min = *value;
+		derivation->max = key;
+		derivation->min = key;
 		break;
 	case LVM_GE:
-		derivation->min.l = value->l + 1;
+		derivation->min = key + 1;
 		break;
 	case LVM_GEQ:
-		derivation->min.l = value->l;
+		derivation->min = key;
 		break;
 	case LVM_LE:
-		derivation->max.l = value->l - 1;
+		derivation->max = key - 1;
 		break;
 	case LVM_LEQ:
-		derivation->max.l = value->l;
+		derivation->max = key;
 		break;
 	default:
 		return DERIVATION_ERROR;
 	}
 
-	DB_LOG_D("derivation max = %ld, min = %ld\n", derivation->max.l, derivation->min.l);
+	DB_LOG_D("derivation max = %lld, min = %lld\n", (long long)derivation->max, (long long)derivation->min);
 	derivation->derived = 1;
 
 	return LVM_TRUE;
@@ -685,7 +861,7 @@ lvm_status_t lvm_derive(lvm_instance_t *p)
 	return derive_relation(p, p->derivations);
 }
 
-lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, operand_value_t *min, operand_value_t *max)
+lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, db_key_t *min, db_key_t *max)
 {
 	int i;
 
@@ -702,6 +878,61 @@ lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, operand_value_
 	return INVALID_IDENTIFIER;
 }
 
+static int range_relation(lvm_instance_t *p, variable_id_t id)
+{
+	operator_t *operator;
+	operand_t operand[2];
+	int i;
+
+	get_type(p);
+	operator = get_operator(p);
+
+	if (IS_CONNECTIVE(*operator)) {
+		if (*operator != LVM_AND) {
+			return LVM_FALSE;
+		}
+		return range_relation(p, id) && range_relation(p, id);
+	}
+
+	switch (*operator) {
+	case LVM_EQ:
+	case LVM_GE:
+	case LVM_GEQ:
+	case LVM_LE:
+	case LVM_LEQ:
+		break;
+	default:
+		return LVM_FALSE;
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (get_type(p) != LVM_OPERAND) {
+			return LVM_FALSE;
+		}
+		get_operand(p, &operand[i]);
+	}
+
+	return operand[0].type == LVM_VARIABLE && operand[0].value.id == id && operand[1].type == LVM_LONG;
+}
+
+/*
+ * Check whether the condition is exactly the derived range of a variable,
+ * which is so for a conjunction of comparisons of the variable with integers.
+ * Rows whose value is in the range need not be tested then.
+ */
+int lvm_is_range(lvm_instance_t *p, char *name)
+{
+	lvm_ip_t ip;
+	int result;
+
+	ip = p->ip;
+	p->ip = 0;
+	result = range_relation(p, lookup(p, name));
+	p->ip = ip;
+
+	return result;
+}
+
 #if DEBUG
 static lvm_ip_t print_operator(lvm_instance_t *p, lvm_ip_t index)
 {
@@ -756,6 +987,12 @@ static lvm_ip_t print_operand(lvm_instance_t *p, lvm_ip_t index)
 	case LVM_LONG:
 		DB_LOG_D("long:%ld ", operand.value.l);
 		break;
+	case LVM_PARAMETER:
+		DB_LOG_D("param:%d ", operand.value.id);
+		break;
+	case LVM_STRING:
+		DB_LOG_D("string:'%s' ", p->strings[operand.value.id]);
+		break;
 	default:
 		DB_LOG_D("?? ");
 		break;
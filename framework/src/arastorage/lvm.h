@@ -62,6 +62,7 @@
  ****************************************************************************/
 #include <stdlib.h>
 #include "db_options.h"
+#include "attribute.h"
 
 /****************************************************************************
 * Pre-processor Definitions
@@ -118,7 +119,9 @@ typedef enum lvm_operator_e operator_t;
 enum operand_type_e {
 	LVM_VARIABLE,
 	LVM_FLOAT,
-	LVM_LONG
+	LVM_LONG,
+	LVM_PARAMETER,
+	LVM_STRING
 };
 typedef enum operand_type_e operand_type_t;
 
@@ -129,6 +132,7 @@ union operand_value_u {
 	float f;
 #endif
 	variable_id_t id;
+	char *s;
 };
 typedef union operand_value_u operand_value_t;
 
@@ -145,9 +149,10 @@ struct operand_variable_s {
 };
 typedef struct operand_variable_s variable_t;
 
+/* The range of the index keys of a variable that a condition allows */
 struct derivation_s {
-	operand_value_t max;
-	operand_value_t min;
+	db_key_t max;
+	db_key_t min;
 	uint8_t derived;
 };
 typedef struct derivation_s derivation_t;
@@ -156,6 +161,8 @@ struct lvm_instance_s {
 	unsigned char code[DB_VM_BYTECODE_SIZE];
 	variable_t variables[LVM_MAX_VARIABLE_ID];
 	derivation_t derivations[LVM_MAX_VARIABLE_ID];
+	char strings[LVM_MAX_STRING_ID][DB_MAX_ELEMENT_SIZE];
+	uint8_t string_count;
 	lvm_ip_t end;
 	lvm_ip_t ip;
 	unsigned error;
@@ -168,7 +175,8 @@ typedef struct lvm_instance_s lvm_instance_t;
 void lvm_reset(lvm_instance_t *p);
 void lvm_clone(lvm_instance_t *dst, lvm_instance_t *src);
 lvm_status_t lvm_derive(lvm_instance_t *p);
-lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, operand_value_t *min, operand_value_t *max);
+lvm_status_t lvm_get_derived_range(lvm_instance_t *p, char *name, db_key_t *min, db_key_t *max);
+int lvm_is_range(lvm_instance_t *p, char *name);
 void lvm_print_derivations(lvm_instance_t *p);
 lvm_status_t lvm_execute(lvm_instance_t *p);
 lvm_status_t lvm_register_variable(lvm_instance_t *p, char *name, operand_type_t type);
@@ -182,6 +190,10 @@ lvm_status_t lvm_set_relation(lvm_instance_t *p, operator_t op);
 lvm_status_t lvm_set_operand(lvm_instance_t *p, operand_t *op);
 lvm_status_t lvm_set_operand_value(lvm_instance_t *p, attribute_t *attr, unsigned char *value);
 lvm_status_t lvm_set_long(lvm_instance_t *p, long l);
+lvm_status_t lvm_set_string(lvm_instance_t *p, char *s);
+lvm_status_t lvm_set_parameter(lvm_instance_t *p, variable_id_t id);
+lvm_status_t lvm_bind_parameter(lvm_instance_t *p, variable_id_t id, long l);
+lvm_status_t lvm_bind_string(lvm_instance_t *p, variable_id_t id, char *s);
 lvm_status_t lvm_set_variable(lvm_instance_t *p, char *name);
 lvm_status_t lvm_set_variable_value(lvm_instance_t *p, char *name, operand_value_t value);
 #endif							/* LVM_H */
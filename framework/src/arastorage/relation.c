@@ -55,6 +55,7 @@
  * Included Files
  ****************************************************************************/
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <tinyara/config.h>
@@ -69,6 +70,13 @@
 #include "memb.h"
 #include "aql.h"
 #include "relation.h"
+#include "transaction.h"
+
+/****************************************************************************
+* Pre-processor Definitions
+****************************************************************************/
+/* The number of tuple ids allocated first for the rows found in an index. */
+#define DB_INDEX_ROWS_MIN 32
 
 /****************************************************************************
 * Global Function Prototypes
@@ -78,6 +86,9 @@ LIST(relations);
 MEMB(relations_memb, relation_t, DB_RELATION_POOL_SIZE);
 MEMB(attributes_memb, attribute_t, DB_ATTRIBUTE_POOL_SIZE);
 
+/* Suffix of the next query result relation name. */
+static uint16_t g_result_relation_seq;
+
 static relation_t *relation_find(char *);
 static attribute_t *attribute_find(relation_t *, char *);
 static int get_attribute_value_offset(relation_t *, attribute_t *);
@@ -256,6 +267,10 @@ end:
 	}
 
 	rel->cardinality = relation_cardinality(rel);
+	if (rel->references == 1) {
+		/* Loaded from storage, rows are inserted after the stored ones. */
+		rel->next_row = rel->cardinality;
+	}
 	DB_LOG_D("DB: Rel %s, Cardinality %d\n", rel->name, rel->cardinality);
 
 	return rel;
@@ -284,7 +299,8 @@ relation_t *relation_create(char *name, db_direction_t dir)
 	if (*name != '\0') {
 		relation_clear(&old_rel);
 
-		if (storage_get_relation(&old_rel, name) == DB_OK) {
+		/* A relation in memory is not stored, only loaded ones are found. */
+		if ((dir == DB_MEMORY && relation_find(name) != NULL) || (dir == DB_STORAGE && storage_get_relation(&old_rel, name) == DB_OK)) {
 			/* Reject a creation request if the relation already exists. */
 			DB_LOG_E("DB: Attempted to create a relation that already exists (%s)\n", name);
 			return NULL;
@@ -438,6 +454,12 @@ db_result_t relation_remove(relation_t *rel, int remove_tuples)
 	if (rel->references > 1) {
 		return DB_BUSY_ERROR;
 	}
+
+	if (rel->dir == DB_MEMORY) {
+		/* Nothing of the relation is in storage. */
+		relation_free(rel);
+		return DB_OK;
+	}
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 	/* Flush insert buffer to make sure of writing tuples before removing relation */
 	if (DB_SUCCESS(storage_flush_insert_buffer())) {
@@ -461,7 +483,7 @@ db_result_t relation_remove(relation_t *rel, int remove_tuples)
 	if (filename == NULL) {
 		return DB_STORAGE_ERROR;
 	}
-	snprintf(filename, len, "%s%s\0", rel->name, INDEX_NAME_SUFFIX);
+	snprintf(filename, len, "%s%s", rel->name, INDEX_NAME_SUFFIX);
 	result = storage_remove(filename);
 	free(filename);
 	if (DB_ERROR(result)) {
@@ -528,22 +550,101 @@ db_result_t relation_insert(relation_t *rel, attribute_value_t *values)
 			DB_LOG_V(", ");
 		}
 #endif              /* DEBUG */
+		ptr += attr->element_size;
+		attr = attr->next;
+		value++;
+	}
+
+	DB_LOG_V(")\n");
+
+	if (transaction_owned()) {
+		/* Stored on commit of the transaction */
+		return transaction_log_row(rel, record);
+	}
+
+	return relation_insert_row(rel, record);
+}
+
+/****************************************************************************
+ * Name: relation_insert_row
+ *
+ * Description: Store a row in physical format as the next row of relation,
+ *   and insert its values into the indexes of relation.
+ *
+ ****************************************************************************/
+db_result_t relation_insert_row(relation_t *rel, storage_row_t row)
+{
+	attribute_t *attr;
+	attribute_value_t value;
+
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if (attr->flags & ATTRIBUTE_FLAG_INVALID) {
+			continue;
+		}
 		if (attr->index == NULL) {
 			index_load(rel, attr);
 		}
-		ptr += attr->element_size;
 		if (attr->index != NULL) {
-			if (DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
+			if (DB_ERROR(relation_get_value(rel, attr, row, &value)) || DB_ERROR(index_insert(attr->index, &value, rel->next_row))) {
 				return DB_INDEX_ERROR;
 			}
 		}
-		attr = attr->next;
-		value++;
 	}
 
-	DB_LOG_V(")\n");
+	return storage_put_row(rel, row, FALSE);
+}
+
+/****************************************************************************
+ * Name: relation_insert_rows
+ *
+ * Description: Insert rows stored next to each other, in physical format.
+ *   Indexes are updated one after another, and the rows are appended to the
+ *   tuple file with one write.
+ *
+ ****************************************************************************/
+db_result_t relation_insert_rows(relation_t *rel, storage_row_t rows, tuple_id_t count)
+{
+	attribute_t *attr;
+	attribute_value_t value;
+	tuple_id_t i;
+
+	for (attr = list_head(rel->attributes); attr != NULL; attr = attr->next) {
+		if (attr->flags & ATTRIBUTE_FLAG_INVALID) {
+			continue;
+		}
+		if (attr->index == NULL) {
+			index_load(rel, attr);
+		}
+		if (attr->index == NULL) {
+			continue;
+		}
+		for (i = 0; i < count; i++) {
+			if (DB_ERROR(relation_get_value(rel, attr, rows + i * rel->row_length, &value)) || DB_ERROR(index_insert(attr->index, &value, rel->next_row + i))) {
+				return DB_INDEX_ERROR;
+			}
+		}
+	}
 
-	return storage_put_row(rel, record, FALSE);
+	return storage_put_rows(rel, rows, count);
+}
+
+/****************************************************************************
+ * Name: relation_sync
+ *
+ * Description: Sync the tuple files of loaded relations to storage.
+ *
+ ****************************************************************************/
+db_result_t relation_sync(void)
+{
+	relation_t *rel;
+	db_result_t result = DB_OK;
+
+	for (rel = list_head(relations); rel != NULL; rel = rel->next) {
+		if (rel->dir == DB_STORAGE && rel->tuple_storage >= 0 && DB_ERROR(storage_sync(rel->tuple_storage))) {
+			result = DB_STORAGE_ERROR;
+		}
+	}
+	return result;
 }
 
 /*
@@ -647,27 +748,29 @@ static void select_index(db_handle_t **handle)
 {
 	index_t *index;
 	attribute_t *attr;
-	operand_value_t min;
-	operand_value_t max;
+	db_key_t min;
+	db_key_t max;
 	attribute_value_t av_min;
 	attribute_value_t av_max;
-	long range;
-	unsigned long min_range;
+	uint64_t range;
+	uint64_t min_range;
 	index = NULL;
-	min_range = ULONG_MAX;
+	min_range = UINT64_MAX;
 
 	/* Find all indexed and derived attributes, and select the index of
 	   the attribute with the smallest range. */
 	attr = list_head((*handle)->rel->attributes);
 	while (attr != NULL) {
 		if (attr->index != NULL && !LVM_ERROR(lvm_get_derived_range((*handle)->lvm_instance, attr->name, &min, &max))) {
-			range = (unsigned long)max.l - (unsigned long)min.l;
-			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %ld values\n", attr->name, range + 1);
+			range = (uint64_t)max - (uint64_t)min;
+			DB_LOG_D("DB: The search range for attribute \"%s\" comprises %llu values\n", attr->name, (unsigned long long)range + 1);
 			if (range <= min_range) {
+				min_range = range;
 				index = attr->index;
-				av_min.domain = av_max.domain = DOMAIN_INT;
-				VALUE_LONG(&av_min) = min.l;
-				VALUE_LONG(&av_max) = max.l;
+				/* Derived ranges are ranges of index keys. */
+				av_min.domain = av_max.domain = DOMAIN_KEY;
+				VALUE_KEY(&av_min) = min;
+				VALUE_KEY(&av_max) = max;
 			}
 		}
 		attr = attr->next;
@@ -683,27 +786,123 @@ static void select_index(db_handle_t **handle)
 	}
 }
 
-static void relation_index_clear(relation_t *rel)
+/*
+ * Answer an aggregation without reading rows when it's possible. A count of
+ * all rows is the cardinality of the relation, other aggregates are made of
+ * the keys of a B+tree index on the attribute. A condition is allowed only if
+ * it's a range of the attribute of the index searched.
+ */
+static void select_aggregate_index(db_handle_t *handle)
 {
-	char *filename;
-	attribute_t *attr_ptr;
-	int len;
+	source_dest_map_t *attr_map_ptr, *attr_map_end;
+	attribute_t *from_attr;
+	attribute_t *range_attr;
+	attribute_value_t av_min;
+	attribute_value_t av_max;
+	index_summary_t summary;
+	tuple_id_t cardinality;
+	double values[AQL_ATTRIBUTE_LIMIT];
+	uint8_t flags;
+	int i;
 
-	len = strlen(rel->name) + strlen(INDEX_NAME_SUFFIX) + 1;
-	filename = (char *)malloc(sizeof(char) * len);
-	if (filename == NULL) {
+	range_attr = NULL;
+	av_min.domain = av_max.domain = DOMAIN_LONG;
+	VALUE_LONG(&av_min) = LONG_MIN;
+	VALUE_LONG(&av_max) = LONG_MAX;
+	if (handle->lvm_instance != NULL) {
+		if (!(handle->flags & DB_HANDLE_FLAG_SEARCH_INDEX)) {
+			return;
+		}
+		range_attr = handle->index_iterator.index->attr;
+		if (!lvm_is_range(handle->lvm_instance, range_attr->name)) {
+			return;
+		}
+		av_min = handle->index_iterator.min_value;
+		av_max = handle->index_iterator.max_value;
+	}
+
+	cardinality = relation_cardinality(handle->rel);
+	if (cardinality == INVALID_TUPLE) {
 		return;
 	}
-	snprintf(filename, len, "%s%s\0", rel->name, INDEX_NAME_SUFFIX);
-	storage_remove(filename);
-	attr_ptr = list_head(rel->attributes);
-	while (attr_ptr != NULL) {
-		if (attr_ptr->index != NULL) {
-			attr_ptr->index = NULL;
+
+	attr_map_end = handle->attr_map + handle->result_rel->attribute_count;
+	for (attr_map_ptr = handle->attr_map, i = 0; attr_map_ptr < attr_map_end; attr_map_ptr++, i++) {
+		from_attr = attr_map_ptr->from_attr;
+		if (attr_map_ptr->to_attr->aggregator == AQL_NONE) {
+			values[i] = attr_map_ptr->to_attr->aggregation_value;
+			continue;
+		}
+		if (from_attr->domain != DOMAIN_INT && from_attr->domain != DOMAIN_LONG) {
+			return;
+		}
+
+		if (attr_map_ptr->to_attr->aggregator == AQL_COUNT && range_attr == NULL) {
+			values[i] = (double)cardinality;
+			continue;
+		}
+
+		if (range_attr != NULL) {
+			if (attr_map_ptr->to_attr->aggregator != AQL_COUNT && from_attr != range_attr) {
+				return;
+			}
+			from_attr = range_attr;
+		}
+
+		switch (attr_map_ptr->to_attr->aggregator) {
+		case AQL_MIN:
+			flags = INDEX_SUMMARY_MIN;
+			break;
+		case AQL_MAX:
+			flags = INDEX_SUMMARY_MAX;
+			break;
+		default:
+			flags = INDEX_SUMMARY_ALL;
+			break;
+		}
+
+		if (from_attr->index == NULL || DB_ERROR(index_summarize(from_attr->index, &av_min, &av_max, flags, &summary))) {
+			return;
+		}
+		if (range_attr == NULL && (flags & INDEX_SUMMARY_ALL) && summary.count != cardinality) {
+			DB_LOG_D("DB: The index of %s has %lu keys for %lu rows\n", from_attr->name, (unsigned long)summary.count, (unsigned long)cardinality);
+			return;
+		}
+
+		/* An empty range keeps the initial value of the aggregation. */
+		values[i] = attr_map_ptr->to_attr->aggregation_value;
+		switch (attr_map_ptr->to_attr->aggregator) {
+		case AQL_COUNT:
+			values[i] = (double)summary.count;
+			break;
+		case AQL_SUM:
+			values[i] = summary.sum;
+			break;
+		case AQL_MEAN:
+			if (summary.count > 0) {
+				values[i] = summary.sum / summary.count;
+			}
+			break;
+		case AQL_MAX:
+			if (summary.count > 0) {
+				values[i] = (double)summary.max;
+			}
+			break;
+		case AQL_MIN:
+			if (summary.count > 0) {
+				values[i] = (double)summary.min;
+			}
+			break;
+		default:
+			return;
 		}
-		attr_ptr = attr_ptr->next;
 	}
-	free(filename);
+
+	for (attr_map_ptr = handle->attr_map, i = 0; attr_map_ptr < attr_map_end; attr_map_ptr++, i++) {
+		attr_map_ptr->to_attr->aggregation_value = values[i];
+	}
+	handle->flags |= DB_HANDLE_FLAG_AGGREGATED;
+	DB_LOG_D("DB: Aggregated relation %s without reading rows\n", handle->rel->name);
 }
 
 static db_result_t generate_selection_result(db_handle_t **handle, relation_t *rel)
@@ -746,6 +945,10 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 		}
 	}
 
+	if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
+		select_aggregate_index(*handle);
+	}
+
 	(*handle)->tuple = (tuple_t)malloc(sizeof(char) * result_rel->row_length + 1);
 	if ((*handle)->tuple == NULL) {
 		DB_LOG_E("DB: Failed to malloc tuple row\n");
@@ -759,7 +962,7 @@ static db_result_t generate_selection_result(db_handle_t **handle, relation_t *r
 	return DB_OK;
 }
 
-db_result_t relation_process(db_handle_t **handle, db_cursor_t *cursor)
+db_result_t relation_process(db_handle_t **handle)
 {
 	uint32_t optype;
 	if (handle == NULL || *handle == NULL) {
@@ -768,9 +971,9 @@ db_result_t relation_process(db_handle_t **handle, db_cursor_t *cursor)
 	optype = AQL_GET_EXEC_TYPE((*handle)->optype);
 	switch (optype) {
 	case AQL_TYPE_REMOVE_TUPLES:
-		return relation_process_remove(handle, cursor);
+		return relation_process_remove(handle);
 	case AQL_TYPE_SELECT:
-		return relation_process_select(handle, cursor);
+		return relation_process_select(handle);
 	default:
 		DB_LOG_E("DB: Invalid operation type: %d\n", optype);
 		return DB_INCONSISTENCY_ERROR;
@@ -786,166 +989,261 @@ int db_processing_status(db_handle_t *handle)
 	return handle->flags & DB_HANDLE_FLAG_PROCESSING;
 }
 
-db_result_t relation_process_select(db_handle_t **handle, db_cursor_t *cursor)
+/*
+ * Project a row to the result tuple and evaluate the condition on it.
+ * DB_GOT_ROW is returned when the row is a result of the selection.
+ */
+static db_result_t select_row(db_handle_t *handle, storage_row_t row)
 {
 	db_result_t result;
-	unsigned attribute_count;
 	source_dest_map_t *attr_map_ptr, *attr_map_end;
-	attribute_t *result_attr, *from_attr;
-	unsigned char *from_ptr, *to_ptr;
-	char aggr_buf[8];
+	attribute_t *from_attr;
+	unsigned char *from_ptr;
 	attribute_value_t value;
-	storage_row_t row = NULL;
-	tuple_t result_row;
 
-	if (cursor == NULL) {
-		return DB_CURSOR_ERROR;
-	}
-	if ((*handle)->tuple == NULL) {
-		return DB_ALLOCATION_ERROR;
-	}
+	attr_map_end = handle->attr_map + handle->result_rel->attribute_count;
 
-	result_row = (*handle)->tuple;
-	attribute_count = (*handle)->result_rel->attribute_count;
-	attr_map_end = (*handle)->attr_map + attribute_count;
+	/* Process the attributes in the result relation. */
+	for (attr_map_ptr = handle->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		from_ptr = row + attr_map_ptr->from_offset;
+		from_attr = attr_map_ptr->from_attr;
 
-	if ((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
-		(*handle)->tuple_id = index_get_next(&((*handle)->index_iterator), TRUE);
-		if ((*handle)->tuple_id == INVALID_TUPLE) {
-			DB_LOG_E("DB: An attribute value could not be found in the index\n");
-			if ((*handle)->index_iterator.next_item_no == 0) {
-				return DB_INDEX_ERROR;
-			}
-			if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
-				result = DB_FINISHED;
-				goto processing_aggregation;
-			}
-			return DB_FINISHED;
+		if (handle->lvm_instance != NULL && (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG || from_attr->domain == DOMAIN_STRING)) {
+			lvm_set_operand_value(handle->lvm_instance, from_attr, from_ptr);
 		}
-	} else {
-		(*handle)->tuple_id++;
-	}
 
-	row = (storage_row_t)malloc(sizeof(char) * (*handle)->rel->row_length + 1);
-	if (row == NULL) {
-		DB_LOG_E("DB: Failed to allocate row\n");
-		return DB_ALLOCATION_ERROR;
+		if (!(handle->adt_flags & AQL_FLAG_AGGREGATE)) {
+			/* No aggregators. Copy the original value into the resulting tuple. */
+			memcpy(handle->tuple + attr_map_ptr->to_offset, from_ptr, from_attr->element_size);
+		}
 	}
 
-	/* Put the tuples fulfilling the- given condition into a new relation.
-	   The tuples may be projected. */
-	result = storage_get_row((*handle)->rel, &((*handle)->tuple_id), row);
-	if (DB_ERROR(result)) {
-		DB_LOG_E("DB: Failed to get a row in relation %s!\n", (*handle)->rel->name);
-		goto errout;
-	} else if (result == DB_FINISHED) {
-		if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
-			goto processing_aggregation;
-		}
-		if (row != NULL) {
-			free(row);
-		}
-		return DB_FINISHED;
+	/* Check whether the given predicate is true for this tuple. */
+	if (handle->lvm_instance != NULL && lvm_execute(handle->lvm_instance) != TRUE) {
+		return DB_OK;
 	}
 
-	/* Process the attributes in the result relation. */
-	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-		from_ptr = row + attr_map_ptr->from_offset;
-		from_attr = attr_map_ptr->from_attr;
+	handle->current_row++;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
-			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
-		}
+	if (!(handle->adt_flags & AQL_FLAG_AGGREGATE)) {
+		/* Skip the rows before the OFFSET of the query. */
+		return handle->current_row > handle->offset ? DB_GOT_ROW : DB_OK;
+	}
 
-		if (from_attr->flags & ATTRIBUTE_FLAG_NO_STORE) {
-			/* The attribute is used just for the predicate,
-			   so do not copy the current value into the result. */
+	for (attr_map_ptr = handle->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		if (attr_map_ptr->to_attr->aggregator == AQL_NONE) {
+			/* The attribute is used just for the condition. */
 			continue;
 		}
 
-		if (!((*handle)->adt_flags & AQL_FLAG_AGGREGATE)) {
-			/* No aggregators. Copy the original value into the resulting tuple. */
-			memcpy(result_row + attr_map_ptr->to_offset, from_ptr, from_attr->element_size);
+		from_ptr = row + attr_map_ptr->from_offset;
+		result = db_phy_to_value(&value, attr_map_ptr->from_attr, from_ptr);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+
+		result = aggregate(attr_map_ptr->to_attr, &value, handle->current_row);
+		if (DB_ERROR(result)) {
+			return result;
 		}
 	}
 
-	/* Check whether the given predicate is true for this tuple. */
-	if ((*handle)->lvm_instance == NULL || lvm_execute((*handle)->lvm_instance) == TRUE) {
-		(*handle)->current_row++;
+	return DB_OK;
+}
 
-		if ((*handle)->adt_flags & AQL_FLAG_AGGREGATE) {
-			for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-				from_ptr = row + attr_map_ptr->from_offset;
-				result = db_phy_to_value(&value, attr_map_ptr->from_attr, from_ptr);
-				if (DB_ERROR(result)) {
-					goto errout;
-				}
+static int tuple_id_compare(const void *a, const void *b)
+{
+	tuple_id_t x = *(const tuple_id_t *)a;
+	tuple_id_t y = *(const tuple_id_t *)b;
 
-				result = aggregate(attr_map_ptr->to_attr, &value, (*handle)->current_row);
-				if (DB_ERROR(result)) {
-					goto errout;
-				}
-			}
-		} else {
-			result = cursor_data_add(cursor, (*handle)->tuple_id);
-			if (DB_ERROR(result)) {
-				goto errout;
+	return x < y ? -1 : x > y;
+}
+
+/*
+ * Collect the tuple ids in the range of the index at once, so that the index
+ * is not locked while the rows are selected. The ids are sorted to read the
+ * rows in the order of the relation file.
+ */
+static db_result_t select_index_rows(db_handle_t *handle)
+{
+	tuple_id_t tuple_id;
+	tuple_id_t *rows;
+	tuple_id_t *new_rows;
+	tuple_id_t size;
+	tuple_id_t count;
+	tuple_id_t i;
+
+	rows = NULL;
+	size = 0;
+	count = 0;
+	while ((tuple_id = index_get_next(&handle->index_iterator, TRUE)) != INVALID_TUPLE) {
+		if (count == size) {
+			size = size == 0 ? DB_INDEX_ROWS_MIN : size * 2;
+			new_rows = (tuple_id_t *)realloc(rows, sizeof(tuple_id_t) * size);
+			if (new_rows == NULL) {
+				DB_LOG_E("DB: Failed to allocate the rows found in the index\n");
+				free(rows);
+				index_release_iterator(&handle->index_iterator);
+				return DB_ALLOCATION_ERROR;
 			}
+			rows = new_rows;
 		}
+		rows[count++] = tuple_id;
 	}
+	index_release_iterator(&handle->index_iterator);
 
-	if (row != NULL) {
-		free(row);
+	if (count > 1) {
+		qsort(rows, count, sizeof(tuple_id_t), tuple_id_compare);
+		size = 1;
+		for (i = 1; i < count; i++) {
+			if (rows[i] != rows[size - 1]) {
+				rows[size++] = rows[i];
+			}
+		}
+		count = size;
 	}
+	DB_LOG_D("DB: Found %lu rows in the index\n", (unsigned long)count);
+
+	handle->index_rows = rows;
+	handle->index_row_count = count;
+	handle->index_row_next = 0;
+	handle->flags |= DB_HANDLE_FLAG_INDEX_ROWS;
+
 	return DB_OK;
+}
 
-processing_aggregation:
-	/* Generate aggregated result if requested. */
-	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
-		result_attr = attr_map_ptr->to_attr;
-		to_ptr = result_row + attr_map_ptr->to_offset;
+/*
+ * Select rows until a row of the result is found, which is left in the tuple
+ * of the handle. An aggregation reads all the rows and results in one row.
+ */
+db_result_t relation_process_select(db_handle_t **handle)
+{
+	db_result_t result;
+	unsigned attribute_count;
+	source_dest_map_t *attr_map_ptr, *attr_map_end;
+	attribute_t *result_attr;
+	attribute_value_t value;
+	storage_row_t row;
+	tuple_t result_row;
 
-		snprintf(aggr_buf, sizeof(aggr_buf), "%f", result_attr->aggregation_value);
-		from_ptr = (unsigned char *)aggr_buf;
-		memcpy(to_ptr, from_ptr, sizeof(aggr_buf));
+	if ((*handle)->tuple == NULL) {
+		return DB_ALLOCATION_ERROR;
 	}
 
-	/* Copy aggregated result to tuple in cursor */
-	memcpy(cursor->tuple, result_row, sizeof(cursor->tuple));
+	result_row = (*handle)->tuple;
+	attribute_count = (*handle)->result_rel->attribute_count;
+	attr_map_end = (*handle)->attr_map + attribute_count;
 
-	(*handle)->current_row = 0;
-	(*handle)->adt_flags &= ~AQL_FLAG_AGGREGATE; /* Stop the aggregation. */
+	if ((*handle)->flags & DB_HANDLE_FLAG_AGGREGATED) {
+		goto end_selection;
+	}
 
-	result = cursor_data_add(cursor, (*handle)->current_row);
-	if (DB_ERROR(result)) {
-		goto errout;
+	if (!((*handle)->adt_flags & AQL_FLAG_AGGREGATE) && (*handle)->limit != AQL_NO_LIMIT && (*handle)->current_row >= (*handle)->offset && (*handle)->current_row - (*handle)->offset >= (*handle)->limit) {
+		/* The LIMIT of the query is reached, no need to read further. */
+		goto end_selection;
 	}
-	cursor->total_rows = 1;
 
-	if (row != NULL) {
-		free(row);
+	if ((*handle)->flags & DB_HANDLE_FLAG_SEARCH_INDEX) {
+		if (!((*handle)->flags & DB_HANDLE_FLAG_INDEX_ROWS)) {
+			result = select_index_rows(*handle);
+			if (DB_ERROR(result)) {
+				return result;
+			}
+		}
+
+		while ((*handle)->index_row_next < (*handle)->index_row_count) {
+			(*handle)->tuple_id = (*handle)->index_rows[(*handle)->index_row_next++];
+			result = storage_scan_get_row(&(*handle)->scan, (*handle)->rel, (*handle)->tuple_id, &row);
+			if (DB_ERROR(result)) {
+				DB_LOG_E("DB: Failed to get a row in relation %s!\n", (*handle)->rel->name);
+				return result;
+			} else if (result == DB_FINISHED) {
+				break;
+			}
+
+			result = select_row(*handle, row);
+			if (result != DB_OK) {
+				return result;
+			}
+		}
+		goto end_selection;
 	}
-	return DB_FINISHED;
 
-errout:
-	if (row != NULL) {
-		free(row);
+	/* Select the tuples fulfilling the given condition. The tuples may be
+	   projected. All rows read in a block are processed before reading the
+	   next block. */
+	do {
+		(*handle)->tuple_id++;
+		result = storage_scan_get_row(&(*handle)->scan, (*handle)->rel, (*handle)->tuple_id, &row);
+		if (DB_ERROR(result)) {
+			DB_LOG_E("DB: Failed to get a row in relation %s!\n", (*handle)->rel->name);
+			return result;
+		} else if (result == DB_FINISHED) {
+			goto end_selection;
+		}
+
+		result = select_row(*handle, row);
+		if (result != DB_OK) {
+			return result;
+		}
+	} while (storage_scan_has_row(&(*handle)->scan, (*handle)->rel, (*handle)->tuple_id + 1));
+
+	return DB_OK;
+
+end_selection:
+	(*handle)->flags &= ~DB_HANDLE_FLAG_PROCESSING;
+	if (!((*handle)->adt_flags & AQL_FLAG_AGGREGATE)) {
+		DB_LOG_D("DB: Finished selecting tuples of relation %s\n", (*handle)->rel->name);
+		return DB_FINISHED;
 	}
 
-	return result;
+	/* Generate aggregated result if requested. A mean is a double, the others are longs. */
+	for (attr_map_ptr = (*handle)->attr_map; attr_map_ptr < attr_map_end; attr_map_ptr++) {
+		result_attr = attr_map_ptr->to_attr;
+		if (result_attr->aggregator == AQL_NONE) {
+			memset(result_row + attr_map_ptr->to_offset, 0, result_attr->element_size);
+			continue;
+		}
+
+		value.domain = result_attr->domain;
+		if (result_attr->domain == DOMAIN_DOUBLE) {
+			VALUE_DOUBLE(&value) = result_attr->aggregation_value;
+		} else {
+			VALUE_LONG(&value) = (long)result_attr->aggregation_value;
+		}
+
+		result = db_value_to_phy(result_row + attr_map_ptr->to_offset, result_attr, &value);
+		if (DB_ERROR(result)) {
+			return result;
+		}
+	}
+
+	return DB_GOT_ROW;
+}
+
+/*
+ * Restart a selection from the first row. Tuple ids found in the index are
+ * kept, so the index is not searched again. An aggregation has one row only,
+ * it's never rewound.
+ */
+void relation_process_rewind(db_handle_t *handle)
+{
+	handle->tuple_id = -1;
+	handle->index_row_next = 0;
+	handle->current_row = 0;
+	handle->flags |= DB_HANDLE_FLAG_PROCESSING;
 }
 
-db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
+db_result_t relation_process_remove(db_handle_t **handle)
 {
 	db_result_t result;
 	unsigned attribute_count;
 	unsigned char *from_ptr;
 	attribute_t *from_attr;
-	storage_row_t row = NULL;
+	storage_row_t row;
 	tuple_t result_row;
 	source_dest_map_t *attr_map_ptr, *attr_map_end;
 	char name[RELATION_NAME_LENGTH + 1];
-	int i;
 
 	if ((*handle)->tuple == NULL) {
 		return DB_ALLOCATION_ERROR;
@@ -958,15 +1256,9 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 	/* Search all tuples sequentially without index. */
 	(*handle)->tuple_id++;
 
-	row = (storage_row_t)malloc(sizeof(char) * (*handle)->rel->row_length + 1);
-	if (row == NULL) {
-		DB_LOG_E("DB: Failed to allocate row\n");
-		return DB_ALLOCATION_ERROR;
-	}
-
 	/* Put the tuples fulfilling the- given condition into a new relation.
 	   The tuples may be projected. */
-	result = storage_get_row((*handle)->rel, &((*handle)->tuple_id), row);
+	result = storage_scan_get_row(&(*handle)->scan, (*handle)->rel, (*handle)->tuple_id, &row);
 	if (DB_ERROR(result)) {
 		DB_LOG_E("DB: Failed to get a row in relation %s!\n", (*handle)->rel->name);
 		goto errout;
@@ -979,7 +1271,7 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 		from_ptr = row + attr_map_ptr->from_offset;
 		from_attr = attr_map_ptr->from_attr;
 
-		if (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG) {
+		if ((*handle)->lvm_instance != NULL && (from_attr->domain == DOMAIN_INT || from_attr->domain == DOMAIN_LONG)) {
 			lvm_set_operand_value((*handle)->lvm_instance, from_attr, from_ptr);
 		}
 
@@ -1001,21 +1293,20 @@ db_result_t relation_process_remove(db_handle_t **handle, db_cursor_t *cursor)
 		}
 
 		(*handle)->current_row++;
-		if (row != NULL) {
-			free(row);
-		}
 		return DB_GOT_ROW;
 	}
 
-	if (row != NULL) {
-		free(row);
-	}
 	return DB_OK;
 
 end_removal:
-	DB_LOG_E("DB: Finished removing tuples. Result relation has %d tuples\n", (*handle)->result_rel->cardinality);
+	DB_LOG_D("DB: Finished removing tuples. Result relation has %d tuples\n", (*handle)->result_rel->cardinality);
 	memcpy(name, (*handle)->rel->name, sizeof(name));
-	relation_remove((*handle)->rel, 1);
+	result = relation_remove((*handle)->rel, 1);
+	if (DB_ERROR(result)) {
+		DB_LOG_E("DB: Failed to remove relation %s\n", name);
+		goto errout;
+	}
+	(*handle)->rel = NULL;
 
 	/* Rename the name of new relation to old relation */
 	result = relation_rename((*handle)->result_rel->name, name);
@@ -1023,25 +1314,7 @@ end_removal:
 		DB_LOG_E("DB: Failed to rename newly created relation\n");
 		goto errout;
 	}
-	memcpy((*handle)->result_rel->name, (*handle)->rel->name, sizeof((*handle)->result_rel->name));
-
-	/* Process finished, we allocate cursor for result of remove */
-	if (DB_ERROR(cursor_init(&cursor, (*handle)->result_rel)) || DB_ERROR(cursor_data_set(cursor, (*handle)->attr_map, (*handle)->result_rel->attribute_count))) {
-		DB_LOG_E("DB: Failed to init cursor and set cursor data\n");
-		goto errout;
-	}
-
-	/* Add cursor tuple data to new relation created by remove operation for update. */
-	for (i = 0; i < (*handle)->result_rel->cardinality; i++) {
-		if (DB_ERROR(cursor_data_add(cursor, i))) {
-			DB_LOG_E("DB: Failed to add cursor tuple data into new relation\n");
-			goto errout;
-		}
-	}
-
-	if (row != NULL) {
-		free(row);
-	}
+	memcpy((*handle)->result_rel->name, name, sizeof((*handle)->result_rel->name));
 
 	return DB_FINISHED;
 
@@ -1050,13 +1323,14 @@ errout:
 	storage_write_buffer_clean();
 #endif
 
-	if (row != NULL) {
-		free(row);
-	}
-
 	return result;
 }
 
+/*
+ * Make a cursor for the result of a query. A selection is handed over to the
+ * cursor with the handle, the rows are selected as the cursor moves. Removal
+ * of tuples is done here, the cursor reads the remaining tuples from storage.
+ */
 db_cursor_t *relation_process_result(db_handle_t *handler)
 {
 	db_result_t res;
@@ -1067,41 +1341,37 @@ db_cursor_t *relation_process_result(db_handle_t *handler)
 		DB_LOG_E("DB: Failed to malloc cursor\n");
 		return NULL;
 	}
-	memset(cursor, 0, sizeof(db_cursor_t));
 
-	/* when SELECT, cursor row data is set in processing tuple by tuple.
-	   So we need to initialize cursor and make cursor data before processing tuples */
 	if (handler->optype == AQL_TYPE_SELECT) {
-		if (DB_ERROR(cursor_init(&cursor, handler->rel)) || DB_ERROR(cursor_data_set(cursor, handler->attr_map, handler->result_rel->attribute_count))) {
+		if (DB_ERROR(cursor_init(cursor, handler->result_rel)) || DB_ERROR(cursor_attach(cursor, handler))) {
 			DB_LOG_E("DB: Failed to init cursor and set cursor data\n");
+			/* The handle is freed by the caller. */
+			cursor->handle = NULL;
 			cursor_deinit(cursor);
 			return NULL;
 		}
+		return cursor;
 	}
 
-	res = DB_ARGUMENT_ERROR;
-	while (db_processing_status(handler)) {
-		res = relation_process(&handler, cursor);
-		if (DB_ERROR(res)) {
-			DB_LOG_E("DB: Failed to process tuples : %d\n", res);
-			cursor_deinit(cursor);
-			return NULL;
-		}
-		switch (res) {
-		case DB_FINISHED:
-			DB_LOG_V("DB: Processing tuples is done!\n");
-			return cursor;
-		case DB_OK:
-			continue;
-		case DB_GOT_ROW:
-			break;
-		default:
-			DB_LOG_E("[%d]\n", res);
-			break;
-		}
+	do {
+		res = relation_process(&handler);
+	} while (res == DB_OK || res == DB_GOT_ROW);
+
+	if (res != DB_FINISHED) {
+		DB_LOG_E("DB: Failed to process tuples : %d\n", res);
+		free(cursor);
+		return NULL;
 	}
-	cursor_deinit(cursor);
-	return NULL;
+
+	if (DB_ERROR(cursor_init(cursor, handler->result_rel))) {
+		DB_LOG_E("DB: Failed to init cursor and set cursor data\n");
+		cursor_deinit(cursor);
+		return NULL;
+	}
+	cursor->cursor_rows = handler->result_rel->cardinality;
+	cursor->flags |= CURSOR_FLAG_FINISHED;
+
+	return cursor;
 }
 
 db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr)
@@ -1112,6 +1382,7 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 	char *attribute_name;
 	attribute_t *attr, *attr_ptr;
 	relation_t * res_rel;
+	char result_name[RELATION_NAME_LENGTH];
 	int i;
 	int normal_attributes = 0;
 	adt = (aql_adt_t *)adt_ptr;
@@ -1120,17 +1391,23 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 	DB_LOG_D("relation_select... optype = %d\n", (*handle)->optype);
 	(*handle)->adt_flags = AQL_GET_FLAGS(adt);
 	(*handle)->lvm_instance = (lvm_instance_t *)adt->lvm_instance;
+	(*handle)->limit = adt->limit;
+	(*handle)->offset = adt->offset;
 
 	if (AQL_GET_FLAGS(adt) & AQL_FLAG_ASSIGN) {
 		name = adt->relations[0];
 		dir = DB_STORAGE;
 	} else {
-		name = RESULT_RELATION;
+		/* Each query has its own result relation, queries may run at once. */
+		snprintf(result_name, sizeof(result_name), "%s%u", RESULT_RELATION, (unsigned)g_result_relation_seq++);
+		name = result_name;
 		dir = DB_MEMORY;
 	}
 
-	res_rel = relation_load(name);
-	relation_remove(res_rel, 1);
+	if (dir == DB_STORAGE) {
+		res_rel = relation_load(name);
+		relation_remove(res_rel, 1);
+	}
 	relation_create(name, dir);
 	(*handle)->result_rel = relation_load(name);
 
@@ -1172,7 +1449,17 @@ db_result_t relation_select(db_handle_t **handle, relation_t *rel, void *adt_ptr
 
 			DB_LOG_D("DB: Found attribute %s in relation %s\n", attribute_name, rel->name);
 
-			attr = relation_attribute_add((*handle)->result_rel, dir, attribute_name, adt->aggregators[i] ? DOMAIN_DOUBLE : attr->domain, adt->aggregators[i] ? sizeof(double) : attr->element_size);
+			switch (adt->aggregators[i]) {
+			case AQL_NONE:
+				attr = relation_attribute_add((*handle)->result_rel, dir, attribute_name, attr->domain, attr->element_size);
+				break;
+			case AQL_MEAN:
+				attr = relation_attribute_add((*handle)->result_rel, dir, attribute_name, DOMAIN_DOUBLE, sizeof(double));
+				break;
+			default:
+				attr = relation_attribute_add((*handle)->result_rel, dir, attribute_name, DOMAIN_LONG, 4);
+				break;
+			}
 
 			if (attr == NULL) {
 				DB_LOG_E("DB: Failed to add a result attribute\n");
@@ -69,35 +69,14 @@
 * Pre-processor Definitions
 ****************************************************************************/
 
-/* This decides index in int array */
-#define GET_INDEX(a) ((a) / (sizeof(uint32_t) * 8))
-
-/* This decides index in a int value of array */
-#define GET_POS(a) ((a) % (sizeof(uint32_t) * 8))
-
-/* This decides int array size to present all tuples in relation */
-#define GET_CURSOR_DATA_ARR_SIZE(a) (((a) / (sizeof(uint32_t) * 8)) + 1)
-
-/* Set a bit to 1 */
-#define BIT_SET(a, b) ((a) |= (1u << (b)))
-
-/* Clear a bit to 0 */
-#define BIT_CLEAR(a, b) ((a) &= ~(1u << (b)))
-
-/* Reverse a bit */
-#define BIT_FLIP(a, b) ((a) ^= (1u << (b)))
-
-/* Check a bit whether 1 or 0 */
-#define BIT_CHECK(a, b) ((a) & (1u << (b)))
-
 /* Check cursor is empty or not */
-#define IS_EMPTY_CURSOR(a) ((a) == NULL || (a)->total_rows <= 0 || (a)->cursor_rows <= 0)
+#define IS_EMPTY_CURSOR(a) ((a) == NULL || (a)->cursor_rows == 0)
 
 /* check current cursor row is valid or invalid*/
 #define IS_INVALID_CURSOR_ROW(a) ((a) == NULL || ((a)->current_cursor_row >= (a)->cursor_rows))
 
-/* check current storage row is valid or invalid*/
-#define IS_INVALID_STORAGE_ROW(a) ((a) == NULL || ((a)->current_storage_row >= (a)->total_rows) || (a)->current_storage_row >= DB_CURSOR_RESULT_ENTRY)
+/* All rows of the cursor are known, cursor_rows is the total. */
+#define CURSOR_FLAG_FINISHED 0x01
 
 #define RELATION_HAS_TUPLES(rel) ((rel)->tuple_storage >= 0)
 
@@ -150,16 +129,25 @@ struct cursor_data_map_s {
 };
 typedef struct cursor_data_map_s cursor_data_map_t;
 
-/* A structure for cursor in SELECT operation */
+/*
+ * A structure for cursor in SELECT operation. Rows are selected as the cursor
+ * moves, the query handle keeps the selection state between moves. The handle
+ * has selected handle_rows rows so far, and the tuple holds the row tuple_row.
+ * The window keeps the last DB_CURSOR_WINDOW rows selected, row r at slot
+ * r % DB_CURSOR_WINDOW, so that moving back to them needs no rewind.
+ * A cursor without a handle reads its rows from the relation file of name.
+ */
 struct _db_cursor_s {
 	tuple_id_t current_cursor_row;
-	tuple_id_t current_storage_row;
 	tuple_id_t cursor_rows;
-	tuple_id_t total_rows;
+	tuple_id_t handle_rows;
+	tuple_id_t tuple_row;
+	uint8_t flags;
 	attribute_id_t attribute_count;
-	size_t storage_row_length;
-	uint32_t *row_arr;
-	unsigned char tuple[DB_MAX_ELEMENT_SIZE + 1];
+	size_t row_length;
+	db_handle_t *handle;
+	unsigned char *tuple;
+	unsigned char *window;
 	char name[TUPLE_NAME_LENGTH + 1];
 	char rel_name[RELATION_NAME_LENGTH + 1];
 	cursor_data_map_t attr_map[AQL_ATTRIBUTE_LIMIT];
@@ -169,17 +157,20 @@ struct _db_cursor_s {
  * Internal function prototypes
  ****************************************************************************/
 /* Operations for cursor processing */
-db_result_t cursor_init(db_cursor_t **cursor, relation_t *rel);
-db_result_t cursor_load(db_cursor_t **target, db_cursor_t *src);
-db_result_t cursor_data_add(db_cursor_t *cursor, tuple_id_t tuple_id);
+db_result_t cursor_init(db_cursor_t *cursor, relation_t *rel);
+db_result_t cursor_attach(db_cursor_t *cursor, db_handle_t *handle);
+db_result_t cursor_get_row_value(attribute_value_t *value, db_cursor_t *cursor, unsigned col);
 db_result_t cursor_deinit(db_cursor_t *cursor);
 
 
 /* API for relations. */
 db_result_t relation_init(void);
 db_result_t relation_deinit(void);
-db_result_t relation_process_remove(db_handle_t **, db_cursor_t *);
-db_result_t relation_process_select(db_handle_t **, db_cursor_t *);
+db_result_t relation_process(db_handle_t **);
+int db_processing_status(db_handle_t *);
+db_result_t relation_process_remove(db_handle_t **);
+db_result_t relation_process_select(db_handle_t **);
+void relation_process_rewind(db_handle_t *);
 db_cursor_t *relation_process_result(db_handle_t *);
 relation_t *relation_load(char *);
 db_result_t relation_release(relation_t *);
@@ -192,6 +183,9 @@ db_result_t relation_attribute_remove(relation_t *, char *);
 db_result_t relation_set_primary_key(relation_t *, char *);
 db_result_t relation_remove(relation_t *, int);
 db_result_t relation_insert(relation_t *, attribute_value_t *);
+db_result_t relation_insert_row(relation_t *, unsigned char *);
+db_result_t relation_insert_rows(relation_t *, unsigned char *, tuple_id_t);
+db_result_t relation_sync(void);
 db_result_t relation_select(db_handle_t **, relation_t *, void *);
 tuple_id_t relation_cardinality(relation_t *);
 
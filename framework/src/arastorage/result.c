@@ -54,6 +54,7 @@
 /****************************************************************************
  * Included Files
  ****************************************************************************/
+#include <limits.h>
 #include <string.h>
 
 #include <arastorage/arastorage.h>
@@ -120,12 +121,14 @@ db_result_t db_phy_to_value(attribute_value_t *value, attribute_t *attr, unsigne
 		DB_LOG_V("DB: %s = %d\n", attr->name, int_value);
 		break;
 	case DOMAIN_LONG:
-		long_value = (long)ptr[0] << 24 | (long)ptr[1] << 16 | (long)ptr[2] << 8 | (long)ptr[3];
+		/* Longs are stored in 32 bits, so their sign is extended to
+		   the C long type of a 64-bit host. */
+		long_value = (int32_t)((uint32_t)ptr[0] << 24 | (uint32_t)ptr[1] << 16 | (uint32_t)ptr[2] << 8 | ptr[3]);
 		VALUE_LONG(value) = long_value;
 		DB_LOG_V("DB: %s = %ld\n", attr->name, long_value);
 		break;
 	case DOMAIN_DOUBLE:
-		double_value = atof((char *)ptr);
+		memcpy(&double_value, ptr, sizeof(double_value));
 		VALUE_DOUBLE(value) = double_value;
 		DB_LOG_V("DB: %s = %.5f\n", attr->name, double_value);
 		break;
@@ -145,7 +148,8 @@ db_result_t db_value_to_phy(unsigned char *ptr, attribute_t *attr, attribute_val
 
 	switch (attr->domain) {
 	case DOMAIN_STRING:
-		memcpy(ptr, VALUE_STRING(value), attr->element_size);
+		/* A value may be shorter than the element, so don't read past its end. */
+		strncpy((char *)ptr, (char *)VALUE_STRING(value), attr->element_size);
 		ptr[attr->element_size - 1] = '\0';
 		break;
 	case DOMAIN_INT:
@@ -160,6 +164,9 @@ db_result_t db_value_to_phy(unsigned char *ptr, attribute_t *attr, attribute_val
 		ptr[2] = long_value >> 8;
 		ptr[3] = long_value & 0xff;
 		break;
+	case DOMAIN_DOUBLE:
+		memcpy(ptr, &VALUE_DOUBLE(value), sizeof(double));
+		break;
 	default:
 		return DB_TYPE_ERROR;
 	}
@@ -171,6 +178,16 @@ db_result_t db_value_to_phy(unsigned char *ptr, attribute_t *attr, attribute_val
    to a value of the C long type. */
 long db_value_to_long(attribute_value_t *value)
 {
+	if (value->domain == DOMAIN_KEY) {
+		/* Keys are wider than long where long has 32 bits. */
+		if (VALUE_KEY(value) > LONG_MAX) {
+			return LONG_MAX;
+		} else if (VALUE_KEY(value) < LONG_MIN) {
+			return LONG_MIN;
+		}
+		return (long)VALUE_KEY(value);
+	}
+
 	switch (value->domain) {
 	case DOMAIN_INT:
 		return (long)VALUE_INT(value);
@@ -180,3 +197,40 @@ long db_value_to_long(attribute_value_t *value)
 		return 0;
 	}
 }
+
+/* db_value_to_key: Convert an attribute value to its key in an index. */
+db_key_t db_value_to_key(attribute_value_t *value)
+{
+	if (value->domain == DOMAIN_KEY) {
+		return VALUE_KEY(value);
+	}
+
+	switch (value->domain) {
+	case DOMAIN_INT:
+		return (db_key_t)VALUE_INT(value);
+	case DOMAIN_LONG:
+		return (db_key_t)VALUE_LONG(value);
+	case DOMAIN_STRING:
+		return db_string_to_key(VALUE_STRING(value));
+	default:
+		return 0;
+	}
+}
+
+/* db_string_to_key: Convert the first bytes of a string to a signed
+   key whose order is the same as that of strcmp for distinct prefixes. */
+db_key_t db_string_to_key(const unsigned char *str)
+{
+	uint64_t key;
+	int i;
+
+	key = 0;
+	for (i = 0; i < DB_STRING_KEY_LENGTH; i++) {
+		key <<= 8;
+		if (*str != '\0') {
+			key |= *str++;
+		}
+	}
+
+	return (db_key_t)(key ^ 0x8000000000000000ULL);
+}
@@ -68,9 +68,14 @@
 #define RESULT_TUPLE_INVALID(tuple)     ((tuple) == NULL)
 #define RESULT_TUPLE_SIZE(handle)       (handle).rel->row_length
 
+/* The number of leading bytes of a string that make up its index key. */
+#define DB_STRING_KEY_LENGTH            8
+
 #define DB_HANDLE_FLAG_INDEX_STEP       0x01
 #define DB_HANDLE_FLAG_SEARCH_INDEX     0x02
 #define DB_HANDLE_FLAG_PROCESSING       0x04
+#define DB_HANDLE_FLAG_INDEX_ROWS       0x08
+#define DB_HANDLE_FLAG_AGGREGATED       0x10
 #define DB_HANDLE_FLAG_INVALID          0x00
 
 /****************************************************************************
@@ -98,6 +103,12 @@ struct _db_handle_s {
 	index_iterator_t index_iterator;
 	tuple_id_t tuple_id;
 	tuple_id_t current_row;
+	tuple_id_t limit;
+	tuple_id_t offset;
+	/* Tuple ids found in the index, sorted to read rows in order. */
+	tuple_id_t *index_rows;
+	tuple_id_t index_row_count;
+	tuple_id_t index_row_next;
 	relation_t *rel;
 	relation_t *result_rel;
 	tuple_t tuple;
@@ -107,6 +118,7 @@ struct _db_handle_s {
 	uint8_t ncolumns;
 	void *lvm_instance;
 	source_dest_map_t *attr_map;
+	storage_scan_t scan;
 };
 
 /****************************************************************************
@@ -118,3 +130,5 @@ db_result_t db_value_to_phy(unsigned char *ptr, attribute_t *attr, attribute_val
 
 #endif              /* !RESULT_H */
 long db_value_to_long(attribute_value_t *value);
+db_key_t db_string_to_key(const unsigned char *str);
+db_key_t db_value_to_key(attribute_value_t *value);
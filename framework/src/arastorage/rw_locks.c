@@ -106,7 +106,7 @@ void rw_unlock_write(struct rw_lock_s *rwLock)
 		pthread_cond_signal(&rwLock->noActiveWriter);
 	} else {					/* rwLock->writers == 0 */
 
-		pthread_cond_signal(&rwLock->noWriters);
+		pthread_cond_broadcast(&rwLock->noWriters);
 	}
 	pthread_mutex_unlock(&rwLock->mutex);
 }
@@ -77,6 +77,20 @@ struct insert_buffer_s g_storage_write_buffer;
 
 typedef unsigned char *storage_row_t;
 
+/*
+ * A sequential scan over the tuple file of a relation. The file is read in
+ * blocks aligned to DB_SCAN_BLOCK_SIZE, and rows are returned from the block,
+ * so a full scan takes one read per block instead of a seek and read per row.
+ */
+struct storage_scan_s {
+	unsigned char *block;		/* rows read, a row may continue from previous block */
+	unsigned long offset;		/* file offset of block[0] */
+	unsigned length;			/* bytes of rows in block */
+	unsigned size;				/* size of block */
+	tuple_id_t nrows;			/* rows in the file when scan started */
+};
+typedef struct storage_scan_s storage_scan_t;
+
 /****************************************************************************
 * Global Function Prototypes
 ****************************************************************************/
@@ -97,10 +111,14 @@ db_result_t storage_put_index(index_t *);
 db_result_t storage_remove_index(relation_t *rel, attribute_t *attr);
 db_result_t storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
 db_result_t storage_put_row(relation_t *, storage_row_t, uint8_t);
+db_result_t storage_put_rows(relation_t *, storage_row_t, tuple_id_t);
 db_result_t storage_write_row(db_storage_id_t, storage_row_t, unsigned, char *);
 db_result_t storage_get_row_amount(relation_t *, tuple_id_t *);
 db_result_t storage_read_from(db_storage_id_t, void *, unsigned long, unsigned);
 db_result_t storage_write_to(db_storage_id_t, void *, unsigned long, unsigned);
+db_result_t storage_scan_get_row(storage_scan_t *, relation_t *, tuple_id_t, storage_row_t *);
+bool storage_scan_has_row(storage_scan_t *, relation_t *, tuple_id_t);
+void storage_scan_deinit(storage_scan_t *);
 
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 db_result_t storage_write_buffer_init(void);
@@ -116,6 +134,7 @@ db_result_t storage_rename(const char *, const char *);
 off_t storage_seek(db_storage_id_t, unsigned long, int);
 ssize_t storage_read(db_storage_id_t, void *, unsigned);
 ssize_t storage_write(db_storage_id_t, void *, unsigned);
+db_result_t storage_sync(db_storage_id_t);
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 ssize_t storage_get_availbyte_size(void);
 #endif
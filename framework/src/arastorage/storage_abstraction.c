@@ -47,7 +47,7 @@ db_storage_id_t storage_open(const char *filename, int oflag)
 	if (rel_path == NULL) {
 		return INVALID_STORAGE_ID;
 	}
-	snprintf(rel_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, filename);
+	snprintf(rel_path, DB_MAX_FILENAME_LENGTH, "%s%s", CONFIG_MOUNT_POINT, filename);
 	fd = open(rel_path, oflag);
 	free(rel_path);
 	return fd;
@@ -68,7 +68,7 @@ db_result_t storage_remove(const char *filename)
 	if (rel_path == NULL) {
 		return DB_STORAGE_ERROR;
 	}
-	snprintf(rel_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, filename);
+	snprintf(rel_path, DB_MAX_FILENAME_LENGTH, "%s%s", CONFIG_MOUNT_POINT, filename);
 	if (unlink(rel_path) == OK) {
 		res = DB_OK;
 	}
@@ -93,8 +93,8 @@ db_result_t storage_rename(const char *old_name, const char *new_name)
 		return DB_STORAGE_ERROR;
 	}
 
-	snprintf(old_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, old_name);
-	snprintf(new_path, DB_MAX_FILENAME_LENGTH, "%s%s\0", CONFIG_MOUNT_POINT, new_name);
+	snprintf(old_path, DB_MAX_FILENAME_LENGTH, "%s%s", CONFIG_MOUNT_POINT, old_name);
+	snprintf(new_path, DB_MAX_FILENAME_LENGTH, "%s%s", CONFIG_MOUNT_POINT, new_name);
 
 	if (rename(old_path, new_path) == OK) {
 		res = DB_OK;
@@ -122,6 +122,15 @@ ssize_t storage_write(db_storage_id_t fd, void *buffer, unsigned length)
 	return write(fd, buffer, length);
 }
 
+/* It mapped with fsync function in specific file system */
+db_result_t storage_sync(db_storage_id_t fd)
+{
+	if (fsync(fd) != OK) {
+		return DB_STORAGE_ERROR;
+	}
+	return DB_OK;
+}
+
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
 ssize_t storage_get_availbyte_size(void)
 {
@@ -83,6 +83,47 @@ struct index_record_s {
 	uint8_t type;
 };
 
+/****************************************************************************
+* Private Variables
+****************************************************************************/
+/*
+ * Tuple and index files are opened once and their descriptors are shared by
+ * the queries running at once, so a seek and the following read or write
+ * are done under this lock.
+ */
+static pthread_mutex_t g_storage_io_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+static ssize_t storage_pread(db_storage_id_t fd, void *buffer, unsigned long offset, unsigned length)
+{
+	ssize_t r;
+
+	pthread_mutex_lock(&g_storage_io_lock);
+	if (storage_seek(fd, offset, SEEK_SET) == (off_t)-1) {
+		r = -1;
+	} else {
+		r = storage_read(fd, buffer, length);
+	}
+	pthread_mutex_unlock(&g_storage_io_lock);
+	return r;
+}
+
+static ssize_t storage_pwrite(db_storage_id_t fd, void *buffer, unsigned long offset, unsigned length)
+{
+	ssize_t r;
+
+	pthread_mutex_lock(&g_storage_io_lock);
+	if (storage_seek(fd, offset, SEEK_SET) == (off_t)-1) {
+		r = -1;
+	} else {
+		r = storage_write(fd, buffer, length);
+	}
+	pthread_mutex_unlock(&g_storage_io_lock);
+	return r;
+}
+
 /****************************************************************************
 * Public Functions
 ****************************************************************************/
@@ -103,7 +144,7 @@ ssize_t storage_get_write_buffer_size(void)
 void storage_write_buffer_clean(void)
 {
 	memset(g_storage_write_buffer.file_name, 0, sizeof(g_storage_write_buffer.file_name));
-	memset(g_storage_write_buffer.buffer, 0, sizeof(g_storage_write_buffer.buffer));
+	/* Only data_size bytes of the buffer are ever written out */
 	g_storage_write_buffer.data_size = 0;
 }
 
@@ -125,6 +166,8 @@ db_result_t storage_write_buffer_init()
 void storage_write_buffer_deinit()
 {
 	if (g_storage_write_buffer.buffer != NULL) {
+		/* Rows inserted last are still in the buffer */
+		storage_flush_insert_buffer();
 		free(g_storage_write_buffer.buffer);
 		g_storage_write_buffer.buffer = NULL;
 	}
@@ -231,7 +274,7 @@ db_result_t storage_put_relation(relation_t *rel)
 	}
 
 	if (rel->tuple_filename[0] == '\0') {
-		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x\0", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
+		snprintf(tuple_path, TUPLE_NAME_LENGTH, "%s.%x", TUPLE_FILE_NAME, (unsigned)(random_rand() & 0xffff));
 		result = storage_generate_file(tuple_path);
 		if (DB_ERROR(result)) {
 			storage_close(fd);
@@ -325,7 +368,7 @@ db_result_t storage_get_index(index_t *index, relation_t *rel, attribute_t *attr
 	if (filename == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	snprintf(filename, len, "%s%s\0", rel->name, INDEX_NAME_SUFFIX);
+	snprintf(filename, len, "%s%s", rel->name, INDEX_NAME_SUFFIX);
 	fd = storage_open(filename, O_RDONLY);
 	if (fd < 0) {
 		free(filename);
@@ -364,7 +407,7 @@ db_result_t storage_put_index(index_t *index)
 	if (filename == NULL) {
 		return DB_ALLOCATION_ERROR;
 	}
-	snprintf(filename, len, "%s%s\0", index->rel->name, INDEX_NAME_SUFFIX);
+	snprintf(filename, len, "%s%s", index->rel->name, INDEX_NAME_SUFFIX);
 	fd = storage_open(filename, O_WROK | O_APPEND | O_CREAT);
 	if (fd < 0) {
 		free(filename);
@@ -405,7 +448,7 @@ db_result_t storage_remove_index(relation_t *rel, attribute_t *attr)
 	if (filename == NULL) {
 		return DB_STORAGE_ERROR;
 	}
-	snprintf(filename, len, "%s%s\0", rel->name, INDEX_NAME_SUFFIX);
+	snprintf(filename, len, "%s%s", rel->name, INDEX_NAME_SUFFIX);
 	fd = storage_open(filename, O_RDONLY);
 	if (fd < 0) {
 		free(filename);
@@ -434,7 +477,7 @@ db_result_t storage_remove_index(relation_t *rel, attribute_t *attr)
 			storage_close(fd);
 			return DB_STORAGE_ERROR;
 		}
-		snprintf(new_filename, len, "%s%s%s\0", rel->name, INDEX_NAME_SUFFIX, TEMP_FILE_SUFFIX);
+		snprintf(new_filename, len, "%s%s%s", rel->name, INDEX_NAME_SUFFIX, TEMP_FILE_SUFFIX);
 		res = storage_generate_file(new_filename);
 		if (DB_ERROR(res)) {
 			free(filename);
@@ -503,11 +546,7 @@ db_result_t storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t
 		return DB_FINISHED;
 	}
 
-	if (storage_seek(rel->tuple_storage, *tuple_id * rel->row_length, SEEK_SET) == (off_t)-1) {
-		return DB_STORAGE_ERROR;
-	}
-
-	r = storage_read(rel->tuple_storage, row, rel->row_length);
+	r = storage_pread(rel->tuple_storage, row, *tuple_id * rel->row_length, rel->row_length);
 	DB_LOG_V("read row = %s, r = %d\n", row, r);
 
 	if (r == 0) {
@@ -543,6 +582,38 @@ db_result_t storage_put_row(relation_t *rel, storage_row_t row, uint8_t flag)
 	return result;
 }
 
+/* Append rows stored next to each other with one write. */
+db_result_t storage_put_rows(relation_t *rel, storage_row_t rows, tuple_id_t count)
+{
+	size_t length;
+
+	length = (size_t)count * rel->row_length;
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	if (length < storage_get_write_buffer_size()) {
+		/* Written with the rows buffered before */
+		if (DB_ERROR(storage_write_row(rel->tuple_storage, rows, length, rel->tuple_filename))) {
+			return DB_STORAGE_ERROR;
+		}
+		rel->cardinality += count;
+		rel->next_row += count;
+		return DB_OK;
+	}
+
+	/* Rows buffered before are stored first */
+	if (DB_ERROR(storage_flush_insert_buffer())) {
+		return DB_STORAGE_ERROR;
+	}
+#endif
+	if (storage_write(rel->tuple_storage, rows, length) != (ssize_t)length) {
+		DB_LOG_D("DB: Failed to store %u rows\n", count);
+		return DB_STORAGE_ERROR;
+	}
+
+	rel->cardinality += count;
+	rel->next_row += count;
+	return DB_OK;
+}
+
 db_result_t storage_write_row(db_storage_id_t fd, storage_row_t row, unsigned length, char *filename)
 {
 #ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
@@ -601,7 +672,9 @@ db_result_t storage_get_row_amount(relation_t *rel, tuple_id_t *amount)
 	if (rel->row_length == 0) {
 		*amount = 0;
 	} else {
+		pthread_mutex_lock(&g_storage_io_lock);
 		offset = storage_seek(rel->tuple_storage, 0, SEEK_END);
+		pthread_mutex_unlock(&g_storage_io_lock);
 		if (offset == (off_t)-1) {
 			return DB_STORAGE_ERROR;
 		}
@@ -614,26 +687,121 @@ db_result_t storage_read_from(db_storage_id_t fd, void *buffer, unsigned long of
 {
 	ssize_t r;
 
-	if (storage_seek(fd, offset, SEEK_SET) == (off_t)-1) {
-		return DB_STORAGE_ERROR;
-	}
-
-	r = storage_read(fd, buffer, length);
+	r = storage_pread(fd, buffer, offset, length);
 	if (r <= 0) {
 		return DB_STORAGE_ERROR;
 	}
 	return DB_OK;
 }
 
-db_result_t storage_write_to(db_storage_id_t fd, void *buffer, unsigned long offset, unsigned length)
+/****************************************************************************
+ * Name: storage_scan_get_row
+ *
+ * Desciption: Get a row of the relation through the scan. The row points
+ *   into the block of scan, it's valid until the next call.
+ *   Rows already in the block are returned without reading the file.
+ *
+ ****************************************************************************/
+db_result_t storage_scan_get_row(storage_scan_t *scan, relation_t *rel, tuple_id_t tuple_id, storage_row_t *row)
 {
+	unsigned long offset;
+	unsigned long pos;
+	unsigned keep;
+	unsigned size;
 	ssize_t r;
 
-	if (storage_seek(fd, offset, SEEK_SET) == (off_t)-1) {
-		return DB_STORAGE_ERROR;
+	if (scan->block == NULL) {
+		if (DB_ERROR(storage_get_row_amount(rel, &scan->nrows))) {
+			return DB_STORAGE_ERROR;
+		}
+		/* A row may start at the end of a block. */
+		scan->size = DB_SCAN_BLOCK_SIZE + rel->row_length;
+		scan->block = (unsigned char *)malloc(scan->size);
+		if (scan->block == NULL) {
+			DB_LOG_E("DB: Failed to allocate scan block\n");
+			return DB_ALLOCATION_ERROR;
+		}
+		scan->offset = 0;
+		scan->length = 0;
+	}
+
+	if (tuple_id >= scan->nrows) {
+		return DB_FINISHED;
+	}
+
+	offset = (unsigned long)tuple_id * rel->row_length;
+	if (offset >= scan->offset && offset + rel->row_length <= scan->offset + scan->length) {
+		*row = scan->block + (offset - scan->offset);
+		return DB_OK;
+	}
+
+	if (offset >= scan->offset && offset < scan->offset + scan->length) {
+		/* Keep the head of the row, the rest is in the next block. */
+		keep = scan->offset + scan->length - offset;
+		memmove(scan->block, scan->block + (offset - scan->offset), keep);
+		scan->offset = offset;
+		scan->length = keep;
+	} else {
+		scan->offset = offset - (offset % DB_SCAN_BLOCK_SIZE);
+		scan->length = 0;
 	}
 
-	r = storage_write(fd, buffer, length);
+	while (scan->offset + scan->length < offset + rel->row_length) {
+		/* Read up to the next block boundary. */
+		pos = scan->offset + scan->length;
+		size = DB_SCAN_BLOCK_SIZE - (pos % DB_SCAN_BLOCK_SIZE);
+		if (size > scan->size - scan->length) {
+			size = scan->size - scan->length;
+		}
+
+		r = storage_pread(rel->tuple_storage, scan->block + scan->length, pos, size);
+		if (r < 0) {
+			DB_LOG_E("DB: Reading failed on fd %d\n", rel->tuple_storage);
+			return DB_STORAGE_ERROR;
+		} else if (r == 0) {
+			DB_LOG_E("DB: Incomplete record of tuple %d\n", tuple_id);
+			return DB_STORAGE_ERROR;
+		}
+		scan->length += r;
+	}
+
+	DB_LOG_D("DB: Read block at %lu, %u bytes from relation %s\n", scan->offset, scan->length, rel->name);
+	*row = scan->block + (offset - scan->offset);
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: storage_scan_has_row
+ *
+ * Desciption: Check whether the row is in the block of scan already.
+ *
+ ****************************************************************************/
+bool storage_scan_has_row(storage_scan_t *scan, relation_t *rel, tuple_id_t tuple_id)
+{
+	unsigned long offset;
+
+	if (scan->block == NULL || tuple_id >= scan->nrows) {
+		return false;
+	}
+
+	offset = (unsigned long)tuple_id * rel->row_length;
+	return offset >= scan->offset && offset + rel->row_length <= scan->offset + scan->length;
+}
+
+void storage_scan_deinit(storage_scan_t *scan)
+{
+	if (scan->block != NULL) {
+		free(scan->block);
+		scan->block = NULL;
+	}
+	scan->length = 0;
+}
+
+db_result_t storage_write_to(db_storage_id_t fd, void *buffer, unsigned long offset, unsigned length)
+{
+	ssize_t r;
+
+	r = storage_pwrite(fd, buffer, offset, length);
 	if (r != length) {
 		return DB_STORAGE_ERROR;
 	}
@@ -0,0 +1,531 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <tinyara/config.h>
+#include "db_options.h"
+#include "db_debug.h"
+#include "index.h"
+#include "list.h"
+#include "relation.h"
+#include "storage.h"
+#include "transaction.h"
+
+/****************************************************************************
+* Pre-processor Definitions
+****************************************************************************/
+#define TRANSACTION_LOG_MAGIC   0x4c415744	/* "DWAL" */
+
+#define FNV_OFFSET_BASIS        2166136261UL
+#define FNV_PRIME               16777619UL
+
+/****************************************************************************
+* Private Types
+****************************************************************************/
+/*
+ * The write-ahead log is a sequence of committed transactions, each one
+ * written with one write. A transaction is a header followed by records,
+ * and a record is followed by the row inserted in physical format.
+ */
+struct transaction_header_s {
+	uint32_t magic;
+	uint32_t length;			/* bytes of records after the header */
+	uint32_t checksum;			/* of records, a torn write doesn't match */
+	uint16_t count;				/* number of records */
+};
+
+struct transaction_record_s {
+	char relation[RELATION_NAME_LENGTH + 1];
+	tuple_id_t tuple_id;		/* id of the row in its relation */
+	uint16_t length;			/* bytes of the row */
+};
+
+/* A relation whose rows are recovered from the log. */
+struct transaction_relation_s {
+	struct transaction_relation_s *next;
+	char name[RELATION_NAME_LENGTH + 1];
+};
+
+/****************************************************************************
+* Private Variables
+****************************************************************************/
+/* Header and records of the active transaction, NULL if there is none. */
+static unsigned char *g_txn_buffer;
+static uint32_t g_txn_length;
+static uint16_t g_txn_count;
+
+/* The thread which began the active transaction. */
+static pthread_t g_txn_owner;
+
+/* Bytes appended to the log since the last checkpoint. */
+static unsigned long g_txn_log_size;
+
+/* Relations recovered, their indexes are created again after recovery. */
+LIST(g_txn_recovered);
+
+/****************************************************************************
+* Private Functions
+****************************************************************************/
+static uint32_t transaction_checksum(const unsigned char *data, uint32_t length)
+{
+	uint32_t hash = FNV_OFFSET_BASIS;
+
+	while (length-- > 0) {
+		hash ^= *data++;
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+static void transaction_clear(void)
+{
+	free(g_txn_buffer);
+	g_txn_buffer = NULL;
+	g_txn_length = 0;
+	g_txn_count = 0;
+}
+
+static db_result_t transaction_recovered(const char *name)
+{
+	struct transaction_relation_s *recovered;
+
+	for (recovered = list_head(g_txn_recovered); recovered != NULL; recovered = recovered->next) {
+		if (strcmp(recovered->name, name) == 0) {
+			return DB_OK;
+		}
+	}
+	recovered = (struct transaction_relation_s *)malloc(sizeof(struct transaction_relation_s));
+	if (recovered == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	strncpy(recovered->name, name, RELATION_NAME_LENGTH);
+	recovered->name[RELATION_NAME_LENGTH] = '\0';
+	list_push(g_txn_recovered, recovered);
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: transaction_reindex
+ *
+ * Description: Create again the indexes of recovered relations from their
+ *   rows. Indexes written partly before a power loss aren't consistent with
+ *   the relations, and rows of the log were stored without them.
+ *
+ ****************************************************************************/
+static db_result_t transaction_reindex(void)
+{
+	struct transaction_relation_s *recovered;
+	relation_t *rel;
+	db_result_t result;
+
+	result = DB_OK;
+	while ((recovered = list_pop(g_txn_recovered)) != NULL) {
+		rel = relation_load(recovered->name);
+		if (rel != NULL) {
+			if (DB_ERROR(index_rebuild(rel))) {
+				DB_LOG_E("DB: Failed to rebuild indexes of relation %s\n", rel->name);
+				result = DB_INDEX_ERROR;
+			}
+			relation_release(rel);
+		}
+		free(recovered);
+	}
+	return result;
+}
+
+/****************************************************************************
+ * Name: transaction_apply_relation
+ *
+ * Description: Store the rows of relation from the records of a transaction
+ *   starting at offset, with one write to the tuple file. A row whose id is
+ *   already taken in the relation was stored before, it's skipped, so a
+ *   transaction may be applied again on recovery. On recovery, rows are not
+ *   added to indexes.
+ *
+ ****************************************************************************/
+static db_result_t transaction_apply_relation(relation_t *rel, unsigned char *data, uint32_t offset, uint32_t length, bool recovery)
+{
+	struct transaction_record_s record;
+	unsigned char *rows;
+	tuple_id_t count;
+	db_result_t result;
+
+	rows = (unsigned char *)malloc(length - offset);
+	if (rows == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+
+	count = 0;
+	while (offset < length) {
+		memcpy(&record, data + offset, sizeof(record));
+		offset += sizeof(record);
+		if (strcmp(record.relation, rel->name) == 0 && record.tuple_id >= rel->next_row + count) {
+			memcpy(rows + count * rel->row_length, data + offset, rel->row_length);
+			count++;
+		}
+		offset += record.length;
+	}
+
+	result = DB_OK;
+	if (count > 0) {
+		if (recovery) {
+			result = storage_put_rows(rel, rows, count);
+		} else {
+			result = relation_insert_rows(rel, rows, count);
+		}
+	}
+	free(rows);
+	return result;
+}
+
+/****************************************************************************
+ * Name: transaction_apply
+ *
+ * Description: Store the rows of a committed transaction to their relations
+ *   and indexes, with one write to each relation. On recovery, rows are
+ *   stored to relations only, and the relations are added to
+ *   g_txn_recovered.
+ *
+ ****************************************************************************/
+static db_result_t transaction_apply(unsigned char *data, uint32_t length, uint16_t count, bool recovery)
+{
+	struct transaction_record_s record;
+	struct transaction_record_s prev;
+	relation_t *rel;
+	db_result_t result;
+	db_result_t res;
+	uint32_t offset;
+	uint32_t prev_offset;
+	uint16_t i;
+
+	/* Check records first, the rows of a relation are gathered from all of them */
+	offset = 0;
+	for (i = 0; i < count; i++) {
+		if (offset + sizeof(record) > length) {
+			return DB_INCONSISTENCY_ERROR;
+		}
+		memcpy(&record, data + offset, sizeof(record));
+		offset += sizeof(record);
+		if (offset + record.length > length) {
+			return DB_INCONSISTENCY_ERROR;
+		}
+		offset += record.length;
+	}
+	length = offset;
+
+	result = DB_OK;
+	for (offset = 0; offset < length; offset += sizeof(record) + record.length) {
+		memcpy(&record, data + offset, sizeof(record));
+
+		/* Rows of the relation were stored with its first record */
+		for (prev_offset = 0; prev_offset < offset; prev_offset += sizeof(prev) + prev.length) {
+			memcpy(&prev, data + prev_offset, sizeof(prev));
+			if (strcmp(prev.relation, record.relation) == 0) {
+				break;
+			}
+		}
+		if (prev_offset < offset) {
+			continue;
+		}
+
+		rel = relation_load(record.relation);
+		if (rel == NULL) {
+			DB_LOG_E("DB: Failed to load relation %s of transaction\n", record.relation);
+			result = DB_NAME_ERROR;
+			continue;
+		}
+		res = DB_OK;
+		if (record.length != rel->row_length) {
+			DB_LOG_E("DB: Row length %u of transaction doesn't match relation %s\n", record.length, rel->name);
+			res = DB_INCONSISTENCY_ERROR;
+		} else if (recovery) {
+			res = transaction_recovered(record.relation);
+		}
+		if (DB_SUCCESS(res)) {
+			res = transaction_apply_relation(rel, data, offset, length, recovery);
+		}
+		if (DB_ERROR(res)) {
+			result = res;
+		}
+		relation_release(rel);
+	}
+	return result;
+}
+
+/****************************************************************************
+ * Name: transaction_log_clear
+ *
+ * Description: Write rows and index nodes cached in RAM to storage, sync
+ *   them and remove the log, whose transactions are stored then.
+ *
+ ****************************************************************************/
+static db_result_t transaction_log_clear(void)
+{
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+	if (DB_ERROR(storage_flush_insert_buffer())) {
+		DB_LOG_E("DB: Failed to flush insert buffer for checkpoint\n");
+		return DB_STORAGE_ERROR;
+	}
+#endif
+	if (DB_ERROR(index_flush()) || DB_ERROR(relation_sync())) {
+		DB_LOG_E("DB: Failed to sync relations for checkpoint\n");
+		return DB_STORAGE_ERROR;
+	}
+	if (DB_ERROR(storage_remove(TRANSACTION_LOG_NAME))) {
+		DB_LOG_E("DB: Failed to remove transaction log\n");
+		return DB_STORAGE_ERROR;
+	}
+	DB_LOG_D("DB: Checkpoint of %lu bytes of transaction log\n", g_txn_log_size);
+	g_txn_log_size = 0;
+	return DB_OK;
+}
+
+/****************************************************************************
+* Public Functions
+****************************************************************************/
+
+/****************************************************************************
+ * Name: transaction_init
+ *
+ * Description: Recover transactions committed to the log before a power loss
+ *   or a reset. A transaction torn by power loss wasn't committed, it's
+ *   dropped with the rest of the log. Indexes of the recovered relations are
+ *   created again from their rows.
+ *
+ ****************************************************************************/
+db_result_t transaction_init(void)
+{
+	struct transaction_header_s header;
+	unsigned char *data;
+	db_storage_id_t fd;
+	db_result_t result;
+	db_result_t res;
+
+	g_txn_buffer = NULL;
+	g_txn_length = 0;
+	g_txn_count = 0;
+	g_txn_log_size = 0;
+
+	fd = storage_open(TRANSACTION_LOG_NAME, O_RDONLY);
+	if (fd < 0) {
+		/* There is no log to recover */
+		return DB_OK;
+	}
+
+	result = DB_OK;
+	while (storage_read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header)) {
+		if (header.magic != TRANSACTION_LOG_MAGIC || header.length > DB_TRANSACTION_BUFFER_SIZE) {
+			break;
+		}
+		data = (unsigned char *)malloc(header.length);
+		if (data == NULL) {
+			result = DB_ALLOCATION_ERROR;
+			break;
+		}
+		if (storage_read(fd, data, header.length) != (ssize_t)header.length || transaction_checksum(data, header.length) != header.checksum) {
+			DB_LOG_D("DB: Drop torn transaction of %u bytes\n", header.length);
+			free(data);
+			break;
+		}
+		res = transaction_apply(data, header.length, header.count, true);
+		free(data);
+		if (DB_ERROR(res)) {
+			DB_LOG_E("DB: Failed to recover transaction, res : %d\n", res);
+			result = res;
+			break;
+		}
+		g_txn_log_size += sizeof(header) + header.length;
+	}
+	storage_close(fd);
+
+	res = transaction_reindex();
+	if (DB_SUCCESS(result)) {
+		result = res;
+	}
+	if (DB_ERROR(result)) {
+		/* Keep the log to recover on next init */
+		return result;
+	}
+	DB_LOG_D("DB: Recovered %lu bytes of transaction log\n", g_txn_log_size);
+	return transaction_log_clear();
+}
+
+db_result_t transaction_deinit(void)
+{
+	if (transaction_active()) {
+		transaction_clear();
+	}
+	return transaction_checkpoint();
+}
+
+bool transaction_active(void)
+{
+	return g_txn_buffer != NULL;
+}
+
+/* Whether the active transaction was begun by the calling thread. */
+bool transaction_owned(void)
+{
+	return transaction_active() && pthread_equal(g_txn_owner, pthread_self());
+}
+
+db_result_t transaction_begin(void)
+{
+	if (transaction_active()) {
+		DB_LOG_E("DB: Transaction is already active\n");
+		return DB_BUSY_ERROR;
+	}
+	g_txn_buffer = (unsigned char *)malloc(DB_TRANSACTION_BUFFER_SIZE);
+	if (g_txn_buffer == NULL) {
+		return DB_ALLOCATION_ERROR;
+	}
+	g_txn_length = sizeof(struct transaction_header_s);
+	g_txn_count = 0;
+	g_txn_owner = pthread_self();
+	return DB_OK;
+}
+
+db_result_t transaction_rollback(void)
+{
+	if (!transaction_owned()) {
+		return DB_ARGUMENT_ERROR;
+	}
+	transaction_clear();
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: transaction_log_row
+ *
+ * Description: Add a row to be inserted into relation on commit. Rows of
+ *   the relation added before it take the ids after the last stored row.
+ *
+ ****************************************************************************/
+db_result_t transaction_log_row(relation_t *rel, unsigned char *row)
+{
+	struct transaction_record_s record;
+	tuple_id_t pending;
+	uint32_t offset;
+
+	if (g_txn_length + sizeof(record) + rel->row_length > DB_TRANSACTION_BUFFER_SIZE || g_txn_count == UINT16_MAX) {
+		DB_LOG_E("DB: Transaction buffer is full\n");
+		return DB_LIMIT_ERROR;
+	}
+
+	pending = 0;
+	for (offset = sizeof(struct transaction_header_s); offset < g_txn_length; offset += sizeof(record) + record.length) {
+		memcpy(&record, g_txn_buffer + offset, sizeof(record));
+		if (strcmp(record.relation, rel->name) == 0) {
+			pending++;
+		}
+	}
+	if (rel->cardinality + pending >= DB_TUPLE_LIMIT) {
+		return DB_LIMIT_ERROR;
+	}
+
+	memset(&record, 0, sizeof(record));
+	snprintf(record.relation, sizeof(record.relation), "%s", rel->name);
+	record.tuple_id = rel->next_row + pending;
+	record.length = rel->row_length;
+	memcpy(g_txn_buffer + g_txn_length, &record, sizeof(record));
+	memcpy(g_txn_buffer + g_txn_length + sizeof(record), row, rel->row_length);
+	g_txn_length += sizeof(record) + rel->row_length;
+	g_txn_count++;
+
+	return DB_OK;
+}
+
+/****************************************************************************
+ * Name: transaction_commit
+ *
+ * Description: Append the active transaction to the log with one write and
+ *   sync it, which commits the transaction, then store its rows with one
+ *   write to each relation. If the log grows to DB_TRANSACTION_LOG_LIMIT, a
+ *   checkpoint follows.
+ *
+ ****************************************************************************/
+db_result_t transaction_commit(void)
+{
+	struct transaction_header_s header;
+	db_storage_id_t fd;
+	db_result_t result;
+	ssize_t written;
+
+	if (!transaction_owned()) {
+		return DB_ARGUMENT_ERROR;
+	}
+	if (g_txn_count == 0) {
+		return transaction_rollback();
+	}
+
+	header.magic = TRANSACTION_LOG_MAGIC;
+	header.length = g_txn_length - sizeof(header);
+	header.checksum = transaction_checksum(g_txn_buffer + sizeof(header), header.length);
+	header.count = g_txn_count;
+	memcpy(g_txn_buffer, &header, sizeof(header));
+
+	fd = storage_open(TRANSACTION_LOG_NAME, O_WRONLY | O_APPEND | O_CREAT);
+	if (fd < 0) {
+		DB_LOG_E("DB: Failed to open transaction log\n");
+		transaction_rollback();
+		return DB_STORAGE_ERROR;
+	}
+	written = storage_write(fd, g_txn_buffer, g_txn_length);
+	if (written != (ssize_t)g_txn_length || DB_ERROR(storage_sync(fd))) {
+		DB_LOG_E("DB: Failed to write transaction log\n");
+		storage_close(fd);
+		transaction_rollback();
+		/* Transactions must not be appended after a part of this one */
+		if (written > 0) {
+			g_txn_log_size += written;
+		}
+		transaction_checkpoint();
+		return DB_STORAGE_ERROR;
+	}
+	storage_close(fd);
+	g_txn_log_size += g_txn_length;
+
+	result = transaction_apply(g_txn_buffer + sizeof(header), header.length, header.count, false);
+	if (DB_ERROR(result)) {
+		DB_LOG_E("DB: Failed to store committed transaction, res : %d\n", result);
+	}
+	transaction_rollback();
+
+	if (g_txn_log_size >= DB_TRANSACTION_LOG_LIMIT) {
+		if (DB_ERROR(transaction_checkpoint()) && DB_SUCCESS(result)) {
+			result = DB_STORAGE_ERROR;
+		}
+	}
+	return result;
+}
+
+db_result_t transaction_checkpoint(void)
+{
+	if (g_txn_log_size == 0) {
+		return DB_OK;
+	}
+	return transaction_log_clear();
+}
@@ -0,0 +1,40 @@
+/****************************************************************************
+ *
+ * Copyright 2016 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+#ifndef __TRANSACTION_H__
+#define __TRANSACTION_H__
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+#include <stdbool.h>
+#include "relation.h"
+
+/****************************************************************************
+* Global Function Prototypes
+****************************************************************************/
+db_result_t transaction_init(void);
+db_result_t transaction_deinit(void);
+db_result_t transaction_begin(void);
+db_result_t transaction_commit(void);
+db_result_t transaction_rollback(void);
+db_result_t transaction_checkpoint(void);
+bool transaction_active(void);
+bool transaction_owned(void);
+db_result_t transaction_log_row(relation_t *, unsigned char *);
+
+#endif							/* __TRANSACTION_H__ */
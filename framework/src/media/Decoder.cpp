@@ -119,6 +119,88 @@ size_t Decoder::getAvailSpace()
 	return 0;
 }
 
+/**
+ * @brief   Seek to the time position with frame index
+ * @remarks Data pushed before is dropped, user must push data from the offset returned.
+ *          Sample rate is known after a frame was decoded, or index was loaded,
+ *          until then only position 0 can be seeked.
+ * @param   msec: time position in milliseconds
+ * @return  offset of the source to push data from, -1 on failure.
+ */
+long Decoder::seekTo(unsigned int msec)
+{
+#ifdef CONFIG_AUDIO_CODEC
+	frame_index_p index = audio_decoder_get_index(&mDecoder);
+	if (msec != 0 && index->samplerate == 0) {
+		meddbg("Error! sample rate is unknown, can't seek to %u msec\n", msec);
+		return -1;
+	}
+
+	uint32_t sample = (uint32_t)((uint64_t)msec * index->samplerate / 1000);
+	return (long)audio_decoder_seek(&mDecoder, sample);
+#endif
+	return -1;
+}
+
+/**
+ * @brief   Get duration of the stream
+ * @return  duration in milliseconds, -1 if it's unknown until the whole stream is indexed.
+ */
+int Decoder::getDuration()
+{
+#ifdef CONFIG_AUDIO_CODEC
+	uint32_t samples;
+	unsigned int sampleRate;
+	if (audio_decoder_get_duration(&mDecoder, &samples, &sampleRate) == AUDIO_DECODER_OK) {
+		return (int)((uint64_t)samples * 1000 / sampleRate);
+	}
+#endif
+	return -1;
+}
+
+/**
+ * @brief   Get average bitrate of the stream decoded so far
+ * @return  bits per second, 0 if it's unknown yet.
+ */
+unsigned int Decoder::getBitrate()
+{
+#ifdef CONFIG_AUDIO_CODEC
+	return frame_index_bitrate(audio_decoder_get_index(&mDecoder));
+#endif
+	return 0;
+}
+
+void Decoder::completeIndex()
+{
+#ifdef CONFIG_AUDIO_CODEC
+	audio_decoder_complete_index(&mDecoder);
+#endif
+}
+
+bool Decoder::loadIndex(const char *path, size_t sourceSize)
+{
+#ifdef CONFIG_AUDIO_CODEC
+	return frame_index_load(audio_decoder_get_index(&mDecoder), path, (uint32_t)sourceSize);
+#endif
+	return false;
+}
+
+/**
+ * @brief   Save frame index to file, only if it was changed since loaded or saved.
+ * @return  true if the file is up to date.
+ */
+bool Decoder::saveIndex(const char *path, size_t sourceSize)
+{
+#ifdef CONFIG_AUDIO_CODEC
+	frame_index_p index = audio_decoder_get_index(&mDecoder);
+	if (!index->dirty) {
+		return true;
+	}
+	return frame_index_save(index, path, (uint32_t)sourceSize);
+#endif
+	return false;
+}
+
 #ifdef CONFIG_AUDIO_CODEC
 bool Decoder::mConfig(int audioType)
 {
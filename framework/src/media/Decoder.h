@@ -37,6 +37,12 @@ public:
 	bool getFrame(unsigned char *buf, size_t *size, unsigned int *sampleRate, unsigned short *channels);
 	bool empty();
 	size_t getAvailSpace();
+	long seekTo(unsigned int msec);
+	int getDuration();
+	unsigned int getBitrate();
+	void completeIndex();
+	bool loadIndex(const char *path, size_t sourceSize);
+	bool saveIndex(const char *path, size_t sourceSize);
 
 private:
 #ifdef CONFIG_AUDIO_CODEC
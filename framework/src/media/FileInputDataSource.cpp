@@ -18,11 +18,15 @@
 
 #include <tinyara/config.h>
 #include <stdio.h>
+#include <sys/stat.h>
 #include <debug.h>
 
 #include <media/FileInputDataSource.h>
 #include "utils/MediaUtils.h"
 #include "StreamBuffer.h"
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+#include "FileReadAhead.h"
+#endif
 
 #ifndef CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE
 #define CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE 4096
@@ -32,20 +36,50 @@
 #define CONFIG_FILE_DATASOURCE_STREAM_BUFFER_THRESHOLD 2048
 #endif
 
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+#ifndef CONFIG_FILE_DATASOURCE_READAHEAD_BLOCK_SIZE
+#define CONFIG_FILE_DATASOURCE_READAHEAD_BLOCK_SIZE 4096
+#endif
+
+#ifndef CONFIG_FILE_DATASOURCE_READAHEAD_BLOCKS
+#define CONFIG_FILE_DATASOURCE_READAHEAD_BLOCKS 4
+#endif
+
+#ifndef CONFIG_FILE_DATASOURCE_READAHEAD_MSEC
+#define CONFIG_FILE_DATASOURCE_READAHEAD_MSEC 500
+#endif
+
+#ifndef CONFIG_FILE_DATASOURCE_READAHEAD_STACKSIZE
+#define CONFIG_FILE_DATASOURCE_READAHEAD_STACKSIZE 2048
+#endif
+#endif
+
+// Frame index of "<file>" is saved as "<file>.idx"
+#define FRAME_INDEX_FILE_SUFFIX ".idx"
+
 namespace media {
 namespace stream {
 
-FileInputDataSource::FileInputDataSource() : InputDataSource(), mDataPath(""), mFp(nullptr)
+FileInputDataSource::FileInputDataSource() : InputDataSource(), mDataPath(""), mFp(nullptr), mFileSize(0)
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	, mReadAhead(nullptr), mBitrate(0)
+#endif
 {
 }
 
 FileInputDataSource::FileInputDataSource(const std::string &dataPath)
-	: InputDataSource(), mDataPath(dataPath), mFp(nullptr)
+	: InputDataSource(), mDataPath(dataPath), mFp(nullptr), mFileSize(0)
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	, mReadAhead(nullptr), mBitrate(0)
+#endif
 {
 }
 
 FileInputDataSource::FileInputDataSource(const FileInputDataSource &source)
-	: InputDataSource(source), mDataPath(source.mDataPath), mFp(source.mFp)
+	: InputDataSource(source), mDataPath(source.mDataPath), mFp(source.mFp), mFileSize(source.mFileSize)
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	, mReadAhead(nullptr), mBitrate(0)
+#endif
 {
 }
 
@@ -78,6 +112,15 @@ bool FileInputDataSource::open()
 		mFp = fopen(mDataPath.c_str(), "rb");
 		if (mFp) {
 			medvdbg("file open success\n");
+			struct stat st;
+			mFileSize = (stat(mDataPath.c_str(), &st) == OK) ? st.st_size : 0;
+#ifdef CONFIG_MEDIA_FRAME_INDEX_SIDECAR
+			// Index of the same file saved last time, seeking and duration are known at once.
+			loadFrameIndex(mDataPath + FRAME_INDEX_FILE_SUFFIX, mFileSize);
+#endif
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+			startReadAhead(0);
+#endif
 			start();
 			return true;
 		} else {
@@ -95,6 +138,17 @@ bool FileInputDataSource::close()
 	bool ret = true;
 	if (mFp) {
 		stop();
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+		if (mReadAhead) {
+			mReadAhead->stop();
+		}
+#endif
+
+#ifdef CONFIG_MEDIA_FRAME_INDEX_SIDECAR
+		if (!saveFrameIndex(mDataPath + FRAME_INDEX_FILE_SUFFIX, mFileSize)) {
+			medvdbg("frame index is not saved\n");
+		}
+#endif
 
 		if (fclose(mFp) == OK) {
 			mFp = nullptr;
@@ -124,6 +178,12 @@ bool FileInputDataSource::isPrepare()
 
 ssize_t FileInputDataSource::onStreamBufferWritable()
 {
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	if (mReadAhead) {
+		return readFromReadAhead();
+	}
+#endif
+
 	unsigned char buf[1024];
 
 	size_t rlen = fread(buf, sizeof(unsigned char), sizeof(buf), mFp);
@@ -132,6 +192,8 @@ ssize_t FileInputDataSource::onStreamBufferWritable()
 		/* If file position reaches end of file, it's a normal case, we returns 0 */
 		if (feof(mFp)) {
 			medvdbg("eof!!!\n");
+			// All frames are decoded, now duration is known.
+			completeFrameIndex();
 			return 0;
 		}
 
@@ -139,17 +201,97 @@ ssize_t FileInputDataSource::onStreamBufferWritable()
 		return EOF;
 	}
 
-	return writeToStreamBuffer(buf, rlen);
+	// Decoder may consume data without output, e.g. samples skipped after seeking.
+	ssize_t ret = writeToStreamBuffer(buf, rlen);
+	return (ret < 0) ? ret : (ssize_t)rlen;
 }
 
 int FileInputDataSource::seek(long offset, int origin)
 {
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	if (mReadAhead) {
+		// Blocks read ahead are dropped, reading restarts from the new position.
+		long position = offset;
+		if (origin == SEEK_CUR) {
+			position += mReadAhead->tell();
+		} else if (origin == SEEK_END) {
+			position += (long)mFileSize;
+		}
+		return mReadAhead->start(mFp, position) ? 0 : -1;
+	}
+#endif
 	return fseek(mFp, offset, origin);
 }
 
+bool FileInputDataSource::getReadAheadStats(file_readahead_stats_t *stats)
+{
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+	// Read-ahead is kept stopped after closing, until the file is opened again.
+	if (stats && mReadAhead && mFp) {
+		mReadAhead->getStats(stats);
+		return true;
+	}
+#endif
+	return false;
+}
+
+#ifdef CONFIG_FILE_DATASOURCE_READAHEAD
+void FileInputDataSource::startReadAhead(long offset)
+{
+	if (!mReadAhead) {
+		auto readAhead = std::make_shared<FileReadAhead>(CONFIG_FILE_DATASOURCE_READAHEAD_BLOCK_SIZE,
+														 CONFIG_FILE_DATASOURCE_READAHEAD_BLOCKS,
+														 CONFIG_FILE_DATASOURCE_READAHEAD_STACKSIZE);
+		if (!readAhead->init()) {
+			return;
+		}
+		mReadAhead = readAhead;
+	}
+
+	mBitrate = 0;
+	if (!mReadAhead->start(mFp, offset)) {
+		// Read the file in place
+		mReadAhead = nullptr;
+		fseek(mFp, offset, SEEK_SET);
+	}
+}
+
+ssize_t FileInputDataSource::readFromReadAhead()
+{
+	unsigned char *data;
+
+	ssize_t rlen = mReadAhead->acquire(&data, 1024);
+	medvdbg("read size : %d\n", rlen);
+	if (rlen <= 0) {
+		if (rlen == 0) {
+			medvdbg("eof!!!\n");
+			completeFrameIndex();
+		}
+		return rlen;
+	}
+
+	// Decoder may reuse the data as scratch buffer, it's consumed anyway.
+	ssize_t ret = writeToStreamBuffer(data, (size_t)rlen);
+	mReadAhead->release((size_t)rlen);
+
+	// Keep enough blocks ahead to cover the latency configured at current bitrate.
+	unsigned int bitrate = getBitrate();
+	if (bitrate != 0 && bitrate != mBitrate) {
+		mBitrate = bitrate;
+		unsigned long long bytes = (unsigned long long)bitrate / 8 * CONFIG_FILE_DATASOURCE_READAHEAD_MSEC / 1000;
+		mReadAhead->setDepth((unsigned int)((bytes + CONFIG_FILE_DATASOURCE_READAHEAD_BLOCK_SIZE - 1) / CONFIG_FILE_DATASOURCE_READAHEAD_BLOCK_SIZE));
+	}
+
+	return (ret < 0) ? ret : rlen;
+}
+#endif
+
 FileInputDataSource::~FileInputDataSource()
 {
-	close();
+	// Player may have closed it already on unprepare
+	if (mFp) {
+		close();
+	}
 }
 
 } // namespace stream
@@ -0,0 +1,237 @@
+/* ****************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ******************************************************************/
+
+#include <tinyara/config.h>
+#include <string.h>
+#include <debug.h>
+
+#include "FileReadAhead.h"
+#include "utils/MediaUtils.h"
+
+namespace media {
+namespace stream {
+
+FileReadAhead::FileReadAhead(size_t blockSize, unsigned int blocks, long stackSize)
+	: mBlockSize(blockSize), mBlocks(blocks), mStackSize(stackSize), mFp(nullptr), mHead(0), mFilled(0), mOffset(0), mDepth(blocks), mPos(0), mEof(false), mError(false), mIsWorkerAlive(false)
+{
+	memset(&mStats, 0, sizeof(mStats));
+}
+
+FileReadAhead::~FileReadAhead()
+{
+	stop();
+}
+
+bool FileReadAhead::init()
+{
+	mBuffer.reset(new (std::nothrow) unsigned char[mBlockSize * mBlocks]);
+	mBlockLen.reset(new (std::nothrow) size_t[mBlocks]);
+	if (!mBuffer || !mBlockLen) {
+		meddbg("Fail to allocate %u read-ahead blocks\n", mBlocks);
+		mBuffer.reset();
+		mBlockLen.reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FileReadAhead::start(FILE *fp, long offset)
+{
+	stop();
+
+	if (!mBuffer || offset < 0) {
+		return false;
+	}
+
+	// Read whole blocks, skip the head of first block.
+	long aligned = offset - (offset % (long)mBlockSize);
+	if (fseek(fp, aligned, SEEK_SET) != 0) {
+		meddbg("Fail to seek %ld\n", aligned);
+		return false;
+	}
+
+	mFp = fp;
+	mHead = 0;
+	mFilled = 0;
+	mOffset = (size_t)(offset - aligned);
+	mPos = offset;
+	mEof = false;
+	mError = false;
+	mIsWorkerAlive = true;
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, mStackSize);
+	int ret = pthread_create(&mWorker, &attr, static_cast<pthread_startroutine_t>(FileReadAhead::workerMain), this);
+	if (ret != OK) {
+		meddbg("Fail to create FileReadAhead thread, return value : %d\n", ret);
+		mIsWorkerAlive = false;
+		return false;
+	}
+	pthread_setname_np(mWorker, "FileReadAhead");
+
+	return true;
+}
+
+void FileReadAhead::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!mIsWorkerAlive) {
+			return;
+		}
+		mIsWorkerAlive = false;
+		mWorkerCondv.notify_one();
+	}
+
+	// Worker may be in reading, wait until it finishes the block.
+	pthread_join(mWorker, NULL);
+	mFilled = 0;
+	mFp = nullptr;
+}
+
+ssize_t FileReadAhead::acquire(unsigned char **data, size_t size)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	uint64_t stallStart = 0;
+
+	while (true) {
+		if (mFilled > 0) {
+			if (mOffset < mBlockLen[mHead]) {
+				break;
+			}
+			// Skipped over a short block, it's the last one.
+			mHead = (mHead + 1) % mBlocks;
+			mFilled--;
+			mOffset = 0;
+			mWorkerCondv.notify_one();
+			continue;
+		}
+
+		if (mError || !mIsWorkerAlive) {
+			return EOF;
+		}
+
+		if (mEof) {
+			return 0;
+		}
+
+		if (stallStart == 0) {
+			stallStart = utils::getCurrentTimeUs();
+		}
+		mConsumerCondv.wait(lock);
+	}
+
+	if (stallStart != 0) {
+		mStats.misses++;
+		mStats.stallUs += utils::getCurrentTimeUs() - stallStart;
+	} else {
+		mStats.hits++;
+	}
+
+	size_t avail = mBlockLen[mHead] - mOffset;
+	*data = mBuffer.get() + mHead * mBlockSize + mOffset;
+	return (ssize_t)(size < avail ? size : avail);
+}
+
+void FileReadAhead::release(size_t size)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mFilled == 0) {
+		return;
+	}
+
+	mOffset += size;
+	mPos += size;
+	if (mOffset >= mBlockLen[mHead]) {
+		mHead = (mHead + 1) % mBlocks;
+		mFilled--;
+		mOffset = 0;
+		mWorkerCondv.notify_one();
+	}
+}
+
+void FileReadAhead::setDepth(unsigned int blocks)
+{
+	if (blocks < 2) {
+		blocks = 2;
+	}
+	if (blocks > mBlocks) {
+		blocks = mBlocks;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mDepth != blocks) {
+		medvdbg("read-ahead depth %u -> %u blocks\n", mDepth, blocks);
+		mDepth = blocks;
+		mWorkerCondv.notify_one();
+	}
+}
+
+void FileReadAhead::getStats(file_readahead_stats_t *stats)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	*stats = mStats;
+	unsigned int total = mStats.hits + mStats.misses;
+	stats->hitRate = (total > 0) ? (unsigned int)((unsigned long long)mStats.hits * 100 / total) : 0;
+	stats->depth = mDepth;
+}
+
+void *FileReadAhead::workerMain(void *arg)
+{
+	auto readAhead = static_cast<FileReadAhead *>(arg);
+	readAhead->readBlocks();
+	return NULL;
+}
+
+void FileReadAhead::readBlocks()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	while (mIsWorkerAlive) {
+		if (mEof || mError || mFilled >= mDepth) {
+			mWorkerCondv.wait(lock);
+			continue;
+		}
+
+		// The tail block isn't visible to consumer until it's counted in mFilled,
+		// so it's read without holding the lock.
+		unsigned int tail = (mHead + mFilled) % mBlocks;
+		lock.unlock();
+		size_t len = fread(mBuffer.get() + tail * mBlockSize, sizeof(unsigned char), mBlockSize, mFp);
+		bool eof = (len < mBlockSize) && feof(mFp);
+		bool error = (len < mBlockSize) && !eof;
+		lock.lock();
+
+		if (len > 0) {
+			mBlockLen[tail] = len;
+			mFilled++;
+			mStats.bytesPrefetched += len;
+		}
+		if (error) {
+			meddbg("read error : %d\n", errno);
+		}
+		mEof = eof;
+		mError = error;
+		mConsumerCondv.notify_one();
+	}
+}
+
+} // namespace stream
+} // namespace media
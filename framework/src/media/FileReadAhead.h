@@ -0,0 +1,84 @@
+/* ****************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ******************************************************************/
+
+#ifndef __MEDIA_FILEREADAHEAD_H
+#define __MEDIA_FILEREADAHEAD_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <media/FileInputDataSource.h>
+
+namespace media {
+namespace stream {
+
+/*
+ * Reads a file ahead of its consumer in a worker thread.
+ * File is read in blocks aligned to the block size into a ring of blocks, so
+ * a slow read (e.g. flash wear-levelling) is hidden as far as filled blocks last.
+ * One consumer only, and it must not call start()/stop() concurrently with acquire().
+ */
+class FileReadAhead
+{
+public:
+	FileReadAhead(size_t blockSize, unsigned int blocks, long stackSize);
+	~FileReadAhead();
+
+	bool init();
+	bool start(FILE *fp, long offset);
+	void stop();
+	ssize_t acquire(unsigned char **data, size_t size);
+	void release(size_t size);
+	void setDepth(unsigned int blocks);
+	long tell() { return mPos; }
+	void getStats(file_readahead_stats_t *stats);
+
+private:
+	static void *workerMain(void *arg);
+	void readBlocks();
+
+	size_t mBlockSize;
+	unsigned int mBlocks;
+	long mStackSize;
+	std::unique_ptr<unsigned char[]> mBuffer;
+	std::unique_ptr<size_t[]> mBlockLen;
+
+	FILE *mFp;
+	unsigned int mHead;         // block consumed now
+	unsigned int mFilled;       // blocks filled from mHead
+	size_t mOffset;             // bytes consumed in the head block
+	unsigned int mDepth;        // blocks kept filled ahead
+	long mPos;                  // file position of the consumer
+	bool mEof;
+	bool mError;
+
+	bool mIsWorkerAlive;
+	pthread_t mWorker;
+	std::mutex mMutex;
+	std::condition_variable mWorkerCondv;
+	std::condition_variable mConsumerCondv;
+
+	file_readahead_stats_t mStats;
+};
+
+} // namespace stream
+} // namespace media
+
+#endif
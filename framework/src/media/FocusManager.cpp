@@ -16,12 +16,16 @@
  *
  ******************************************************************/
 
+#include <tinyara/config.h>
 #include <media/FocusManager.h>
+#ifdef CONFIG_AUDIO_MIXER
+#include "audio/audio_manager.h"
+#endif
 
 namespace media {
 
-FocusManager::FocusRequester::FocusRequester(std::string id, std::shared_ptr<FocusChangeListener> listener)
-	: mId(id), mListener(listener)
+FocusManager::FocusRequester::FocusRequester(std::string id, std::shared_ptr<FocusChangeListener> listener, int focusGain)
+	: mId(id), mListener(listener), mFocusGain(focusGain)
 {
 }
 
@@ -30,6 +34,11 @@ bool FocusManager::FocusRequester::hasSameId(std::string id)
 	return (mId.compare(id) == 0);
 }
 
+int FocusManager::FocusRequester::getFocusGain()
+{
+	return mFocusGain;
+}
+
 void FocusManager::FocusRequester::notify(int focusChange)
 {
 	if (mListener) {
@@ -61,6 +70,7 @@ int FocusManager::abandonFocus(std::shared_ptr<FocusRequest> focusRequest)
 		removeFocusElement(focusRequest->getId());
 	}
 
+	updateDucking();
 	return FOCUS_REQUEST_SUCCESS;
 }
 
@@ -77,14 +87,16 @@ int FocusManager::requestFocus(std::shared_ptr<FocusRequest> focusRequest)
 
 	removeFocusElement(focusRequest->getId());
 
+	int focusGain = focusRequest->getFocusGain();
 	if (!mFocusList.empty()) {
-		mFocusList.front()->notify(FOCUS_LOSS);
+		mFocusList.front()->notify(focusGain == FOCUS_GAIN_TRANSIENT_MAY_DUCK ? FOCUS_LOSS_TRANSIENT_CAN_DUCK : FOCUS_LOSS);
 	}
 
-	auto focusRequester = std::make_shared<FocusRequester>(focusRequest->getId(), focusRequest->getListener());
+	auto focusRequester = std::make_shared<FocusRequester>(focusRequest->getId(), focusRequest->getListener(), focusGain);
 	mFocusList.push_front(focusRequester);
 	focusRequester->notify(FOCUS_GAIN);
 
+	updateDucking();
 	return FOCUS_REQUEST_SUCCESS;
 }
 
@@ -99,4 +111,17 @@ void FocusManager::removeFocusElement(std::string id)
 		}
 	}
 }
+
+void FocusManager::updateDucking()
+{
+	// Others are ducked while the focus holder allows them to play
+	bool ducking = (!mFocusList.empty()) && (mFocusList.front()->getFocusGain() == FOCUS_GAIN_TRANSIENT_MAY_DUCK);
+	if (ducking == mDucking) {
+		return;
+	}
+	mDucking = ducking;
+#ifdef CONFIG_AUDIO_MIXER
+	set_audio_mixer_ducking(ducking);
+#endif
+}
 } // namespace media
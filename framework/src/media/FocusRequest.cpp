@@ -20,7 +20,8 @@
 #include <media/FocusRequest.h>
 
 namespace media {
-FocusRequest::FocusRequest(std::string id, std::shared_ptr<FocusChangeListener> listener) : mId(id), mListener(listener)
+FocusRequest::FocusRequest(std::string id, std::shared_ptr<FocusChangeListener> listener, int focusGain)
+	: mId(id), mListener(listener), mFocusGain(focusGain)
 {
 }
 
@@ -34,7 +35,12 @@ std::shared_ptr<FocusChangeListener> FocusRequest::getListener()
 	return mListener;
 }
 
-FocusRequest::Builder::Builder() : mId(""), mListener(nullptr)
+int FocusRequest::getFocusGain()
+{
+	return mFocusGain;
+}
+
+FocusRequest::Builder::Builder() : mId(""), mListener(nullptr), mFocusGain(FOCUS_GAIN)
 {
 }
 
@@ -44,13 +50,19 @@ FocusRequest::Builder &FocusRequest::Builder::setFocusChangeListener(std::shared
 	return *this;
 }
 
+FocusRequest::Builder &FocusRequest::Builder::setFocusGain(int focusGain)
+{
+	mFocusGain = focusGain;
+	return *this;
+}
+
 std::shared_ptr<FocusRequest> FocusRequest::Builder::build()
 {
 	std::stringstream ss;
 	ss << static_cast<const void *>(this);
 	ss << static_cast<const void *>(mListener.get());
 	mId = ss.str();
-	auto focusRequest = std::make_shared<FocusRequest>(mId, mListener);
+	auto focusRequest = std::make_shared<FocusRequest>(mId, mListener, mFocusGain);
 	return focusRequest;
 }
 } // namespace media
@@ -18,14 +18,17 @@
 
 #include <tinyara/config.h>
 #include <assert.h>
+#include <limits.h>
 #include <debug.h>
 #include <unistd.h>
 #include <media/InputDataSource.h>
 #include "Decoder.h"
 #include "MediaPlayerImpl.h"
+#include "PlayerWorker.h"
 #include "StreamBuffer.h"
 #include "StreamBufferReader.h"
 #include "StreamBufferWriter.h"
+#include "utils/rb.h"
 
 #ifndef CONFIG_INPUT_DATASOURCE_STACKSIZE
 #define CONFIG_INPUT_DATASOURCE_STACKSIZE 4096
@@ -35,7 +38,7 @@ namespace media {
 namespace stream {
 
 InputDataSource::InputDataSource()
-	: DataSource(), mAudioType(AUDIO_TYPE_INVALID), mDecoder(nullptr), mState(BUFFER_STATE_EMPTY), mTotalBytes(0), mIsWorkerAlive(false)
+	: DataSource(), mAudioType(AUDIO_TYPE_INVALID), mDecoder(nullptr), mState(BUFFER_STATE_EMPTY), mReadyLevel(0), mTotalBytes(0), mIsWorkerAlive(false)
 {
 }
 
@@ -109,6 +112,98 @@ size_t InputDataSource::getDecodeFrames(unsigned char *buf, size_t *size)
 	return 0;
 }
 
+void InputDataSource::completeFrameIndex()
+{
+	if (mDecoder) {
+		mDecoder->completeIndex();
+	}
+}
+
+unsigned int InputDataSource::getBitrate()
+{
+	if (mDecoder) {
+		return mDecoder->getBitrate();
+	}
+
+	// 16bit PCM
+	return getSampleRate() * getChannels() * 16;
+}
+
+bool InputDataSource::loadFrameIndex(const std::string &path, size_t sourceSize)
+{
+	if (!mDecoder) {
+		return false;
+	}
+
+	return mDecoder->loadIndex(path.c_str(), sourceSize);
+}
+
+bool InputDataSource::saveFrameIndex(const std::string &path, size_t sourceSize)
+{
+	if (!mDecoder) {
+		return false;
+	}
+
+	return mDecoder->saveIndex(path.c_str(), sourceSize);
+}
+
+int InputDataSource::seekTo(unsigned int msec)
+{
+	int ret = -1;
+
+	if (!mDecoder) {
+		meddbg("InputDataSource::seekTo : not supported without decoder\n");
+		return -1;
+	}
+
+	// The player reads the stream buffer in PlayerWorker, so it's reset there while playing.
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	if (!getPlayer() || !mpw.isAlive() || mpw.isWorkerThread()) {
+		seekToPosition(msec, ret);
+		return ret;
+	}
+
+	std::unique_lock<std::mutex> lock(mSyncMtx);
+	mpw.enQueue(&InputDataSource::seekToPosition, this, msec, std::ref(ret));
+	mSyncCv.wait(lock);
+
+	return ret;
+}
+
+void InputDataSource::seekToPosition(unsigned int msec, int &ret)
+{
+	int result = -1;
+
+	stop(); // Stop before seeking, then restart in read()
+
+	// Drop the data of the previous position, and its end of stream
+	if (mStreamBuffer) {
+		mStreamBuffer->reset();
+	}
+
+	long offset = mDecoder->seekTo(msec);
+	if (offset < 0) {
+		meddbg("InputDataSource::seekTo : fail to find %u msec\n", msec);
+	} else if (seek(offset, SEEK_SET) != 0) {
+		meddbg("InputDataSource::seekTo : fail to seek %ld\n", offset);
+	} else {
+		result = 0;
+	}
+
+	std::lock_guard<std::mutex> lock(mSyncMtx);
+	ret = result;
+	mSyncCv.notify_one();
+}
+
+int InputDataSource::getDuration()
+{
+	if (!mDecoder) {
+		return -1;
+	}
+
+	return mDecoder->getDuration();
+}
+
 int InputDataSource::readAt(long offset, int origin, unsigned char *buf, size_t size)
 {
 	stop(); // Stop before seeking, then restart in read()
@@ -155,14 +250,40 @@ ssize_t InputDataSource::writeToStreamBuffer(unsigned char *buf, size_t size)
 			push += temp;
 
 			while (1) {
-				// Reuse free space: buf[0~push)
-				size_t pcmlen = push & ~0x1;
-				if (!getDecodeFrames(buf, &pcmlen)) {
+				rb_span_t span;
+				size_t decoded = 0;
+				if (!mBufferWriter->acquire(&span, push & ~0x1)) {
+					// Streaming was stopped (EOS was set)
+					break;
+				}
+
+				if ((span.len[0] & 0x1) == 0) {
+					// Decode PCM data straight into free space of input stream buffer.
+					for (int i = 0; i < 2 && span.len[i] > 0; i++) {
+						size_t pcmlen = span.len[i];
+						if (!getDecodeFrames((unsigned char *)span.ptr[i], &pcmlen)) {
+							break;
+						}
+						decoded += pcmlen;
+						if (pcmlen < span.len[i]) {
+							break;
+						}
+					}
+					mBufferWriter->commit(decoded);
+				} else {
+					// Odd-sized space before wrap-around can't hold 16bit-PCM samples,
+					// reuse free space: buf[0~push) and write PCM data to input stream buffer.
+					size_t pcmlen = push & ~0x1;
+					if (getDecodeFrames(buf, &pcmlen)) {
+						decoded = mBufferWriter->write(buf, pcmlen);
+					}
+				}
+
+				if (decoded == 0) {
 					// Normal case: break and push more data...
 					break;
 				}
-				// Write PCM data to input stream buffer.
-				written += mBufferWriter->write(buf, pcmlen);
+				written += decoded;
 			}
 		}
 	} else {
@@ -185,6 +306,59 @@ ssize_t InputDataSource::read(unsigned char *buf, size_t size)
 	return (ssize_t) rlen;
 }
 
+ssize_t InputDataSource::acquire(struct rb_span_s *span, size_t size)
+{
+	size_t rlen = 0;
+
+	start(); // Auto start
+
+	if (mBufferReader) {
+		rlen = mBufferReader->acquire(span, size);
+	}
+
+	return (ssize_t) rlen;
+}
+
+void InputDataSource::release(size_t size)
+{
+	if (mBufferReader) {
+		mBufferReader->commit(size);
+	}
+}
+
+bool InputDataSource::isReady(size_t size)
+{
+	start(); // Auto start
+
+	if (!mBufferReader) {
+		// Let read() report the failure
+		return true;
+	}
+
+	if (size > mStreamBuffer->getBufferSize()) {
+		size = mStreamBuffer->getBufferSize();
+	}
+
+	// Set level before checking, so that writer can't miss to wake player up.
+	mReadyLevel = size;
+	if (mBufferReader->sizeOfData() >= size || mBufferReader->isEndOfStream()) {
+		mReadyLevel = 0;
+		return true;
+	}
+
+	return false;
+}
+
+void InputDataSource::notifyReady()
+{
+	if (mReadyLevel.exchange(0) != 0) {
+		auto mp = getPlayer();
+		if (mp) {
+			mp->onInputReady();
+		}
+	}
+}
+
 bool InputDataSource::start()
 {
 	if (!isPrepare()) {
@@ -218,6 +392,8 @@ void *InputDataSource::workerMain(void *arg)
 			if (worker->onStreamBufferWritable() <= 0) {
 				// Error occurred, or inputting finished
 				worker->mBufferWriter->setEndOfStream();
+				// Player may be waiting for data remained
+				worker->notifyReady();
 				break;
 			}
 		}
@@ -287,8 +463,8 @@ void InputDataSource::wakenWorker()
 
 void InputDataSource::setBufferState(buffer_state_t state)
 {
-	if (mState != state) {
-		mState = state;
+	// Reader and writer may update the state concurrently in lock-free mode of stream buffer.
+	if (mState.exchange(state) != state) {
 		auto mp = getPlayer();
 		if (mp) {
 			mp->notifyObserver(PLAYER_OBSERVER_COMMAND_BUFFER_STATECHANGED, (int)state);
@@ -330,10 +506,16 @@ void InputDataSource::onBufferUpdated(ssize_t change, size_t current)
 	}
 
 	if (change > 0) {
+		size_t level = mReadyLevel;
+		if (level > 0 && current >= level) {
+			// Wake player up only when the data desired is buffered
+			notifyReady();
+		}
+
 		mTotalBytes += change;
 		if (mTotalBytes > INT_MAX) {
 			mTotalBytes = 0;
-			meddbg("Too huge value: %u, set 0 to prevent overflow\n", mTotalBytes);
+			meddbg("Too huge value: %zu, set 0 to prevent overflow\n", mTotalBytes);
 		}
 
 		auto mp = getPlayer();
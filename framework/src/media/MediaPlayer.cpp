@@ -72,6 +72,11 @@ player_result_t MediaPlayer::setVolume(uint8_t vol)
 	return mPMpImpl->setVolume(vol);
 }
 
+player_result_t MediaPlayer::getStats(player_stats_t *stats)
+{
+	return mPMpImpl->getStats(stats);
+}
+
 player_result_t MediaPlayer::setDataSource(std::unique_ptr<stream::InputDataSource> source)
 {
 	return mPMpImpl->setDataSource(std::move(source));
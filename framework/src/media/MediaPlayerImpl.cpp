@@ -22,7 +22,14 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <stdarg.h>
+#include <string.h>
 #include "audio/audio_manager.h"
+#include "utils/rb.h"
+#include "utils/MediaUtils.h"
+
+/* Shortest sleep of player worker while waiting for output device, in microseconds */
+#define PLAYBACK_MIN_SLEEP_US 1000
 
 namespace media {
 MediaPlayerImpl::MediaPlayerImpl(MediaPlayer &player) : mPlayer(player)
@@ -32,6 +39,13 @@ MediaPlayerImpl::MediaPlayerImpl(MediaPlayer &player) : mPlayer(player)
 	mBuffer = nullptr;
 	mBufSize = 0;
 	mInputDataSource = nullptr;
+	memset(&mStats, 0, sizeof(player_stats_t));
+	mDeadlineUs = 0;
+	mLastWriteUs = 0;
+	mInputStarved = false;
+#ifdef CONFIG_AUDIO_MIXER
+	mStream = -1;
+#endif
 }
 
 player_result_t MediaPlayerImpl::create()
@@ -150,6 +164,17 @@ void MediaPlayerImpl::preparePlayer(player_result_t &ret)
 		return notifySync();
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	mStream = open_audio_mixer_stream(mInputDataSource->getChannels(), mInputDataSource->getSampleRate(),
+									  mInputDataSource->getPcmFormat());
+	if (mStream < 0) {
+		meddbg("MediaPlayer prepare fail : open_audio_mixer_stream fail : %d\n", mStream);
+		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+		return notifySync();
+	}
+
+	mBufSize = framesToBytes(get_audio_mixer_stream_frame_count(mStream));
+#else
 	if (set_audio_stream_out(mInputDataSource->getChannels(), mInputDataSource->getSampleRate(),
 							 mInputDataSource->getPcmFormat()) != AUDIO_MANAGER_SUCCESS) {
 		meddbg("MediaPlayer prepare fail : set_audio_stream_out fail\n");
@@ -158,6 +183,7 @@ void MediaPlayerImpl::preparePlayer(player_result_t &ret)
 	}
 
 	mBufSize = get_output_frames_to_byte(get_output_frame_count());
+#endif
 	if (mBufSize < 0) {
 		meddbg("MediaPlayer prepare fail : get_output_frames_byte_size fail\n");
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
@@ -165,6 +191,7 @@ void MediaPlayerImpl::preparePlayer(player_result_t &ret)
 	}
 
 	medvdbg("MediaPlayer mBuffer size : %d\n", mBufSize);
+	memset(&mStats, 0, sizeof(player_stats_t));
 
 	mBuffer = new unsigned char[mBufSize];
 	if (!mBuffer) {
@@ -216,11 +243,20 @@ void MediaPlayerImpl::unpreparePlayer(player_result_t &ret)
 	}
 	mBufSize = 0;
 
+#ifdef CONFIG_AUDIO_MIXER
+	if (close_audio_mixer_stream(mStream) != AUDIO_MANAGER_SUCCESS) {
+		meddbg("MediaPlayer unprepare fail : close_audio_mixer_stream fail\n");
+		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+		return notifySync();
+	}
+	mStream = -1;
+#else
 	if (reset_audio_stream_out() != AUDIO_MANAGER_SUCCESS) {
 		meddbg("MediaPlayer unprepare fail : reset_audio_stream_out fail\n");
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
 		return notifySync();
 	}
+#endif
 
 	mInputDataSource->close();
 
@@ -255,6 +291,10 @@ void MediaPlayerImpl::startPlayer()
 		return;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	// Players play together, their streams are mixed
+	mpw.addPlayer(shared_from_this());
+#else
 	auto prevPlayer = mpw.getPlayer();
 	auto curPlayer = shared_from_this();
 	if (prevPlayer != curPlayer) {
@@ -264,6 +304,12 @@ void MediaPlayerImpl::startPlayer()
 		}
 		mpw.setPlayer(curPlayer);
 	}
+#endif
+
+	// Output device starts from empty, there's no deadline yet.
+	mDeadlineUs = 0;
+	mLastWriteUs = 0;
+	mInputStarved = false;
 
 	mCurState = PLAYER_STATE_PLAYING;
 	notifyObserver(PLAYER_OBSERVER_COMMAND_STARTED);
@@ -296,7 +342,11 @@ void MediaPlayerImpl::stopPlayer(player_result_t ret)
 		return;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	audio_manager_result_t result = drain_audio_mixer_stream(mStream);
+#else
 	audio_manager_result_t result = stop_audio_stream_out();
+#endif
 	if (result != AUDIO_MANAGER_SUCCESS) {
 		meddbg("stop_audio_stream_out failed ret : %d\n", result);
 		if (ret == PLAYER_OK) {
@@ -306,7 +356,11 @@ void MediaPlayerImpl::stopPlayer(player_result_t ret)
 		}
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	mpw.removePlayer(shared_from_this());
+#else
 	mpw.setPlayer(nullptr);
+#endif
 	mCurState = PLAYER_STATE_READY;
 }
 
@@ -336,18 +390,26 @@ void MediaPlayerImpl::pausePlayer()
 		return;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	audio_manager_result_t result = pause_audio_mixer_stream(mStream);
+#else
 	audio_manager_result_t result = pause_audio_stream_out();
+#endif
 	if (result != AUDIO_MANAGER_SUCCESS) {
 		meddbg("pause_audio_stream_in failed ret : %d\n", result);
 		notifyObserver(PLAYER_OBSERVER_COMMAND_PAUSE_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 		return;
 	}
 
+#ifdef CONFIG_AUDIO_MIXER
+	mpw.removePlayer(shared_from_this());
+#else
 	auto prevPlayer = mpw.getPlayer();
 	auto curPlayer = shared_from_this();
 	if (prevPlayer == curPlayer) {
 		mpw.setPlayer(nullptr);
 	}
+#endif
 	mCurState = PLAYER_STATE_PAUSED;
 }
 
@@ -379,6 +441,15 @@ player_result_t MediaPlayerImpl::getVolume(uint8_t *vol)
 void MediaPlayerImpl::getPlayerVolume(uint8_t *vol, player_result_t &ret)
 {
 	medvdbg("MediaPlayer Worker : getVolume\n");
+#ifdef CONFIG_AUDIO_MIXER
+	// Volume of a prepared player is the gain of its mixer stream
+	if (mStream >= 0) {
+		if (get_audio_mixer_stream_volume(mStream, vol) != AUDIO_MANAGER_SUCCESS) {
+			ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
+		}
+		return notifySync();
+	}
+#endif
 	if (get_output_audio_volume(vol) != AUDIO_MANAGER_SUCCESS) {
 		meddbg("get_output_audio_volume() is failed, ret = %d\n", ret);
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
@@ -410,7 +481,11 @@ void MediaPlayerImpl::setPlayerVolume(uint8_t vol, player_result_t &ret)
 {
 	medvdbg("MediaPlayer Worker : setVolume %d\n", vol);
 
+#ifdef CONFIG_AUDIO_MIXER
+	audio_manager_result_t result = (mStream >= 0) ? set_audio_mixer_stream_volume(mStream, vol) : set_output_audio_volume(vol);
+#else
 	audio_manager_result_t result = set_output_audio_volume(vol);
+#endif
 	if (result != AUDIO_MANAGER_SUCCESS) {
 		meddbg("set_input_audio_volume failed vol : %d ret : %d\n", vol, result);
 		ret = PLAYER_ERROR_INTERNAL_OPERATION_FAILED;
@@ -422,6 +497,42 @@ void MediaPlayerImpl::setPlayerVolume(uint8_t vol, player_result_t &ret)
 	return notifySync();
 }
 
+player_result_t MediaPlayerImpl::getStats(player_stats_t *stats)
+{
+	player_result_t ret = PLAYER_OK;
+
+	std::unique_lock<std::mutex> lock(mCmdMtx);
+	medvdbg("MediaPlayer getStats\n");
+
+	if (stats == nullptr) {
+		meddbg("The given argument is invalid.\n");
+		return PLAYER_ERROR_INVALID_PARAMETER;
+	}
+
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	if (!mpw.isAlive()) {
+		meddbg("PlayerWorker is not alive\n");
+		return PLAYER_ERROR_NOT_ALIVE;
+	}
+
+	mpw.enQueue(&MediaPlayerImpl::getPlayerStats, shared_from_this(), stats, std::ref(ret));
+	mSyncCv.wait(lock);
+
+	return ret;
+}
+
+void MediaPlayerImpl::getPlayerStats(player_stats_t *stats, player_result_t &ret)
+{
+	medvdbg("MediaPlayer Worker : getStats\n");
+	*stats = mStats;
+	if (mDeadlineUs != 0) {
+		stats->deadlineUs = (long long)mDeadlineUs - (long long)utils::getCurrentTimeUs();
+	}
+
+	ret = PLAYER_OK;
+	notifySync();
+}
+
 player_result_t MediaPlayerImpl::setDataSource(std::unique_ptr<stream::InputDataSource> source)
 {
 	player_result_t ret = PLAYER_OK;
@@ -555,12 +666,113 @@ void MediaPlayerImpl::notifyObserver(player_observer_command_t cmd, ...)
 	va_end(ap);
 }
 
-void MediaPlayerImpl::playback()
+unsigned int MediaPlayerImpl::getPeriodUs()
+{
+	unsigned int sampleRate = mInputDataSource->getSampleRate();
+	if (sampleRate == 0) {
+		return PLAYBACK_MIN_SLEEP_US;
+	}
+
+	return (unsigned int)((uint64_t)bytesToFrames((unsigned int)mBufSize) * 1000000 / sampleRate);
+}
+
+unsigned int MediaPlayerImpl::framesToBytes(unsigned int frames)
+{
+#ifdef CONFIG_AUDIO_MIXER
+	// Mixer streams take 16 bits PCM in the source format
+	return frames * mInputDataSource->getChannels() * sizeof(int16_t);
+#else
+	return get_output_frames_to_byte(frames);
+#endif
+}
+
+unsigned int MediaPlayerImpl::bytesToFrames(unsigned int bytes)
+{
+#ifdef CONFIG_AUDIO_MIXER
+	unsigned int frameSize = mInputDataSource->getChannels() * sizeof(int16_t);
+	return frameSize ? bytes / frameSize : 0;
+#else
+	return get_output_bytes_to_frame(bytes);
+#endif
+}
+
+void MediaPlayerImpl::onInputReady()
 {
-	ssize_t num_read = mInputDataSource->read(mBuffer, (int)mBufSize);
-	meddbg("num_read : %d\n", num_read);
+	PlayerWorker &mpw = PlayerWorker::getWorker();
+	mpw.wakeUp();
+}
+
+unsigned int MediaPlayerImpl::playback()
+{
+	uint64_t now = utils::getCurrentTimeUs();
+	unsigned int periodUs = getPeriodUs();
+
+	mStats.wakeups++;
+
+	// Sleep until a period of input data is buffered, InputDataSource wakes us up then.
+	if (!mInputDataSource->isReady((size_t)mBufSize)) {
+		if (!mInputStarved) {
+			mInputStarved = true;
+			mStats.inputUnderruns++;
+		}
+		return periodUs;
+	}
+	mInputStarved = false;
+
+#ifdef CONFIG_AUDIO_MIXER
+	// Sleep until mixer consumes half of the stream queue, output device is written meanwhile.
+	int avail = get_audio_mixer_stream_avail(mStream);
+	if (avail >= 0 && (unsigned int)avail < bytesToFrames((unsigned int)mBufSize) / 2) {
+		uint64_t next = mLastWriteUs + periodUs / 2;
+		return (next > now + PLAYBACK_MIN_SLEEP_US) ? (unsigned int)(next - now) : PLAYBACK_MIN_SLEEP_US;
+	}
+	size_t size = (avail > 0) ? (size_t)framesToBytes((unsigned int)avail) : (size_t)mBufSize;
+	if (size > (size_t)mBufSize) {
+		size = (size_t)mBufSize;
+	}
+#else
+	// Sleep until output device consumes a period, it's about one period after the last write.
+	int avail = get_output_avail_frames();
+	if (avail >= 0 && (unsigned int)avail < get_output_frame_count()) {
+		uint64_t next = mLastWriteUs + periodUs;
+		return (next > now + PLAYBACK_MIN_SLEEP_US) ? (unsigned int)(next - now) : PLAYBACK_MIN_SLEEP_US;
+	}
+	size_t size = (size_t)mBufSize;
+#endif
+
+	rb_span_t span;
+	ssize_t num_read = mInputDataSource->acquire(&span, size);
+	medvdbg("num_read : %d\n", num_read);
 	if (num_read > 0) {
-		int ret = start_audio_stream_out(mBuffer, get_output_bytes_to_frame((unsigned int)num_read));
+		unsigned char *data;
+		unsigned int len;
+		unsigned int frames = bytesToFrames((unsigned int)span.len[0]);
+		if (frames > 0) {
+			// Hand PCM data over to output device straight from the stream buffer.
+			data = (unsigned char *)span.ptr[0];
+			len = framesToBytes(frames);
+		} else {
+			// Less than one frame remains before wrap-around, gather it into mBuffer.
+			memcpy(mBuffer, span.ptr[0], span.len[0]);
+			if (span.len[1] > 0) {
+				memcpy(mBuffer + span.len[0], span.ptr[1], span.len[1]);
+			}
+			data = mBuffer;
+			len = (unsigned int)num_read;
+			frames = bytesToFrames(len);
+		}
+
+#ifdef CONFIG_AUDIO_MIXER
+		// Mixer stream may take a part of data when its queue is full
+		int ret = write_audio_mixer_stream(mStream, data, frames);
+		if (ret >= 0) {
+			frames = (unsigned int)ret;
+			len = framesToBytes(frames);
+		}
+#else
+		int ret = start_audio_stream_out(data, frames);
+#endif
+		mInputDataSource->release(len);
 		if (ret < 0) {
 			notifyObserver(PLAYER_OBSERVER_COMMAND_PLAYBACK_ERROR, PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 			PlayerWorker &mpw = PlayerWorker::getWorker();
@@ -574,7 +786,21 @@ void MediaPlayerImpl::playback()
 				mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INTERNAL_OPERATION_FAILED);
 				break;
 			}
+			return 0;
 		}
+
+		// Queued data lasts until the deadline, writing after it means device starved.
+		unsigned int sampleRate = mInputDataSource->getSampleRate();
+		unsigned int durationUs = sampleRate ? (unsigned int)((uint64_t)frames * 1000000 / sampleRate) : 0;
+		if (mDeadlineUs != 0 && now > mDeadlineUs) {
+			mStats.deviceUnderruns++;
+		}
+		mDeadlineUs = ((mDeadlineUs == 0 || now > mDeadlineUs) ? now : mDeadlineUs) + durationUs;
+
+		mLastWriteUs = utils::getCurrentTimeUs();
+		mStats.periods++;
+		mStats.periodUs = durationUs;
+		mStats.busyUs += mLastWriteUs - now;
 	} else if (num_read == 0) {
 		notifyObserver(PLAYER_OBSERVER_COMMAND_FINISHIED);
 		stop();
@@ -584,6 +810,8 @@ void MediaPlayerImpl::playback()
 		PlayerWorker &mpw = PlayerWorker::getWorker();
 		mpw.enQueue(&MediaPlayerImpl::stopPlayer, shared_from_this(), PLAYER_ERROR_INVALID_OPERATION);
 	}
+
+	return 0;
 }
 
 MediaPlayerImpl::~MediaPlayerImpl()
@@ -19,6 +19,7 @@
 #ifndef __MEDIA_MEDIAPLAYERIMPL_H
 #define __MEDIA_MEDIAPLAYERIMPL_H
 
+#include <tinyara/config.h>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -81,6 +82,8 @@ public:
 	player_result_t getVolume(uint8_t *vol);
 	player_result_t setVolume(uint8_t vol);
 
+	player_result_t getStats(player_stats_t *stats);
+
 	player_result_t setDataSource(std::unique_ptr<stream::InputDataSource>);
 	player_result_t setObserver(std::shared_ptr<MediaPlayerObserverInterface>);
 
@@ -89,7 +92,8 @@ public:
 	void notifySync();
 	void notifyObserver(player_observer_command_t cmd, ...);
 
-	void playback();
+	unsigned int playback();
+	void onInputReady();
 
 private:
 	void createPlayer(player_result_t &ret);
@@ -101,6 +105,10 @@ private:
 	void pausePlayer();
 	void getPlayerVolume(uint8_t *vol, player_result_t &ret);
 	void setPlayerVolume(uint8_t vol, player_result_t &ret);
+	void getPlayerStats(player_stats_t *stats, player_result_t &ret);
+	unsigned int getPeriodUs();
+	unsigned int framesToBytes(unsigned int frames);
+	unsigned int bytesToFrames(unsigned int bytes);
 	void setPlayerObserver(std::shared_ptr<MediaPlayerObserverInterface> observer);
 	void setPlayerDataSource(std::shared_ptr<stream::InputDataSource> dataSource, player_result_t &ret);
 
@@ -113,6 +121,13 @@ private:
 	std::condition_variable mSyncCv;
 	std::shared_ptr<MediaPlayerObserverInterface> mPlayerObserver;
 	std::shared_ptr<stream::InputDataSource> mInputDataSource;
+	player_stats_t mStats;
+	uint64_t mDeadlineUs;
+	uint64_t mLastWriteUs;
+	bool mInputStarved;
+#ifdef CONFIG_AUDIO_MIXER
+	int mStream;
+#endif
 };
 } // namespace media
 #endif
@@ -19,28 +19,90 @@
 #include "MediaQueue.h"
 
 namespace media {
-MediaQueue::MediaQueue()
+MediaQueue::MediaQueue() : mHead(0), mCount(0), mWakeUp(false), mHasConsumer(false)
 {
 }
 MediaQueue::~MediaQueue()
 {
 }
 
-std::function<void()> MediaQueue::deQueue()
+void MediaQueue::deQueue(MediaCommand &cmd)
 {
 	std::unique_lock<std::mutex> lock(mQueueMtx);
-	if (mQueueData.empty()) {
+	while (mCount == 0) {
 		mQueueCv.wait(lock);
 	}
 
-	auto data = std::move(mQueueData.front());
-	mQueueData.pop();
-	return data;
+	popFront(cmd);
+}
+
+bool MediaQueue::deQueue(MediaCommand &cmd, unsigned int timeoutUs)
+{
+	std::unique_lock<std::mutex> lock(mQueueMtx);
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeoutUs);
+	while (mCount == 0 && !mWakeUp) {
+		if (mQueueCv.wait_until(lock, deadline) == std::cv_status::timeout) {
+			break;
+		}
+	}
+	mWakeUp = false;
+
+	if (mCount == 0) {
+		return false;
+	}
+
+	popFront(cmd);
+	return true;
+}
+
+bool MediaQueue::tryDeQueue(MediaCommand &cmd)
+{
+	std::unique_lock<std::mutex> lock(mQueueMtx);
+	if (mCount == 0) {
+		return false;
+	}
+
+	popFront(cmd);
+	return true;
+}
+
+void MediaQueue::wakeUp()
+{
+	std::unique_lock<std::mutex> lock(mQueueMtx);
+	mWakeUp = true;
+	mQueueCv.notify_one();
+}
+
+void MediaQueue::setConsumer(pthread_t consumer)
+{
+	std::unique_lock<std::mutex> lock(mQueueMtx);
+	mConsumer = consumer;
+	mHasConsumer = true;
+}
+
+void MediaQueue::clearConsumer()
+{
+	std::unique_lock<std::mutex> lock(mQueueMtx);
+	mHasConsumer = false;
+}
+
+bool MediaQueue::isConsumer()
+{
+	std::unique_lock<std::mutex> lock(mQueueMtx);
+	return mHasConsumer && pthread_equal(mConsumer, pthread_self());
 }
 
 bool MediaQueue::isEmpty()
 {
 	std::unique_lock<std::mutex> lock(mQueueMtx);
-	return mQueueData.empty();
+	return mCount == 0;
+}
+
+void MediaQueue::popFront(MediaCommand &cmd)
+{
+	cmd.moveFrom(mQueueData[mHead]);
+	mHead = (mHead + 1) % CONFIG_MEDIA_QUEUE_DEPTH;
+	mCount--;
+	mNotFullCv.notify_one();
 }
 } // namespace media
@@ -19,32 +19,129 @@
 #ifndef __MEDIA_QUEUE_H
 #define __MEDIA_QUEUE_H
 
+#include <tinyara/config.h>
+#include <debug.h>
+#include <pthread.h>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
 #include <atomic>
 #include <iostream>
 #include <functional>
+#include <type_traits>
+#include <new>
+#include <chrono>
+
+#ifndef CONFIG_MEDIA_QUEUE_DEPTH
+#define CONFIG_MEDIA_QUEUE_DEPTH 16
+#endif
+
+#ifndef CONFIG_MEDIA_QUEUE_COMMAND_SIZE
+#define CONFIG_MEDIA_QUEUE_COMMAND_SIZE 64
+#endif
 
 namespace media {
+
+/*
+ * MediaCommand keeps a bound callable inline, so queueing a command never allocates.
+ * The binding is the same as std::bind, arguments are copied unless wrapped by std::ref.
+ */
+class MediaCommand
+{
+public:
+	MediaCommand() : mInvoke(nullptr), mMove(nullptr), mDestroy(nullptr) {}
+	~MediaCommand() { reset(); }
+	MediaCommand(const MediaCommand &) = delete;
+	MediaCommand &operator=(const MediaCommand &) = delete;
+
+	template <typename _Callable, typename... _Args>
+	void set(_Callable &&__f, _Args &&... __args) {
+		typedef decltype(std::bind(std::forward<_Callable>(__f), std::forward<_Args>(__args)...)) _Bound;
+		static_assert(sizeof(_Bound) <= sizeof(mStorage), "CONFIG_MEDIA_QUEUE_COMMAND_SIZE is too small for this command");
+		static_assert(alignof(_Bound) <= alignof(Storage), "Command is over-aligned");
+
+		reset();
+		new (&mStorage) _Bound(std::bind(std::forward<_Callable>(__f), std::forward<_Args>(__args)...));
+		mInvoke = [](void *p) { (*static_cast<_Bound *>(p))(); };
+		mMove = [](void *dst, void *src) { new (dst) _Bound(std::move(*static_cast<_Bound *>(src))); };
+		mDestroy = [](void *p) { static_cast<_Bound *>(p)->~_Bound(); };
+	}
+
+	void moveFrom(MediaCommand &other) {
+		reset();
+		if (other.mInvoke) {
+			other.mMove(&mStorage, &other.mStorage);
+			mInvoke = other.mInvoke;
+			mMove = other.mMove;
+			mDestroy = other.mDestroy;
+			other.reset();
+		}
+	}
+
+	void reset() {
+		if (mDestroy) {
+			mDestroy(&mStorage);
+		}
+		mInvoke = nullptr;
+		mMove = nullptr;
+		mDestroy = nullptr;
+	}
+
+	bool empty() { return mInvoke == nullptr; }
+	void operator()() { mInvoke(&mStorage); }
+
+private:
+	typedef std::aligned_storage<CONFIG_MEDIA_QUEUE_COMMAND_SIZE, alignof(long double)>::type Storage;
+	Storage mStorage;
+	void (*mInvoke)(void *);
+	void (*mMove)(void *, void *);
+	void (*mDestroy)(void *);
+};
+
 class MediaQueue
 {
 public:
 	MediaQueue();
 	~MediaQueue();
 	template <typename _Callable, typename... _Args>
-	void enQueue(_Callable &&__f, _Args &&... __args) {
+	bool enQueue(_Callable &&__f, _Args &&... __args) {
 		std::unique_lock<std::mutex> lock(mQueueMtx);
-		std::function<void()> func = std::bind(std::forward<_Callable>(__f), std::forward<_Args>(__args)...);
-		mQueueData.push(func);
+		if (mHasConsumer && pthread_equal(mConsumer, pthread_self())) {
+			// The consumer can't wait for itself to make room.
+			if (mCount == CONFIG_MEDIA_QUEUE_DEPTH) {
+				meddbg("MediaQueue is full, command dropped\n");
+				return false;
+			}
+		} else {
+			while (mCount == CONFIG_MEDIA_QUEUE_DEPTH) {
+				mNotFullCv.wait(lock);
+			}
+		}
+		mQueueData[(mHead + mCount) % CONFIG_MEDIA_QUEUE_DEPTH].set(std::forward<_Callable>(__f), std::forward<_Args>(__args)...);
+		mCount++;
 		mQueueCv.notify_one();
+		return true;
 	}
-	std::function<void()> deQueue();
+	void deQueue(MediaCommand &cmd);
+	bool deQueue(MediaCommand &cmd, unsigned int timeoutUs);
+	bool tryDeQueue(MediaCommand &cmd);
+	void wakeUp();
 	bool isEmpty();
+	/* The consumer thread enqueueing to its own queue never blocks, other threads wait while it's full */
+	void setConsumer(pthread_t consumer);
+	void clearConsumer();
+	bool isConsumer();
 
 private:
-	std::queue<std::function<void()>> mQueueData;
+	void popFront(MediaCommand &cmd);
+
+	MediaCommand mQueueData[CONFIG_MEDIA_QUEUE_DEPTH];
+	size_t mHead;
+	size_t mCount;
+	bool mWakeUp;
+	bool mHasConsumer;
+	pthread_t mConsumer;
 	std::condition_variable mQueueCv;
+	std::condition_variable mNotFullCv;
 	std::mutex mQueueMtx;
 };
 } // namespace media
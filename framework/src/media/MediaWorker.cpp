@@ -69,9 +69,19 @@ void MediaWorker::stopWorker()
 	}
 }
 
-std::function<void()> MediaWorker::deQueue()
+void MediaWorker::deQueue(MediaCommand &cmd)
 {
-	return mWorkerQueue.deQueue();
+	mWorkerQueue.deQueue(cmd);
+}
+
+bool MediaWorker::tryDeQueue(MediaCommand &cmd)
+{
+	return mWorkerQueue.tryDeQueue(cmd);
+}
+
+void MediaWorker::wakeUp()
+{
+	mWorkerQueue.wakeUp();
 }
 
 bool MediaWorker::processLoop()
@@ -79,20 +89,38 @@ bool MediaWorker::processLoop()
 	return false;
 }
 
+unsigned int MediaWorker::getSleepTime()
+{
+	return 0;
+}
+
 void *MediaWorker::mediaLooper(void *arg)
 {
 	auto worker = static_cast<MediaWorker *>(arg);
 	medvdbg("MediaWorker : mediaLooper\n");
 
+	worker->mWorkerQueue.setConsumer(pthread_self());
+
 	while (worker->mIsRunning) {
 		while (worker->processLoop() && worker->mWorkerQueue.isEmpty());
 
-		std::function<void()> run = worker->deQueue();
+		MediaCommand run;
+		unsigned int sleepTime = worker->getSleepTime();
+		if (sleepTime > 0) {
+			// Timed out or woken up, it's time for processLoop()
+			if (!worker->mWorkerQueue.deQueue(run, sleepTime)) {
+				continue;
+			}
+		} else {
+			worker->deQueue(run);
+		}
 		medvdbg("MediaWorker : deQueue\n");
-		if (run != nullptr) {
+		if (!run.empty()) {
 			run();
 		}
 	}
+
+	worker->mWorkerQueue.clearConsumer();
 	return NULL;
 }
 
@@ -101,4 +129,9 @@ bool MediaWorker::isAlive()
 	std::unique_lock<std::mutex> lock(mRefMtx);
 	return mRefCnt == 0 ? false : true;
 }
+
+bool MediaWorker::isWorkerThread()
+{
+	return mWorkerQueue.isConsumer();
+}
 } // namespace media
@@ -35,16 +35,23 @@ public:
 	void stopWorker();
 
 	template <typename _Callable, typename... _Args>
-	void enQueue(_Callable &&__f, _Args &&... __args) {
-		mWorkerQueue.enQueue(__f, __args...);
+	bool enQueue(_Callable &&__f, _Args &&... __args) {
+		return mWorkerQueue.enQueue(std::forward<_Callable>(__f), std::forward<_Args>(__args)...);
 	}
-	std::function<void()> deQueue();
+	void deQueue(MediaCommand &cmd);
+	bool tryDeQueue(MediaCommand &cmd);
+	void wakeUp();
 	bool isAlive();
+	bool isWorkerThread();
 
 protected:
 	long mStacksize;
 	const char *mThreadName;
 	virtual bool processLoop();
+	/* Time in microseconds the worker may sleep before processLoop() is needed again.
+	 * 0 means sleeping until a command is enqueued.
+	 */
+	virtual unsigned int getSleepTime();
 
 private:
 	static void *mediaLooper(void *);
@@ -29,7 +29,7 @@
 using namespace std;
 
 namespace media {
-PlayerWorker::PlayerWorker() : mCurPlayer(nullptr)
+PlayerWorker::PlayerWorker() : mCurPlayer(nullptr), mSleepTime(0)
 {
 	mThreadName = "PlayerWorker";
 	mStacksize = CONFIG_MEDIA_PLAYER_STACKSIZE;
@@ -47,12 +47,37 @@ PlayerWorker& PlayerWorker::getWorker()
 
 bool PlayerWorker::processLoop()
 {
+	mSleepTime = 0;
+#ifdef CONFIG_AUDIO_MIXER
+	// Every player playing is served, sleep until the earliest one needs it
+	bool busy = false;
+	for (auto &player : mPlayers) {
+		if (player->getState() != PLAYER_STATE_PLAYING) {
+			continue;
+		}
+		unsigned int sleepTime = player->playback();
+		if (sleepTime == 0) {
+			busy = true;
+		} else if (mSleepTime == 0 || sleepTime < mSleepTime) {
+			mSleepTime = sleepTime;
+		}
+	}
+
+	return busy;
+#else
 	if (mCurPlayer && (mCurPlayer->getState() == PLAYER_STATE_PLAYING)) {
-		mCurPlayer->playback();
-		return true;
+		// Nonzero sleep time means neither output space nor input data is ready
+		mSleepTime = mCurPlayer->playback();
+		return (mSleepTime == 0);
 	}
 
 	return false;
+#endif
+}
+
+unsigned int PlayerWorker::getSleepTime()
+{
+	return mSleepTime;
 }
 
 void PlayerWorker::setPlayer(std::shared_ptr<MediaPlayerImpl> player)
@@ -65,4 +90,21 @@ std::shared_ptr<MediaPlayerImpl> PlayerWorker::getPlayer()
 	return mCurPlayer;
 }
 
+#ifdef CONFIG_AUDIO_MIXER
+void PlayerWorker::addPlayer(std::shared_ptr<MediaPlayerImpl> player)
+{
+	for (auto &p : mPlayers) {
+		if (p == player) {
+			return;
+		}
+	}
+	mPlayers.push_back(player);
+}
+
+void PlayerWorker::removePlayer(std::shared_ptr<MediaPlayerImpl> player)
+{
+	mPlayers.remove(player);
+}
+#endif
+
 } // namespace media
@@ -19,6 +19,8 @@
 #ifndef __MEDIA_PLAYERWORKER_HPP
 #define __MEDIA_PLAYERWORKER_HPP
 
+#include <tinyara/config.h>
+#include <list>
 #include <memory>
 #include <media/MediaPlayer.h>
 #include "MediaWorker.h"
@@ -31,14 +33,23 @@ public:
 
 	void setPlayer(std::shared_ptr<MediaPlayerImpl>);
 	std::shared_ptr<MediaPlayerImpl> getPlayer();
+#ifdef CONFIG_AUDIO_MIXER
+	void addPlayer(std::shared_ptr<MediaPlayerImpl>);
+	void removePlayer(std::shared_ptr<MediaPlayerImpl>);
+#endif
 
 private:
 	PlayerWorker();
 	virtual ~PlayerWorker();
 	bool processLoop() override;
+	unsigned int getSleepTime() override;
 
 private:
 	std::shared_ptr<MediaPlayerImpl> mCurPlayer;
+#ifdef CONFIG_AUDIO_MIXER
+	std::list<std::shared_ptr<MediaPlayerImpl>> mPlayers;
+#endif
+	unsigned int mSleepTime;
 };
 } // namespace media
 #endif
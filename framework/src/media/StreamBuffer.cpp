@@ -18,6 +18,7 @@
 
 #include <tinyara/config.h>
 #include <iostream>
+#include <algorithm>
 #include <cstring>
 #include <stdio.h>
 #include <stdarg.h>
@@ -47,7 +48,7 @@ namespace media {
 namespace stream {
 
 StreamBuffer::StreamBuffer(size_t bufferSize, size_t threshold)
-	: mObserver(nullptr), mRingBuf(nullptr), mEOS(false), mBufferSize(bufferSize), mThreshold(threshold)
+	: mObserver(nullptr), mRingBuf(nullptr), mEOS(false), mReaders(0), mWriters(0), mDataWanted(0), mSpaceWanted(0), mBufferSize(bufferSize), mThreshold(threshold)
 {
 }
 
@@ -92,6 +93,30 @@ size_t StreamBuffer::write(unsigned char *buf, size_t size)
 	return rb_write(mRingBuf, buf, size);
 }
 
+size_t StreamBuffer::acquireRead(size_t size, struct rb_span_s *span)
+{
+	assert(mRingBuf);
+	return rb_acquire_read(mRingBuf, size, span);
+}
+
+size_t StreamBuffer::commitRead(size_t size)
+{
+	assert(mRingBuf);
+	return rb_commit_read(mRingBuf, size);
+}
+
+size_t StreamBuffer::acquireWrite(size_t size, struct rb_span_s *span)
+{
+	assert(mRingBuf);
+	return rb_acquire_write(mRingBuf, size, span);
+}
+
+size_t StreamBuffer::commitWrite(size_t size)
+{
+	assert(mRingBuf);
+	return rb_commit_write(mRingBuf, size);
+}
+
 size_t StreamBuffer::sizeOfSpace()
 {
 	assert(mRingBuf);
@@ -114,6 +139,109 @@ bool StreamBuffer::isEndOfStream()
 	return mEOS;
 }
 
+void StreamBuffer::attachReader()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mReaders++;
+	// Waiters recheck the mode, locked waits aren't signalled by wake*().
+	mCondv.notify_all();
+}
+
+void StreamBuffer::detachReader()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mReaders--;
+	mCondv.notify_all();
+}
+
+void StreamBuffer::attachWriter()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mWriters++;
+	mCondv.notify_all();
+}
+
+void StreamBuffer::detachWriter()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mWriters--;
+	mCondv.notify_all();
+}
+
+void StreamBuffer::waitForData(size_t size)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	waitForData(lock, size);
+}
+
+void StreamBuffer::waitForData(std::unique_lock<std::mutex> &lock, size_t size)
+{
+	if (size > mBufferSize) {
+		size = mBufferSize;
+	}
+
+	while (!mEOS) {
+		mDataWanted = size;
+		// Pairs with the fence in wakeReader(): either writer sees mDataWanted, or we see its data.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sizeOfData() >= size) {
+			break;
+		}
+		if (mSpaceWanted > 0) {
+			// Writer waits for less space now, see waitForSpace().
+			mCondv.notify_all();
+		}
+		mCondv.wait(lock);
+	}
+	mDataWanted = 0;
+}
+
+void StreamBuffer::waitForSpace(size_t size)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	waitForSpace(lock, size);
+}
+
+void StreamBuffer::waitForSpace(std::unique_lock<std::mutex> &lock, size_t size)
+{
+	if (size > mBufferSize) {
+		size = mBufferSize;
+	}
+
+	while (!mEOS) {
+		mSpaceWanted = size;
+		// Pairs with the fence in wakeWriter(): either reader sees mSpaceWanted, or we see its space.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		// Reader may wait for more data than the space wanted leaves in buffer, then any space is written.
+		size_t wanted = std::max(std::min(size, mBufferSize - std::min(mDataWanted.load(), mBufferSize)), (size_t)1);
+		if (sizeOfSpace() >= wanted) {
+			break;
+		}
+		mCondv.wait(lock);
+	}
+	mSpaceWanted = 0;
+}
+
+void StreamBuffer::wakeReader()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	size_t wanted = mDataWanted;
+	if (wanted > 0 && sizeOfData() >= wanted) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCondv.notify_all();
+	}
+}
+
+void StreamBuffer::wakeWriter()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	size_t wanted = mSpaceWanted;
+	if (wanted > 0 && sizeOfSpace() >= wanted) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCondv.notify_all();
+	}
+}
+
 void StreamBuffer::setObserver(BufferObserverInterface *observer)
 {
 	mObserver = observer;
@@ -183,7 +311,7 @@ std::shared_ptr<StreamBuffer> StreamBuffer::Builder::build()
 		return instance;
 	}
 
-	meddbg("init failed! mBufferSize %u, mThreshold:%u\n", mBufferSize, mThreshold);
+	meddbg("init failed! mBufferSize %zu, mThreshold:%zu\n", mBufferSize, mThreshold);
 	return nullptr;
 }
 
@@ -20,10 +20,12 @@
 #define __MEDIA_STREAMBUFFER_H
 
 #include <memory>
+#include <atomic>
 #include <mutex>
 #include <condition_variable>
 
 struct rb_s;
+struct rb_span_s;
 
 namespace media {
 namespace stream {
@@ -65,6 +67,10 @@ public:
 	void notifyObserver(State st, ...);
 	size_t read(unsigned char *buf, size_t size);
 	size_t write(unsigned char *buf, size_t size);
+	size_t acquireRead(size_t size, struct rb_span_s *span);
+	size_t commitRead(size_t size);
+	size_t acquireWrite(size_t size, struct rb_span_s *span);
+	size_t commitWrite(size_t size);
 	size_t sizeOfData();
 	size_t sizeOfSpace();
 	void setEndOfStream();
@@ -72,12 +78,32 @@ public:
 	size_t getBufferSize() { return mBufferSize; }
 	size_t getThreshold() { return mThreshold; }
 
+	/* Exactly one reader and one writer attached: ring is accessed without mMutex,
+	 * which only guards waiting. Waiters are signalled in batches by wake*().
+	 */
+	void attachReader();
+	void detachReader();
+	void attachWriter();
+	void detachWriter();
+	bool isLockFree() { return mReaders == 1 && mWriters == 1; }
+	void waitForData(size_t size);
+	void waitForSpace(size_t size);
+	/* Same as above with mMutex held, also used by locked mode so that it's woken up after switching. */
+	void waitForData(std::unique_lock<std::mutex> &lock, size_t size);
+	void waitForSpace(std::unique_lock<std::mutex> &lock, size_t size);
+	void wakeReader();
+	void wakeWriter();
+
 private:
 	std::mutex mMutex;
 	std::condition_variable mCondv;
 	BufferObserverInterface *mObserver;
 	struct rb_s *mRingBuf;
-	bool mEOS;
+	std::atomic<bool> mEOS;
+	std::atomic<int> mReaders;
+	std::atomic<int> mWriters;
+	std::atomic<size_t> mDataWanted;
+	std::atomic<size_t> mSpaceWanted;
 	size_t mBufferSize;
 	size_t mThreshold;
 };
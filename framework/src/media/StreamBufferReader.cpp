@@ -17,12 +17,14 @@
  ******************************************************************/
 
 #include <iostream>
+#include <algorithm>
 #include <stdio.h>
 #include <assert.h>
 #include <debug.h>
 
 #include "StreamBuffer.h"
 #include "StreamBufferReader.h"
+#include "utils/rb.h"
 
 namespace media {
 namespace stream {
@@ -31,11 +33,21 @@ StreamBufferReader::StreamBufferReader(std::shared_ptr<StreamBuffer> stream)
 	: mStream(stream)
 {
 	assert(mStream);
+	mStream->attachReader();
+}
+
+StreamBufferReader::~StreamBufferReader()
+{
+	mStream->detachReader();
 }
 
 size_t StreamBufferReader::read(unsigned char *buf, size_t size, bool sync)
 {
 	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	if (mStream->isLockFree()) {
+		return readLockFree(buf, size, sync);
+	}
+
 	std::unique_lock<std::mutex> lock(mStream->getMutex());
 
 	size_t rlen = 0;
@@ -60,7 +72,7 @@ size_t StreamBufferReader::read(unsigned char *buf, size_t size, bool sync)
 				// Writer may be waiting for more spaces, so it's necessary to notify after reading.
 				mStream->getCondv().notify_one();
 				// Then wait notification from writer.
-				mStream->getCondv().wait(lock);
+				mStream->waitForData(lock, 1);
 			}
 		}
 
@@ -77,6 +89,129 @@ size_t StreamBufferReader::read(unsigned char *buf, size_t size, bool sync)
 	return rlen;
 }
 
+size_t StreamBufferReader::acquire(struct rb_span_s *span, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	if (mStream->isLockFree()) {
+		return acquireLockFree(span, size, sync);
+	}
+
+	std::unique_lock<std::mutex> lock(mStream->getMutex());
+
+	if (size > mStream->getBufferSize()) {
+		size = mStream->getBufferSize();
+	}
+
+	if (sync) {
+		while (mStream->sizeOfData() < size) {
+			// There's not enough data
+			if (mStream->isEndOfStream()) {
+				// End of stream, acquire data remained
+				medvdbg("EOS break\n");
+				break;
+			}
+
+			// Notify observer, shouldn't be blocked.
+			mStream->notifyObserver(StreamBuffer::State::UNDERRUN);
+			// Writer may be waiting for more spaces.
+			mStream->getCondv().notify_one();
+			// Then wait notification from writer.
+			mStream->waitForData(lock, size);
+		}
+	}
+
+	// Data in regions acquired won't be overwritten by writer until commit().
+	size_t rlen = mStream->acquireRead(size, span);
+
+	medvdbg("acquired %lu\n", rlen);
+	return rlen;
+}
+
+size_t StreamBufferReader::commit(size_t size)
+{
+	size_t rlen;
+
+	if (mStream->isLockFree()) {
+		rlen = mStream->commitRead(size);
+		mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) rlen));
+		// Writer is signalled only if it can write enough data now.
+		mStream->wakeWriter();
+	} else {
+		std::lock_guard<std::mutex> lock(mStream->getMutex());
+
+		rlen = mStream->commitRead(size);
+		mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) rlen));
+
+		// Writer may be waiting for more spaces, so it's necessary to notify after reading.
+		mStream->getCondv().notify_one();
+	}
+
+	medvdbg("read %lu\n", rlen);
+	return rlen;
+}
+
+size_t StreamBufferReader::readLockFree(unsigned char *buf, size_t size, bool sync)
+{
+	size_t rlen = 0;
+
+	while (true) {
+		// Check EOS before reading, data written before EOS must not be missed.
+		bool eos = mStream->isEndOfStream();
+
+		// Read data from stream as much as possible
+		size_t temp = mStream->read(buf + rlen, size - rlen);
+		rlen += temp;
+		if (temp > 0) {
+			mStream->notifyObserver(StreamBuffer::State::UPDATED, -((ssize_t) temp));
+			// Writer is signalled only if it can write enough data now.
+			mStream->wakeWriter();
+		}
+
+		if (!sync || rlen == size) {
+			break;
+		}
+
+		if (eos) {
+			// End of stream, break reading
+			medvdbg("EOS break\n");
+			break;
+		}
+
+		medvdbg("read %lu/%lu\n", rlen, size);
+		// Notify observer, shouldn't be blocked.
+		mStream->notifyObserver(StreamBuffer::State::UNDERRUN);
+		// Wait until data reaches the threshold, instead of waking up on every write.
+		mStream->waitForData(std::min(size - rlen, mStream->getThreshold()));
+	}
+
+	medvdbg("read %lu\n", rlen);
+	return rlen;
+}
+
+size_t StreamBufferReader::acquireLockFree(struct rb_span_s *span, size_t size, bool sync)
+{
+	if (size > mStream->getBufferSize()) {
+		size = mStream->getBufferSize();
+	}
+
+	while (sync) {
+		bool eos = mStream->isEndOfStream();
+		if (mStream->sizeOfData() >= size || eos) {
+			break;
+		}
+
+		// Notify observer, shouldn't be blocked.
+		mStream->notifyObserver(StreamBuffer::State::UNDERRUN);
+		// Then wait until writer fills enough data.
+		mStream->waitForData(size);
+	}
+
+	size_t rlen = mStream->acquireRead(size, span);
+
+	medvdbg("acquired %lu\n", rlen);
+	return rlen;
+}
+
 size_t StreamBufferReader::sizeOfData()
 {
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
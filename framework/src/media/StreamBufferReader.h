@@ -22,6 +22,8 @@
 #include <memory>
 #include <media/BufferReaderInterface.h>
 
+struct rb_span_s;
+
 namespace media {
 namespace stream {
 class StreamBuffer;
@@ -32,6 +34,7 @@ class StreamBufferReader
 public:
 	StreamBufferReader() = delete;
 	StreamBufferReader(std::shared_ptr<StreamBuffer> stream);
+	virtual ~StreamBufferReader();
 
 public:
 	virtual size_t read(unsigned char *buf, size_t size, bool sync = true) override;
@@ -39,8 +42,13 @@ public:
 
 public:
 	bool isEndOfStream();
+	size_t acquire(struct rb_span_s *span, size_t size, bool sync = true);
+	size_t commit(size_t size);
 
 private:
+	size_t readLockFree(unsigned char *buf, size_t size, bool sync);
+	size_t acquireLockFree(struct rb_span_s *span, size_t size, bool sync);
+
 	std::shared_ptr<StreamBuffer> mStream;
 };
 
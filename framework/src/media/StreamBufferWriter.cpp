@@ -17,12 +17,14 @@
  ******************************************************************/
 
 #include <iostream>
+#include <algorithm>
 #include <stdio.h>
 #include <assert.h>
 #include <debug.h>
 
 #include "StreamBuffer.h"
 #include "StreamBufferWriter.h"
+#include "utils/rb.h"
 
 namespace media {
 namespace stream {
@@ -31,11 +33,21 @@ StreamBufferWriter::StreamBufferWriter(std::shared_ptr<StreamBuffer> stream)
 	: mStream(stream)
 {
 	assert(mStream);
+	mStream->attachWriter();
+}
+
+StreamBufferWriter::~StreamBufferWriter()
+{
+	mStream->detachWriter();
 }
 
 size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
 {
 	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	if (mStream->isLockFree()) {
+		return writeLockFree(buf, size, sync);
+	}
+
 	std::unique_lock<std::mutex> lock(mStream->getMutex());
 
 	size_t wlen = 0;
@@ -61,7 +73,7 @@ size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
 				// Reader may be waiting for more data, so it's necessary to notify after writing.
 				mStream->getCondv().notify_one();
 				// Then wait notification from reader.
-				mStream->getCondv().wait(lock);
+				mStream->waitForSpace(lock, 1);
 			}
 		}
 	} else {
@@ -76,6 +88,125 @@ size_t StreamBufferWriter::write(unsigned char *buf, size_t size, bool sync)
 	return wlen;
 }
 
+size_t StreamBufferWriter::acquire(struct rb_span_s *span, size_t size, bool sync)
+{
+	medvdbg("size %lu sync %c\n", size, sync ? 'Y' : 'N');
+	if (mStream->isLockFree()) {
+		return acquireLockFree(span, size, sync);
+	}
+
+	std::unique_lock<std::mutex> lock(mStream->getMutex());
+
+	if (sync) {
+		// Wait for any space only, reader may be waiting for more data than we can write in one go.
+		while (mStream->sizeOfSpace() == 0) {
+			// Streaming may be stopped (EOS was set)
+			if (mStream->isEndOfStream()) {
+				// Don't need to write anymore
+				medvdbg("EOS break\n");
+				return 0;
+			}
+
+			// There's not enough space
+			// Notify observer, shouldn't be blocked.
+			mStream->notifyObserver(StreamBuffer::State::OVERRUN);
+			// Reader may be waiting for more data.
+			mStream->getCondv().notify_one();
+			// Then wait notification from reader.
+			mStream->waitForSpace(lock, 1);
+		}
+	}
+
+	// Regions acquired are invisible to reader until commit().
+	size_t wlen = mStream->acquireWrite(size, span);
+
+	medvdbg("acquired %lu\n", wlen);
+	return wlen;
+}
+
+size_t StreamBufferWriter::commit(size_t size)
+{
+	size_t wlen;
+
+	if (mStream->isLockFree()) {
+		wlen = mStream->commitWrite(size);
+		mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) wlen);
+		// Reader is signalled only if it can read enough data now.
+		mStream->wakeReader();
+	} else {
+		std::lock_guard<std::mutex> lock(mStream->getMutex());
+
+		wlen = mStream->commitWrite(size);
+		mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) wlen);
+
+		// Reader may be waiting for more data, so it's necessary to notify after writing.
+		mStream->getCondv().notify_one();
+	}
+
+	medvdbg("written %lu\n", wlen);
+	return wlen;
+}
+
+size_t StreamBufferWriter::writeLockFree(unsigned char *buf, size_t size, bool sync)
+{
+	size_t wlen = 0;
+	// Writer is woken up once data falls to the threshold, i.e. this much space is available.
+	size_t batch = std::max(mStream->getBufferSize() - mStream->getThreshold(), (size_t)1);
+
+	while (true) {
+		// Streaming may be stopped (EOS was set)
+		if (mStream->isEndOfStream()) {
+			// Don't need to write anymore
+			medvdbg("EOS break\n");
+			break;
+		}
+
+		// Write data into stream as much as possible
+		size_t temp = mStream->write(buf + wlen, size - wlen);
+		wlen += temp;
+		if (temp > 0) {
+			mStream->notifyObserver(StreamBuffer::State::UPDATED, (ssize_t) temp);
+			// Reader is signalled only if it can read enough data now.
+			mStream->wakeReader();
+		}
+
+		if (!sync || wlen == size) {
+			break;
+		}
+
+		medvdbg("written %lu/%lu\n", wlen, size);
+		// There's not enough space
+		// Notify observer, shouldn't be blocked.
+		mStream->notifyObserver(StreamBuffer::State::OVERRUN);
+		// Then wait until reader frees enough space.
+		mStream->waitForSpace(std::min(size - wlen, batch));
+	}
+
+	medvdbg("written %lu\n", wlen);
+	return wlen;
+}
+
+size_t StreamBufferWriter::acquireLockFree(struct rb_span_s *span, size_t size, bool sync)
+{
+	while (sync && mStream->sizeOfSpace() == 0) {
+		if (mStream->isEndOfStream()) {
+			// Don't need to write anymore
+			medvdbg("EOS break\n");
+			return 0;
+		}
+
+		// Notify observer, shouldn't be blocked.
+		mStream->notifyObserver(StreamBuffer::State::OVERRUN);
+		// Then wait until reader frees any space.
+		mStream->waitForSpace(1);
+	}
+
+	size_t wlen = mStream->acquireWrite(size, span);
+
+	medvdbg("acquired %lu\n", wlen);
+	return wlen;
+}
+
 size_t StreamBufferWriter::sizeOfSpace()
 {
 	std::lock_guard<std::mutex> lock(mStream->getMutex());
@@ -89,8 +220,8 @@ void StreamBufferWriter::setEndOfStream()
 	// Set EOS flag in stream.
 	mStream->setEndOfStream();
 
-	// Reader may be waiting for more data, so it's necessary to notify.
-	mStream->getCondv().notify_one();
+	// Reader (and writer in lock-free mode) may be waiting, so it's necessary to notify.
+	mStream->getCondv().notify_all();
 }
 
 } // namespace stream
@@ -22,6 +22,8 @@
 #include <memory>
 #include <media/BufferWriterInterface.h>
 
+struct rb_span_s;
+
 namespace media {
 namespace stream {
 class StreamBuffer;
@@ -32,6 +34,7 @@ class StreamBufferWriter
 public:
 	StreamBufferWriter() = delete;
 	StreamBufferWriter(std::shared_ptr<StreamBuffer> stream);
+	virtual ~StreamBufferWriter();
 
 public:
 	virtual size_t write(unsigned char *buf, size_t size, bool sync = true) override;
@@ -39,8 +42,13 @@ public:
 
 public:
 	void setEndOfStream();
+	size_t acquire(struct rb_span_s *span, size_t size, bool sync = true);
+	size_t commit(size_t size);
 
 private:
+	size_t writeLockFree(unsigned char *buf, size_t size, bool sync);
+	size_t acquireLockFree(struct rb_span_s *span, size_t size, bool sync);
+
 	std::shared_ptr<StreamBuffer> mStream;
 };
 
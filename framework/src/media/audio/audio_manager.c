@@ -31,6 +31,9 @@
 
 #include "audio_manager.h"
 #include "resample/samplerate.h"
+#ifdef CONFIG_AUDIO_MIXER
+#include "audio_mixer.h"
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -65,6 +68,36 @@
 #define CONFIG_AUDIO_RESAMPLER_BUFSIZE 4096
 #endif
 
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+#define AUDIO_RESAMPLER_TYPE SRC_TYPE_POLYPHASE
+#else
+#define AUDIO_RESAMPLER_TYPE SRC_TYPE_LINEAR
+#endif
+
+#ifdef CONFIG_AUDIO_MIXER
+#ifndef CONFIG_AUDIO_MIXER_SAMPLE_RATE
+#define CONFIG_AUDIO_MIXER_SAMPLE_RATE 48000
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_CHANNELS
+#define CONFIG_AUDIO_MIXER_CHANNELS 2
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_MAX_STREAMS
+#define CONFIG_AUDIO_MIXER_MAX_STREAMS 4
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_STREAM_FRAMES
+#define CONFIG_AUDIO_MIXER_STREAM_FRAMES 4096
+#endif
+
+#ifndef CONFIG_AUDIO_MIXER_DUCK_PERCENT
+#define CONFIG_AUDIO_MIXER_DUCK_PERCENT 25
+#endif
+
+#define AUDIO_MIXER_DUCK_GAIN (CONFIG_AUDIO_MIXER_DUCK_PERCENT * AUDIO_MIXER_GAIN_UNITY / 100)
+#endif
+
 #define INVALID_ID -1
 
 /****************************************************************************
@@ -133,6 +166,14 @@ static audio_card_info_t g_audio_out_cards[CONFIG_AUDIO_MAX_OUTPUT_CARD_NUM];
 static int g_actual_audio_in_card_id = INVALID_ID;
 static int g_actual_audio_out_card_id = INVALID_ID;
 
+#ifdef CONFIG_AUDIO_MIXER
+/* Mixer owns the active output card while any stream is open */
+static audio_mixer_t *g_audio_mixer;
+static int16_t *g_audio_mixer_buffer;
+static int g_audio_mixer_stream_num;
+static uint8_t g_audio_mixer_volume[CONFIG_AUDIO_MIXER_MAX_STREAMS];
+#endif
+
 static const struct audio_samprate_map_entry_s g_audio_samprate_entry[] = {
 	{AUDIO_SAMP_RATE_TYPE_8K, AUDIO_SAMP_RATE_8K},
 	{AUDIO_SAMP_RATE_TYPE_11K, AUDIO_SAMP_RATE_11K},
@@ -155,6 +196,7 @@ static audio_manager_result_t get_supported_sample_rate(int fd, uint8_t *sample_
 static uint32_t get_closest_samprate(unsigned origin_samprate, audio_card_type_t type);
 static unsigned int resample_stream_in(audio_card_info_t *cur_card, void *data, unsigned int frames);
 static unsigned int resample_stream_out(audio_card_info_t *cur_card, void *data, unsigned int frames);
+static int write_audio_card_frames(audio_card_info_t *cur_card, void *data, unsigned int frames);
 static audio_manager_result_t get_audio_volume(int fd, audio_config_t *config, audio_card_type_t card_type);
 static audio_manager_result_t set_audio_volume(audio_card_type_t type, uint8_t volume);
 
@@ -367,7 +409,7 @@ static unsigned int resample_stream_in(audio_card_info_t *cur_card, void *data,
 	unsigned int resampled_frames = 0;
 	src_data_t srcData = { 0, };
 
-	srcData.channels_num = 2;
+	srcData.channels_num = pcm_get_channels(cur_card->pcm);
 	srcData.origin_sample_rate = cur_card->resample.from;
 	srcData.origin_sample_width = SAMPLE_WIDTH_16BITS;
 	srcData.desired_sample_rate = cur_card->resample.to;
@@ -386,7 +428,7 @@ static unsigned int resample_stream_in(audio_card_info_t *cur_card, void *data,
 			return AUDIO_MANAGER_RESAMPLE_FAIL;
 		}
 
-		if (srcData.output_frames_gen > 0) {
+		if (srcData.output_frames_gen > 0 || srcData.input_frames_used > 0) {
 			resampled_frames += srcData.output_frames_gen;
 			used_frames += srcData.input_frames_used;
 			medvdbg("Record resampled in:%d/%d, out:%d\n", used_frames, frames, resampled_frames);
@@ -405,7 +447,7 @@ static unsigned int resample_stream_out(audio_card_info_t *cur_card, void *data,
 	unsigned int resampled_frames = 0;
 	src_data_t srcData = { 0, };
 
-	srcData.channels_num = 2;
+	srcData.channels_num = pcm_get_channels(cur_card->pcm);
 	srcData.origin_sample_rate = cur_card->resample.from;
 	srcData.origin_sample_width = SAMPLE_WIDTH_16BITS;
 	srcData.desired_sample_rate = cur_card->resample.to;
@@ -425,7 +467,7 @@ static unsigned int resample_stream_out(audio_card_info_t *cur_card, void *data,
 			return AUDIO_MANAGER_RESAMPLE_FAIL;
 		}
 
-		if (srcData.output_frames_gen > 0) {
+		if (srcData.output_frames_gen > 0 || srcData.input_frames_used > 0) {
 			resampled_frames += srcData.output_frames_gen;
 			used_frames += srcData.input_frames_used;
 		} else {
@@ -439,6 +481,38 @@ static unsigned int resample_stream_out(audio_card_info_t *cur_card, void *data,
 	return resampled_frames;
 }
 
+static int write_audio_card_frames(audio_card_info_t *cur_card, void *data, unsigned int frames)
+{
+	int ret;
+	int prepare_retry = AUDIO_STREAM_RETRY_COUNT;
+
+	do {
+		ret = pcm_writei(cur_card->pcm, data, frames);
+		if (ret < 0) {
+			if (ret == -EPIPE) {
+				if (prepare_retry > 0) {
+					ret = pcm_prepare(cur_card->pcm);
+					if (ret != OK) {
+						meddbg("Fail to pcm_prepare()\n");
+						return AUDIO_MANAGER_XRUN_STATE;
+					}
+					prepare_retry--;
+				} else {
+					meddbg("prepare_retry = 0\n");
+					return AUDIO_MANAGER_XRUN_STATE;
+				}
+			} else if (ret == -EINVAL) {
+				meddbg("pcm_writei = -EINVAL\n");
+				return AUDIO_MANAGER_INVALID_PARAM;
+			} else {
+				return AUDIO_MANAGER_FAIL;
+			}
+		}
+	} while (ret == OK);
+
+	return ret;
+}
+
 static audio_manager_result_t get_audio_volume(int fd, audio_config_t *config, audio_card_type_t card_type)
 {
 	struct audio_caps_desc_s caps_desc;
@@ -581,7 +655,7 @@ audio_manager_result_t set_audio_stream_in(unsigned int channels, unsigned int s
 		g_audio_in_cards[g_actual_audio_in_card_id].resample.from = config.rate;
 		g_audio_in_cards[g_actual_audio_in_card_id].resample.to = sample_rate;
 		g_audio_in_cards[g_actual_audio_in_card_id].resample.ratio = (float)sample_rate / (float)config.rate;
-		g_audio_in_cards[g_actual_audio_in_card_id].resample.handle = src_init(CONFIG_AUDIO_RESAMPLER_BUFSIZE);
+		g_audio_in_cards[g_actual_audio_in_card_id].resample.handle = src_init_ex(CONFIG_AUDIO_RESAMPLER_BUFSIZE, AUDIO_RESAMPLER_TYPE);
 		g_audio_in_cards[g_actual_audio_in_card_id].resample.buffer = malloc((int)((float)get_input_frames_to_byte(get_input_frame_count()) / g_audio_in_cards[g_actual_audio_in_card_id].resample.ratio) + 1);	// +1 for floating point margin
 		if (!g_audio_in_cards[g_actual_audio_in_card_id].resample.buffer) {
 			meddbg("malloc for a resampling buffer(stream_in) is failed\n");
@@ -654,7 +728,7 @@ audio_manager_result_t set_audio_stream_out(unsigned int channels, unsigned int
 	g_audio_out_cards[g_actual_audio_out_card_id].status = AUDIO_CARD_READY;
 
 	if (g_audio_out_cards[g_actual_audio_out_card_id].resample.necessary) {
-		g_audio_out_cards[g_actual_audio_out_card_id].resample.handle = src_init(CONFIG_AUDIO_RESAMPLER_BUFSIZE);
+		g_audio_out_cards[g_actual_audio_out_card_id].resample.handle = src_init_ex(CONFIG_AUDIO_RESAMPLER_BUFSIZE, AUDIO_RESAMPLER_TYPE);
 		g_audio_out_cards[g_actual_audio_out_card_id].resample.buffer_size = (int)((float)get_output_frames_to_byte(get_output_frame_count()) * g_audio_out_cards[g_actual_audio_out_card_id].resample.ratio) + 1;	// +1 for floating point margin
 		g_audio_out_cards[g_actual_audio_out_card_id].resample.buffer = malloc(g_audio_out_cards[g_actual_audio_out_card_id].resample.buffer_size);
 		if (!g_audio_out_cards[g_actual_audio_out_card_id].resample.buffer) {
@@ -752,7 +826,6 @@ int start_audio_stream_out(void *data, unsigned int frames)
 {
 	int ret;
 	unsigned int resampled_frames = 0;
-	int prepare_retry = AUDIO_STREAM_RETRY_COUNT;
 	audio_card_info_t *cur_card;
 	medvdbg("start_audio_stream_out(%u)\n", frames);
 
@@ -781,39 +854,12 @@ int start_audio_stream_out(void *data, unsigned int frames)
 		resampled_frames = resample_stream_out(cur_card, data, frames);
 	}
 
-	do {
-		medvdbg("Start Playing!! Resample : %d\t", cur_card->resample.necessary);
-		if (cur_card->resample.necessary) {
-			ret = pcm_writei(cur_card->pcm, cur_card->resample.buffer, resampled_frames);
-		} else {
-			ret = pcm_writei(cur_card->pcm, data, frames);
-		}
-
-		if (ret < 0) {
-			if (ret == -EPIPE) {
-				if (prepare_retry > 0) {
-					ret = pcm_prepare(cur_card->pcm);
-					if (ret != OK) {
-						meddbg("Fail to pcm_prepare()\n");
-						ret = AUDIO_MANAGER_XRUN_STATE;
-						goto error_with_lock;
-					}
-					prepare_retry--;
-				} else {
-					meddbg("prepare_retry = 0\n");
-					ret = AUDIO_MANAGER_XRUN_STATE;
-					goto error_with_lock;
-				}
-			} else if (ret == -EINVAL) {
-				meddbg("pcm_writei = -EINVAL\n");
-				ret = AUDIO_MANAGER_INVALID_PARAM;
-				goto error_with_lock;
-			} else {
-				ret = AUDIO_MANAGER_FAIL;
-				goto error_with_lock;
-			}
-		}
-	} while (ret == OK);
+	medvdbg("Start Playing!! Resample : %d\t", cur_card->resample.necessary);
+	if (cur_card->resample.necessary) {
+		ret = write_audio_card_frames(cur_card, cur_card->resample.buffer, resampled_frames);
+	} else {
+		ret = write_audio_card_frames(cur_card, data, frames);
+	}
 
 error_with_lock:
 	pthread_mutex_unlock(&(cur_card->card_mutex));
@@ -1010,6 +1056,27 @@ unsigned int get_output_frame_count(void)
 	return pcm_get_buffer_size(g_audio_out_cards[g_actual_audio_out_card_id].pcm);
 }
 
+int get_output_avail_frames(void)
+{
+	int ret;
+
+	if (g_actual_audio_out_card_id < 0) {
+		meddbg("No output audio card is active.\n");
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	pthread_mutex_lock(&(g_audio_out_cards[g_actual_audio_out_card_id].card_mutex));
+	ret = pcm_avail_update(g_audio_out_cards[g_actual_audio_out_card_id].pcm);
+	pthread_mutex_unlock(&(g_audio_out_cards[g_actual_audio_out_card_id].card_mutex));
+
+	if (ret < 0) {
+		meddbg("pcm_avail_update failed, ret = %d\n", ret);
+		return AUDIO_MANAGER_FAIL;
+	}
+
+	return ret;
+}
+
 unsigned int get_output_frames_to_byte(unsigned int frames)
 {
 	if ((g_actual_audio_out_card_id < 0) || (frames == 0)) {
@@ -1101,3 +1168,312 @@ audio_manager_result_t set_output_audio_volume(uint8_t volume)
 {
 	return set_audio_volume(OUTPUT, volume);
 }
+
+#ifdef CONFIG_AUDIO_MIXER
+/* Write mixed frames to the card, called with card_mutex locked.
+ * If 'block' is false, only frames the card can take without blocking are written.
+ */
+static int mix_audio_stream_out(audio_card_info_t *cur_card, bool block)
+{
+	int ret;
+	int avail;
+	unsigned int frames;
+
+	while ((frames = audio_mixer_ready(g_audio_mixer)) > 0) {
+		if (!block) {
+			avail = pcm_avail_update(cur_card->pcm);
+			if (avail <= 0) {
+				break;
+			}
+			if (frames > (unsigned int)avail) {
+				frames = (unsigned int)avail;
+			}
+		}
+		if (frames > AUDIO_STREAM_VOIP_PERIOD_SIZE) {
+			frames = AUDIO_STREAM_VOIP_PERIOD_SIZE;
+		}
+
+		audio_mixer_mix(g_audio_mixer, g_audio_mixer_buffer, frames);
+		ret = write_audio_card_frames(cur_card, g_audio_mixer_buffer, frames);
+		if (ret < 0) {
+			return ret;
+		}
+		cur_card->status = AUDIO_CARD_RUNNING;
+	}
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+static void close_audio_mixer(audio_card_info_t *cur_card)
+{
+	audio_mixer_destroy(g_audio_mixer);
+	g_audio_mixer = NULL;
+	free(g_audio_mixer_buffer);
+	g_audio_mixer_buffer = NULL;
+
+	pcm_close(cur_card->pcm);
+	cur_card->pcm = NULL;
+	cur_card->status = AUDIO_CARD_IDLE;
+}
+
+static audio_manager_result_t open_audio_mixer(audio_card_info_t *cur_card, int format)
+{
+	struct pcm_config config;
+
+	memset(&config, 0, sizeof(struct pcm_config));
+	config.channels = CONFIG_AUDIO_MIXER_CHANNELS;
+	config.rate = get_closest_samprate(CONFIG_AUDIO_MIXER_SAMPLE_RATE, OUTPUT);
+	config.format = format;
+	config.period_size = AUDIO_STREAM_VOIP_PERIOD_SIZE;
+	config.period_count = AUDIO_STREAM_VOIP_PERIOD_COUNT;
+
+	medvdbg("[MIXER] Device samplerate: %u, channels: %u\n", config.rate, config.channels);
+	cur_card->resample.necessary = false;
+	cur_card->pcm = pcm_open(g_actual_audio_out_card_id, 0, PCM_OUT, &config);
+	if (!pcm_is_ready(cur_card->pcm)) {
+		meddbg("fail to pcm_is_ready() error : %s", pcm_get_error(cur_card->pcm));
+		pcm_close(cur_card->pcm);
+		cur_card->pcm = NULL;
+		return AUDIO_MANAGER_CARD_NOT_READY;
+	}
+	cur_card->status = AUDIO_CARD_READY;
+
+	g_audio_mixer = audio_mixer_create(config.rate, config.channels, CONFIG_AUDIO_MIXER_STREAM_FRAMES, AUDIO_RESAMPLER_TYPE);
+	g_audio_mixer_buffer = (int16_t *)malloc(get_output_frames_to_byte(AUDIO_STREAM_VOIP_PERIOD_SIZE));
+	if (!g_audio_mixer || !g_audio_mixer_buffer) {
+		meddbg("Fail to create the mixer\n");
+		close_audio_mixer(cur_card);
+		return AUDIO_MANAGER_FAIL;
+	}
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+static audio_card_info_t *lock_audio_mixer(int stream)
+{
+	audio_card_info_t *cur_card;
+
+	if (g_actual_audio_out_card_id < 0) {
+		meddbg("Found no active output audio card\n");
+		return NULL;
+	}
+
+	cur_card = &g_audio_out_cards[g_actual_audio_out_card_id];
+	pthread_mutex_lock(&(cur_card->card_mutex));
+
+	if (!g_audio_mixer || stream < 0 || stream >= CONFIG_AUDIO_MIXER_MAX_STREAMS) {
+		pthread_mutex_unlock(&(cur_card->card_mutex));
+		return NULL;
+	}
+
+	return cur_card;
+}
+
+int open_audio_mixer_stream(unsigned int channels, unsigned int sample_rate, int format)
+{
+	int stream;
+	audio_manager_result_t ret;
+	audio_card_info_t *cur_card;
+
+	if (g_actual_audio_out_card_id < 0) {
+		meddbg("Found no active output audio card\n");
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	if ((channels == 0) || (sample_rate == 0) || (format != PCM_FORMAT_S16_LE)) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	cur_card = &g_audio_out_cards[g_actual_audio_out_card_id];
+	pthread_mutex_lock(&(cur_card->card_mutex));
+
+	if (!g_audio_mixer) {
+		ret = open_audio_mixer(cur_card, format);
+		if (ret != AUDIO_MANAGER_SUCCESS) {
+			pthread_mutex_unlock(&(cur_card->card_mutex));
+			return ret;
+		}
+	}
+
+	stream = audio_mixer_open(g_audio_mixer, sample_rate, channels);
+	if (stream < 0) {
+		meddbg("Fail to open mixer stream, rate: %u, channels: %u\n", sample_rate, channels);
+		if (g_audio_mixer_stream_num == 0) {
+			close_audio_mixer(cur_card);
+		}
+		pthread_mutex_unlock(&(cur_card->card_mutex));
+		return AUDIO_MANAGER_RESAMPLE_FAIL;
+	}
+
+	g_audio_mixer_stream_num++;
+	g_audio_mixer_volume[stream] = AUDIO_DEVICE_MAX_VOLUME;
+	medvdbg("Mixer stream %d opened, rate: %u, channels: %u\n", stream, sample_rate, channels);
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return stream;
+}
+
+audio_manager_result_t close_audio_mixer_stream(int stream)
+{
+	audio_card_info_t *cur_card = lock_audio_mixer(stream);
+	if (!cur_card) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	audio_mixer_close(g_audio_mixer, stream);
+	if (--g_audio_mixer_stream_num == 0) {
+		close_audio_mixer(cur_card);
+	}
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+int write_audio_mixer_stream(int stream, void *data, unsigned int frames)
+{
+	int ret;
+	audio_card_info_t *cur_card = lock_audio_mixer(stream);
+	if (!cur_card) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	ret = audio_mixer_write(g_audio_mixer, stream, data, frames);
+	if (ret < 0) {
+		ret = AUDIO_MANAGER_RESAMPLE_FAIL;
+	} else {
+		int result = mix_audio_stream_out(cur_card, false);
+		if (result < 0) {
+			ret = result;
+		}
+	}
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return ret;
+}
+
+int get_audio_mixer_stream_avail(int stream)
+{
+	int ret;
+	audio_card_info_t *cur_card = lock_audio_mixer(stream);
+	if (!cur_card) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	ret = mix_audio_stream_out(cur_card, false);
+	if (ret == AUDIO_MANAGER_SUCCESS) {
+		ret = (int)audio_mixer_space(g_audio_mixer, stream);
+	}
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return ret;
+}
+
+unsigned int get_audio_mixer_stream_frame_count(int stream)
+{
+	unsigned int frames;
+	audio_card_info_t *cur_card = lock_audio_mixer(stream);
+	if (!cur_card) {
+		return 0;
+	}
+
+	frames = audio_mixer_capacity(g_audio_mixer, stream);
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return frames;
+}
+
+audio_manager_result_t pause_audio_mixer_stream(int stream)
+{
+	audio_card_info_t *cur_card = lock_audio_mixer(stream);
+	if (!cur_card) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	audio_mixer_pause(g_audio_mixer, stream, true);
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t drain_audio_mixer_stream(int stream)
+{
+	int ret = AUDIO_MANAGER_SUCCESS;
+	audio_card_info_t *cur_card = lock_audio_mixer(stream);
+	if (!cur_card) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	audio_mixer_pause(g_audio_mixer, stream, false);
+	audio_mixer_drain(g_audio_mixer, stream);
+	while (audio_mixer_queued(g_audio_mixer, stream) > 0) {
+		ret = mix_audio_stream_out(cur_card, true);
+		if (ret < 0) {
+			meddbg("Fail to drain mixer stream %d, ret = %d\n", stream, ret);
+			audio_mixer_flush(g_audio_mixer, stream);
+			break;
+		}
+	}
+	audio_mixer_pause(g_audio_mixer, stream, true);
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return (audio_manager_result_t)(ret < 0 ? ret : AUDIO_MANAGER_SUCCESS);
+}
+
+audio_manager_result_t get_audio_mixer_stream_volume(int stream, uint8_t *volume)
+{
+	audio_card_info_t *cur_card;
+
+	if (volume == NULL) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	cur_card = lock_audio_mixer(stream);
+	if (!cur_card) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	*volume = g_audio_mixer_volume[stream];
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t set_audio_mixer_stream_volume(int stream, uint8_t volume)
+{
+	audio_card_info_t *cur_card = lock_audio_mixer(stream);
+	if (!cur_card) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	if (volume > AUDIO_DEVICE_MAX_VOLUME) {
+		volume = AUDIO_DEVICE_MAX_VOLUME;
+	}
+
+	// Square law is closer to perceived loudness than linear gain
+	g_audio_mixer_volume[stream] = volume;
+	audio_mixer_set_gain(g_audio_mixer, stream, (uint32_t)volume * volume * AUDIO_MIXER_GAIN_UNITY / (AUDIO_DEVICE_MAX_VOLUME * AUDIO_DEVICE_MAX_VOLUME));
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t set_audio_mixer_ducking(bool duck)
+{
+	audio_card_info_t *cur_card;
+
+	if (g_actual_audio_out_card_id < 0) {
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	cur_card = &g_audio_out_cards[g_actual_audio_out_card_id];
+	pthread_mutex_lock(&(cur_card->card_mutex));
+
+	if (g_audio_mixer) {
+		medvdbg("Mixer ducking : %d\n", duck);
+		audio_mixer_set_ducking(g_audio_mixer, duck, AUDIO_MIXER_DUCK_GAIN);
+	}
+
+	pthread_mutex_unlock(&(cur_card->card_mutex));
+	return AUDIO_MANAGER_SUCCESS;
+}
+#endif
@@ -24,7 +24,9 @@
 #ifndef __AUDIO_MANAGER_H
 #define __AUDIO_MANAGER_H
 
+#include <tinyara/config.h>
 #include <sys/time.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -281,6 +283,18 @@ unsigned int get_input_bytes_to_frame(unsigned int bytes);
  ****************************************************************************/
 unsigned int get_output_frame_count(void);
 
+/****************************************************************************
+ * Name: get_output_avail_frames
+ *
+ * Description:
+ *   Get the number of frames which can be written to the active output audio
+ *   device without blocking.
+ *
+ * Return Value:
+ *   On success, the number of frames. Otherwise, a negative value.
+ ****************************************************************************/
+int get_output_avail_frames(void);
+
 /****************************************************************************
  * Name: get_output_frames_to_byte
  *
@@ -376,6 +390,144 @@ audio_manager_result_t set_input_audio_gain(uint8_t gain);
  ****************************************************************************/
 audio_manager_result_t set_output_audio_volume(uint8_t volume);
 
+#ifdef CONFIG_AUDIO_MIXER
+/****************************************************************************
+ * Name: open_audio_mixer_stream
+ *
+ * Description:
+ *   Open a stream of the software mixer. The active output card is opened in
+ *   the mixer format with the first stream, and closed with the last one.
+ *   Streams in any sample rate and channels are converted and mixed together.
+ *   The stream is paused until data is written.
+ *
+ * Input parameters:
+ *   channels: number of channels
+ *   sample_rate: sample rate of the stream
+ *   format: pcm format, only PCM_FORMAT_S16_LE is supported
+ *
+ * Return Value:
+ *   On success, id of the stream. Otherwise, a negative value.
+ ****************************************************************************/
+int open_audio_mixer_stream(unsigned int channels, unsigned int sample_rate, int format);
+
+/****************************************************************************
+ * Name: close_audio_mixer_stream
+ *
+ * Description:
+ *   Close the mixer stream, data not mixed yet is dropped.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t close_audio_mixer_stream(int stream);
+
+/****************************************************************************
+ * Name: write_audio_mixer_stream
+ *
+ * Description:
+ *   Queue frames to the mixer stream and resume it if it's paused, then write
+ *   frames mixed to the output card as far as it doesn't block.
+ *
+ * Input parameters:
+ *   stream: id of the stream
+ *   data: buffer to transfer the frame data in the stream format
+ *   frames: number of frames to be written
+ *
+ * Return Value:
+ *   On success, the number of frames consumed, it can be less than 'frames'
+ *   when the stream queue is full. Otherwise, a negative value.
+ ****************************************************************************/
+int write_audio_mixer_stream(int stream, void *data, unsigned int frames);
+
+/****************************************************************************
+ * Name: get_audio_mixer_stream_avail
+ *
+ * Description:
+ *   Write frames mixed to the output card as far as it doesn't block, then get
+ *   the number of frames which can be written to the mixer stream.
+ *
+ * Return Value:
+ *   On success, the number of frames in the stream format. Otherwise, a negative value.
+ ****************************************************************************/
+int get_audio_mixer_stream_avail(int stream);
+
+/****************************************************************************
+ * Name: get_audio_mixer_stream_frame_count
+ *
+ * Description:
+ *   Get the number of frames in the stream format the mixer stream can queue.
+ *
+ * Return Value:
+ *   On success, the number of frames. Otherwise, 0.
+ ****************************************************************************/
+unsigned int get_audio_mixer_stream_frame_count(int stream);
+
+/****************************************************************************
+ * Name: pause_audio_mixer_stream
+ *
+ * Description:
+ *   Leave the mixer stream out of mixing, data queued is kept.
+ *   Writing to the stream resumes it.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t pause_audio_mixer_stream(int stream);
+
+/****************************************************************************
+ * Name: drain_audio_mixer_stream
+ *
+ * Description:
+ *   Mix and write all data queued in the mixer stream, other streams are
+ *   padded with silence if they run short. The stream is paused then.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t drain_audio_mixer_stream(int stream);
+
+/****************************************************************************
+ * Name: get_audio_mixer_stream_volume
+ *
+ * Input parameter:
+ *   stream: id of the stream
+ *   volume: the pointer to get the current volume value of the stream
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t get_audio_mixer_stream_volume(int stream, uint8_t *volume);
+
+/****************************************************************************
+ * Name: set_audio_mixer_stream_volume
+ *
+ * Description:
+ *   Adjust the gain applied to the mixer stream. Gain is ramped in the next
+ *   mixing to avoid clicks.
+ *
+ * Input parameter:
+ *   stream: id of the stream
+ *   volume: volume value to set, Min = 0, Max = get_max_audio_volume()
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t set_audio_mixer_stream_volume(int stream, uint8_t volume);
+
+/****************************************************************************
+ * Name: set_audio_mixer_ducking
+ *
+ * Description:
+ *   Start or stop ducking. Streams open when ducking starts are attenuated
+ *   by CONFIG_AUDIO_MIXER_DUCK_PERCENT until it stops, streams opened later
+ *   (e.g. a notification sound) play at their own volume.
+ *
+ * Return Value:
+ *   On success, AUDIO_MANAGER_SUCCESS. Otherwise, a negative value.
+ ****************************************************************************/
+audio_manager_result_t set_audio_mixer_ducking(bool duck);
+#endif
+
 #if defined(__cplusplus)
 }								/* extern "C" */
 #endif
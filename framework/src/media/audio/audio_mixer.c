@@ -0,0 +1,563 @@
+/******************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <debug.h>
+
+#include "audio_mixer.h"
+#include "../utils/rb.h"
+#include "../utils/internal_defs.h"
+
+#ifndef CONFIG_AUDIO_MIXER_MAX_STREAMS
+#define CONFIG_AUDIO_MIXER_MAX_STREAMS 4
+#endif
+
+#ifndef CONFIG_AUDIO_RESAMPLER_BUFSIZE
+#define CONFIG_AUDIO_RESAMPLER_BUFSIZE 4096
+#endif
+
+/* Frames converted or mixed at once, also the length of gain ramps */
+#define AUDIO_MIXER_CHUNK_FRAMES 256
+#define AUDIO_MIXER_MAX_CHANNELS 8
+#define AUDIO_MIXER_LINEAR_MAX_CHANNELS 2
+
+#define AUDIO_MIXER_FRAME_BYTES(ch) ((ch) * sizeof(int16_t))
+
+struct audio_mixer_stream_s {
+	bool used;
+	bool paused;
+	bool draining;
+	bool ducked;
+	unsigned int rate;
+	unsigned int channels;
+	src_handle_t src;           /* NULL if no resampling needed            */
+	rb_t queue;                 /* frames in mixer format                  */
+	uint32_t gain;              /* gain desired, Q15                       */
+	uint32_t cur_gain;          /* gain applied at end of last mixing, Q15 */
+	unsigned int underruns;
+};
+
+struct audio_mixer_s {
+	unsigned int rate;
+	unsigned int channels;
+	unsigned int frames;        /* queue depth of each stream in frames    */
+	src_type_t type;
+	bool ducking;
+	uint32_t duck_gain;
+	int32_t *acc;               /* accumulator of a chunk                  */
+	int16_t *scratch;           /* resampler output of a chunk             */
+	struct audio_mixer_stream_s streams[CONFIG_AUDIO_MIXER_MAX_STREAMS];
+};
+
+static inline int16_t mix_clip(int32_t x)
+{
+	if (x > INT16_MAX) {
+		return INT16_MAX;
+	}
+	if (x < INT16_MIN) {
+		return INT16_MIN;
+	}
+	return (int16_t)x;
+}
+
+static struct audio_mixer_stream_s *get_stream(audio_mixer_t *mixer, int stream)
+{
+	RETURN_VAL_IF_FAIL(mixer != NULL, NULL);
+	RETURN_VAL_IF_FAIL((stream >= 0 && stream < CONFIG_AUDIO_MIXER_MAX_STREAMS), NULL);
+	RETURN_VAL_IF_FAIL(mixer->streams[stream].used, NULL);
+	return &mixer->streams[stream];
+}
+
+static uint32_t target_gain(audio_mixer_t *mixer, struct audio_mixer_stream_s *s)
+{
+	if (s->ducked) {
+		return (uint32_t)(((uint64_t)s->gain * mixer->duck_gain) >> 15);
+	}
+	return s->gain;
+}
+
+static unsigned int queue_free(audio_mixer_t *mixer, struct audio_mixer_stream_s *s)
+{
+	return (unsigned int)(rb_avail(&s->queue) / AUDIO_MIXER_FRAME_BYTES(mixer->channels));
+}
+
+static unsigned int queue_used(audio_mixer_t *mixer, struct audio_mixer_stream_s *s)
+{
+	return (unsigned int)(rb_used(&s->queue) / AUDIO_MIXER_FRAME_BYTES(mixer->channels));
+}
+
+/**
+ * @brief   Map channels of frames to mixer channels.
+ * @remarks Mono is duplicated to all channels, mixer mono takes average of all
+ *          channels, otherwise extra channels are dropped and missing channels
+ *          repeat the last one.
+ */
+static void remap_frames(const int16_t *in, unsigned int in_ch, int16_t *out, unsigned int out_ch, unsigned int frames)
+{
+	unsigned int i;
+	unsigned int k;
+
+	if (in_ch == out_ch) {
+		memcpy(out, in, frames * AUDIO_MIXER_FRAME_BYTES(in_ch));
+	} else if (in_ch == 1) {
+		for (i = 0; i < frames; i++) {
+			for (k = 0; k < out_ch; k++) {
+				*out++ = in[i];
+			}
+		}
+	} else if (out_ch == 1) {
+		for (i = 0; i < frames; i++) {
+			int32_t sum = 0;
+			for (k = 0; k < in_ch; k++) {
+				sum += *in++;
+			}
+			*out++ = (int16_t)(sum / (int32_t)in_ch);
+		}
+	} else {
+		for (i = 0; i < frames; i++) {
+			for (k = 0; k < out_ch; k++) {
+				*out++ = in[(k < in_ch) ? k : (in_ch - 1)];
+			}
+			in += in_ch;
+		}
+	}
+}
+
+/* Put frames in stream format into the queue in mixer format, returns frames queued */
+static unsigned int queue_frames(audio_mixer_t *mixer, struct audio_mixer_stream_s *s, const int16_t *in, unsigned int frames)
+{
+	size_t frame_bytes = AUDIO_MIXER_FRAME_BYTES(mixer->channels);
+	rb_span_t span;
+	unsigned int done = 0;
+	int r;
+
+	rb_acquire_write(&s->queue, frames * frame_bytes, &span);
+	for (r = 0; r < 2; r++) {
+		unsigned int n = (unsigned int)(span.len[r] / frame_bytes);
+		if (n == 0) {
+			break;
+		}
+		remap_frames(in, s->channels, (int16_t *)span.ptr[r], mixer->channels, n);
+		in += n * s->channels;
+		done += n;
+	}
+	rb_commit_write(&s->queue, done * frame_bytes);
+
+	return done;
+}
+
+static void reset_stream(audio_mixer_t *mixer, struct audio_mixer_stream_s *s)
+{
+	rb_reset(&s->queue);
+	if (s->src) {
+		src_destroy(s->src);
+		s->src = src_init_ex(CONFIG_AUDIO_RESAMPLER_BUFSIZE, mixer->type);
+	}
+	s->draining = false;
+}
+
+/* Add frames of the stream to accumulator, ramping gain over 'block' frames */
+static void accumulate(audio_mixer_t *mixer, struct audio_mixer_stream_s *s, int32_t *acc, unsigned int frames, unsigned int block)
+{
+	unsigned int channels = mixer->channels;
+	size_t frame_bytes = AUDIO_MIXER_FRAME_BYTES(channels);
+	uint32_t target = target_gain(mixer, s);
+	int32_t gain_q8 = (int32_t)(s->cur_gain << 8);
+	int32_t step = (((int32_t)target - (int32_t)s->cur_gain) * 256) / (int32_t)block;
+	rb_span_t span;
+	unsigned int i;
+	unsigned int k;
+	int r;
+
+	rb_acquire_read(&s->queue, frames * frame_bytes, &span);
+	for (r = 0; r < 2; r++) {
+		const int16_t *in = (const int16_t *)span.ptr[r];
+		unsigned int n = (unsigned int)(span.len[r] / frame_bytes);
+
+		if (step == 0 && target == AUDIO_MIXER_GAIN_UNITY) {
+			for (i = 0; i < n * channels; i++) {
+				acc[i] += in[i];
+			}
+		} else if (step == 0) {
+			int32_t g = (int32_t)target;
+			for (i = 0; i < n * channels; i++) {
+				acc[i] += (in[i] * g) >> 15;
+			}
+		} else {
+			for (i = 0; i < n; i++) {
+				int32_t g = gain_q8 >> 8;
+				for (k = 0; k < channels; k++) {
+					acc[k] += (in[k] * g) >> 15;
+				}
+				acc += channels;
+				in += channels;
+				gain_q8 += step;
+			}
+			continue;
+		}
+		acc += n * channels;
+	}
+	rb_commit_read(&s->queue, frames * frame_bytes);
+
+	s->cur_gain = target;
+}
+
+audio_mixer_t *audio_mixer_create(unsigned int rate, unsigned int channels, unsigned int frames, src_type_t type)
+{
+	audio_mixer_t *mixer;
+
+	RETURN_VAL_IF_FAIL(rate > 0, NULL);
+	RETURN_VAL_IF_FAIL((channels > 0 && channels <= AUDIO_MIXER_MAX_CHANNELS), NULL);
+
+	mixer = (audio_mixer_t *)calloc(1, sizeof(audio_mixer_t));
+	RETURN_VAL_IF_FAIL(mixer != NULL, NULL);
+
+	mixer->rate = rate;
+	mixer->channels = channels;
+	// Resampled streams are written a chunk at a time, the queue must hold more
+	mixer->frames = (frames < 2 * AUDIO_MIXER_CHUNK_FRAMES) ? 2 * AUDIO_MIXER_CHUNK_FRAMES : frames;
+	mixer->type = type;
+	mixer->duck_gain = AUDIO_MIXER_GAIN_UNITY;
+	mixer->acc = (int32_t *)malloc(AUDIO_MIXER_CHUNK_FRAMES * channels * sizeof(int32_t));
+	mixer->scratch = (int16_t *)malloc(AUDIO_MIXER_CHUNK_FRAMES * AUDIO_MIXER_FRAME_BYTES(AUDIO_MIXER_MAX_CHANNELS));
+	if (!mixer->acc || !mixer->scratch) {
+		meddbg("Fail to allocate mixer buffers\n");
+		audio_mixer_destroy(mixer);
+		return NULL;
+	}
+
+	return mixer;
+}
+
+void audio_mixer_destroy(audio_mixer_t *mixer)
+{
+	int i;
+
+	RETURN_IF_FAIL(mixer != NULL);
+
+	for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+		if (mixer->streams[i].used) {
+			audio_mixer_close(mixer, i);
+		}
+	}
+	free(mixer->acc);
+	free(mixer->scratch);
+	free(mixer);
+}
+
+int audio_mixer_open(audio_mixer_t *mixer, unsigned int rate, unsigned int channels)
+{
+	struct audio_mixer_stream_s *s = NULL;
+	int i;
+
+	RETURN_VAL_IF_FAIL(mixer != NULL, -1);
+	RETURN_VAL_IF_FAIL(rate > 0, -1);
+	RETURN_VAL_IF_FAIL((channels > 0 && channels <= AUDIO_MIXER_MAX_CHANNELS), -1);
+
+	for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+		if (!mixer->streams[i].used) {
+			s = &mixer->streams[i];
+			break;
+		}
+	}
+	if (!s) {
+		meddbg("No free mixer stream\n");
+		return -1;
+	}
+
+	memset(s, 0, sizeof(struct audio_mixer_stream_s));
+	if (rate != mixer->rate) {
+		if (!src_is_valid_ratio_ex(mixer->type, (float)mixer->rate / (float)rate)) {
+			meddbg("Resampling from %u to %u isn't supported\n", rate, mixer->rate);
+			return -1;
+		}
+		if (mixer->type == SRC_TYPE_LINEAR && channels > AUDIO_MIXER_LINEAR_MAX_CHANNELS) {
+			meddbg("Resampling %u channels isn't supported\n", channels);
+			return -1;
+		}
+		s->src = src_init_ex(CONFIG_AUDIO_RESAMPLER_BUFSIZE, mixer->type);
+		if (!s->src) {
+			return -1;
+		}
+	}
+
+	if (!rb_init(&s->queue, mixer->frames * AUDIO_MIXER_FRAME_BYTES(mixer->channels))) {
+		meddbg("Fail to allocate stream queue\n");
+		if (s->src) {
+			src_destroy(s->src);
+		}
+		return -1;
+	}
+
+	s->used = true;
+	s->paused = true;
+	s->rate = rate;
+	s->channels = channels;
+	s->gain = AUDIO_MIXER_GAIN_UNITY;
+	s->cur_gain = AUDIO_MIXER_GAIN_UNITY;
+
+	return i;
+}
+
+void audio_mixer_close(audio_mixer_t *mixer, int stream)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_IF_FAIL(s != NULL);
+
+	if (s->src) {
+		src_destroy(s->src);
+	}
+	rb_free(&s->queue);
+	s->used = false;
+}
+
+int audio_mixer_write(audio_mixer_t *mixer, int stream, const void *data, unsigned int frames)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	const int16_t *in = (const int16_t *)data;
+	unsigned int consumed = 0;
+
+	RETURN_VAL_IF_FAIL(s != NULL, -1);
+	RETURN_VAL_IF_FAIL(data != NULL, -1);
+
+	s->paused = false;
+	s->draining = false;
+
+	while (consumed < frames) {
+		if (s->src) {
+			src_data_t srcData = { 0, };
+
+			if (queue_free(mixer, s) < AUDIO_MIXER_CHUNK_FRAMES) {
+				break;
+			}
+
+			srcData.data_in = in + consumed * s->channels;
+			srcData.input_frames = frames - consumed;
+			srcData.channels_num = s->channels;
+			srcData.origin_sample_rate = s->rate;
+			srcData.origin_sample_width = SAMPLE_WIDTH_16BITS;
+			srcData.desired_sample_rate = mixer->rate;
+			srcData.desired_sample_width = SAMPLE_WIDTH_16BITS;
+			srcData.data_out = mixer->scratch;
+			srcData.out_buf_length = AUDIO_MIXER_CHUNK_FRAMES * AUDIO_MIXER_FRAME_BYTES(s->channels);
+			if (src_simple(s->src, &srcData) != SRC_ERR_NO_ERROR) {
+				meddbg("Fail to resample stream %d from %u to %u\n", stream, s->rate, mixer->rate);
+				return consumed > 0 ? (int)consumed : -1;
+			}
+			if (srcData.output_frames_gen == 0 && srcData.input_frames_used == 0) {
+				break;
+			}
+			queue_frames(mixer, s, mixer->scratch, srcData.output_frames_gen);
+			consumed += srcData.input_frames_used;
+		} else {
+			unsigned int n = queue_frames(mixer, s, in + consumed * s->channels, frames - consumed);
+			if (n == 0) {
+				break;
+			}
+			consumed += n;
+		}
+	}
+
+	return (int)consumed;
+}
+
+unsigned int audio_mixer_space(audio_mixer_t *mixer, int stream)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	unsigned int free_frames;
+
+	RETURN_VAL_IF_FAIL(s != NULL, 0);
+
+	free_frames = queue_free(mixer, s);
+	if (!s->src) {
+		return free_frames;
+	}
+
+	RETURN_VAL_IF_FAIL(free_frames >= AUDIO_MIXER_CHUNK_FRAMES, 0);
+	return (unsigned int)((uint64_t)(free_frames - AUDIO_MIXER_CHUNK_FRAMES) * s->rate / mixer->rate);
+}
+
+unsigned int audio_mixer_capacity(audio_mixer_t *mixer, int stream)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_VAL_IF_FAIL(s != NULL, 0);
+
+	if (!s->src) {
+		return mixer->frames;
+	}
+	return (unsigned int)((uint64_t)(mixer->frames - AUDIO_MIXER_CHUNK_FRAMES) * s->rate / mixer->rate);
+}
+
+unsigned int audio_mixer_queued(audio_mixer_t *mixer, int stream)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_VAL_IF_FAIL(s != NULL, 0);
+
+	return queue_used(mixer, s);
+}
+
+void audio_mixer_pause(audio_mixer_t *mixer, int stream, bool pause)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_IF_FAIL(s != NULL);
+
+	s->paused = pause;
+}
+
+void audio_mixer_drain(audio_mixer_t *mixer, int stream)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_IF_FAIL(s != NULL);
+
+	s->draining = true;
+}
+
+void audio_mixer_flush(audio_mixer_t *mixer, int stream)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_IF_FAIL(s != NULL);
+
+	reset_stream(mixer, s);
+}
+
+void audio_mixer_set_gain(audio_mixer_t *mixer, int stream, uint32_t gain)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_IF_FAIL(s != NULL);
+
+	s->gain = MINIMUM(gain, AUDIO_MIXER_GAIN_UNITY);
+}
+
+uint32_t audio_mixer_get_gain(audio_mixer_t *mixer, int stream)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_VAL_IF_FAIL(s != NULL, 0);
+
+	return s->gain;
+}
+
+void audio_mixer_set_ducking(audio_mixer_t *mixer, bool duck, uint32_t gain)
+{
+	int i;
+
+	RETURN_IF_FAIL(mixer != NULL);
+
+	if (duck && !mixer->ducking) {
+		for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+			mixer->streams[i].ducked = mixer->streams[i].used;
+		}
+	} else if (!duck) {
+		for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+			mixer->streams[i].ducked = false;
+		}
+	}
+	mixer->ducking = duck;
+	mixer->duck_gain = MINIMUM(gain, AUDIO_MIXER_GAIN_UNITY);
+}
+
+unsigned int audio_mixer_ready(audio_mixer_t *mixer)
+{
+	unsigned int min_frames = UINT32_MAX;
+	unsigned int max_frames = 0;
+	bool force = false;
+	int i;
+
+	RETURN_VAL_IF_FAIL(mixer != NULL, 0);
+
+	for (i = 0; i < CONFIG_AUDIO_MIXER_MAX_STREAMS; i++) {
+		struct audio_mixer_stream_s *s = &mixer->streams[i];
+		unsigned int used;
+
+		if (!s->used || s->paused) {
+			continue;
+		}
+
+		used = queue_used(mixer, s);
+		if (used > max_frames) {
+			max_frames = used;
+		}
+		if (s->draining) {
+			force = force || (used > 0);
+			continue;
+		}
+		if (queue_free(mixer, s) < AUDIO_MIXER_CHUNK_FRAMES) {
+			force = true;
+		}
+		if (used < min_frames) {
+			min_frames = used;
+		}
+	}
+
+	if (force || min_frames == UINT32_MAX) {
+		return max_frames;
+	}
+	return min_frames;
+}
+
+unsigned int audio_mixer_mix(audio_mixer_t *mixer, int16_t *out, unsigned int frames)
+{
+	unsigned int channels;
+	unsigned int done = 0;
+	unsigned int i;
+	int k;
+
+	RETURN_VAL_IF_FAIL(mixer != NULL, 0);
+	RETURN_VAL_IF_FAIL(out != NULL, 0);
+	channels = mixer->channels;
+
+	while (done < frames) {
+		unsigned int block = MINIMUM(frames - done, AUDIO_MIXER_CHUNK_FRAMES);
+
+		memset(mixer->acc, 0, block * channels * sizeof(int32_t));
+		for (k = 0; k < CONFIG_AUDIO_MIXER_MAX_STREAMS; k++) {
+			struct audio_mixer_stream_s *s = &mixer->streams[k];
+			unsigned int n;
+
+			if (!s->used || s->paused) {
+				continue;
+			}
+
+			n = MINIMUM(block, queue_used(mixer, s));
+			if (n < block && !s->draining) {
+				s->underruns++;
+			}
+			if (n > 0) {
+				accumulate(mixer, s, mixer->acc, n, block);
+			}
+		}
+
+		for (i = 0; i < block * channels; i++) {
+			out[i] = mix_clip(mixer->acc[i]);
+		}
+		out += block * channels;
+		done += block;
+	}
+
+	return done;
+}
+
+unsigned int audio_mixer_underruns(audio_mixer_t *mixer, int stream)
+{
+	struct audio_mixer_stream_s *s = get_stream(mixer, stream);
+	RETURN_VAL_IF_FAIL(s != NULL, 0);
+
+	return s->underruns;
+}
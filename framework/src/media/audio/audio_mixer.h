@@ -0,0 +1,189 @@
+/******************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#ifndef _AUDIO_MIXER_H_
+#define _AUDIO_MIXER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "resample/samplerate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Unity gain in Q15 */
+#define AUDIO_MIXER_GAIN_UNITY 32768
+
+/*
+ * Software mixer of 16 bits PCM streams.
+ * Each stream is converted to the mixer rate and channels when it's written,
+ * and queued until audio_mixer_mix() sums all streams with their gains.
+ * Mixer isn't thread safe, calls must be serialized by the caller.
+ */
+typedef struct audio_mixer_s audio_mixer_t;
+
+/**
+ * @brief  Create a mixer.
+ * @param  rate    : sample rate of mixed output
+ * @param  channels: number of channels of mixed output
+ * @param  frames  : queue depth of each stream in output frames
+ * @param  type    : resampler used for streams in other sample rates
+ * @return pointer to the mixer on success, NULL on failure.
+ */
+audio_mixer_t *audio_mixer_create(unsigned int rate, unsigned int channels, unsigned int frames, src_type_t type);
+
+/**
+ * @brief  Destroy the mixer and all streams in it.
+ * @param  mixer: Pointer to the mixer
+ */
+void audio_mixer_destroy(audio_mixer_t *mixer);
+
+/**
+ * @brief  Open a stream, it's paused until data is written.
+ * @param  mixer   : Pointer to the mixer
+ * @param  rate    : sample rate of the stream
+ * @param  channels: number of channels of the stream
+ * @return stream id on success, -1 if no free slot or the rate isn't supported.
+ */
+int audio_mixer_open(audio_mixer_t *mixer, unsigned int rate, unsigned int channels);
+
+/**
+ * @brief  Close the stream, data queued is dropped.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ */
+void audio_mixer_close(audio_mixer_t *mixer, int stream);
+
+/**
+ * @brief  Convert and queue frames of the stream, resume it if paused.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ * @param  data  : interleaved frames in the stream format
+ * @param  frames: number of frames
+ * @return number of frames consumed, range[0, frames], negative value on failure.
+ */
+int audio_mixer_write(audio_mixer_t *mixer, int stream, const void *data, unsigned int frames);
+
+/**
+ * @brief  Get number of frames in the stream format which can be written
+ *         without being truncated. It's an estimation for resampled streams.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ * @return number of frames.
+ */
+unsigned int audio_mixer_space(audio_mixer_t *mixer, int stream);
+
+/**
+ * @brief  Get maximum number of frames in the stream format which can be queued.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ * @return number of frames.
+ */
+unsigned int audio_mixer_capacity(audio_mixer_t *mixer, int stream);
+
+/**
+ * @brief  Get number of output frames queued and not mixed yet.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ * @return number of frames.
+ */
+unsigned int audio_mixer_queued(audio_mixer_t *mixer, int stream);
+
+/**
+ * @brief  Pause or resume the stream. Paused streams keep queued data but
+ *         they're left out of mixing.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ * @param  pause : true to pause
+ */
+void audio_mixer_pause(audio_mixer_t *mixer, int stream, bool pause);
+
+/**
+ * @brief  Mark the stream as draining, no more data will come. Other streams
+ *         don't wait for it, and it doesn't wait for others.
+ *         It's cleared by next audio_mixer_write().
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ */
+void audio_mixer_drain(audio_mixer_t *mixer, int stream);
+
+/**
+ * @brief  Drop data queued in the stream and reset its resampler.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ */
+void audio_mixer_flush(audio_mixer_t *mixer, int stream);
+
+/**
+ * @brief  Set gain of the stream, it's ramped within next mixing.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ * @param  gain  : gain in Q15, range[0, AUDIO_MIXER_GAIN_UNITY]
+ */
+void audio_mixer_set_gain(audio_mixer_t *mixer, int stream, uint32_t gain);
+
+/**
+ * @brief  Get gain of the stream.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ * @return gain in Q15
+ */
+uint32_t audio_mixer_get_gain(audio_mixer_t *mixer, int stream);
+
+/**
+ * @brief  Start or stop ducking. Streams open when ducking starts are attenuated
+ *         by 'gain' until it stops, streams opened later are not.
+ * @param  mixer : Pointer to the mixer
+ * @param  duck  : true to start ducking
+ * @param  gain  : gain in Q15 applied to ducked streams
+ */
+void audio_mixer_set_ducking(audio_mixer_t *mixer, bool duck, uint32_t gain);
+
+/**
+ * @brief  Get number of frames which can be mixed now.
+ *         Streams running are mixed as far as all of them have data, unless
+ *         a stream is full or draining: then starved streams are padded with
+ *         silence, so one stalled stream can't block others.
+ * @param  mixer: Pointer to the mixer
+ * @return number of frames.
+ */
+unsigned int audio_mixer_ready(audio_mixer_t *mixer);
+
+/**
+ * @brief  Mix streams running into output buffer with saturation.
+ * @param  mixer : Pointer to the mixer
+ * @param  out   : interleaved output frames
+ * @param  frames: number of frames to mix, it should be no more than audio_mixer_ready()
+ * @return number of frames mixed.
+ */
+unsigned int audio_mixer_mix(audio_mixer_t *mixer, int16_t *out, unsigned int frames);
+
+/**
+ * @brief  Get number of times a running stream had no data while others were mixed.
+ * @param  mixer : Pointer to the mixer
+ * @param  stream: stream id
+ * @return number of underruns.
+ */
+unsigned int audio_mixer_underruns(audio_mixer_t *mixer, int stream);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
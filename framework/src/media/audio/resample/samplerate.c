@@ -81,6 +81,32 @@
 // At least remain one frame (one sample for each channel)
 #define OVERLAP_DEFAULT (1)
 
+// Zero crossings of the polyphase interpolation kernel on each side
+#define SRC_POLY_ZERO_CROSSINGS (8)
+
+// Taps per phase are padded to a multiple of this, for the MAC loops to vectorize
+#define SRC_POLY_TAP_ALIGN  (4)
+
+// Max number of phases (interpolation factor after reduction) of polyphase SRC
+#define SRC_POLY_MAX_PHASES (512)
+
+// Range of ratio supported for polyphase sample rate conversion
+#define SRC_POLY_MAX_RATIO  ((float)6)
+#define SRC_POLY_MIN_RATIO  ((float)1 / SRC_POLY_MAX_RATIO)
+
+// Max channel num supported for polyphase SRC
+#define SRC_POLY_MAX_CH     (8)
+
+// Pass band edge relative to the lower nyquist frequency, and kaiser window beta
+#define SRC_POLY_ROLLOFF    (0.90)
+#define SRC_POLY_KAISER_BETA    (8.0)
+
+// Coefficients are Q15 fixed point values
+#define SRC_POLY_COEFF_BITS (15)
+#define SRC_POLY_COEFF_ONE  (1 << SRC_POLY_COEFF_BITS)
+
+#define ALIGN_UP(x, a)  ((((x) + (a) - 1) / (a)) * (a))
+
 #define RETURN_VAL_IF_FAIL(condition, val) \
 	do { \
 		if (!(condition)) { \
@@ -92,6 +118,25 @@
 /****************************************************************************
  * Private Declarations
  ****************************************************************************/
+/**
+ * @structure src_poly_s: streaming context of the polyphase filter bank.
+ * @brief The ratio is reduced to phases/step, output frame j is computed from
+ *        the coefficients of phase (j * step) % phases. Input frames are kept
+ *        per channel (planar) in history, so that every output sample is one
+ *        contiguous int16 x int16 dot product.
+ */
+struct src_poly_s {
+	int16_t *coeff;         // phases * taps Q15 coefficients, each phase stored reversed
+	int16_t *history;       // channels_num planes of hist_frames input frames
+	int phases;             // interpolation factor L
+	int step;               // decimation factor M
+	int taps;               // coefficients per phase
+	int hist_frames;        // capacity of each history plane in frames
+	int fill;               // number of frames valid in history
+	int pos;                // first history frame of the next output window
+	int phase;              // phase of the next output frame, range [0, phases)
+};
+
 /**
  * @structure resampler_s: main structure used for SRC, it contains context
  *            variables used between src_simple() calls.
@@ -109,6 +154,8 @@ struct resampler_s {
 	float lastratio;        // memorize last sample rate coversion ratio
 	int lastoldformat;      // memorize last origin sample width(format)
 	int lastnewformat;      // memorize last desired sample width(format)
+	src_type_t type;        // algorithm selected in src_init_ex()
+	struct src_poly_s poly; // context of SRC_TYPE_POLYPHASE
 };
 
 typedef struct resampler_s resampler_t;
@@ -368,11 +415,244 @@ static void downresample_2_1_filter_frac(resampler_t *src, int32_t num_frames_in
 	}
 }
 
+/**
+ * @brief   Greatest common divisor, used to reduce the conversion ratio.
+ */
+static int gcd(int a, int b)
+{
+	while (b != 0) {
+		int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * @brief   Zeroth order modified bessel function of the first kind.
+ * @remarks Used to build the kaiser window, power series until converged.
+ */
+static double bessel_i0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	double half = x / 2.0;
+	int k;
+	for (k = 1; k < 32; k++) {
+		term *= (half / k) * (half / k);
+		sum += term;
+		if (term < sum * 1e-12) {
+			break;
+		}
+	}
+	return sum;
+}
+
+/**
+ * @brief   Value of the kaiser windowed sinc prototype filter at offset t.
+ * @param   t: offset from the filter center, in samples of the interpolated rate.
+ * @param   cutoff: cutoff frequency in cycles per interpolated sample.
+ * @param   half_len: half length of the prototype filter.
+ * @return  unnormalized filter coefficient.
+ */
+static double poly_kernel(double t, double cutoff, double half_len)
+{
+	double x = t / half_len;
+	double w;
+	double arg;
+
+	if (x <= -1.0 || x >= 1.0) {
+		return 0.0;
+	}
+
+	w = bessel_i0(SRC_POLY_KAISER_BETA * sqrt(1.0 - x * x)) / bessel_i0(SRC_POLY_KAISER_BETA);
+	arg = M_PI * 2.0 * cutoff * t;
+	if (fabs(arg) < 1e-9) {
+		return w;
+	}
+	return w * sin(arg) / arg;
+}
+
+/**
+ * @brief   Build the Q15 coefficient table of every phase.
+ * @remarks Each phase is normalized to unity DC gain and stored reversed, so
+ *          output is dot(coeff + phase * taps, history + pos) in ascending order.
+ *          The rounding error of a phase is folded into its largest coefficient.
+ * @param   poly: polyphase context with phases, step and taps set.
+ * @return  void
+ */
+static void poly_design(struct src_poly_s *poly)
+{
+	int phases = poly->phases;
+	int taps = poly->taps;
+	double cutoff = SRC_POLY_ROLLOFF * 0.5 / (double)MAXIMUM(phases, poly->step);
+	double center = ((double)phases * taps - 1.0) / 2.0;
+	double half_len = ((double)phases * taps) / 2.0;
+
+	int p;
+	for (p = 0; p < phases; p++) {
+		int16_t *coeff = poly->coeff + p * taps;
+		double sum = 0.0;
+		int32_t qsum = 0;
+		int peak = 0;
+		int k;
+
+		for (k = 0; k < taps; k++) {
+			sum += poly_kernel((double)(p + k * phases) - center, cutoff, half_len);
+		}
+
+		for (k = 0; k < taps; k++) {
+			double h = poly_kernel((double)(p + k * phases) - center, cutoff, half_len) / sum;
+			int32_t q = (int32_t)floor(h * SRC_POLY_COEFF_ONE + 0.5);
+			int idx = taps - 1 - k;
+			coeff[idx] = (int16_t)MINIMUM(MAXIMUM(q, INT16_MIN), INT16_MAX);
+			qsum += coeff[idx];
+			if (abs(coeff[idx]) > abs(coeff[peak])) {
+				peak = idx;
+			}
+		}
+
+		coeff[peak] += (int16_t)(SRC_POLY_COEFF_ONE - qsum);
+	}
+}
+
+/**
+ * @brief   Allocate tables and reset the streaming state of polyphase SRC.
+ * @param   src: pointer to resampler object.
+ * @param   channels_num: num of channels of input samples.
+ * @param   old_sample_rate: original sample rate.
+ * @param   new_sample_rate: desired sample rate.
+ * @return  SRC_ERR_NO_ERROR on success, otherwise, it means failure.
+ */
+static int poly_init(resampler_t *src, int channels_num, int old_sample_rate, int new_sample_rate)
+{
+	struct src_poly_s *poly = &src->poly;
+	int divisor = gcd(old_sample_rate, new_sample_rate);
+	int taps = SRC_POLY_ZERO_CROSSINGS * 2;
+
+	poly->phases = new_sample_rate / divisor;
+	poly->step = old_sample_rate / divisor;
+	RETURN_VAL_IF_FAIL((poly->phases <= SRC_POLY_MAX_PHASES), SRC_ERR_NOT_SUPPORT);
+
+	// Widen the kernel in proportion when decimating, to keep the same transition band
+	if (poly->step > poly->phases) {
+		taps = (taps * poly->step + poly->phases - 1) / poly->phases;
+	}
+	poly->taps = ALIGN_UP(taps, SRC_POLY_TAP_ALIGN);
+
+	poly->hist_frames = src->size_in_bytes / (BYTES_PER_SAMPLE(SAMPLE_WIDTH_16BITS) * channels_num) + poly->taps;
+
+	poly->coeff = (int16_t *)malloc(poly->phases * poly->taps * sizeof(int16_t));
+	RETURN_VAL_IF_FAIL((poly->coeff != NULL), SRC_ERR_MALLOC_FAILED);
+
+	poly->history = (int16_t *)malloc(poly->hist_frames * channels_num * sizeof(int16_t));
+	if (poly->history == NULL) {
+		free(poly->coeff);
+		poly->coeff = NULL;
+		return SRC_ERR_MALLOC_FAILED;
+	}
+
+	poly_design(poly);
+
+	// Start with half a window of silence, so the first input frame lines up with the filter center
+	memset(poly->history, 0, poly->hist_frames * channels_num * sizeof(int16_t));
+	poly->fill = poly->taps / 2;
+	poly->pos = 0;
+	poly->phase = 0;
+
+	return SRC_ERR_NO_ERROR;
+}
+
+/**
+ * @brief   Multiply-accumulate one window of Q15 coefficients with samples.
+ * @remarks Plain int16 x int16 -> int32 loop over contiguous arrays, which is
+ *          auto-vectorized (SMLAD/NEON/PMADDWD). Per phase gain is normalized,
+ *          so the sum can't overflow int32.
+ */
+static int32_t poly_dot(const int16_t *coeff, const int16_t *input, int32_t taps)
+{
+	int32_t sum = 1 << (SRC_POLY_COEFF_BITS - 1);
+	int32_t i;
+	for (i = 0; i < taps; i++) {
+		sum += (int32_t)coeff[i] * (int32_t)input[i];
+	}
+	return sum >> SRC_POLY_COEFF_BITS;
+}
+
+/**
+ * @brief   Streaming polyphase conversion of interleaved frames.
+ * @remarks Input is accepted as far as the history has room, output is generated
+ *          as far as the history and the output buffer allow. Frames not yet
+ *          consumed stay in the handle for the next call.
+ * @param   src: pointer to resampler object.
+ * @param   input: interleaved input frames.
+ * @param   num_frames_in: number of input frames.
+ * @param   input_frames_used: number of input frames accepted.
+ * @return  number of frames stored in output buffer.
+ */
+static int poly_process(resampler_t *src, const int16_t *input, int num_frames_in, int *input_frames_used)
+{
+	struct src_poly_s *poly = &src->poly;
+	int channels_num = src->channels_num;
+	int16_t *output = src->out_buffer;
+	int taps = poly->taps;
+	int frames;
+	int gen = 0;
+	int i;
+	int k;
+
+	// Drop frames no output window will use anymore
+	if (poly->pos > 0) {
+		frames = poly->fill - poly->pos;
+		for (k = 0; k < channels_num; k++) {
+			int16_t *plane = poly->history + k * poly->hist_frames;
+			memmove(plane, plane + poly->pos, frames * sizeof(int16_t));
+		}
+		poly->fill -= poly->pos;
+		poly->pos = 0;
+	}
+
+	// De-interleave new input frames into history
+	frames = MINIMUM(num_frames_in, poly->hist_frames - poly->fill);
+	for (k = 0; k < channels_num; k++) {
+		int16_t *plane = poly->history + k * poly->hist_frames + poly->fill;
+		const int16_t *in = input + k;
+		for (i = 0; i < frames; i++) {
+			plane[i] = in[i * channels_num];
+		}
+	}
+	poly->fill += frames;
+	*input_frames_used = frames;
+
+	while (gen < src->outsize_in_frames && poly->pos + taps <= poly->fill) {
+		const int16_t *coeff = poly->coeff + poly->phase * taps;
+		for (k = 0; k < channels_num; k++) {
+			*output++ = clip(poly_dot(coeff, poly->history + k * poly->hist_frames + poly->pos, taps));
+		}
+		gen++;
+
+		poly->phase += poly->step;
+		while (poly->phase >= poly->phases) {
+			poly->phase -= poly->phases;
+			poly->pos++;
+		}
+	}
+
+	return gen;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 src_handle_t src_init(int size)
 {
+	return src_init_ex(size, SRC_TYPE_LINEAR);
+}
+
+src_handle_t src_init_ex(int size, src_type_t type)
+{
+	RETURN_VAL_IF_FAIL((type == SRC_TYPE_LINEAR || type == SRC_TYPE_POLYPHASE), NULL);
+
 	resampler_t *src = (resampler_t *)malloc(sizeof(resampler_t));
 	RETURN_VAL_IF_FAIL((src != NULL), NULL);
 
@@ -391,6 +671,9 @@ src_handle_t src_init(int size)
 	src->left_frames = 0;
 	src->lastratio = 0.0f;
 
+	src->type = type;
+	memset(&src->poly, 0, sizeof(struct src_poly_s));
+
 	return (src_handle_t)src;
 }
 
@@ -402,6 +685,9 @@ int src_destroy(src_handle_t handle)
 	free(src->in_buffer);
 	src->in_buffer = NULL;
 
+	free(src->poly.coeff);
+	free(src->poly.history);
+
 	free(src);
 	return SRC_ERR_NO_ERROR;
 }
@@ -415,12 +701,78 @@ bool src_is_valid_ratio(float ratio)
 	return false;
 }
 
+bool src_is_valid_ratio_ex(src_type_t type, float ratio)
+{
+	if (type == SRC_TYPE_POLYPHASE) {
+		return (ratio <= SRC_POLY_MAX_RATIO) && (ratio >= SRC_POLY_MIN_RATIO);
+	}
+
+	return src_is_valid_ratio(ratio);
+}
+
+/**
+ * @brief   src_simple() of SRC_TYPE_POLYPHASE.
+ * @remarks The filter state is kept in the handle, so same restriction as
+ *          SRC_TYPE_LINEAR: rates, channels and width can't change in same processing.
+ */
+static int src_simple_poly(resampler_t *src, src_data_t *src_data)
+{
+	int channels_num = src_data->channels_num;
+	int old_sample_rate = src_data->origin_sample_rate;
+	int new_sample_rate = src_data->desired_sample_rate;
+	int bytes_per_sample = BYTES_PER_SAMPLE(SAMPLE_WIDTH_16BITS);
+	int input_frames_used = 0;
+	int output_frames_gen = 0;
+	float src_ratio;
+
+	RETURN_VAL_IF_FAIL((channels_num > 0 && channels_num <= SRC_POLY_MAX_CH), SRC_ERR_BAD_CHANNEL_COUNT);
+	RETURN_VAL_IF_FAIL((old_sample_rate > 0 && new_sample_rate > 0), SRC_ERR_BAD_PARAMS);
+	RETURN_VAL_IF_FAIL((src_data->origin_sample_width == SAMPLE_WIDTH_16BITS && src_data->desired_sample_width == SAMPLE_WIDTH_16BITS), SRC_ERR_NOT_SUPPORT);
+
+	src_ratio = (float)new_sample_rate / (float)old_sample_rate;
+	src_data->src_ratio = src_ratio;
+	RETURN_VAL_IF_FAIL(src_is_valid_ratio_ex(SRC_TYPE_POLYPHASE, src_ratio), SRC_ERR_BAD_SRC_RATIO);
+
+	src->outsize_in_frames = src_data->out_buf_length / (bytes_per_sample * channels_num);
+	RETURN_VAL_IF_FAIL((src->outsize_in_frames > 0), SRC_ERR_BAD_PARAMS);
+	src->out_buffer = src_data->data_out;
+
+	if (src->poly.coeff == NULL) {
+		int ret = poly_init(src, channels_num, old_sample_rate, new_sample_rate);
+		RETURN_VAL_IF_FAIL((ret == SRC_ERR_NO_ERROR), ret);
+
+		src->channels_num = channels_num;
+		src->lastratio = src_ratio;
+	} else {
+		RETURN_VAL_IF_FAIL((src->lastratio == src_ratio), SRC_ERR_NOT_SUPPORT);
+		RETURN_VAL_IF_FAIL((src->channels_num == channels_num), SRC_ERR_NOT_SUPPORT);
+	}
+
+	if (old_sample_rate == new_sample_rate) {
+		// same rate, just copy data
+		input_frames_used = MINIMUM(src_data->input_frames, src->outsize_in_frames);
+		output_frames_gen = input_frames_used;
+		memcpy((void *)src->out_buffer, src_data->data_in, output_frames_gen * channels_num * bytes_per_sample);
+	} else {
+		output_frames_gen = poly_process(src, (const int16_t *)src_data->data_in, src_data->input_frames, &input_frames_used);
+	}
+
+	src_data->input_frames_used = input_frames_used;
+	src_data->output_frames_gen = output_frames_gen;
+
+	return SRC_ERR_NO_ERROR;
+}
+
 int src_simple(src_handle_t handle, src_data_t *src_data)
 {
 	resampler_t *src = (resampler_t *)handle;
 	RETURN_VAL_IF_FAIL((src != NULL && src_data != NULL), SRC_ERR_BAD_PARAMS);
 	RETURN_VAL_IF_FAIL((src_data->data_in != NULL && src_data->data_out != NULL), SRC_ERR_BAD_PARAMS);
 
+	if (src->type == SRC_TYPE_POLYPHASE) {
+		return src_simple_poly(src, src_data);
+	}
+
 	int channels_num = src_data->channels_num;
 	RETURN_VAL_IF_FAIL((channels_num > 0 && channels_num <= SRC_MAX_CH), SRC_ERR_BAD_CHANNEL_COUNT);
 
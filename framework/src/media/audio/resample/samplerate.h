@@ -70,6 +70,21 @@ enum {
 	SAMPLE_WIDTH_MAX = SAMPLE_WIDTH_32BITS,
 };
 
+/**
+ * @enum  Define SRC algorithm types, selected in src_init_ex().
+ * @brief SRC_TYPE_LINEAR: linear interpolation with FIR filtering on some ratios,
+ *        ratio in range [1/3, 3], at most 2 channels.
+ *        SRC_TYPE_POLYPHASE: Q15 polyphase filter bank for any rational ratio
+ *        in range [1/6, 6] whose reduced interpolation factor is at most 512,
+ *        at most 8 interleaved channels.
+ */
+enum src_type_e {
+	SRC_TYPE_LINEAR = 0,
+	SRC_TYPE_POLYPHASE,
+};
+
+typedef enum src_type_e src_type_t;
+
 /**
  * @typedef src_handle_t, SRC(Sample Rate Convertor) hanlde type declaration.
  * @brief   NULL means invalid handle.
@@ -129,6 +144,17 @@ int src_simple(src_handle_t handle, src_data_t *data);
  */
 src_handle_t src_init(int size);
 
+/**
+ * @brief   SRC (Sample Rate Convertor) initialize with the given algorithm.
+ * @remarks Coefficient tables and internal buffers will be allocated in the
+ *          first src_simple(), when rates and channels are known.
+ * @param   size: buffer size in bytes, same as src_init().
+ * @param   type: SRC algorithm, see src_type_t.
+ * @return  SRC handle, if NULL, it means failure.
+ * @see     src_init(), src_destroy()
+ */
+src_handle_t src_init_ex(int size, src_type_t type);
+
 /**
  * @brief   Release buffers allocated by SRC in src_init().
  * @remarks This function must be called in pairs with src_init(), to avoid mem leak.
@@ -172,6 +198,15 @@ int src_MonoToStereo(short *samples, int size);
  */
 bool src_is_valid_ratio(float ratio);
 
+/**
+ * @brief   Check if the conversion ratio is valid for the given SRC algorithm.
+ * @param   type: SRC algorithm, see src_type_t.
+ * @param   ratio: target_samplerate/original_samplerate.
+ * @return  true if it's valid, otherwise, returns false.
+ * @see     src_is_valid_ratio()
+ */
+bool src_is_valid_ratio_ex(src_type_t type, float ratio);
+
 #ifdef __cplusplus
 }		/* extern "C" */
 #endif	/* __cplusplus */
@@ -20,6 +20,7 @@
 #include <debug.h>
 #include <assert.h>
 #include <pthread.h>
+#include <string.h>
 #include "opus_encoder_api.h"
 
 // Opus packet header is self-defined, 4 bytes syncword + 4 bytes packet length.
@@ -102,7 +103,7 @@ int32_t opus_frameEncode(opus_enc_external_t *pExt, void *pMem)
 
 	// Sync word
 	out_data = (unsigned char *)pExt->pOutputBuffer;
-	strncpy(out_data, "Opus", 4);
+	memcpy(out_data, "Opus", 4);
 	out_data += 4;
 
 	// Packet length
@@ -42,6 +42,10 @@ namespace media {
 // Mask to verfiy the MP3 header, all bits should be '1' for all MP3 frames.
 #define MP3_FRAME_VERIFY_MASK 0xffe00000
 
+// Above 11 sync bits, in the first and second byte of MP3 header
+#define MP3_SYNC_BYTE0 0xff
+#define MP3_SYNC_BYTE1_MASK 0xe0
+
 // Mask to extract the version, layer, sampling rate parts of the MP3 header,
 // which should be same for all MP3 frames.
 #define MP3_FRAME_HEADER_MASK 0xfffe0c00
@@ -54,7 +58,10 @@ namespace media {
 #define AAC_ADTS_FRAME_HEADER_LEN 9
 
 // AAC ADTS frame sync verify
-#define AAC_ADTS_SYNC_VERIFY(buf) ((buf[0] == 0xff) && ((buf[1] & 0xf6) == 0xf0))
+#define AAC_ADTS_SYNC_BYTE0 0xff
+#define AAC_ADTS_SYNC_BYTE1_MASK 0xf6
+#define AAC_ADTS_SYNC_BYTE1 0xf0
+#define AAC_ADTS_SYNC_VERIFY(buf) ((buf[0] == AAC_ADTS_SYNC_BYTE0) && ((buf[1] & AAC_ADTS_SYNC_BYTE1_MASK) == AAC_ADTS_SYNC_BYTE1))
 
 // AAC ADTS Frame size value stores in 13 bits started at the 31th bit from header
 #define AAC_ADTS_FRAME_GETSIZE(buf) ((buf[3] & 0x03) << 11 | buf[4] << 3 | buf[5] >> 5)
@@ -111,11 +118,22 @@ namespace media {
 #define OPUS_PACKET_HEADER_LEN 8
 
 // Opus packet sync verify
-#define OPUS_PACKET_SYNC_VERIFY(buf) (strncmp((const char *)buf, "Opus", 4) == 0)
+#define OPUS_SYNC_BYTE0 'O'
+#define OPUS_SYNC_BYTE1 'p'
+#define OPUS_PACKET_SYNC_VERIFY(buf) (memcmp((const char *)buf, "Opus", 4) == 0)
 #define OPUS_PACKET_GETSIZE(buf) (OPUS_PACKET_HEADER_LEN + _u32_at(buf+4))
 
 #define BYTES_PER_SAMPLE sizeof(signed short)
 
+// Frame index: one entry per interval frames, bounded to max entries.
+#ifndef CONFIG_MEDIA_FRAME_INDEX_INTERVAL
+#define CONFIG_MEDIA_FRAME_INDEX_INTERVAL 16
+#endif
+
+#ifndef CONFIG_MEDIA_FRAME_INDEX_MAX_ENTRIES
+#define CONFIG_MEDIA_FRAME_INDEX_MAX_ENTRIES 1024
+#endif
+
 /****************************************************************************
  * Private Declarations
  ****************************************************************************/
@@ -143,6 +161,10 @@ struct priv_data_s {
 	ssize_t mCurrentPos;        /* read position when decoding */
 	uint32_t mFixedHeader;      /* mp3 frame header */
 	pcm_data_t pcm;             /* a recorder of pcm data info */
+	ssize_t mFramePos;          /* position of the frame got last */
+	uint32_t mSamplePos;        /* sample position of the next frame decoded */
+	uint32_t mSkipTo;           /* samples before it are dropped, after seeking */
+	frame_index_t mIndex;       /* index of frames decoded */
 };
 
 typedef struct priv_data_s priv_data_t;
@@ -256,6 +278,65 @@ static ssize_t _source_read_at(rbstream_p fp, ssize_t offset, void *data, size_t
 	return rbs_read(data, 1, size, fp);
 }
 
+/**
+ * @brief  Get 'size' bytes at stream position 'offset', from the resync window
+ *         (buf holds 'len' bytes started at position 'base') if they're inside,
+ *         otherwise read them from stream to 'temp'.
+ * @return pointer to the data, NULL if the stream can't provide them.
+ */
+static const uint8_t *_window_at(rbstream_p fp, const uint8_t *buf, ssize_t base, ssize_t len, ssize_t offset, uint8_t *temp, size_t size)
+{
+	if (offset >= base && offset + (ssize_t)size <= base + len) {
+		return buf + (offset - base);
+	}
+
+	RETURN_VAL_IF_FAIL((_source_read_at(fp, offset, temp, size) == (ssize_t)size), NULL);
+	return temp;
+}
+
+/**
+ * @brief  Find sync word candidates in the resync window: the first position i
+ *         in [0, len) where buf[i] == b0 and (buf[i + 1] & mask1) == val1.
+ *         buf[len] must be readable.
+ * @remarks Compares a machine word at a time (SWAR): bytes equal to b0 are
+ *          flagged exactly by the zero-byte test on (word ^ b0 pattern), only
+ *          words having any flag are checked byte by byte.
+ * @return position found, or len if there's no candidate.
+ */
+static size_t _sync_scan(const uint8_t *buf, size_t len, uint8_t b0, uint8_t mask1, uint8_t val1)
+{
+	const uintptr_t ones = (uintptr_t)-1 / 0xff;
+	const uintptr_t lows = ones * 0x7f;
+	const uintptr_t pattern = ones * b0;
+	size_t i = 0;
+
+	for (; i + sizeof(uintptr_t) <= len; i += sizeof(uintptr_t)) {
+		uintptr_t word;
+		memcpy(&word, buf + i, sizeof(word));
+		word ^= pattern;
+
+		// High bit set in each byte which is zero, without false positives.
+		if ((~(((word & lows) + lows) | word | lows)) == 0) {
+			continue;
+		}
+
+		size_t j;
+		for (j = i; j < i + sizeof(uintptr_t); j++) {
+			if (buf[j] == b0 && (buf[j + 1] & mask1) == val1) {
+				return j;
+			}
+		}
+	}
+
+	for (; i < len; i++) {
+		if (buf[i] == b0 && (buf[i + 1] & mask1) == val1) {
+			return i;
+		}
+	}
+
+	return len;
+}
+
 // Resync to next valid MP3 frame in the file.
 static bool mp3_resync(rbstream_p fp, uint32_t match_header, ssize_t *inout_pos, uint32_t *out_header)
 {
@@ -318,6 +399,15 @@ static bool mp3_resync(rbstream_p fp, uint32_t match_header, ssize_t *inout_pos,
 			continue;
 		}
 
+		// Skip to the next 11 bits frame sync, all candidates in window at once.
+		size_t skip = _sync_scan(buf_ptr, remainingBytes - U32_LEN_IN_BYTES + 1, MP3_SYNC_BYTE0, MP3_SYNC_BYTE1_MASK, MP3_SYNC_BYTE1_MASK);
+		if (skip > 0) {
+			pos += skip;
+			buf_ptr += skip;
+			remainingBytes -= skip;
+			continue;
+		}
+
 		uint32_t header = _u32_at(buf_ptr);
 
 		if (match_header != 0 && (header & MP3_FRAME_HEADER_MASK) != (match_header & MP3_FRAME_HEADER_MASK)) {
@@ -343,13 +433,13 @@ static bool mp3_resync(rbstream_p fp, uint32_t match_header, ssize_t *inout_pos,
 		int j;
 		for (j = 0; j < FRAME_MATCH_REQUIRED; ++j) {
 			uint8_t temp[U32_LEN_IN_BYTES];
-			ssize_t retval = _source_read_at(fp, test_pos, temp, sizeof(temp));
-			if (retval < (ssize_t) sizeof(temp)) {
+			const uint8_t *test_ptr = _window_at(fp, buf_ptr, pos, remainingBytes, test_pos, temp, sizeof(temp));
+			if (test_ptr == NULL) {
 				valid = false;
 				break;
 			}
 
-			uint32_t test_header = _u32_at(temp);
+			uint32_t test_header = _u32_at(test_ptr);
 
 			if ((test_header & MP3_FRAME_HEADER_MASK) != (header & MP3_FRAME_HEADER_MASK)) {
 				medvdbg("[%s] Line %d, invalid frame at pos1 %#x\n", __FUNCTION__, __LINE__, test_pos);
@@ -447,8 +537,10 @@ bool mp3_check_type(rbstream_p rbsp)
 {
 	bool result = false;
 	uint8_t id3header[MP3_HEAD_ID3_TAG_LEN];
+	// Stream may start from a frame in the middle of source, after seeking.
+	ssize_t pos = rbsp->rd_size;
 
-	int retVal = _source_read_at(rbsp, 0, id3header, sizeof(id3header));
+	int retVal = _source_read_at(rbsp, pos, id3header, sizeof(id3header));
 	RETURN_VAL_IF_FAIL((retVal == (ssize_t) sizeof(id3header)), false);
 
 	if (memcmp("ID3", id3header, 3) == OK) {
@@ -456,7 +548,6 @@ bool mp3_check_type(rbstream_p rbsp)
 	}
 
 	int value = rbs_ctrl(rbsp, OPTION_ALLOW_TO_DEQUEUE, 0);
-	ssize_t pos = 0;
 	result = mp3_resync(rbsp, 0, &pos, NULL);
 	rbs_ctrl(rbsp, OPTION_ALLOW_TO_DEQUEUE, value);
 
@@ -505,10 +596,12 @@ static bool aac_resync(rbstream_p fp, ssize_t *inout_pos)
 			continue;
 		}
 
-		if (!AAC_ADTS_SYNC_VERIFY(buf_ptr)) {
-			++pos;
-			++buf_ptr;
-			--remainingBytes;
+		// Skip to the next ADTS syncword, all candidates in window at once.
+		size_t skip = _sync_scan(buf_ptr, remainingBytes - AAC_ADTS_FRAME_HEADER_LEN + 1, AAC_ADTS_SYNC_BYTE0, AAC_ADTS_SYNC_BYTE1_MASK, AAC_ADTS_SYNC_BYTE1);
+		if (skip > 0) {
+			pos += skip;
+			buf_ptr += skip;
+			remainingBytes -= skip;
 			continue;
 		}
 
@@ -520,18 +613,18 @@ static bool aac_resync(rbstream_p fp, ssize_t *inout_pos)
 		int j;
 		for (j = 0; j < FRAME_MATCH_REQUIRED; ++j) {
 			uint8_t temp[AAC_ADTS_FRAME_HEADER_LEN];
-			ssize_t retval = _source_read_at(fp, test_pos, temp, sizeof(temp));
-			if (retval < (ssize_t) sizeof(temp)) {
+			const uint8_t *test_ptr = _window_at(fp, buf_ptr, pos, remainingBytes, test_pos, temp, sizeof(temp));
+			if (test_ptr == NULL) {
 				valid = false;
 				break;
 			}
 
-			if (!AAC_ADTS_SYNC_VERIFY(temp)) {
+			if (!AAC_ADTS_SYNC_VERIFY(test_ptr)) {
 				valid = false;
 				break;
 			}
 
-			int test_frame_size = AAC_ADTS_FRAME_GETSIZE(temp);
+			int test_frame_size = AAC_ADTS_FRAME_GETSIZE(test_ptr);
 			test_pos += test_frame_size;
 		}
 
@@ -597,15 +690,15 @@ bool aac_check_type(rbstream_p rbsp)
 {
 	bool result = false;
 	uint8_t syncword[AAC_ADIF_SYNC_LEN];
+	ssize_t pos = rbsp->rd_size;
 
-	ssize_t rlen = _source_read_at(rbsp, 0, syncword, sizeof(syncword));
+	ssize_t rlen = _source_read_at(rbsp, pos, syncword, sizeof(syncword));
 	RETURN_VAL_IF_FAIL((rlen == (ssize_t) sizeof(syncword)), false);
 
 	// Don't support ADIF
 	RETURN_VAL_IF_FAIL((memcmp(AAC_ADIF_SYNC_DATA, syncword, AAC_ADIF_SYNC_LEN) != OK), false);
 
 	int value = rbs_ctrl(rbsp, OPTION_ALLOW_TO_DEQUEUE, 0);
-	ssize_t pos = 0;
 	result = aac_resync(rbsp, &pos);
 	rbs_ctrl(rbsp, OPTION_ALLOW_TO_DEQUEUE, value);
 
@@ -655,6 +748,15 @@ static bool opus_resync(rbstream_p fp, ssize_t *inout_pos)
 			continue;
 		}
 
+		// Skip to the next "Op", all candidates in window at once.
+		size_t skip = _sync_scan(buf_ptr, remainingBytes - OPUS_PACKET_HEADER_LEN + 1, OPUS_SYNC_BYTE0, 0xff, OPUS_SYNC_BYTE1);
+		if (skip > 0) {
+			pos += skip;
+			buf_ptr += skip;
+			remainingBytes -= skip;
+			continue;
+		}
+
 		if (!OPUS_PACKET_SYNC_VERIFY(buf_ptr)) {
 			++pos;
 			++buf_ptr;
@@ -670,18 +772,18 @@ static bool opus_resync(rbstream_p fp, ssize_t *inout_pos)
 		int j;
 		for (j = 0; j < FRAME_MATCH_REQUIRED; ++j) {
 			uint8_t temp[OPUS_PACKET_HEADER_LEN];
-			ssize_t retval = _source_read_at(fp, test_pos, temp, sizeof(temp));
-			if (retval < (ssize_t) sizeof(temp)) {
+			const uint8_t *test_ptr = _window_at(fp, buf_ptr, pos, remainingBytes, test_pos, temp, sizeof(temp));
+			if (test_ptr == NULL) {
 				valid = false;
 				break;
 			}
 
-			if (!OPUS_PACKET_SYNC_VERIFY(temp)) {
+			if (!OPUS_PACKET_SYNC_VERIFY(test_ptr)) {
 				valid = false;
 				break;
 			}
 
-			int test_frame_size = OPUS_PACKET_GETSIZE(temp);
+			int test_frame_size = OPUS_PACKET_GETSIZE(test_ptr);
 			test_pos += test_frame_size;
 		}
 
@@ -747,7 +849,7 @@ bool opus_check_type(rbstream_p rbsp)
 {
 	bool result = false;
 	int value = rbs_ctrl(rbsp, OPTION_ALLOW_TO_DEQUEUE, 0);
-	ssize_t pos = 0;
+	ssize_t pos = rbsp->rd_size;
 	result = opus_resync(rbsp, &pos);
 	rbs_ctrl(rbsp, OPTION_ALLOW_TO_DEQUEUE, value);
 
@@ -779,21 +881,30 @@ bool _get_frame(audio_decoder_p decoder)
 	priv_data_p priv = (priv_data_p) decoder->priv_data;
 	assert(priv != NULL);
 
+	uint32_t size = 0;
+	bool ret;
+
 	switch (decoder->audio_type) {
 	case AUDIO_TYPE_MP3: {
 		tPVMP3DecoderExternal *mp3_ext = (tPVMP3DecoderExternal *) decoder->dec_ext;
-		return mp3_get_frame(decoder->rbsp, &priv->mCurrentPos, priv->mFixedHeader, (void *)mp3_ext->pInputBuffer, (uint32_t *)&mp3_ext->inputBufferCurrentLength);
+		ret = mp3_get_frame(decoder->rbsp, &priv->mCurrentPos, priv->mFixedHeader, (void *)mp3_ext->pInputBuffer, (uint32_t *)&mp3_ext->inputBufferCurrentLength);
+		size = mp3_ext->inputBufferCurrentLength;
+		break;
 	}
 
 	case AUDIO_TYPE_AAC: {
 		tPVMP4AudioDecoderExternal *aac_ext = (tPVMP4AudioDecoderExternal *) decoder->dec_ext;
-		return aac_get_frame(decoder->rbsp, &priv->mCurrentPos, (void *)aac_ext->pInputBuffer, (uint32_t *)&aac_ext->inputBufferCurrentLength);
+		ret = aac_get_frame(decoder->rbsp, &priv->mCurrentPos, (void *)aac_ext->pInputBuffer, (uint32_t *)&aac_ext->inputBufferCurrentLength);
+		size = aac_ext->inputBufferCurrentLength;
+		break;
 	}
 
 #ifdef CONFIG_CODEC_LIBOPUS
 	case AUDIO_TYPE_OPUS: {
 		opus_dec_external_t *opus_ext = (opus_dec_external_t *) decoder->dec_ext;
-		return opus_get_frame(decoder->rbsp, &priv->mCurrentPos, (void *)opus_ext->pInputBuffer, (uint32_t *)&opus_ext->inputBufferCurrentLength);
+		ret = opus_get_frame(decoder->rbsp, &priv->mCurrentPos, (void *)opus_ext->pInputBuffer, (uint32_t *)&opus_ext->inputBufferCurrentLength);
+		size = opus_ext->inputBufferCurrentLength;
+		break;
 	}
 #endif
 
@@ -801,6 +912,63 @@ bool _get_frame(audio_decoder_p decoder)
 		medwdbg("[%s] unsupported audio type: %d\n", __FUNCTION__, decoder->audio_type);
 		return false;
 	}
+
+	if (ret) {
+		// *_get_frame() moves read position to the end of frame got.
+		priv->mFramePos = priv->mCurrentPos - size;
+	}
+
+	return ret;
+}
+
+// Reset codec state for decoding from another frame, after seeking.
+static void _reset_decoder(audio_decoder_p decoder)
+{
+	RETURN_IF_FAIL(decoder->dec_ext != NULL && decoder->dec_mem != NULL);
+
+	switch (decoder->audio_type) {
+	case AUDIO_TYPE_MP3:
+		pvmp3_InitDecoder((tPVMP3DecoderExternal *) decoder->dec_ext, decoder->dec_mem);
+		break;
+
+	case AUDIO_TYPE_AAC:
+		PVMP4AudioDecoderResetBuffer(decoder->dec_mem);
+		break;
+
+#ifdef CONFIG_CODEC_LIBOPUS
+	case AUDIO_TYPE_OPUS:
+		opus_initDecoder((opus_dec_external_t *) decoder->dec_ext, decoder->dec_mem);
+		break;
+#endif
+
+	default:
+		break;
+	}
+}
+
+// Record the frame decoded in index, and drop samples before the seeking target.
+static void _update_position(priv_data_p priv, pcm_data_p pcm)
+{
+	RETURN_IF_FAIL(pcm->channels > 0);
+
+	uint32_t frames = pcm->length / pcm->channels;
+
+	frame_index_add(&priv->mIndex, (uint32_t)priv->mFramePos, priv->mSamplePos);
+	if (priv->mIndex.samplerate != pcm->samplerate) {
+		priv->mIndex.samplerate = pcm->samplerate;
+		priv->mIndex.dirty = true;
+	}
+
+	if (priv->mSkipTo > priv->mSamplePos) {
+		uint32_t skip = MINIMUM(priv->mSkipTo - priv->mSamplePos, frames);
+		pcm->samples += skip * pcm->channels;
+		pcm->length -= skip * pcm->channels;
+		if (pcm->length == 0) {
+			pcm->samples = NULL;
+		}
+	}
+
+	priv->mSamplePos += frames;
 }
 
 int _init_decoder(audio_decoder_p decoder, void *dec_ext)
@@ -808,10 +976,11 @@ int _init_decoder(audio_decoder_p decoder, void *dec_ext)
 	priv_data_p priv = (priv_data_p) decoder->priv_data;
 	assert(priv != NULL);
 
-	// Init private data
-	priv->mCurrentPos = 0;
+	// Init private data, decoding starts from the beginning of stream data pushed.
+	priv->mCurrentPos = decoder->rbsp->rd_size;
 	priv->mFixedHeader = 0;
 	memset(&(priv->pcm), 0, sizeof(pcm_data_t));
+	priv->mFramePos = priv->mCurrentPos;
 
 	switch (decoder->audio_type) {
 	case AUDIO_TYPE_MP3: {
@@ -863,7 +1032,6 @@ int _init_decoder(audio_decoder_p decoder, void *dec_ext)
 		int err = opus_initDecoder((opus_dec_external_t *) decoder->dec_ext, decoder->dec_mem);
 		RETURN_VAL_IF_FAIL((err == OPUS_OK), AUDIO_DECODER_ERROR);
 
-		priv->mCurrentPos = 0;
 		bool ret = opus_init(decoder->rbsp, &priv->mCurrentPos);
 		RETURN_VAL_IF_FAIL((ret == true), AUDIO_DECODER_ERROR);
 		break;
@@ -1073,6 +1241,8 @@ size_t audio_decoder_get_frames(audio_decoder_p decoder, unsigned char *buf, siz
 			meddbg("frame decoding failed!\n");
 			break;
 		}
+
+		_update_position(priv, pcm);
 	}
 
 	// Output sample rate if desired
@@ -1088,6 +1258,58 @@ size_t audio_decoder_get_frames(audio_decoder_p decoder, unsigned char *buf, siz
 	return size;
 }
 
+ssize_t audio_decoder_seek(audio_decoder_p decoder, uint32_t sample)
+{
+	assert(decoder != NULL);
+
+	priv_data_p priv = (priv_data_p) decoder->priv_data;
+	frame_index_entry_t entry = {0, 0};
+
+	// Restart from the beginning if nothing indexed yet.
+	frame_index_find(&priv->mIndex, sample, &entry);
+	medvdbg("seek to sample %u, restart from frame at %u sample %u\n", sample, entry.offset, entry.sample);
+
+	RETURN_VAL_IF_FAIL((rbs_reset(decoder->rbsp, entry.offset) == OK), AUDIO_DECODER_ERROR);
+
+	priv->mCurrentPos = entry.offset;
+	priv->mFramePos = entry.offset;
+	priv->mSamplePos = entry.sample;
+	priv->mSkipTo = sample;
+	priv->pcm.samples = NULL;
+	priv->pcm.length = 0;
+
+	_reset_decoder(decoder);
+
+	return (ssize_t) entry.offset;
+}
+
+int audio_decoder_get_duration(audio_decoder_p decoder, uint32_t *samples, unsigned int *samplerate)
+{
+	assert(decoder != NULL);
+
+	priv_data_p priv = (priv_data_p) decoder->priv_data;
+	RETURN_VAL_IF_FAIL((priv->mIndex.complete && priv->mIndex.samplerate != 0), AUDIO_DECODER_ERROR);
+
+	*samples = priv->mIndex.total_samples;
+	*samplerate = priv->mIndex.samplerate;
+	return AUDIO_DECODER_OK;
+}
+
+void audio_decoder_complete_index(audio_decoder_p decoder)
+{
+	assert(decoder != NULL);
+
+	priv_data_p priv = (priv_data_p) decoder->priv_data;
+	frame_index_complete(&priv->mIndex, priv->mSamplePos);
+}
+
+frame_index_p audio_decoder_get_index(audio_decoder_p decoder)
+{
+	assert(decoder != NULL);
+
+	priv_data_p priv = (priv_data_p) decoder->priv_data;
+	return &priv->mIndex;
+}
 
 int audio_decoder_init(audio_decoder_p decoder, size_t rbuf_size)
 {
@@ -1099,6 +1321,11 @@ int audio_decoder_init(audio_decoder_p decoder, size_t rbuf_size)
 	// init private data
 	priv->mCurrentPos = 0;
 	priv->mFixedHeader = 0;
+	memset(&(priv->pcm), 0, sizeof(pcm_data_t));
+	priv->mFramePos = 0;
+	priv->mSamplePos = 0;
+	priv->mSkipTo = 0;
+	frame_index_init(&priv->mIndex, CONFIG_MEDIA_FRAME_INDEX_INTERVAL, CONFIG_MEDIA_FRAME_INDEX_MAX_ENTRIES);
 
 	// init decoder data
 	decoder->cb_data = NULL;
@@ -1153,6 +1380,7 @@ int audio_decoder_finish(audio_decoder_p decoder)
 
 	// free private data buffer
 	if (decoder->priv_data != NULL) {
+		frame_index_free(&((priv_data_p) decoder->priv_data)->mIndex);
 		free(decoder->priv_data);
 		decoder->priv_data = NULL;
 	}
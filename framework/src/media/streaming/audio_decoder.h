@@ -21,6 +21,7 @@
 
 #include "../utils/rb.h"
 #include "../utils/rbs.h"
+#include "../utils/frame_index.h"
 #include <audiocodec/mp3dec/pvmp3decoder_api.h>
 #include <audiocodec/aacdec/pvmp4audiodecoder_api.h>
 #include <media/MediaTypes.h>
@@ -162,6 +163,44 @@ int audio_decoder_init_decoder(audio_decoder_p decoder, int audio_type, void *de
  */
 size_t audio_decoder_get_frames(audio_decoder_p decoder, unsigned char *buf, size_t max, unsigned int *sr, unsigned short *ch);
 
+/**
+ * @brief  Seek to the given sample position with frame index.
+ *         Decoding restarts from the last frame indexed before the position,
+ *         samples before the position are dropped. Data in decoder is dropped,
+ *         user must push audio source data started from the offset returned.
+ *
+ * @param  decoder : Pointer to decoder object
+ * @param  sample : sample position (in PCM frames) desired
+ * @return offset in bytes of the source to push data from, -1 on failure.
+ */
+ssize_t audio_decoder_seek(audio_decoder_p decoder, uint32_t sample);
+
+/**
+ * @brief  Get duration of the audio stream, it's known after the whole stream
+ *         was indexed by decoding, or after a complete index was loaded.
+ *
+ * @param  decoder : Pointer to decoder object
+ * @param  samples : total number of samples (in PCM frames)
+ * @param  samplerate : Sample rate (Hz) of the output PCM data
+ * @return 0 on success, -1 if duration is unknown yet.
+ */
+int audio_decoder_get_duration(audio_decoder_p decoder, uint32_t *samples, unsigned int *samplerate);
+
+/**
+ * @brief  Mark frame index complete, called when all source data was pushed and decoded.
+ *
+ * @param  decoder : Pointer to decoder object
+ */
+void audio_decoder_complete_index(audio_decoder_p decoder);
+
+/**
+ * @brief  Get frame index built while decoding, e.g. to save or load it.
+ *
+ * @param  decoder : Pointer to decoder object
+ * @return Pointer to frame index of decoder.
+ */
+frame_index_p audio_decoder_get_index(audio_decoder_p decoder);
+
 } // namespace media
 
 #endif /* STREAMING_DECODER_H */
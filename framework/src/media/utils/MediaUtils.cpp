@@ -16,6 +16,8 @@
  *
  ******************************************************************/
 
+#include <tinyara/config.h>
+#include <time.h>
 #include "MediaUtils.h"
 #include <debug.h>
 
@@ -73,5 +75,16 @@ audio_type_t getAudioTypeFromPath(std::string datapath)
 		return AUDIO_TYPE_INVALID;
 	}
 }
+
+uint64_t getCurrentTimeUs(void)
+{
+	struct timespec ts;
+#ifdef CONFIG_CLOCK_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+	clock_gettime(CLOCK_REALTIME, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
 } // namespace util
 } // namespace media
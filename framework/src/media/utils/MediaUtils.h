@@ -30,6 +30,7 @@
 #define __MEDIA_UTILS_H
 
 #include <string>
+#include <stdint.h>
 #include <media/MediaTypes.h>
 
 namespace media {
@@ -57,6 +58,13 @@ void toUpperString(std::string& str);
  * @since TizenRT v2.0 PRE
  */
 audio_type_t getAudioTypeFromPath(std::string path);
+/**
+ * @brief Gets the current time of monotonic clock, realtime clock if it's not supported.
+ * @details @b #include <media/MediaUtils.h>
+ * @return The current time in microseconds
+ * @since TizenRT v2.0
+ */
+uint64_t getCurrentTimeUs(void);
 } // namespace utils
 } // namespace media
 
@@ -0,0 +1,241 @@
+/******************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <debug.h>
+#include "frame_index.h"
+#include "internal_defs.h"
+
+#define FRAME_INDEX_MAGIC       0x58444946  /* "FIDX" */
+#define FRAME_INDEX_VERSION     1
+#define FRAME_INDEX_MIN_CAPACITY 16
+
+/* Header of the index file, followed by 'count' entries */
+struct frame_index_file_s {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t source_size;
+	uint32_t interval;
+	uint32_t samplerate;
+	uint32_t total_samples;
+	uint32_t complete;
+	uint32_t count;
+};
+
+static bool _reserve(frame_index_p fip, size_t count)
+{
+	if (count <= fip->capacity) {
+		return true;
+	}
+
+	size_t capacity = fip->capacity ? fip->capacity : FRAME_INDEX_MIN_CAPACITY;
+	while (capacity < count) {
+		capacity <<= 1;
+	}
+	capacity = MINIMUM(capacity, fip->max_entries);
+	RETURN_VAL_IF_FAIL(capacity >= count, false);
+
+	frame_index_entry_t *entries = (frame_index_entry_t *)realloc(fip->entries, capacity * sizeof(frame_index_entry_t));
+	RETURN_VAL_IF_FAIL(entries != NULL, false);
+
+	fip->entries = entries;
+	fip->capacity = capacity;
+	return true;
+}
+
+// Keep every other entry and double the interval, the first entry is always kept.
+static void _thin(frame_index_p fip)
+{
+	size_t i;
+	for (i = 0; i * 2 < fip->count; i++) {
+		fip->entries[i] = fip->entries[i * 2];
+	}
+	fip->count = i;
+	fip->interval <<= 1;
+}
+
+void frame_index_init(frame_index_p fip, unsigned int interval, size_t max_entries)
+{
+	memset(fip, 0, sizeof(frame_index_t));
+	fip->interval = interval ? interval : 1;
+	fip->max_entries = (max_entries > 2) ? max_entries : 2;
+}
+
+void frame_index_free(frame_index_p fip)
+{
+	free(fip->entries);
+	fip->entries = NULL;
+	fip->count = 0;
+	fip->capacity = 0;
+	fip->pending = 0;
+	fip->complete = false;
+	fip->total_samples = 0;
+}
+
+bool frame_index_add(frame_index_p fip, uint32_t offset, uint32_t sample)
+{
+	if (fip->count > 0) {
+		frame_index_entry_t *last = &fip->entries[fip->count - 1];
+		if (offset <= last->offset) {
+			// Inside the range indexed already
+			fip->pending = 0;
+			return false;
+		}
+
+		if (++fip->pending < fip->interval) {
+			return false;
+		}
+	}
+
+	if (fip->count == fip->max_entries) {
+		_thin(fip);
+		if (fip->pending < fip->interval) {
+			return false;
+		}
+	}
+
+	if (!_reserve(fip, fip->count + 1)) {
+		meddbg("frame index: fail to allocate %zu entries\n", fip->count + 1);
+		return false;
+	}
+
+	fip->entries[fip->count].offset = offset;
+	fip->entries[fip->count].sample = sample;
+	fip->count++;
+	fip->pending = 0;
+	fip->dirty = true;
+	return true;
+}
+
+void frame_index_complete(frame_index_p fip, uint32_t total_samples)
+{
+	if (!fip->complete || fip->total_samples != total_samples) {
+		fip->complete = true;
+		fip->total_samples = total_samples;
+		fip->dirty = true;
+	}
+}
+
+bool frame_index_find(frame_index_p fip, uint32_t sample, frame_index_entry_t *entry)
+{
+	RETURN_VAL_IF_FAIL(fip->count > 0, false);
+
+	// Last entry whose sample <= desired, the first one if none.
+	size_t lo = 0;
+	size_t hi = fip->count;
+	while (hi - lo > 1) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (fip->entries[mid].sample <= sample) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	*entry = fip->entries[lo];
+	return true;
+}
+
+uint32_t frame_index_bitrate(frame_index_p fip)
+{
+	RETURN_VAL_IF_FAIL(fip->count > 1 && fip->samplerate > 0, 0);
+
+	frame_index_entry_t *first = &fip->entries[0];
+	frame_index_entry_t *last = &fip->entries[fip->count - 1];
+	RETURN_VAL_IF_FAIL(last->sample > first->sample, 0);
+
+	return (uint32_t)((uint64_t)(last->offset - first->offset) * 8 * fip->samplerate / (last->sample - first->sample));
+}
+
+bool frame_index_save(frame_index_p fip, const char *path, uint32_t source_size)
+{
+	struct frame_index_file_s header;
+	bool ret = false;
+
+	FILE *fp = fopen(path, "wb");
+	RETURN_VAL_IF_FAIL(fp != NULL, false);
+
+	header.magic = FRAME_INDEX_MAGIC;
+	header.version = FRAME_INDEX_VERSION;
+	header.source_size = source_size;
+	header.interval = fip->interval;
+	header.samplerate = fip->samplerate;
+	header.total_samples = fip->total_samples;
+	header.complete = fip->complete;
+	header.count = fip->count;
+
+	GOTO_IF_FAIL(fwrite(&header, sizeof(header), 1, fp) == 1, done);
+	if (fip->count > 0) {
+		GOTO_IF_FAIL(fwrite(fip->entries, sizeof(frame_index_entry_t), fip->count, fp) == fip->count, done);
+	}
+
+	fip->dirty = false;
+	ret = true;
+
+done:
+	if (fclose(fp) != OK) {
+		ret = false;
+	}
+	if (!ret) {
+		meddbg("frame index: fail to save %s\n", path);
+		remove(path);
+	}
+	return ret;
+}
+
+bool frame_index_load(frame_index_p fip, const char *path, uint32_t source_size)
+{
+	struct frame_index_file_s header;
+	frame_index_entry_t *entries = NULL;
+	bool ret = false;
+
+	FILE *fp = fopen(path, "rb");
+	RETURN_VAL_IF_FAIL(fp != NULL, false);
+
+	GOTO_IF_FAIL(fread(&header, sizeof(header), 1, fp) == 1, done);
+	GOTO_IF_FAIL(header.magic == FRAME_INDEX_MAGIC && header.version == FRAME_INDEX_VERSION, done);
+	GOTO_IF_FAIL(header.source_size == source_size, done);
+	GOTO_IF_FAIL(header.interval > 0 && header.count <= fip->max_entries, done);
+
+	if (header.count > 0) {
+		entries = (frame_index_entry_t *)malloc(header.count * sizeof(frame_index_entry_t));
+		GOTO_IF_FAIL(entries != NULL, done);
+		GOTO_IF_FAIL(fread(entries, sizeof(frame_index_entry_t), header.count, fp) == header.count, done);
+	}
+
+	free(fip->entries);
+	fip->entries = entries;
+	fip->count = header.count;
+	fip->capacity = header.count;
+	fip->interval = header.interval;
+	fip->pending = 0;
+	fip->samplerate = header.samplerate;
+	fip->total_samples = header.total_samples;
+	fip->complete = (header.complete != 0);
+	fip->dirty = false;
+	entries = NULL;
+	ret = true;
+
+done:
+	free(entries);
+	fclose(fp);
+	medvdbg("frame index: load %s %s\n", path, ret ? "done" : "failed");
+	return ret;
+}
@@ -0,0 +1,130 @@
+/******************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#ifndef _FRAME_INDEX_H_
+#define _FRAME_INDEX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Sparse index of compressed audio frames, built while decoding.
+ * Each entry maps byte offset of a frame in the source to the sample position
+ * (in PCM frames) of its first output sample. One entry is kept every
+ * 'interval' frames, when the table is full the interval is doubled and every
+ * other entry is dropped, so memory is bounded by max_entries.
+ */
+struct frame_index_entry_s {
+	uint32_t offset;            /* byte offset of the frame in source      */
+	uint32_t sample;            /* sample position of the frame            */
+};
+
+typedef struct frame_index_entry_s frame_index_entry_t;
+
+struct frame_index_s {
+	frame_index_entry_t *entries;   /* entries in ascending order          */
+	size_t count;               /* number of entries                       */
+	size_t capacity;            /* number of entries allocated             */
+	size_t max_entries;         /* maximum number of entries               */
+	unsigned int interval;      /* frames between two entries              */
+	unsigned int pending;       /* frames appended since the last entry    */
+	unsigned int samplerate;    /* sample rate of decoded PCM, 0 unknown   */
+	uint32_t total_samples;     /* length of stream, valid if complete     */
+	bool complete;              /* whole stream indexed until end          */
+	bool dirty;                 /* changed since loaded or saved           */
+};
+
+typedef struct frame_index_s frame_index_t;
+typedef struct frame_index_s *frame_index_p;
+
+/**
+ * @brief  Initialize an empty frame index.
+ * @param  fip: Pointer to the frame index object
+ * @param  interval: number of frames between two entries, at least 1
+ * @param  max_entries: maximum number of entries kept, at least 2
+ */
+void frame_index_init(frame_index_p fip, unsigned int interval, size_t max_entries);
+
+/**
+ * @brief  Release memory of entries, the index becomes empty.
+ * @param  fip: Pointer to the frame index object
+ */
+void frame_index_free(frame_index_p fip);
+
+/**
+ * @brief  Add a decoded frame. Frames must be added in stream order, frames
+ *         at or before the last entry are ignored (e.g. decoding again after
+ *         seeking back), so it's fine to add every frame decoded.
+ * @param  fip: Pointer to the frame index object
+ * @param  offset: byte offset of the frame in source
+ * @param  sample: sample position of the first sample of the frame
+ * @return true if the frame was recorded as an entry.
+ */
+bool frame_index_add(frame_index_p fip, uint32_t offset, uint32_t sample);
+
+/**
+ * @brief  Mark the stream indexed until end.
+ * @param  fip: Pointer to the frame index object
+ * @param  total_samples: total number of samples of the stream
+ */
+void frame_index_complete(frame_index_p fip, uint32_t total_samples);
+
+/**
+ * @brief  Find the last entry at or before the sample position, in O(log n).
+ * @param  fip: Pointer to the frame index object
+ * @param  sample: sample position desired
+ * @param  entry: Pointer to the entry saving result
+ * @return true if found, false if the index is empty.
+ */
+bool frame_index_find(frame_index_p fip, uint32_t sample, frame_index_entry_t *entry);
+
+/**
+ * @brief  Get average bitrate of the source over the range indexed.
+ * @param  fip: Pointer to the frame index object
+ * @return bits per second, 0 if it's unknown yet.
+ */
+uint32_t frame_index_bitrate(frame_index_p fip);
+
+/**
+ * @brief  Save the index to a file.
+ * @param  fip: Pointer to the frame index object
+ * @param  path: path of the index file
+ * @param  source_size: size of the source, used to verify the index on loading
+ * @return true on success, false on failure.
+ */
+bool frame_index_save(frame_index_p fip, const char *path, uint32_t source_size);
+
+/**
+ * @brief  Load the index saved by frame_index_save(), entries kept already
+ *         are replaced. The file is rejected if source size doesn't match.
+ * @param  fip: Pointer to the frame index object
+ * @param  path: path of the index file
+ * @param  source_size: size of the source
+ * @return true on success, false on failure, the index is unchanged then.
+ */
+bool frame_index_load(frame_index_p fip, const char *path, uint32_t source_size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -24,8 +24,13 @@
 #include "rb.h"
 #include "internal_defs.h"
 
-#define IS_EMPTY(rbp) (rbp->rd_idx == rbp->wr_idx)
-#define IS_FULL(rbp) ((rbp->rd_idx & IDX_MASK) == (rbp->wr_idx & IDX_MASK) && (rbp->rd_idx & MSB_MASK) != (rbp->wr_idx & MSB_MASK))
+/*
+ * Indexes are published with release semantics after data was copied, and loaded
+ * with acquire semantics before data is copied. So one producer and one consumer
+ * can access the ring-buffer concurrently without any lock.
+ */
+#define LOAD_IDX(idx) __atomic_load_n(&(idx), __ATOMIC_ACQUIRE)
+#define STORE_IDX(idx, val) __atomic_store_n(&(idx), (val), __ATOMIC_RELEASE)
 
 /**
  * @brief  Increase the buffer index while writing or reading the ring-buffer.
@@ -38,6 +43,16 @@
  */
 static void _incr(rb_p rbp, volatile size_t *p_idx, size_t len);
 
+/**
+ * @brief  Split 'len' bytes started from the buffer index into contiguous regions.
+ *
+ * @param  rbp: Pointer to the ring-buffer
+ * @param  idx: Buffer index the regions start from (MSB ignored)
+ * @param  len: Total length of the regions, no more than rbp->depth
+ * @param  span: Pointer to the span saving regions
+ */
+static void _span(rb_p rbp, size_t idx, size_t len, rb_span_t *span);
+
 bool rb_init(rb_p rbp, size_t size)
 {
 	RETURN_VAL_IF_FAIL(rbp != NULL, false);
@@ -64,12 +79,15 @@ size_t rb_used(rb_p rbp)
 {
 	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
 
-	if (IS_EMPTY(rbp)) {
+	size_t wr_idx = LOAD_IDX(rbp->wr_idx);
+	size_t rd_idx = LOAD_IDX(rbp->rd_idx);
+
+	if (wr_idx == rd_idx) {
 		return SIZE_ZERO;
 	}
 
-	size_t wr_idx = (rbp->wr_idx & IDX_MASK);
-	size_t rd_idx = (rbp->rd_idx & IDX_MASK);
+	wr_idx = (wr_idx & IDX_MASK);
+	rd_idx = (rd_idx & IDX_MASK);
 
 	if (wr_idx > rd_idx) {
 		return (wr_idx - rd_idx);
@@ -155,12 +173,55 @@ size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset)
 	return len;
 }
 
+size_t rb_acquire_write(rb_p rbp, size_t len, rb_span_t *span)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+	RETURN_VAL_IF_FAIL(span != NULL, SIZE_ZERO);
+
+	// MINIMUM() evaluates its arguments twice, the other side may move in between.
+	size_t avail = rb_avail(rbp);
+	len = MINIMUM(len, avail);
+	_span(rbp, rbp->wr_idx, len, span);
+	return len;
+}
+
+size_t rb_commit_write(rb_p rbp, size_t len)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+
+	size_t avail = rb_avail(rbp);
+	len = MINIMUM(len, avail);
+	_incr(rbp, &rbp->wr_idx, len);
+	return len;
+}
+
+size_t rb_acquire_read(rb_p rbp, size_t len, rb_span_t *span)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+	RETURN_VAL_IF_FAIL(span != NULL, SIZE_ZERO);
+
+	size_t used = rb_used(rbp);
+	len = MINIMUM(len, used);
+	_span(rbp, rbp->rd_idx, len, span);
+	return len;
+}
+
+size_t rb_commit_read(rb_p rbp, size_t len)
+{
+	RETURN_VAL_IF_FAIL(rbp != NULL, SIZE_ZERO);
+
+	size_t used = rb_used(rbp);
+	len = MINIMUM(len, used);
+	_incr(rbp, &rbp->rd_idx, len);
+	return len;
+}
+
 bool rb_reset(rb_p rbp)
 {
 	RETURN_VAL_IF_FAIL(rbp != NULL, false);
 
-	rbp->rd_idx = 0;
-	rbp->wr_idx = 0;
+	STORE_IDX(rbp->rd_idx, 0);
+	STORE_IDX(rbp->wr_idx, 0);
 
 	return true;
 }
@@ -176,5 +237,23 @@ static void _incr(rb_p rbp, volatile size_t *p_idx, size_t len)
 		idx -= rbp->depth;
 	}
 
-	*p_idx = msb | idx;
+	STORE_IDX(*p_idx, msb | idx);
+}
+
+static void _span(rb_p rbp, size_t idx, size_t len, rb_span_t *span)
+{
+	idx = (idx & IDX_MASK);
+	size_t len_part = rbp->depth - idx;
+
+	span->ptr[0] = (void *)((uint8_t *)rbp->buf + idx);
+	if (len > len_part) {
+		// Region wraps around the end of ring buffer, the remained part starts at the beginning.
+		span->len[0] = len_part;
+		span->ptr[1] = rbp->buf;
+		span->len[1] = len - len_part;
+	} else {
+		span->len[0] = len;
+		span->ptr[1] = NULL;
+		span->len[1] = SIZE_ZERO;
+	}
 }
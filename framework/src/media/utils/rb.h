@@ -30,7 +30,11 @@ extern "C" {
 #define IDX_MASK (SIZE_MAX>>1)
 #define MSB_MASK (~IDX_MASK)    /* also the maximum value of the buffer depth */
 
-/* ring buffer structure */
+/*
+ * ring buffer structure
+ * One producer and one consumer may access it concurrently without locking,
+ * more producers or consumers must be serialized by the caller.
+ */
 struct rb_s {
 	void *buf;                  /* pointer to the buffer allocated   */
 	size_t depth;               /* maximum size of the ring buffer   */
@@ -41,6 +45,14 @@ struct rb_s {
 typedef struct rb_s  rb_t;
 typedef struct rb_s *rb_p;
 
+/* contiguous regions of the ring-buffer, region[1] is used on wrap-around */
+struct rb_span_s {
+	void *ptr[2];               /* start address of each region      */
+	size_t len[2];              /* length in bytes of each region    */
+};
+
+typedef struct rb_span_s rb_span_t;
+
 /**
  * @brief  Initialize the ring-buffer. Allocate necessary memory for the buffer.
  * @param  rbp : Pointer to the ring-buffer object
@@ -102,6 +114,44 @@ size_t rb_read(rb_p rbp, void *ptr, size_t len);
  */
 size_t rb_read_ext(rb_p rbp, void *ptr, size_t len, size_t offset);
 
+/**
+ * @brief  Get free space of the ring-buffer as (at most two) contiguous regions,
+ *         so that data can be produced in place. wr_idx will not be increased
+ *         until rb_commit_write() is called.
+ * @param  rbp : Pointer to the ring-buffer object
+ * @param  len : maximum length of the space desired
+ * @param  span: Pointer to the span saving regions acquired
+ * @return total size of the regions acquired, range[0, len]
+ */
+size_t rb_acquire_write(rb_p rbp, size_t len, rb_span_t *span);
+
+/**
+ * @brief  Make data produced in the regions got by rb_acquire_write() visible.
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  len: length of the data produced
+ * @return size wr_idx increased, range[0, len]
+ */
+size_t rb_commit_write(rb_p rbp, size_t len);
+
+/**
+ * @brief  Get data of the ring-buffer as (at most two) contiguous regions,
+ *         so that data can be consumed in place. rd_idx will not be increased
+ *         until rb_commit_read() is called.
+ * @param  rbp : Pointer to the ring-buffer object
+ * @param  len : maximum length of the data desired
+ * @param  span: Pointer to the span saving regions acquired
+ * @return total size of the regions acquired, range[0, len]
+ */
+size_t rb_acquire_read(rb_p rbp, size_t len, rb_span_t *span);
+
+/**
+ * @brief  Release data consumed in the regions got by rb_acquire_read().
+ * @param  rbp: Pointer to the ring-buffer object
+ * @param  len: length of the data consumed
+ * @return size rd_idx increased, range[0, len]
+ */
+size_t rb_commit_read(rb_p rbp, size_t len);
+
 /**
  * @brief  Reset ring-buffer, data in ring-buffer will be dropped.
  * @param  rbp: Pointer to the ring-buffer object
@@ -213,6 +213,18 @@ int rbs_seek_ext(rbstream_p rbsp, ssize_t offset, int whence)
 	return ret;
 }
 
+int rbs_reset(rbstream_p rbsp, size_t pos)
+{
+	medvdbg("[%s] pos %zu\n", __FUNCTION__, pos);
+	RETURN_VAL_IF_FAIL(rbsp != NULL, ERROR);
+	RETURN_VAL_IF_FAIL(rb_reset(rbsp->rbp), ERROR);
+
+	rbsp->rd_size = pos;
+	rbsp->cur_pos = pos;
+	rbsp->wr_size = pos;
+	return OK;
+}
+
 int rbs_ctrl(rbstream_p rbsp, int option, int value)
 {
 	medvdbg("[%s] option %d value %d\n", __FUNCTION__, option, value);
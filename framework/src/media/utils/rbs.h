@@ -149,6 +149,17 @@ int rbs_seek(rbstream_p stream, ssize_t offset, int whence);
  */
 int rbs_seek_ext(rbstream_p stream, ssize_t offset, int whence);
 
+/**
+ * @brief  Drop all data in ring-buffer and restart the stream at given position.
+ *         Data pushed later is regarded as the stream data started from 'pos',
+ *         it's used after the source was seeked.
+ *
+ * @param  stream : Pointer to the ring-buffer stream
+ * @param  pos : new position of rd_size, cur_pos and wr_size
+ * @return 0 is returned on success. Otherwise, -1 is returned.
+ */
+int rbs_reset(rbstream_p stream, size_t pos);
+
 /**
  * @brief  Set options
  *
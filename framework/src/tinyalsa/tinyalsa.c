@@ -1333,13 +1333,25 @@ int pcm_avail_update(struct pcm *pcm)
 		return -EINVAL;
 	}
 
-	if (!(pcm->flags & PCM_MMAP)) {
-		return -EINVAL;
-	}
-
 	int count = 0;
 	int i;
 
+	if (!(pcm->flags & PCM_MMAP)) {
+		struct mq_attr attr;
+
+		if (!(pcm->flags & PCM_OUT)) {
+			return -EINVAL;
+		}
+
+		/* Buffers never enqueued yet, and buffers dequeued by kernel but not reused */
+		if (mq_getattr(pcm->mq, &attr) < 0) {
+			return -errno;
+		}
+		count = (pcm->buffer_cnt - pcm->buf_idx) + attr.mq_curmsgs;
+
+		return count * pcm->buffer_size;
+	}
+
 	/* We will count the number of bytes available in all the buffers which have not been enqueued */
 	if (pcm->flags & PCM_OUT) {
 		for (i = 0; i < pcm->buffer_cnt; i++) {
@@ -0,0 +1,322 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * fs/procfs/fs_procfspool.c
+ *
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <sys/statfs.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/kmalloc.h>
+#include <tinyara/fs/fs.h>
+#include <tinyara/fs/procfs.h>
+#include <tinyara/mm/pool.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifndef CONFIG_FS_PROCFS_EXCLUDE_POOLS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define POOL_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct pool_file_s {
+	struct procfs_file_s base;	/* Base open file structure */
+	unsigned int linesize;		/* Number of valid characters in line[] */
+	char line[POOL_LINELEN];	/* Pre-allocated buffer for formatted lines */
+};
+
+/* State of one read() while walking the pools */
+
+struct pool_read_s {
+	FAR struct pool_file_s *attr;	/* The open file */
+	FAR char *buffer;			/* User buffer */
+	size_t remaining;			/* Space left in the user buffer */
+	size_t totalsize;			/* Bytes copied to the user buffer */
+	off_t offset;				/* Bytes of the file still to be skipped */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int pool_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode);
+static int pool_close(FAR struct file *filep);
+static ssize_t pool_read(FAR struct file *filep, FAR char *buffer, size_t buflen);
+
+static int pool_dup(FAR const struct file *oldp, FAR struct file *newp);
+
+static int pool_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/****************************************************************************
+ * Public Variables
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations pool_operations = {
+	pool_open,					/* open */
+	pool_close,					/* close */
+	pool_read,					/* read */
+	NULL,						/* write */
+
+	pool_dup,					/* dup */
+
+	NULL,						/* opendir */
+	NULL,						/* closedir */
+	NULL,						/* readdir */
+	NULL,						/* rewinddir */
+
+	pool_stat					/* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pool_copyline
+ ****************************************************************************/
+
+static void pool_copyline(FAR struct pool_read_s *state)
+{
+	FAR struct pool_file_s *attr = state->attr;
+	size_t copysize;
+
+	copysize = procfs_memcpy(attr->line, attr->linesize, state->buffer, state->remaining, &state->offset);
+	state->totalsize += copysize;
+	state->buffer += copysize;
+	state->remaining -= copysize;
+}
+
+/****************************************************************************
+ * Name: pool_readone
+ *
+ * Description:
+ *   pool_foreach() callback, formats the line of one pool.
+ *
+ ****************************************************************************/
+
+static void pool_readone(FAR const struct poolinfo_s *info, FAR void *arg)
+{
+	FAR struct pool_read_s *state = (FAR struct pool_read_s *)arg;
+	FAR struct pool_file_s *attr = state->attr;
+
+	if (state->remaining == 0) {
+		return;
+	}
+
+	attr->linesize = snprintf(attr->line, POOL_LINELEN, "%-12s %6u %6u %6u %6u %10lu %6lu\n", info->name, (unsigned int)info->objsize, info->nobjects, info->nfree, info->minfree, info->nalloc, info->nfail);
+	pool_copyline(state);
+}
+
+/****************************************************************************
+ * Name: pool_open
+ ****************************************************************************/
+
+static int pool_open(FAR struct file *filep, FAR const char *relpath, int oflags, mode_t mode)
+{
+	FAR struct pool_file_s *attr;
+
+	fvdbg("Open '%s'\n", relpath);
+
+	/* PROCFS is read-only.  Any attempt to open with any kind of write
+	 * access is not permitted.
+	 */
+
+	if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0) {
+		fdbg("ERROR: Only O_RDONLY supported\n");
+		return -EACCES;
+	}
+
+	/* "pools" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "pools") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* Allocate a container to hold the file attributes */
+
+	attr = (FAR struct pool_file_s *)kmm_zalloc(sizeof(struct pool_file_s));
+	if (!attr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* Save the attributes as the open-specific state in filep->f_priv */
+
+	filep->f_priv = (FAR void *)attr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pool_close
+ ****************************************************************************/
+
+static int pool_close(FAR struct file *filep)
+{
+	FAR struct pool_file_s *attr;
+
+	/* Recover our private data from the struct file instance */
+
+	attr = (FAR struct pool_file_s *)filep->f_priv;
+	DEBUGASSERT(attr);
+
+	/* Release the file attributes structure */
+
+	kmm_free(attr);
+	filep->f_priv = NULL;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pool_read
+ ****************************************************************************/
+
+static ssize_t pool_read(FAR struct file *filep, FAR char *buffer, size_t buflen)
+{
+	struct pool_read_s state;
+
+	fvdbg("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+	/* Recover our private data from the struct file instance */
+
+	state.attr = (FAR struct pool_file_s *)filep->f_priv;
+	DEBUGASSERT(state.attr);
+
+	state.buffer = buffer;
+	state.remaining = buflen;
+	state.totalsize = 0;
+	state.offset = filep->f_pos;
+
+	state.attr->linesize = snprintf(state.attr->line, POOL_LINELEN, "%-12s %6s %6s %6s %6s %10s %6s\n", "NAME", "SIZE", "TOTAL", "FREE", "MIN", "ALLOCS", "FAILS");
+	pool_copyline(&state);
+
+	pool_foreach(pool_readone, &state);
+
+	if (state.totalsize > 0) {
+		filep->f_pos += state.totalsize;
+	}
+
+	return state.totalsize;
+}
+
+/****************************************************************************
+ * Name: pool_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int pool_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+	FAR struct pool_file_s *oldattr;
+	FAR struct pool_file_s *newattr;
+
+	fvdbg("Dup %p->%p\n", oldp, newp);
+
+	/* Recover our private data from the old struct file instance */
+
+	oldattr = (FAR struct pool_file_s *)oldp->f_priv;
+	DEBUGASSERT(oldattr);
+
+	/* Allocate a new container to hold the task and attribute selection */
+
+	newattr = (FAR struct pool_file_s *)kmm_malloc(sizeof(struct pool_file_s));
+	if (!newattr) {
+		fdbg("ERROR: Failed to allocate file attributes\n");
+		return -ENOMEM;
+	}
+
+	/* The copy the file attributes from the old attributes to the new */
+
+	memcpy(newattr, oldattr, sizeof(struct pool_file_s));
+
+	/* Save the new attributes in the new file structure */
+
+	newp->f_priv = (FAR void *)newattr;
+	return OK;
+}
+
+/****************************************************************************
+ * Name: pool_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int pool_stat(const char *relpath, struct stat *buf)
+{
+	/* "pools" is the only acceptable value for the relpath */
+
+	if (strcmp(relpath, "pools") != 0) {
+		fdbg("ERROR: relpath is '%s'\n", relpath);
+		return -ENOENT;
+	}
+
+	/* "pools" is the name for a read-only file */
+
+	buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+	buf->st_size = 0;
+	buf->st_blksize = 0;
+	buf->st_blocks = 0;
+	return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif							/* !CONFIG_FS_PROCFS_EXCLUDE_POOLS */
+#endif							/* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
@@ -179,6 +179,21 @@
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* With CONFIG_MM_TLSF, each power of two of free node sizes is split into
+ * MM_TLSF_SLCOUNT lists of equal size ranges.  The second level index takes
+ * the bits of a size following its most significant one, so the smallest
+ * chunk must have at least MM_TLSF_SLI of them.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#define MM_TLSF_SLI      CONFIG_MM_TLSF_SLI
+#define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLI)
+
+#if MM_TLSF_SLI < 1 || MM_TLSF_SLI > MM_MIN_SHIFT
+#error "CONFIG_MM_TLSF_SLI must be from 1 to MM_MIN_SHIFT"
+#endif
+#endif
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -353,14 +368,41 @@ struct mm_heap_s {
 	int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+	/* Free nodes are kept in doubly linked lists segregated by size.  A bit
+	 * of mm_flbitmap is set for each power of two having free nodes, and a
+	 * bit of mm_slbitmap[] for each of its lists which isn't empty.
+	 */
+
+	uint32_t mm_flbitmap;
+	uint16_t mm_slbitmap[MM_NNODES];
+	FAR struct mm_freenode_s *mm_freelist[MM_NNODES][MM_TLSF_SLCOUNT];
+#else
 	/* All free nodes are maintained in a doubly linked list.  This
 	 * array provides some hooks into the list at various points to
 	 * speed searches for free nodes.
 	 */
 
 	struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
 };
 
+#ifdef CONFIG_MM_TASK_CACHE
+/* Small chunks of the user heap cached by a thread.  There is one list for
+ * each chunk size up to MM_TCACHE_MAXCHUNK, linked through the first word of
+ * the user memory of the chunks.
+ */
+
+#define MM_TCACHE_MAXCHUNK MM_ALIGN_UP(CONFIG_MM_TASK_CACHE_MAXSIZE + SIZEOF_MM_ALLOCNODE)
+#define MM_TCACHE_NLISTS   (MM_TCACHE_MAXCHUNK >> MM_MIN_SHIFT)
+
+struct mm_tcache_s {
+	FAR void *list[MM_TCACHE_NLISTS];	/* Free chunks of each size */
+	uint8_t count[MM_TCACHE_NLISTS];	/* Number of chunks in each list */
+	size_t cached;				/* Total size of the cached chunks */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -424,6 +466,19 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart, size_t heapsi
 
 void umm_initialize(FAR void *heap_start, size_t heap_size);
 
+/* Functions contained in umm_tcache.c **************************************/
+
+#ifdef CONFIG_MM_TASK_CACHE
+struct tcb_s;					/* Forward reference */
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *umm_tcache_malloc(size_t size, mmaddress_t caller_retaddr);
+#else
+FAR void *umm_tcache_malloc(size_t size);
+#endif
+void umm_tcache_free(FAR void *mem);
+void umm_tcache_release(FAR struct tcb_s *tcb);
+#endif
+
 /* Functions contained in kmm_initialize.c **********************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -636,9 +691,16 @@ void mm_shrinkchunk(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node,
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c *********************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node);
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
+#ifdef CONFIG_MM_TLSF
+void mm_size2tlsf(size_t size, bool roundup, FAR int *fl, FAR int *sl);
+#endif
 
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 /* Functions contained in kmm_mallinfo.c . Used to display memory allocation details */
@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * include/tinyara/mm/pool.h
+ ****************************************************************************/
+
+#ifndef __INCLUDE_MM_POOL_H
+#define __INCLUDE_MM_POOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+/* Configuration ************************************************************/
+/* CONFIG_MM_POOL_ALIGN - Alignment of the objects of a pool, which should be
+ *   the size of a cache line so that no two objects share one.
+ */
+
+#ifndef CONFIG_MM_POOL_ALIGN
+#define CONFIG_MM_POOL_ALIGN 32
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+typedef FAR void *POOL_HANDLE;
+
+/* Statistics of one pool, as reported by pool_foreach() */
+
+struct poolinfo_s {
+	FAR const char *name;		/* Name given to pool_create() */
+	size_t objsize;				/* Size of one object after alignment */
+	unsigned int nobjects;		/* Number of objects in the pool */
+	unsigned int nfree;			/* Number of free objects */
+	unsigned int minfree;		/* Least number of free objects so far */
+	unsigned long nalloc;		/* Number of successful allocations */
+	unsigned long nfail;		/* Number of allocations from an empty pool */
+};
+
+/* This is the callback type used by pool_foreach() */
+
+typedef void (*pool_foreach_t)(FAR const struct poolinfo_s *info, FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: pool_create
+ *
+ * Description:
+ *   Create a pool of nobjects objects of objsize bytes each.  The memory of
+ *   the pool is allocated at once, each object is aligned to
+ *   CONFIG_MM_POOL_ALIGN.  Objects are then allocated and freed in constant
+ *   time, from tasks or interrupt handlers.
+ *
+ *   General Usage Summary:
+ *
+ *     POOL_HANDLE handle = pool_create("mymsg", sizeof(struct mymsg_s), 16);
+ *
+ *     FAR struct mymsg_s *msg = (FAR struct mymsg_s *)pool_alloc(handle);
+ *     ...
+ *     pool_free(handle, msg);
+ *
+ * Input Parameters:
+ *   name     - Name of the pool in /proc/pools.  The string is not copied.
+ *   objsize  - Size of one object in bytes
+ *   nobjects - Number of objects in the pool
+ *
+ * Returned Value:
+ *   On success, a non-NULL handle is returned that may be used with other
+ *   pool interfaces.  NULL if the memory couldn't be allocated.
+ *
+ ****************************************************************************/
+
+POOL_HANDLE pool_create(FAR const char *name, size_t objsize, unsigned int nobjects);
+
+/****************************************************************************
+ * Name: pool_destroy
+ *
+ * Description:
+ *   Release the memory of a pool.  All of its objects must have been freed.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pool_destroy(POOL_HANDLE handle);
+
+/****************************************************************************
+ * Name: pool_alloc
+ *
+ * Description:
+ *   Allocate one object from a pool.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *
+ * Returned Value:
+ *   A pointer to the object, or NULL if the pool is empty.
+ *
+ ****************************************************************************/
+
+FAR void *pool_alloc(POOL_HANDLE handle);
+
+/****************************************************************************
+ * Name: pool_free
+ *
+ * Description:
+ *   Return an object to the pool it was allocated from.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *   object - A pointer to an object previously allocated by pool_alloc
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pool_free(POOL_HANDLE handle, FAR void *object);
+
+/****************************************************************************
+ * Name: pool_member
+ *
+ * Description:
+ *   Check if an object belongs to a pool.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *   object - A pointer to check
+ *
+ * Returned Value:
+ *   true if the object lies in the memory of the pool.
+ *
+ ****************************************************************************/
+
+bool pool_member(POOL_HANDLE handle, FAR const void *object);
+
+/****************************************************************************
+ * Name: pool_nfree
+ *
+ * Description:
+ *   Return the number of free objects of a pool.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *
+ * Returned Value:
+ *   The number of free objects
+ *
+ ****************************************************************************/
+
+unsigned int pool_nfree(POOL_HANDLE handle);
+
+/****************************************************************************
+ * Name: pool_foreach
+ *
+ * Description:
+ *   Call handler with the statistics of each pool.  In the protected build,
+ *   the kernel and the user space have their own lists of pools.
+ *
+ * Input Parameters:
+ *   handler - The function to be called for each pool
+ *   arg     - An argument passed along to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pool_foreach(pool_foreach_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif							/* __INCLUDE_MM_POOL_H */
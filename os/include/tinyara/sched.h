@@ -464,6 +464,9 @@ struct task_group_s {
 /* struct tcb_s ******************************************************************/
 
 FAR struct wdog_s;				/* Forward reference                   */
+#ifdef CONFIG_MM_TASK_CACHE
+struct mm_tcache_s;				/* Forward reference                   */
+#endif
 /** @brief This is the common part of the task control block (TCB).  The TCB is the heart
  * of the TinyAra task-control logic.  Each task or thread is represented by a TCB
  * that includes these common definitions.
@@ -571,6 +574,12 @@ struct tcb_s {
 	char name[CONFIG_TASK_NAME_SIZE + 1];	/* Task name (with NUL terminator)     */
 #endif
 
+	/* Memory Management Fields ************************************************** */
+
+#ifdef CONFIG_MM_TASK_CACHE
+	FAR struct mm_tcache_s *tcache;	/* Small chunks cached from user heap */
+#endif
+
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	int curr_alloc_size;
 	int peak_alloc_size;
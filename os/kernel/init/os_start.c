@@ -131,6 +131,13 @@ volatile dq_queue_t g_readytorun;
 
 volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* These are the indexes of the g_readytorun and g_pendingtasks lists */
+
+struct sched_listindex_s g_readytorunindex;
+struct sched_listindex_s g_pendingindex;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 volatile dq_queue_t g_waitingforsemaphore;
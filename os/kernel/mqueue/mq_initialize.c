@@ -58,7 +58,9 @@
 
 #include <stdint.h>
 #include <queue.h>
+#include <assert.h>
 #include <tinyara/kmalloc.h>
+#include <tinyara/mm/pool.h>
 
 #include "mqueue/mqueue.h"
 
@@ -81,18 +83,18 @@ struct mq_des_block_s {
  * Public Variables
  ************************************************************************/
 
-/* The g_msgfree is a list of messages that are available for general
- * use.  The number of messages in this list is a system configuration
+/* g_msgpool is the pool of messages that are available for general
+ * use.  The number of messages in this pool is a system configuration
  * item.
  */
 
-sq_queue_t g_msgfree;
+POOL_HANDLE g_msgpool;
 
-/* The g_msgfreeInt is a list of messages that are reserved for use by
+/* g_msgpoolirq is the pool of messages that are reserved for use by
  * interrupt handlers.
  */
 
-sq_queue_t g_msgfreeirq;
+POOL_HANDLE g_msgpoolirq;
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -105,18 +107,6 @@ sq_queue_t g_desfree;
  * Private Variables
  ************************************************************************/
 
-/* g_msgalloc is a pointer to the start of the allocated block of
- * messages.
- */
-
-static struct mqueue_msg_s *g_msgalloc;
-
-/* g_msgfreeirqalloc is a pointer to the start of the allocated block of
- * messages.
- */
-
-static struct mqueue_msg_s *g_msgfreeirqalloc;
-
 /* g_desalloc is a list of allocated block of message queue descriptors. */
 
 static sq_queue_t g_desalloc;
@@ -125,40 +115,6 @@ static sq_queue_t g_desalloc;
  * Private Functions
  ************************************************************************/
 
-/************************************************************************
- * Name: mq_msgblockalloc
- *
- * Description:
- *   Allocate a block of messages and place them on the free list.
- *
- * Inputs Parameters:
- *  queue
- *
- ************************************************************************/
-
-static struct mqueue_msg_s *mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nmsgs, uint8_t alloc_type)
-{
-	struct mqueue_msg_s *mqmsgblock;
-
-	/* The g_msgfree must be loaded at initialization time to hold the
-	 * configured number of messages.
-	 */
-
-	mqmsgblock = (FAR struct mqueue_msg_s *)kmm_malloc(sizeof(struct mqueue_msg_s) * nmsgs);
-
-	if (mqmsgblock) {
-		struct mqueue_msg_s *mqmsg = mqmsgblock;
-		int i;
-
-		for (i = 0; i < nmsgs; i++) {
-			mqmsg->type = alloc_type;
-			sq_addlast((FAR sq_entry_t *)mqmsg++, queue);
-		}
-	}
-
-	return mqmsgblock;
-}
-
 /************************************************************************
  * Public Functions
  ************************************************************************/
@@ -181,21 +137,19 @@ static struct mqueue_msg_s *mq_msgblockalloc(FAR sq_queue_t *queue, uint16_t nms
 
 void mq_initialize(void)
 {
-	/* Initialize the message free lists */
-
-	sq_init(&g_msgfree);
-	sq_init(&g_msgfreeirq);
 	sq_init(&g_desalloc);
 
-	/* Allocate a block of messages for general use */
+	/* Create a pool of messages for general use */
 
-	g_msgalloc = mq_msgblockalloc(&g_msgfree, CONFIG_PREALLOC_MQ_MSGS, MQ_ALLOC_FIXED);
+	g_msgpool = pool_create("mqmsg", sizeof(struct mqueue_msg_s), CONFIG_PREALLOC_MQ_MSGS);
+	DEBUGASSERT(g_msgpool);
 
-	/* Allocate a block of messages for use exclusively by
+	/* Create a pool of messages for use exclusively by
 	 * interrupt handlers
 	 */
 
-	g_msgfreeirqalloc = mq_msgblockalloc(&g_msgfreeirq, NUM_INTERRUPT_MSGS, MQ_ALLOC_IRQ);
+	g_msgpoolirq = pool_create("mqmsgirq", sizeof(struct mqueue_msg_s), NUM_INTERRUPT_MSGS);
+	DEBUGASSERT(g_msgpoolirq);
 
 	/* Allocate a block of message queue descriptors */
 
@@ -105,34 +105,20 @@
 
 void mq_msgfree(FAR struct mqueue_msg_s *mqmsg)
 {
-	irqstate_t saved_state;
-
 	/* If this is a generally available pre-allocated message,
-	 * then just put it back in the free list.
+	 * then just put it back in its pool.
 	 */
 
 	if (mqmsg->type == MQ_ALLOC_FIXED) {
-		/* Make sure we avoid concurrent access to the free
-		 * list from interrupt handlers.
-		 */
-
-		saved_state = irqsave();
-		sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfree);
-		irqrestore(saved_state);
+		pool_free(g_msgpool, mqmsg);
 	}
 
 	/* If this is a message pre-allocated for interrupts,
-	 * then put it back in the correct  free list.
+	 * then put it back in the pool reserved for interrupts.
 	 */
 
 	else if (mqmsg->type == MQ_ALLOC_IRQ) {
-		/* Make sure we avoid concurrent access to the free
-		 * list from interrupt handlers.
-		 */
-
-		saved_state = irqsave();
-		sq_addlast((FAR sq_entry_t *)mqmsg, &g_msgfreeirq);
-		irqrestore(saved_state);
+		pool_free(g_msgpoolirq, mqmsg);
 	}
 
 	/* Otherwise, deallocate it.  Note:  interrupt handlers
@@ -154,17 +154,17 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
  *
  * Description:
  *   The mq_msgalloc function will get a free message for use by the
- *   operating system.  The message will be allocated from the g_msgfree
- *   list.
+ *   operating system.  The message will be allocated from the g_msgpool
+ *   pool.
  *
- *   If the list is empty AND the message is NOT being allocated from the
+ *   If the pool is empty AND the message is NOT being allocated from the
  *   interrupt level, then the message will be allocated.  If a message
  *   cannot be obtained, the operating system is dead and therefore cannot
  *   continue.
  *
- *   If the list is empty AND the message IS being allocated from the
+ *   If the pool is empty AND the message IS being allocated from the
  *   interrupt level.  This function will attempt to get a message from
- *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
+ *   the g_msgpoolirq pool.  If this is unsuccessful, the calling interrupt
  *   handler will be notified.
  *
  * Inputs:
@@ -179,45 +179,36 @@ int mq_verifysend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
 FAR struct mqueue_msg_s *mq_msgalloc(void)
 {
 	FAR struct mqueue_msg_s *mqmsg;
-	irqstate_t saved_state;
 
-	/* If we were called from an interrupt handler, then try to get the message
-	 * from generally available list of messages. If this fails, then try the
-	 * list of messages reserved for interrupt handlers
+	/* Try to get the message from the pool of generally available messages.
+	 * The pool may be accessed from interrupt handlers too.
 	 */
 
-	if (up_interrupt_context()) {
-		/* Try the general free list */
+	mqmsg = (FAR struct mqueue_msg_s *)pool_alloc(g_msgpool);
+	if (mqmsg) {
+		mqmsg->type = MQ_ALLOC_FIXED;
+	}
 
-		mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
-		if (!mqmsg) {
-			/* Try the free list reserved for interrupt handlers */
+	/* If we were called from an interrupt handler and the pool is empty,
+	 * then try the pool of messages reserved for interrupt handlers.
+	 */
 
-			mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfreeirq);
+	else if (up_interrupt_context()) {
+		mqmsg = (FAR struct mqueue_msg_s *)pool_alloc(g_msgpoolirq);
+		if (mqmsg) {
+			mqmsg->type = MQ_ALLOC_IRQ;
 		}
 	}
 
-	/* We were not called from an interrupt handler. */
+	/* We were not called from an interrupt handler, so we can allocate one. */
 
 	else {
-		/* Try to get the message from the generally available free list.
-		 * Disable interrupts -- we might be called from an interrupt handler.
-		 */
+		mqmsg = (FAR struct mqueue_msg_s *)kmm_malloc((sizeof(struct mqueue_msg_s)));
 
-		saved_state = irqsave();
-		mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&g_msgfree);
-		irqrestore(saved_state);
+		/* Check if we got an allocated message */
 
-		/* If we cannot a message from the free list, then we will have to allocate one. */
-
-		if (!mqmsg) {
-			mqmsg = (FAR struct mqueue_msg_s *)kmm_malloc((sizeof(struct mqueue_msg_s)));
-
-			/* Check if we got an allocated message */
-
-			ASSERT(mqmsg);
-			mqmsg->type = MQ_ALLOC_DYN;
-		}
+		ASSERT(mqmsg);
+		mqmsg->type = MQ_ALLOC_DYN;
 	}
 
 	return mqmsg;
@@ -69,6 +69,7 @@
 #include <signal.h>
 
 #include <tinyara/mqueue.h>
+#include <tinyara/mm/pool.h>
 
 #if !defined(CONFIG_DISABLE_MQUEUE) && CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -127,17 +128,17 @@ extern "C" {
 #define EXTERN extern
 #endif
 
-/* The g_msgfree is a list of messages that are available for general use.
- * The number of messages in this list is a system configuration item.
+/* g_msgpool is the pool of messages that are available for general use.
+ * The number of messages in this pool is a system configuration item.
  */
 
-EXTERN sq_queue_t g_msgfree;
+EXTERN POOL_HANDLE g_msgpool;
 
-/* The g_msgfreeInt is a list of messages that are reserved for use by
+/* g_msgpoolirq is the pool of messages that are reserved for use by
  * interrupt handlers.
  */
 
-EXTERN sq_queue_t g_msgfreeirq;
+EXTERN POOL_HANDLE g_msgpoolirq;
 
 /* The g_desfree data structure is a list of message descriptors available
  * to the operating system for general use. The number of messages in the
@@ -93,6 +93,17 @@
 #define this_cpu()             (0)
 #define this_task()            (current_task(this_cpu()))
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* The number of 32-bit words in the bitmap of priorities of a task list */
+
+#define SCHED_BITMAP_NWORDS    ((SCHED_PRIORITY_MAX + 32) >> 5)
+
+/* Returns the index of a task list, NULL if the list has none */
+
+#define sched_listindex(list) \
+	((FAR volatile dq_queue_t *)(list) == &g_readytorun ? &g_readytorunindex : \
+	 (FAR volatile dq_queue_t *)(list) == &g_pendingtasks ? &g_pendingindex : NULL)
+#endif
 
 /****************************************************************************
  * Public Type Definitions
@@ -127,6 +138,21 @@ struct tasklist_s {
 	bool prioritized;			/* true if the list is prioritized */
 };
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* This structure indexes a prioritized task list by priority.  The list is
+ * made of one FIFO of tasks per priority, from the highest priority to the
+ * lowest, so a task is added after the last task of its own priority or of
+ * the nearest higher priority in the list.  tail[p] is only meaningful if
+ * bit p of the bitmap is set.
+ */
+
+struct sched_listindex_s {
+	uint32_t words;				/* Bit n set if bitmap[n] is not zero */
+	uint32_t bitmap[SCHED_BITMAP_NWORDS];	/* Bit p set if tasks of priority p are in the list */
+	FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1];	/* Last task of each priority in the list */
+};
+#endif
+
 /****************************************************************************
  * Global Variables
  ****************************************************************************/
@@ -156,6 +182,13 @@ extern volatile dq_queue_t g_readytorun;
 
 extern volatile dq_queue_t g_pendingtasks;
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/* These are the indexes of the g_readytorun and g_pendingtasks lists */
+
+extern struct sched_listindex_s g_readytorunindex;
+extern struct sched_listindex_s g_pendingindex;
+#endif
+
 /* This is the list of all tasks that are blocked waiting for a semaphore */
 
 extern volatile dq_queue_t g_waitingforsemaphore;
@@ -253,6 +286,14 @@ bool sched_addreadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_removereadytorun(FAR struct tcb_s *rtrtcb);
 bool sched_addprioritized(FAR struct tcb_s *newTcb, DSEG dq_queue_t *list);
 bool sched_mergepending(void);
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+void sched_remfromlist(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
+#else
+#define sched_remfromlist(tcb, list) \
+		dq_rem((FAR dq_entry_t *)(tcb), (list))
+#endif
+
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int sched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
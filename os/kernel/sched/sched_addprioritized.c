@@ -83,6 +83,103 @@
  * Private Function Prototypes
  ************************************************************************/
 
+/************************************************************************
+ * Private Functions
+ ************************************************************************/
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+/************************************************************************
+ * Name: sched_nexthigher
+ *
+ * Description:
+ *   Return the lowest priority above sched_priority that has tasks in
+ *   an indexed list, or -1 if there is none.
+ *
+ ************************************************************************/
+
+static int sched_nexthigher(FAR struct sched_listindex_s *index, int sched_priority)
+{
+	uint32_t mask;
+	int bit = sched_priority + 1;
+	int word = bit >> 5;
+
+	if (word >= SCHED_BITMAP_NWORDS) {
+		return -1;
+	}
+
+	/* First the higher priorities sharing the word of sched_priority */
+
+	mask = index->bitmap[word] & ~((1u << (bit & 31)) - 1);
+	if (mask) {
+		return (word << 5) + __builtin_ctz(mask);
+	}
+
+	/* Then the lowest non-empty word above it */
+
+	mask = index->words & ~((2u << word) - 1);
+	if (mask) {
+		word = __builtin_ctz(mask);
+		return (word << 5) + __builtin_ctz(index->bitmap[word]);
+	}
+
+	return -1;
+}
+
+/************************************************************************
+ * Name: sched_addindexed
+ *
+ * Description:
+ *   sched_addprioritized() for a list with an index.  The tcb goes after
+ *   the last task of its priority, or of the nearest higher priority if
+ *   there is none, or at the head of the list.
+ *
+ ************************************************************************/
+
+static bool sched_addindexed(FAR struct tcb_s *tcb, DSEG dq_queue_t *list, FAR struct sched_listindex_s *index)
+{
+	FAR struct tcb_s *prev;
+	FAR struct tcb_s *next;
+	uint8_t sched_priority = tcb->sched_priority;
+	int word = sched_priority >> 5;
+	int higher;
+	bool ret = false;
+
+	if (index->bitmap[word] & (1u << (sched_priority & 31))) {
+		prev = index->tail[sched_priority];
+	} else {
+		higher = sched_nexthigher(index, sched_priority);
+		prev = higher < 0 ? NULL : index->tail[higher];
+
+		index->bitmap[word] |= 1u << (sched_priority & 31);
+		index->words |= 1u << word;
+	}
+
+	index->tail[sched_priority] = tcb;
+
+	if (!prev) {
+		/* Insert at the head of the list */
+
+		next = (FAR struct tcb_s *)list->head;
+		list->head = (FAR dq_entry_t *)tcb;
+		ret = true;
+	} else {
+		next = prev->flink;
+		prev->flink = tcb;
+	}
+
+	tcb->flink = next;
+	tcb->blink = prev;
+
+	if (!next) {
+		list->tail = (FAR dq_entry_t *)tcb;
+	} else {
+		next->blink = tcb;
+	}
+
+	return ret;
+}
+#endif
+
 /************************************************************************
  * Public Functions
  ************************************************************************/
@@ -123,6 +220,14 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
 	ASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+	/* Lists with an index don't need to be searched */
+
+	if (sched_listindex(list)) {
+		return sched_addindexed(tcb, list, sched_listindex(list));
+	}
+#endif
+
 	/* Search the list to find the location to insert the new Tcb.
 	 * Each is list is maintained in ascending sched_priority order.
 	 */
@@ -57,6 +57,7 @@
 #include <tinyara/config.h>
 
 #include <stdbool.h>
+#include <string.h>
 #include <sched.h>
 #include <queue.h>
 #include <assert.h>
@@ -109,6 +110,41 @@
  *
  ************************************************************************/
 
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+bool sched_mergepending(void)
+{
+	FAR struct tcb_s *rtcb = this_task();
+	FAR struct tcb_s *pndtcb;
+	FAR struct tcb_s *pndnext;
+
+	/* Add every TCB in the g_pendingtasks list to the g_readytorun list.
+	 * Both lists are indexed, so no search is needed.
+	 */
+
+	for (pndtcb = (FAR struct tcb_s *)g_pendingtasks.head; pndtcb; pndtcb = pndnext) {
+		pndnext = pndtcb->flink;
+		(void)sched_addprioritized(pndtcb, (FAR dq_queue_t *)&g_readytorun);
+		pndtcb->task_state = TSTATE_TASK_READYTORUN;
+	}
+
+	/* Mark the input list and its index empty */
+
+	g_pendingtasks.head = NULL;
+	g_pendingtasks.tail = NULL;
+	g_pendingindex.words = 0;
+	memset(g_pendingindex.bitmap, 0, sizeof(g_pendingindex.bitmap));
+
+	/* Check if the head of the g_readytorun list has changed */
+
+	if (this_task() == rtcb) {
+		return false;
+	}
+
+	rtcb->task_state = TSTATE_TASK_READYTORUN;
+	this_task()->task_state = TSTATE_TASK_RUNNING;
+	return true;
+}
+#else
 bool sched_mergepending(void)
 {
 	FAR struct tcb_s *pndtcb;
@@ -177,3 +213,4 @@ bool sched_mergepending(void)
 
 	return ret;
 }
+#endif
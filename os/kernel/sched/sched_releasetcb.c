@@ -72,7 +72,7 @@
 #if defined(CONFIG_ENABLE_STACKMONITOR_CMD) && defined(CONFIG_DEBUG)
 #include <apps/system/utils.h>
 #endif
-#ifdef CONFIG_DEBUG_MM_HEAPINFO
+#if defined(CONFIG_DEBUG_MM_HEAPINFO) || defined(CONFIG_MM_TASK_CACHE)
 #include <tinyara/mm/mm.h>
 #endif
 
@@ -152,6 +152,14 @@ int sched_releasetcb(FAR struct tcb_s *tcb, uint8_t ttype)
 		heapinfo_update_group_info(tcb->pid, -1, HEAPINFO_DEL_INFO);
 #endif
 
+#ifdef CONFIG_MM_TASK_CACHE
+		/* Return the chunks cached by the thread to the user heap while its
+		 * PID is still valid for heapinfo.
+		 */
+
+		umm_tcache_release(tcb);
+#endif
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
 		/* Release any timers that the task might hold.  We do this
 		 * before release the PID because it may still be trying to
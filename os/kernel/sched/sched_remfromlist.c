@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/************************************************************************
+ * kernel/sched/sched_remfromlist.c
+ ************************************************************************/
+
+/************************************************************************
+ * Included Files
+ ************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYTORUN_BITMAP
+
+/************************************************************************
+ * Public Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name: sched_remfromlist
+ *
+ * Description:
+ *  This function removes a TCB from the task list it is in, keeping the
+ *  index of the list up to date if it has one.
+ *
+ * Inputs:
+ *   tcb - Points to the TCB to remove
+ *   list - Points to the task list holding tcb
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ * - The caller has established a critical section before
+ *   calling this function.
+ * - The priority of the TCB has not changed since it was added to
+ *   the list.
+ ************************************************************************/
+
+void sched_remfromlist(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
+{
+	FAR struct sched_listindex_s *index = sched_listindex(list);
+	FAR struct tcb_s *prev = tcb->blink;
+	uint8_t sched_priority = tcb->sched_priority;
+	int word = sched_priority >> 5;
+
+	/* If the tcb is the last task of its priority, the task before it
+	 * becomes the last one, unless the tcb was the only one.
+	 */
+
+	if (index && index->tail[sched_priority] == tcb) {
+		if (prev && prev->sched_priority == sched_priority) {
+			index->tail[sched_priority] = prev;
+		} else {
+			index->tail[sched_priority] = NULL;
+			index->bitmap[word] &= ~(1u << (sched_priority & 31));
+			if (index->bitmap[word] == 0) {
+				index->words &= ~(1u << word);
+			}
+		}
+	}
+
+	dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+#endif							/* CONFIG_SCHED_READYTORUN_BITMAP */
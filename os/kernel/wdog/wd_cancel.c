@@ -108,8 +108,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	FAR struct wdog_s *curr;
 	FAR struct wdog_s *prev;
+#endif
 	irqstate_t state;
 	int ret = ERROR;
 
@@ -123,6 +125,25 @@ int wd_cancel(WDOG_ID wdog)
 	 * active.
 	 */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+	if (wdog && WDOG_ISACTIVE(wdog)) {
+		/* Remove the watchdog from the timer wheel.  If its slot became
+		 * empty, the next interval event may be later.
+		 */
+
+		if (wd_wheel_remove(wdog)) {
+			sched_timer_reassess();
+		}
+
+		/* Mark the watchdog inactive */
+
+		WDOG_CLRACTIVE(wdog);
+
+		/* Return success */
+
+		ret = OK;
+	}
+#else
 	if (wdog && WDOG_ISACTIVE(wdog)) {
 		/* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
 		 * to do this because there are additional operations that need to be
@@ -178,6 +199,7 @@ int wd_cancel(WDOG_ID wdog)
 
 		ret = OK;
 	}
+#endif
 
 	irqrestore(state);
 	return ret;
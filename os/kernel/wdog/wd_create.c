@@ -62,6 +62,7 @@
 #include <tinyara/arch.h>
 #include <tinyara/wdog.h>
 #include <tinyara/kmalloc.h>
+#include <tinyara/mm/pool.h>
 
 #include "wdog/wdog.h"
 
@@ -124,26 +125,18 @@ WDOG_ID wd_create(void)
 	 * the head of the free list.
 	 */
 
-	if (g_wdnfree > CONFIG_WDOG_INTRESERVE || up_interrupt_context()) {
-		/* Remove the watchdog timer from the free list and decrement the
-		 * count of free timers all with interrupts disabled.
-		 */
+	if (pool_nfree(g_wdpool) > CONFIG_WDOG_INTRESERVE || up_interrupt_context()) {
+		/* Allocate the watchdog timer from the pool of pre-allocated timers */
 
-		wdog = (FAR struct wdog_s *)sq_remfirst(&g_wdfreelist);
+		wdog = (FAR struct wdog_s *)pool_alloc(g_wdpool);
 
 		/* Did we get one? */
 
 		if (wdog) {
-			DEBUGASSERT(g_wdnfree > 0);
-			g_wdnfree--;
-
 			/* Yes.. Clear the forward link and all flags */
 
 			wdog->next = NULL;
 			wdog->flags = 0;
-		} else {
-			/* If wdog is Null, g_wdnfree must be zero, else assert */
-			DEBUGASSERT(g_wdnfree == 0);
 		}
 		irqrestore(state);
 	}
@@ -152,13 +152,9 @@ int wd_delete(WDOG_ID wdog)
 	 */
 
 	else if (!WDOG_ISSTATIC(wdog)) {
-		/* Put the timer back on the free list and increment the count of free
-		 * timers, all with interrupts disabled.
-		 */
+		/* Put the timer back in the pool of pre-allocated timers */
 
-		sq_addlast((FAR sq_entry_t *)wdog, &g_wdfreelist);
-		g_wdnfree++;
-		DEBUGASSERT(g_wdnfree <= CONFIG_PREALLOC_WDOGS);
+		pool_free(g_wdpool, wdog);
 		irqrestore(state);
 	} else {
 		/* There is no guarantee that, this API is not called for statically
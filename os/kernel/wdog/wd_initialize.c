@@ -57,6 +57,9 @@
 #include <tinyara/config.h>
 
 #include <queue.h>
+#include <assert.h>
+
+#include <tinyara/mm/pool.h>
 
 #include "wdog/wdog.h"
 
@@ -72,36 +75,25 @@
  * Public Variables
  ************************************************************************/
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* g_wdpool is the pool of pre-allocated watchdogs.  The number of
+ * watchdogs in the pool is a configuration item.
  */
 
-sq_queue_t g_wdfreelist;
+POOL_HANDLE g_wdpool;
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
-
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
-
-uint16_t g_wdnfree;
+#endif
 
 /************************************************************************
  * Private Data
  ************************************************************************/
 
-/* g_wdpool is a list of pre-allocated watchdogs. The number of watchdogs
-* in the pool is a configuration item.
- */
-
-static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
-
 /************************************************************************
  * Private Functions
  ************************************************************************/
@@ -131,23 +123,14 @@ static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
 
 void wd_initialize(void)
 {
-	FAR struct wdog_s *wdog = g_wdpool;
-	int i;
-
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 	/* Initialize watchdog lists */
 
-	sq_init(&g_wdfreelist);
 	sq_init(&g_wdactivelist);
+#endif
 
-	/* The g_wdfreelist must be loaded at initialization time to hold the
-	 * configured number of watchdogs.
-	 */
-
-	for (i = 0; i < CONFIG_PREALLOC_WDOGS; i++) {
-		sq_addlast((FAR sq_entry_t *)wdog++, &g_wdfreelist);
-	}
-
-	/* All watchdogs are free */
+	/* Allocate the pool of watchdogs */
 
-	g_wdnfree = CONFIG_PREALLOC_WDOGS;
+	g_wdpool = pool_create("wdog", sizeof(struct wdog_s), CONFIG_PREALLOC_WDOGS);
+	DEBUGASSERT(g_wdpool);
 }
@@ -0,0 +1,376 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * kernel/wdog/wd_wheel.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <tinyara/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each level of the wheel has 32 slots, one bit of a 32-bit bitmap each.
+ * A slot of level n holds the watchdogs expiring in one period of 32^n
+ * ticks.
+ */
+
+#define WHEEL_BITS       5
+#define WHEEL_SLOTS      (1 << WHEEL_BITS)
+#define WHEEL_MASK       (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS     CONFIG_WDOG_TIMER_WHEEL_LEVELS
+#define WHEEL_SHIFT(l)   ((l) * WHEEL_BITS)
+
+/* Longer delays are kept in the last level until they get shorter */
+
+#define WHEEL_MAXDELAY   ((int32_t)((1ul << WHEEL_SHIFT(WHEEL_LEVELS)) - 1))
+
+/****************************************************************************
+ * Private Variables
+ ****************************************************************************/
+
+/* The slots of the wheel, and the bitmaps of the non-empty ones */
+
+static FAR struct wdog_s *g_wdwheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint32_t g_wdbitmap[WHEEL_LEVELS];
+
+/* The watchdogs of the last tick processed that haven't run yet */
+
+static FAR struct wdog_s *g_wdexpired;
+
+/* The next tick to be processed */
+
+static uint32_t g_wdtick;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_link
+ *
+ * Description:
+ *   Link a watchdog at the head of a list of the wheel.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_link(FAR struct wdog_s *wdog, FAR struct wdog_s **head)
+{
+	wdog->next = *head;
+	if (wdog->next) {
+		wdog->next->pprev = &wdog->next;
+	}
+
+	wdog->pprev = head;
+	*head = wdog;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_add
+ *
+ * Description:
+ *   Add a watchdog to the slot of its expiration tick, kept in its lag
+ *   field.  The nearer the expiration, the lower the level.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_add(FAR struct wdog_s *wdog)
+{
+	uint32_t expires = (uint32_t)wdog->lag;
+	int32_t delay = (int32_t)(expires - g_wdtick);
+	int level = 0;
+	int slot;
+
+	if (delay < 0) {
+		/* Already due, it runs with the next tick */
+
+		slot = g_wdtick & WHEEL_MASK;
+	} else {
+		if (delay > WHEEL_MAXDELAY) {
+			delay = WHEEL_MAXDELAY;
+			expires = g_wdtick + WHEEL_MAXDELAY;
+		}
+
+		while (level < WHEEL_LEVELS - 1 && delay >= (1 << WHEEL_SHIFT(level + 1))) {
+			level++;
+		}
+
+		slot = (expires >> WHEEL_SHIFT(level)) & WHEEL_MASK;
+	}
+
+	wd_wheel_link(wdog, &g_wdwheel[level][slot]);
+	g_wdbitmap[level] |= 1u << slot;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_detach
+ *
+ * Description:
+ *   Empty a slot of the wheel and return the list of its watchdogs.
+ *
+ ****************************************************************************/
+
+static FAR struct wdog_s *wd_wheel_detach(int level, int slot)
+{
+	FAR struct wdog_s *list = g_wdwheel[level][slot];
+
+	g_wdwheel[level][slot] = NULL;
+	g_wdbitmap[level] &= ~(1u << slot);
+	return list;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_search
+ *
+ * Description:
+ *   Return how many slots after slot the first non-empty slot of a level
+ *   is, counting slot itself as 0 and wrapping around, or -1 if the level
+ *   is empty.
+ *
+ ****************************************************************************/
+
+static int wd_wheel_search(int level, int slot)
+{
+	uint32_t bitmap = g_wdbitmap[level];
+
+	if (bitmap == 0) {
+		return -1;
+	}
+
+	if (slot != 0) {
+		bitmap = (bitmap >> slot) | (bitmap << (WHEEL_SLOTS - slot));
+	}
+
+	return __builtin_ctz(bitmap);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add a watchdog to the wheel.  It will expire with the delay'th tick
+ *   processed from now.
+ *
+ * Parameters:
+ *   wdog  - The watchdog to add
+ *   delay - The number of ticks, at least one
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int delay)
+{
+	wdog->lag = (int)(g_wdtick + (uint32_t)delay - 1);
+	wd_wheel_add(wdog);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove a watchdog from the wheel, or from the expired watchdogs that
+ *   haven't run yet.
+ *
+ * Parameters:
+ *   wdog - The watchdog to remove
+ *
+ * Return Value:
+ *   true if a slot of the wheel became empty, so the next expiration may
+ *   be later than it was.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_remove(FAR struct wdog_s *wdog)
+{
+	FAR struct wdog_s **head = wdog->pprev;
+	int ndx;
+
+	*head = wdog->next;
+	if (wdog->next) {
+		wdog->next->pprev = head;
+	}
+
+	wdog->next = NULL;
+	wdog->pprev = NULL;
+
+	/* Check if the watchdog was the only one of its slot */
+
+	if (*head == NULL && head >= &g_wdwheel[0][0] && head < &g_wdwheel[0][0] + WHEEL_LEVELS * WHEEL_SLOTS) {
+		ndx = head - &g_wdwheel[0][0];
+		g_wdbitmap[ndx >> WHEEL_BITS] &= ~(1u << (ndx & WHEEL_MASK));
+		return true;
+	}
+
+	return false;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_gettime
+ *
+ * Description:
+ *   Return the number of ticks to be processed until a watchdog of the
+ *   wheel expires.
+ *
+ ****************************************************************************/
+
+int wd_wheel_gettime(FAR struct wdog_s *wdog)
+{
+	int32_t delay = (int32_t)((uint32_t)wdog->lag - g_wdtick) + 1;
+
+	return delay > 0 ? delay : 0;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Return the number of ticks to be processed until the next one with
+ *   watchdogs to expire or to move to a lower level, 1 for the next tick,
+ *   or 0 if the wheel is empty.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_next(void)
+{
+	uint32_t next = UINT32_MAX;
+	uint32_t base;
+	uint32_t ticks;
+	int level;
+	int slots;
+
+	/* The slots of level 0 hold the watchdogs of the next 32 ticks */
+
+	slots = wd_wheel_search(0, g_wdtick & WHEEL_MASK);
+	if (slots >= 0) {
+		next = (uint32_t)slots;
+	}
+
+	/* A slot of an upper level is moved down at the first tick of its
+	 * period, when all the lower levels wrap around.
+	 */
+
+	for (level = 1; level < WHEEL_LEVELS; level++) {
+		base = (g_wdtick + (1u << WHEEL_SHIFT(level)) - 1) & ~((1u << WHEEL_SHIFT(level)) - 1);
+		slots = wd_wheel_search(level, (base >> WHEEL_SHIFT(level)) & WHEEL_MASK);
+		if (slots >= 0) {
+			ticks = base - g_wdtick + ((uint32_t)slots << WHEEL_SHIFT(level));
+			if (ticks < next) {
+				next = ticks;
+			}
+		}
+	}
+
+	return next == UINT32_MAX ? 0 : next + 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_skip
+ *
+ * Description:
+ *   Advance the wheel by ticks that have nothing to process, less than
+ *   returned by wd_wheel_next().
+ *
+ ****************************************************************************/
+
+void wd_wheel_skip(unsigned int ticks)
+{
+	g_wdtick += ticks;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_tick
+ *
+ * Description:
+ *   Process the next tick: move the watchdogs of the upper levels whose
+ *   period starts down, then take the watchdogs expiring at this tick out
+ *   of the wheel.  They are returned one by one by wd_wheel_expired().
+ *
+ ****************************************************************************/
+
+void wd_wheel_tick(void)
+{
+	FAR struct wdog_s *wdog;
+	FAR struct wdog_s *next;
+	int level;
+	int slot;
+
+	for (level = 1; level < WHEEL_LEVELS; level++) {
+		if ((g_wdtick & ((1u << WHEEL_SHIFT(level)) - 1)) != 0) {
+			break;
+		}
+
+		slot = (g_wdtick >> WHEEL_SHIFT(level)) & WHEEL_MASK;
+		for (wdog = wd_wheel_detach(level, slot); wdog; wdog = next) {
+			next = wdog->next;
+			wd_wheel_add(wdog);
+		}
+	}
+
+	wdog = wd_wheel_detach(0, g_wdtick & WHEEL_MASK);
+	if (wdog) {
+		wdog->pprev = &g_wdexpired;
+		g_wdexpired = wdog;
+	}
+
+	g_wdtick++;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expired
+ *
+ * Description:
+ *   Return the next watchdog expired by wd_wheel_tick(), removed from the
+ *   wheel, or NULL if there are no more.  Watchdogs cancelled in between
+ *   are not returned.
+ *
+ ****************************************************************************/
+
+FAR struct wdog_s *wd_wheel_expired(void)
+{
+	FAR struct wdog_s *wdog = g_wdexpired;
+
+	if (wdog) {
+		(void)wd_wheel_remove(wdog);
+	}
+
+	return wdog;
+}
+
+#endif							/* CONFIG_WDOG_TIMER_WHEEL */
@@ -64,6 +64,7 @@
 
 #include <tinyara/compiler.h>
 #include <tinyara/wdog.h>
+#include <tinyara/mm/pool.h>
 
 /************************************************************************
  * Pre-processor Definitions
@@ -84,25 +85,18 @@ extern "C" {
 #define EXTERN extern
 #endif
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
- */
+/* g_wdpool is the pool of pre-allocated watchdogs */
 
-extern sq_queue_t g_wdfreelist;
+extern POOL_HANDLE g_wdpool;
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
-
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
-
-extern uint16_t g_wdnfree;
+#endif
 
 /************************************************************************
  * Public Function Prototypes
@@ -182,6 +176,25 @@ void wd_timer(void);
 struct tcb_s;
 void wd_recover(FAR struct tcb_s *tcb);
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/****************************************************************************
+ * Name: wd_wheel_*
+ *
+ * Description:
+ *   The timer wheel holding the active watchdogs, see wd_wheel.c.  These
+ *   are called with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wdog_s *wdog, int delay);
+bool wd_wheel_remove(FAR struct wdog_s *wdog);
+int wd_wheel_gettime(FAR struct wdog_s *wdog);
+unsigned int wd_wheel_next(void);
+void wd_wheel_skip(unsigned int ticks);
+void wd_wheel_tick(void);
+FAR struct wdog_s *wd_wheel_expired(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -79,6 +79,29 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_MM_TLSF
+void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+	FAR struct mm_freenode_s *next;
+	int fl;
+	int sl;
+
+	/* Lists aren't ordered, the new node is put at the head of its list */
+
+	mm_size2tlsf(node->size, false, &fl, &sl);
+
+	next = heap->mm_freelist[fl][sl];
+	node->blink = NULL;
+	node->flink = next;
+	if (next) {
+		next->blink = node;
+	}
+
+	heap->mm_freelist[fl][sl] = node;
+	heap->mm_flbitmap |= (uint32_t)1 << fl;
+	heap->mm_slbitmap[fl] |= (uint16_t)(1 << sl);
+}
+#else
 void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 {
 	FAR struct mm_freenode_s *next;
@@ -104,3 +127,4 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
 		next->blink = node;
 	}
 }
+#endif
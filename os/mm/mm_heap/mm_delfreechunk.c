@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_heap/mm_delfreechunk.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/mm/mm.h>
+
+/****************************************************************************
+ * Global Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the nodelist, before it's allocated or merged
+ *   with a neighbor.  The size of the chunk must be the one it was added
+ *   with.  It is assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
+{
+#ifdef CONFIG_MM_TLSF
+	int fl;
+	int sl;
+
+	/* The first node of a list has no predecessor, the list head points to
+	 * it.  Clear the bitmaps when the list becomes empty.
+	 */
+
+	if (node->blink) {
+		node->blink->flink = node->flink;
+	} else {
+		mm_size2tlsf(node->size, false, &fl, &sl);
+		DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+		heap->mm_freelist[fl][sl] = node->flink;
+		if (!node->flink) {
+			heap->mm_slbitmap[fl] &= (uint16_t)~(1 << sl);
+			if (heap->mm_slbitmap[fl] == 0) {
+				heap->mm_flbitmap &= ~((uint32_t)1 << fl);
+			}
+		}
+	}
+#else
+	/* There must be a predecessor, but there may not be a successor node */
+
+	DEBUGASSERT(node->blink);
+	node->blink->flink = node->flink;
+#endif
+
+	if (node->flink) {
+		node->flink->blink = node->blink;
+	}
+}
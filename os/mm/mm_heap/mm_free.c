@@ -159,15 +159,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
 		andbeyond = (FAR struct mm_allocnode_s *)((char *)next + next->size);
 
-		/* Remove the next node.  There must be a predecessor,
-		 * but there may not be a successor node.
-		 */
+		/* Remove the next node from the nodelist */
 
-		DEBUGASSERT(next->blink);
-		next->blink->flink = next->flink;
-		if (next->flink) {
-			next->flink->blink = next->blink;
-		}
+		mm_delfreechunk(heap, next);
 
 		/* Then merge the two chunks */
 
@@ -182,15 +176,9 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
 
 	prev = (FAR struct mm_freenode_s *)((char *)node - node->preceding);
 	if ((prev->preceding & MM_ALLOC_BIT) == 0) {
-		/* Remove the node.  There must be a predecessor, but there may
-		 * not be a successor node.
-		 */
+		/* Remove the node from the nodelist */
 
-		DEBUGASSERT(prev->blink);
-		prev->blink->flink = prev->flink;
-		if (prev->flink) {
-			prev->flink->blink = prev->blink;
-		}
+		mm_delfreechunk(heap, prev);
 
 		/* Then merge the two chunks */
 
@@ -88,6 +88,57 @@
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_MM_TLSF
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *  Find a free chunk of at least size bytes in constant time.  The size is
+ *  rounded up to the next list boundary, then the bitmaps give the first
+ *  list from there which isn't empty, and any node of it fits.  If there is
+ *  none, the list holding the size itself may still have a large enough
+ *  node, it's searched as a last resort.  So is the last list, where nodes
+ *  beyond MM_MAX_CHUNK aren't sorted by size.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+	FAR struct mm_freenode_s *node = NULL;
+	uint32_t bitmap;
+	int fl;
+	int sl;
+
+	mm_size2tlsf(size, true, &fl, &sl);
+
+	bitmap = heap->mm_slbitmap[fl] & ((uint32_t)~0 << sl);
+	if (bitmap == 0) {
+		bitmap = heap->mm_flbitmap & ((uint32_t)~0 << (fl + 1));
+		if (bitmap != 0) {
+			fl = __builtin_ctz(bitmap);
+			bitmap = heap->mm_slbitmap[fl];
+		}
+	}
+
+	if (bitmap != 0) {
+		sl = __builtin_ctz(bitmap);
+		node = heap->mm_freelist[fl][sl];
+		if (node->size >= size) {
+			return node;
+		}
+	} else {
+		mm_size2tlsf(size, false, &fl, &sl);
+		node = heap->mm_freelist[fl][sl];
+	}
+
+	while (node && node->size < size) {
+		node = node->flink;
+	}
+
+	return node;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -97,7 +148,9 @@
  *
  * Description:
  *  Find the smallest chunk that satisfies the request. Take the memory from
- *  that chunk, save the remaining, smaller chunk (if any).
+ *  that chunk, save the remaining, smaller chunk (if any).  With
+ *  CONFIG_MM_TLSF, the chunk is found in constant time and is the smallest
+ *  one up to the size range of a free list.
  *
  *  8-byte alignment of the allocated data is assured.
  *
@@ -110,7 +163,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 {
 	FAR struct mm_freenode_s *node;
 	void *ret = NULL;
+#ifndef CONFIG_MM_TLSF
 	int ndx;
+#endif
 
 	/* Handle bad sizes */
 
@@ -133,6 +188,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
 	mm_takesemaphore(heap);
 
+#ifdef CONFIG_MM_TLSF
+	node = mm_findfreechunk(heap, size);
+#else
 	/* Get the location in the node list to start the search. Special case
 	 * really big allocations
 	 */
@@ -151,6 +209,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 	 */
 
 	for (node = heap->mm_nodelist[ndx].flink; node && node->size < size; node = node->flink) ;
+#endif
 
 	/* If we found a node with non-zero size, then this is one to use. Since
 	 * the list is ordered, we know that is must be best fitting chunk
@@ -162,15 +221,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 		FAR struct mm_freenode_s *next;
 		size_t remaining;
 
-		/* Remove the node.  There must be a predecessor, but there may not be
-		 * a successor node.
-		 */
+		/* Remove the node from the nodelist */
 
-		DEBUGASSERT(node->blink);
-		node->blink->flink = node->flink;
-		if (node->flink) {
-			node->flink->blink = node->blink;
-		}
+		mm_delfreechunk(heap, node);
 
 		/* Check if we have to split the free node into one of the allocated
 		 * size and another smaller freenode.  In some cases, the remaining
@@ -263,15 +263,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 		if (takeprev) {
 			FAR struct mm_allocnode_s *newnode;
 
-			/* Remove the previous node.  There must be a predecessor, but
-			 * there may not be a successor node.
-			 */
+			/* Remove the previous node from the nodelist */
 
-			DEBUGASSERT(prev->blink);
-			prev->blink->flink = prev->flink;
-			if (prev->flink) {
-				prev->flink->blink = prev->blink;
-			}
+			mm_delfreechunk(heap, prev);
 
 			/* Extend the node into the previous free chunk */
 			/* Did we consume the entire preceding chunk? */
@@ -298,15 +292,17 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 				next->preceding     = newnode->size | (next->preceding & MM_ALLOC_BIT);
 			}
 
-			oldnode = newnode;
-			oldsize = newnode->size;
-
-			/* Now we have to move the user contents 'down' in memory.  memcpy should
-			 * should be save for this.
+			/* Now we have to move the user contents 'down' in memory.  The old and
+			 * new regions overlap when less than the old size is taken from the
+			 * previous chunk, so memmove must be used.  Only the old user contents
+			 * are moved; the extended chunk reaches past the end of the old one.
 			 */
 
 			newmem = (FAR void *)((FAR char *)newnode + SIZEOF_MM_ALLOCNODE);
-			memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+			memmove(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+
+			oldnode = newnode;
+			oldsize = newnode->size;
 		}
 
 		/* Extend into the next free chunk */
@@ -321,15 +317,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem, size_t size)
 
 			andbeyond = (FAR struct mm_allocnode_s *)((char *)next + nextsize);
 
-			/* Remove the next node.  There must be a predecessor, but there
-			 * may not be a successor node.
-			 */
+			/* Remove the next node from the nodelist */
 
-			DEBUGASSERT(next->blink);
-			next->blink->flink = next->flink;
-			if (next->flink) {
-				next->flink->blink = next->blink;
-			}
+			mm_delfreechunk(heap, next);
 
 			/* Extend the node into the next chunk */
 			/* Did we consume the entire preceding chunk? */
@@ -90,3 +90,37 @@ int mm_size2ndx(size_t size)
 
 	return ndx;
 }
+
+#ifdef CONFIG_MM_TLSF
+/****************************************************************************
+ * Name: mm_size2tlsf
+ *
+ * Description:
+ *    Convert the size to the indexes of a free list.  A free node of the
+ *    size is put in the list found without roundup.  With roundup, the size
+ *    is rounded up to the next list boundary first, so that every node of
+ *    the list found is at least as large as the size.  Sizes beyond
+ *    MM_MAX_CHUNK all go to the last list.
+ *
+ ****************************************************************************/
+
+void mm_size2tlsf(size_t size, bool roundup, FAR int *fl, FAR int *sl)
+{
+	int shift;
+
+	shift = (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl((unsigned long)size);
+	if (roundup) {
+		size += ((size_t)1 << (shift - MM_TLSF_SLI)) - 1;
+		shift = (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl((unsigned long)size);
+	}
+
+	if (shift > MM_MAX_SHIFT) {
+		*fl = MM_NNODES - 1;
+		*sl = MM_TLSF_SLCOUNT - 1;
+		return;
+	}
+
+	*fl = shift - MM_MIN_SHIFT;
+	*sl = (int)(size >> (shift - MM_TLSF_SLI)) - MM_TLSF_SLCOUNT;
+}
+#endif
@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/mm_pool.h
+ ****************************************************************************/
+
+#ifndef __MM_MM_POOL_MM_POOL_H
+#define __MM_MM_POOL_MM_POOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdlib.h>
+#include <semaphore.h>
+
+#include <tinyara/mm/pool.h>
+#if !defined(CONFIG_BUILD_PROTECTED) || defined(__KERNEL__)
+#include <tinyara/kmalloc.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define POOL_ALIGN_MASK  (CONFIG_MM_POOL_ALIGN - 1)
+#define POOL_ALIGN_UP(a) (((a) + POOL_ALIGN_MASK) & ~POOL_ALIGN_MASK)
+
+/* The objects follow the pool structure in the same allocation */
+
+#define SIZEOF_POOL_S    POOL_ALIGN_UP(sizeof(struct pool_s))
+
+/* Pools of the user space of the protected build are allocated from the
+ * user heap.
+ */
+
+#if defined(CONFIG_BUILD_PROTECTED) && !defined(__KERNEL__)
+#define pool_memalign(a, s) memalign(a, s)
+#define pool_memfree(m)     free(m)
+#else
+#define pool_memalign(a, s) kmm_memalign(a, s)
+#define pool_memfree(m)     kmm_free(m)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure represents the state of one pool */
+
+struct pool_s {
+	FAR struct pool_s *flink;	/* Next pool in g_pools */
+	FAR void *freelist;			/* Free objects, linked by their first word */
+	FAR char *start;			/* The first object */
+	FAR char *end;				/* The end of the last object */
+	struct poolinfo_s info;		/* Statistics */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* All pools, for pool_foreach().  g_poolsem protects the list, the objects
+ * of each pool are protected by disabling interrupts.
+ */
+
+extern FAR struct pool_s *g_pools;
+extern sem_t g_poolsem;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pool_takesem and pool_givesem
+ *
+ * Description:
+ *   Exclusive access to the list of pools.
+ *
+ ****************************************************************************/
+
+void pool_takesem(void);
+void pool_givesem(void);
+
+#endif							/* __MM_MM_POOL_MM_POOL_H */
@@ -0,0 +1,81 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/mm_poolalloc.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pool_alloc
+ *
+ * Description:
+ *   Allocate one object from a pool.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *
+ * Returned Value:
+ *   A pointer to the object, or NULL if the pool is empty.
+ *
+ ****************************************************************************/
+
+FAR void *pool_alloc(POOL_HANDLE handle)
+{
+	FAR struct pool_s *pool = (FAR struct pool_s *)handle;
+	FAR void *object;
+	irqstate_t flags;
+
+	DEBUGASSERT(pool);
+
+	/* Disable interrupts, objects may be allocated and freed by interrupt
+	 * handlers.
+	 */
+
+	flags = irqsave();
+	object = pool->freelist;
+	if (object) {
+		pool->freelist = *(FAR void **)object;
+		pool->info.nfree--;
+		if (pool->info.nfree < pool->info.minfree) {
+			pool->info.minfree = pool->info.nfree;
+		}
+
+		pool->info.nalloc++;
+	} else {
+		pool->info.nfail++;
+	}
+
+	irqrestore(flags);
+	return object;
+}
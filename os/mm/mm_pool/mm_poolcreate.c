@@ -0,0 +1,139 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/mm_poolcreate.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <tinyara/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+FAR struct pool_s *g_pools;
+sem_t g_poolsem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pool_takesem and pool_givesem
+ *
+ * Description:
+ *   Exclusive access to the list of pools.
+ *
+ ****************************************************************************/
+
+void pool_takesem(void)
+{
+	while (sem_wait(&g_poolsem) != 0) {
+		/* The only case that an error should occur here is if the wait was
+		 * awakened by a signal.
+		 */
+
+		ASSERT(errno == EINTR);
+	}
+}
+
+void pool_givesem(void)
+{
+	sem_post(&g_poolsem);
+}
+
+/****************************************************************************
+ * Name: pool_create
+ *
+ * Description:
+ *   Create a pool of nobjects objects of objsize bytes each.  The memory of
+ *   the pool is allocated at once, each object is aligned to
+ *   CONFIG_MM_POOL_ALIGN.
+ *
+ * Input Parameters:
+ *   name     - Name of the pool in /proc/pools.  The string is not copied.
+ *   objsize  - Size of one object in bytes
+ *   nobjects - Number of objects in the pool
+ *
+ * Returned Value:
+ *   On success, a non-NULL handle is returned that may be used with other
+ *   pool interfaces.  NULL if the memory couldn't be allocated.
+ *
+ ****************************************************************************/
+
+POOL_HANDLE pool_create(FAR const char *name, size_t objsize, unsigned int nobjects)
+{
+	FAR struct pool_s *pool;
+	FAR char *object;
+	unsigned int i;
+
+	DEBUGASSERT(name && objsize > 0);
+
+	/* Each free object holds the link to the next one */
+
+	if (objsize < sizeof(FAR void *)) {
+		objsize = sizeof(FAR void *);
+	}
+
+	objsize = POOL_ALIGN_UP(objsize);
+
+	pool = (FAR struct pool_s *)pool_memalign(CONFIG_MM_POOL_ALIGN, SIZEOF_POOL_S + objsize * nobjects);
+	if (!pool) {
+		mdbg("ERROR: Failed to allocate pool %s of %u objects\n", name, nobjects);
+		return NULL;
+	}
+
+	pool->start = (FAR char *)pool + SIZEOF_POOL_S;
+	pool->end = pool->start + objsize * nobjects;
+
+	/* Link the objects in the order of their addresses */
+
+	pool->freelist = NULL;
+	object = pool->end;
+	for (i = 0; i < nobjects; i++) {
+		object -= objsize;
+		*(FAR void **)object = pool->freelist;
+		pool->freelist = object;
+	}
+
+	pool->info.name = name;
+	pool->info.objsize = objsize;
+	pool->info.nobjects = nobjects;
+	pool->info.nfree = nobjects;
+	pool->info.minfree = nobjects;
+	pool->info.nalloc = 0;
+	pool->info.nfail = 0;
+
+	pool_takesem();
+	pool->flink = g_pools;
+	g_pools = pool;
+	pool_givesem();
+
+	return (POOL_HANDLE)pool;
+}
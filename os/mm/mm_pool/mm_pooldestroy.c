@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/mm_pooldestroy.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pool_destroy
+ *
+ * Description:
+ *   Release the memory of a pool.  All of its objects must have been freed.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pool_destroy(POOL_HANDLE handle)
+{
+	FAR struct pool_s *pool = (FAR struct pool_s *)handle;
+	FAR struct pool_s **prev;
+
+	DEBUGASSERT(pool && pool->info.nfree == pool->info.nobjects);
+
+	pool_takesem();
+	for (prev = &g_pools; *prev; prev = &(*prev)->flink) {
+		if (*prev == pool) {
+			*prev = pool->flink;
+			break;
+		}
+	}
+	pool_givesem();
+
+	pool_memfree(pool);
+}
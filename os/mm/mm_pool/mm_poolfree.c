@@ -0,0 +1,68 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/mm_poolfree.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pool_free
+ *
+ * Description:
+ *   Return an object to the pool it was allocated from.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *   object - A pointer to an object previously allocated by pool_alloc
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pool_free(POOL_HANDLE handle, FAR void *object)
+{
+	FAR struct pool_s *pool = (FAR struct pool_s *)handle;
+	irqstate_t flags;
+
+	DEBUGASSERT(pool && pool_member(handle, object));
+	DEBUGASSERT(((FAR char *)object - pool->start) % pool->info.objsize == 0);
+
+	flags = irqsave();
+	*(FAR void **)object = pool->freelist;
+	pool->freelist = object;
+	pool->info.nfree++;
+	DEBUGASSERT(pool->info.nfree <= pool->info.nobjects);
+	irqrestore(flags);
+}
@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/mm_pool/mm_poolinfo.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <assert.h>
+
+#include <tinyara/irq.h>
+#include <tinyara/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pool_member
+ *
+ * Description:
+ *   Check if an object belongs to a pool.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *   object - A pointer to check
+ *
+ * Returned Value:
+ *   true if the object lies in the memory of the pool.
+ *
+ ****************************************************************************/
+
+bool pool_member(POOL_HANDLE handle, FAR const void *object)
+{
+	FAR struct pool_s *pool = (FAR struct pool_s *)handle;
+
+	DEBUGASSERT(pool);
+	return (FAR const char *)object >= pool->start && (FAR const char *)object < pool->end;
+}
+
+/****************************************************************************
+ * Name: pool_nfree
+ *
+ * Description:
+ *   Return the number of free objects of a pool.
+ *
+ * Input Parameters:
+ *   handle - The handle previously returned by pool_create
+ *
+ * Returned Value:
+ *   The number of free objects
+ *
+ ****************************************************************************/
+
+unsigned int pool_nfree(POOL_HANDLE handle)
+{
+	FAR struct pool_s *pool = (FAR struct pool_s *)handle;
+
+	DEBUGASSERT(pool);
+	return pool->info.nfree;
+}
+
+/****************************************************************************
+ * Name: pool_foreach
+ *
+ * Description:
+ *   Call handler with the statistics of each pool.  The statistics are
+ *   copied with interrupts disabled, so they are consistent with each other.
+ *
+ * Input Parameters:
+ *   handler - The function to be called for each pool
+ *   arg     - An argument passed along to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void pool_foreach(pool_foreach_t handler, FAR void *arg)
+{
+	FAR struct pool_s *pool;
+	struct poolinfo_s info;
+	irqstate_t flags;
+
+	DEBUGASSERT(handler);
+
+	pool_takesem();
+	for (pool = g_pools; pool; pool = pool->flink) {
+		flags = irqsave();
+		info = pool->info;
+		irqrestore(flags);
+
+		handler(&info, arg);
+	}
+	pool_givesem();
+}
@@ -83,7 +83,11 @@
 
 void free(FAR void *mem)
 {
+#ifdef CONFIG_MM_TASK_CACHE
+	umm_tcache_free(mem);
+#else
 	mm_free(USR_HEAP, mem);
+#endif
 }
 
 #endif							/* !CONFIG_BUILD_PROTECTED || !__KERNEL__ */
@@ -127,6 +127,15 @@ FAR void *malloc(size_t size)
 	} while (mem == NULL);
 
 	return mem;
+#elif defined(CONFIG_MM_TASK_CACHE)
+	/* Small requests are served from the cache of the calling thread */
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	ARCH_GET_RET_ADDRESS
+	return umm_tcache_malloc(size, retaddr);
+#else
+	return umm_tcache_malloc(size);
+#endif
 #else
 #ifdef CONFIG_DEBUG_MM_HEAPINFO
 	ARCH_GET_RET_ADDRESS
@@ -0,0 +1,318 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * mm/umm_heap/umm_tcache.c
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+
+#include <stdbool.h>
+
+#include <tinyara/arch.h>
+#include <tinyara/sched.h>
+#include <tinyara/kmalloc.h>
+#include <tinyara/mm/mm.h>
+
+#ifdef CONFIG_MM_TASK_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+#define TCACHE_MALLOC(s) mm_malloc(USR_HEAP, s, caller_retaddr)
+#define TCACHE_ZALLOC(s) mm_zalloc(USR_HEAP, s, caller_retaddr)
+#else
+#define TCACHE_MALLOC(s) mm_malloc(USR_HEAP, s)
+#define TCACHE_ZALLOC(s) mm_zalloc(USR_HEAP, s)
+#endif
+
+/* The list holding the chunks of a given size */
+
+#define TCACHE_NDX(chunk) (((chunk) >> MM_MIN_SHIFT) - 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_tcache_owner
+ *
+ * Description:
+ *   Return the TCB of the thread whose cache may be used, or NULL if the
+ *   heap must be used directly.  A cache is only used by the thread owning
+ *   it while it runs, never from interrupt handlers nor by task_exit()
+ *   tearing down the exiting task on behalf of the next one.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *umm_tcache_owner(void)
+{
+	FAR struct tcb_s *rtcb;
+
+	if (up_interrupt_context()) {
+		return NULL;
+	}
+
+	rtcb = sched_self();
+	if (rtcb == NULL || rtcb->task_state != TSTATE_TASK_RUNNING) {
+		return NULL;
+	}
+
+	return rtcb;
+}
+
+/****************************************************************************
+ * Name: umm_tcache_push
+ *
+ * Description:
+ *   Add an allocated chunk to the cache.  Return false if it's too large or
+ *   its list is full, the chunk must go to the heap then.
+ *
+ ****************************************************************************/
+
+static bool umm_tcache_push(FAR struct mm_tcache_s *tcache, FAR void *mem)
+{
+	FAR struct mm_allocnode_s *node;
+	int ndx;
+
+	node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+	if (node->size > MM_TCACHE_MAXCHUNK) {
+		return false;
+	}
+
+	ndx = TCACHE_NDX(node->size);
+	if (tcache->count[ndx] >= CONFIG_MM_TASK_CACHE_DEPTH) {
+		return false;
+	}
+
+	*(FAR void **)mem = tcache->list[ndx];
+	tcache->list[ndx] = mem;
+	tcache->count[ndx]++;
+	tcache->cached += node->size;
+	return true;
+}
+
+/****************************************************************************
+ * Name: umm_tcache_pop
+ *
+ * Description:
+ *   Take the first chunk of a non-empty list of the cache.
+ *
+ ****************************************************************************/
+
+static FAR void *umm_tcache_pop(FAR struct mm_tcache_s *tcache, int ndx)
+{
+	FAR void *mem = tcache->list[ndx];
+
+	tcache->list[ndx] = *(FAR void **)mem;
+	tcache->count[ndx]--;
+	tcache->cached -= (size_t)(ndx + 1) << MM_MIN_SHIFT;
+	return mem;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_tcache_malloc
+ *
+ * Description:
+ *   Allocate memory from the user heap through the cache of the calling
+ *   thread.  If the list of the chunk size is empty, it's refilled with
+ *   CONFIG_MM_TASK_CACHE_BATCH chunks taking the heap semaphore once.
+ *   Larger requests go to the heap directly.
+ *
+ * Parameters:
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *
+ * Return Value:
+ *   The address of the allocated memory (NULL on failure to allocate)
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+FAR void *umm_tcache_malloc(size_t size, mmaddress_t caller_retaddr)
+#else
+FAR void *umm_tcache_malloc(size_t size)
+#endif
+{
+	FAR struct tcb_s *rtcb;
+	FAR struct mm_tcache_s *tcache;
+	FAR void *mem;
+	int ndx;
+	int i;
+
+	rtcb = umm_tcache_owner();
+	if (rtcb == NULL || size < 1 || size > CONFIG_MM_TASK_CACHE_MAXSIZE) {
+		return TCACHE_MALLOC(size);
+	}
+
+	/* The cache is created by the first small allocation of the thread */
+
+	tcache = rtcb->tcache;
+	if (tcache == NULL) {
+		tcache = (FAR struct mm_tcache_s *)TCACHE_ZALLOC(sizeof(struct mm_tcache_s));
+		if (tcache == NULL) {
+			return TCACHE_MALLOC(size);
+		}
+
+		rtcb->tcache = tcache;
+	}
+
+	ndx = TCACHE_NDX(MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE));
+	if (tcache->list[ndx] == NULL) {
+		/* The heap may return a chunk a bit larger than asked for, it's
+		 * cached in the list of its own size.
+		 */
+
+		mm_takesemaphore(USR_HEAP);
+		for (i = 0; i < CONFIG_MM_TASK_CACHE_BATCH; i++) {
+			mem = TCACHE_MALLOC(size);
+			if (mem == NULL) {
+				break;
+			}
+
+			if (!umm_tcache_push(tcache, mem)) {
+				mm_free(USR_HEAP, mem);
+			}
+		}
+		mm_givesemaphore(USR_HEAP);
+
+		if (tcache->list[ndx] == NULL) {
+			return TCACHE_MALLOC(size);
+		}
+	}
+
+	mem = umm_tcache_pop(tcache, ndx);
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	heapinfo_update_node((FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE), caller_retaddr);
+#endif
+
+	return mem;
+}
+
+/****************************************************************************
+ * Name: umm_tcache_free
+ *
+ * Description:
+ *   Return memory to the cache of the calling thread, which may be another
+ *   thread than the one it was allocated by.  If the list of the chunk size
+ *   is full, CONFIG_MM_TASK_CACHE_BATCH chunks of it are returned to the
+ *   heap taking the heap semaphore once.  Larger chunks go to the heap
+ *   directly.
+ *
+ * Parameters:
+ *   mem - Memory to be freed
+ *
+ ****************************************************************************/
+
+void umm_tcache_free(FAR void *mem)
+{
+	FAR struct tcb_s *rtcb;
+	FAR struct mm_tcache_s *tcache;
+	FAR struct mm_allocnode_s *node;
+	int ndx;
+	int i;
+
+	rtcb = umm_tcache_owner();
+	if (mem == NULL || rtcb == NULL || rtcb->tcache == NULL) {
+		mm_free(USR_HEAP, mem);
+		return;
+	}
+
+	tcache = rtcb->tcache;
+	node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+	if (node->size > MM_TCACHE_MAXCHUNK) {
+		mm_free(USR_HEAP, mem);
+		return;
+	}
+
+	ndx = TCACHE_NDX(node->size);
+	if (tcache->count[ndx] >= CONFIG_MM_TASK_CACHE_DEPTH) {
+		mm_takesemaphore(USR_HEAP);
+		for (i = 0; i < CONFIG_MM_TASK_CACHE_BATCH && tcache->list[ndx]; i++) {
+			mm_free(USR_HEAP, umm_tcache_pop(tcache, ndx));
+		}
+		mm_givesemaphore(USR_HEAP);
+	}
+
+#ifdef CONFIG_DEBUG_MM_HEAPINFO
+	/* Cached chunks are accounted to the thread caching them */
+
+	if (node->pid != rtcb->pid) {
+		heapinfo_subtract_size(node->pid, node->size);
+		heapinfo_add_size(rtcb->pid, node->size);
+		node->pid = rtcb->pid;
+	}
+#endif
+
+	(void)umm_tcache_push(tcache, mem);
+}
+
+/****************************************************************************
+ * Name: umm_tcache_release
+ *
+ * Description:
+ *   Return all chunks cached by a thread, and the cache itself, to the user
+ *   heap.  This is called by sched_releasetcb() when the thread is deleted.
+ *   If the heap semaphore isn't available, the deallocations are delayed.
+ *
+ * Parameters:
+ *   tcb - The TCB of the thread being deleted
+ *
+ ****************************************************************************/
+
+void umm_tcache_release(FAR struct tcb_s *tcb)
+{
+	FAR struct mm_tcache_s *tcache = tcb->tcache;
+	bool delayed;
+	int ndx;
+
+	if (tcache == NULL) {
+		return;
+	}
+
+	tcb->tcache = NULL;
+
+	delayed = up_interrupt_context() || umm_trysemaphore() != OK;
+	for (ndx = 0; ndx < MM_TCACHE_NLISTS; ndx++) {
+		while (tcache->list[ndx]) {
+			if (delayed) {
+				sched_ufree(umm_tcache_pop(tcache, ndx));
+			} else {
+				mm_free(USR_HEAP, umm_tcache_pop(tcache, ndx));
+			}
+		}
+	}
+
+	if (delayed) {
+		sched_ufree(tcache);
+	} else {
+		mm_free(USR_HEAP, tcache);
+		umm_givesemaphore();
+	}
+}
+
+#endif							/* CONFIG_MM_TASK_CACHE */
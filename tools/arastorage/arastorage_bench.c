@@ -0,0 +1,467 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/arastorage/arastorage_bench.c
+ *
+ * Host benchmark of arastorage. A relation of (id int, val long) indexed by
+ * a B+tree on val goes through the phases of a workload mix, and each phase
+ * reports its throughput, the storage operations it issued and the hit rates
+ * of the B+tree node and bucket caches. With the flash backend, the time the
+ * device would have spent is simulated, so the throughput on a slow flash
+ * can be estimated on host. Running the benchmark with different
+ * HOSTDEFS helps sizing CONFIG_ARASTORAGE_TREE_CACHE_SIZE, CONFIG_NODE_LIMIT
+ * and CONFIG_BUCKETS_LIMIT for a workload. Inserts refused by the engine,
+ * e.g. beyond DB_TUPLE_LIMIT rows of a relation, are counted as failures.
+ *
+ * Build & run: make -C tools/arastorage && ./tools/arastorage/arastorage_bench -b flash
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arastorage/arastorage.h>
+
+#include "index.h"
+#include "arastorage_bench.h"
+
+#define BENCH_MAX_PHASES 16
+#define BENCH_QUERY_LEN  128
+
+/* Latency of a SPI NOR flash behind a journaling file system */
+static const struct bench_latency_s g_flash_latency = {
+	.open_us = 200,
+	.read_us = 50,
+	.write_us = 100,
+	.sync_us = 2000,
+	.remove_us = 1000,
+	.read_kb_us = 25,
+	.write_kb_us = 300,
+};
+
+struct bench_opts_s {
+	enum bench_backend_e backend;
+	const char *dir;
+	struct bench_latency_s latency;
+	unsigned int block_size;
+	long tuples;
+	long lookups;
+	long ranges;
+	long width;
+	int delete_pct;
+	int batch;
+	unsigned int seed;
+};
+
+struct bench_result_s {
+	long ops;
+	long failed;
+};
+
+static struct bench_opts_s g_opts;
+static long *g_keys;
+static long g_key_space;
+static long g_live;
+static int g_indexed;
+static uint32_t g_rand;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t next_rand(void)
+{
+	g_rand ^= g_rand << 13;
+	g_rand ^= g_rand >> 17;
+	g_rand ^= g_rand << 5;
+	return g_rand;
+}
+
+static long count_rows(db_cursor_t *cursor)
+{
+	long rows = 0;
+
+	if (DB_SUCCESS(cursor_move_first(cursor))) {
+		do {
+			rows++;
+		} while (DB_SUCCESS(cursor_move_next(cursor)));
+	}
+	return rows;
+}
+
+static void phase_insert(struct bench_result_s *res)
+{
+	db_stmt_t *stmt;
+	long i;
+
+	if (DB_ERROR(db_prepare("INSERT (?, ?) INTO bench;", &stmt))) {
+		res->failed = g_opts.tuples;
+		return;
+	}
+	for (i = 0; i < g_opts.tuples; i++) {
+		if (g_opts.batch > 0 && i % g_opts.batch == 0) {
+			db_begin();
+		}
+		g_keys[i] = next_rand() % g_key_space;
+		db_bind_long(stmt, 1, g_live + i);
+		db_bind_long(stmt, 2, g_keys[i]);
+		if (DB_ERROR(db_step(stmt, NULL))) {
+			res->failed++;
+		} else {
+			res->ops++;
+		}
+		if (g_opts.batch > 0 && (i % g_opts.batch == g_opts.batch - 1 || i == g_opts.tuples - 1)) {
+			if (DB_ERROR(db_commit())) {
+				res->failed++;
+			}
+		}
+	}
+	g_live += res->ops;
+	db_finalize(stmt);
+}
+
+static void phase_lookup(struct bench_result_s *res)
+{
+	db_stmt_t *stmt;
+	db_cursor_t *cursor;
+	long i;
+
+	if (DB_ERROR(db_prepare("SELECT id, val FROM bench WHERE val = ?;", &stmt))) {
+		res->failed = g_opts.lookups;
+		return;
+	}
+	for (i = 0; i < g_opts.lookups; i++) {
+		db_bind_long(stmt, 1, g_keys[next_rand() % g_opts.tuples]);
+		if (DB_ERROR(db_step(stmt, &cursor)) || cursor == NULL) {
+			res->failed++;
+			continue;
+		}
+		count_rows(cursor);
+		db_cursor_free(cursor);
+		res->ops++;
+	}
+	db_finalize(stmt);
+}
+
+static void phase_range(struct bench_result_s *res)
+{
+	db_stmt_t *stmt;
+	db_cursor_t *cursor;
+	long low;
+	long i;
+
+	if (DB_ERROR(db_prepare("SELECT id, val FROM bench WHERE val >= ? AND val < ?;", &stmt))) {
+		res->failed = g_opts.ranges;
+		return;
+	}
+	for (i = 0; i < g_opts.ranges; i++) {
+		low = next_rand() % g_key_space;
+		db_bind_long(stmt, 1, low);
+		db_bind_long(stmt, 2, low + g_opts.width);
+		if (DB_ERROR(db_step(stmt, &cursor)) || cursor == NULL) {
+			res->failed++;
+			continue;
+		}
+		count_rows(cursor);
+		db_cursor_free(cursor);
+		res->ops++;
+	}
+	db_finalize(stmt);
+}
+
+/* A removal rewrites the relation without its indexes, counted in rows removed */
+static void phase_delete(struct bench_result_s *res)
+{
+	char query[BENCH_QUERY_LEN];
+	db_cursor_t *cursor;
+	long left;
+
+	snprintf(query, sizeof(query), "REMOVE FROM bench WHERE val < %ld;", g_key_space * g_opts.delete_pct / 100);
+	cursor = db_query(query);
+	if (cursor == NULL) {
+		res->failed++;
+		return;
+	}
+	left = cursor_get_count(cursor);
+	db_cursor_free(cursor);
+	res->ops = g_live - left;
+	g_live = left;
+	g_indexed = 0;
+}
+
+/* Builds the index again over the rows left, counted in rows indexed */
+static void phase_vacuum(struct bench_result_s *res)
+{
+	db_result_t result;
+
+	if (g_indexed) {
+		result = db_exec("REBUILD INDEX bench.val;");
+	} else {
+		result = db_exec("CREATE INDEX bench.val TYPE bplustree;");
+	}
+	if (DB_ERROR(result)) {
+		res->failed++;
+		return;
+	}
+	g_indexed = 1;
+	res->ops = g_live;
+}
+
+struct bench_phase_s {
+	const char *name;
+	void (*run)(struct bench_result_s *res);
+};
+
+static const struct bench_phase_s g_phases[] = {
+	{"insert", phase_insert},
+	{"lookup", phase_lookup},
+	{"range", phase_range},
+	{"delete", phase_delete},
+	{"vacuum", phase_vacuum},
+};
+
+#define BENCH_NPHASES (sizeof(g_phases) / sizeof(g_phases[0]))
+
+static double hit_rate(unsigned long hits, unsigned long misses)
+{
+	if (hits + misses == 0) {
+		return 0.0;
+	}
+	return 100.0 * hits / (hits + misses);
+}
+
+static void run_phase(const struct bench_phase_s *phase)
+{
+	struct bench_result_s res = {0, 0};
+	struct bench_io_stats_s io;
+	struct index_cache_stats_s cache;
+	uint64_t start;
+	double wall;
+	double device;
+
+	bench_storage_reset_stats();
+	memset(&g_index_cache_stats, 0, sizeof(g_index_cache_stats));
+	start = now_ns();
+	phase->run(&res);
+	wall = (now_ns() - start) / 1e9;
+	bench_storage_get_stats(&io);
+	cache = g_index_cache_stats;
+	device = wall + io.sim_ns / 1e9;
+
+	printf("%-7s %7ld %5ld %10.0f %10.0f %7lu %7lu %6lu %8.1f %8.1f %7.1f%% %7.1f%%\n",
+		   phase->name, res.ops, res.failed, res.ops / wall, res.ops / device,
+		   io.reads, io.writes, io.syncs, io.bytes_read / 1024.0, io.bytes_written / 1024.0,
+		   hit_rate(cache.node_hits, cache.node_misses), hit_rate(cache.bucket_hits, cache.bucket_misses));
+}
+
+static int parse_mix(char *mix, const struct bench_phase_s **phases)
+{
+	char *name;
+	int count = 0;
+	unsigned int i;
+
+	for (name = strtok(mix, ","); name != NULL; name = strtok(NULL, ",")) {
+		for (i = 0; i < BENCH_NPHASES && strcmp(name, g_phases[i].name) != 0; i++) ;
+		if (i == BENCH_NPHASES || count == BENCH_MAX_PHASES) {
+			return -1;
+		}
+		phases[count++] = &g_phases[i];
+	}
+	return count;
+}
+
+static int parse_latency(const char *arg, struct bench_latency_s *latency)
+{
+	struct bench_latency_s l;
+
+	if (sscanf(arg, "%u,%u,%u,%u,%u,%u,%u", &l.open_us, &l.read_us, &l.write_us, &l.sync_us,
+			   &l.remove_us, &l.read_kb_us, &l.write_kb_us) != 7) {
+		return -1;
+	}
+	*latency = l;
+	return 0;
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [options]\n", prog);
+	fprintf(stderr, "  -b backend   posix, ram or flash (default ram)\n");
+	fprintf(stderr, "  -d dir       directory of the posix backend (default /tmp/arastorage_bench)\n");
+	fprintf(stderr, "  -L latency   us per open,read,write,sync,remove and per KiB read,written\n");
+	fprintf(stderr, "               (flash default %u,%u,%u,%u,%u,%u,%u)\n", g_flash_latency.open_us,
+			g_flash_latency.read_us, g_flash_latency.write_us, g_flash_latency.sync_us,
+			g_flash_latency.remove_us, g_flash_latency.read_kb_us, g_flash_latency.write_kb_us);
+	fprintf(stderr, "  -B bytes     block size reported by the storage (default 4096)\n");
+	fprintf(stderr, "  -n tuples    tuples inserted (default 1000)\n");
+	fprintf(stderr, "  -l lookups   point lookups (default 1000)\n");
+	fprintf(stderr, "  -r ranges    range scans (default 100)\n");
+	fprintf(stderr, "  -w width     key width of range scans (default 1%% of keys)\n");
+	fprintf(stderr, "  -D percent   keys removed by delete (default 25)\n");
+	fprintf(stderr, "  -t rows      insert in transactions of rows (default 0, no transaction)\n");
+	fprintf(stderr, "  -m mix       phases among insert,lookup,range,delete,vacuum\n");
+	fprintf(stderr, "               (default insert,lookup,range,delete,vacuum,lookup)\n");
+	fprintf(stderr, "  -s seed      seed of random keys (default 1)\n");
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	const struct bench_phase_s *phases[BENCH_MAX_PHASES];
+	char default_mix[] = "insert,lookup,range,delete,vacuum,lookup";
+	char *mix = default_mix;
+	int latency_set = 0;
+	int nphases;
+	int opt;
+	int i;
+
+	g_opts.backend = BENCH_BACKEND_RAM;
+	g_opts.dir = "/tmp/arastorage_bench";
+	g_opts.block_size = 4096;
+	g_opts.tuples = 1000;
+	g_opts.lookups = 1000;
+	g_opts.ranges = 100;
+	g_opts.delete_pct = 25;
+	g_opts.seed = 1;
+
+	while ((opt = getopt(argc, argv, "b:d:L:B:n:l:r:w:D:t:m:s:h")) != -1) {
+		switch (opt) {
+		case 'b':
+			if (strcmp(optarg, "posix") == 0) {
+				g_opts.backend = BENCH_BACKEND_POSIX;
+			} else if (strcmp(optarg, "ram") == 0) {
+				g_opts.backend = BENCH_BACKEND_RAM;
+			} else if (strcmp(optarg, "flash") == 0) {
+				g_opts.backend = BENCH_BACKEND_FLASH;
+			} else {
+				usage(argv[0]);
+				return 1;
+			}
+			break;
+		case 'd':
+			g_opts.dir = optarg;
+			break;
+		case 'L':
+			if (parse_latency(optarg, &g_opts.latency) != 0) {
+				usage(argv[0]);
+				return 1;
+			}
+			latency_set = 1;
+			break;
+		case 'B':
+			g_opts.block_size = atoi(optarg);
+			break;
+		case 'n':
+			g_opts.tuples = atol(optarg);
+			break;
+		case 'l':
+			g_opts.lookups = atol(optarg);
+			break;
+		case 'r':
+			g_opts.ranges = atol(optarg);
+			break;
+		case 'w':
+			g_opts.width = atol(optarg);
+			break;
+		case 'D':
+			g_opts.delete_pct = atoi(optarg);
+			break;
+		case 't':
+			g_opts.batch = atoi(optarg);
+			break;
+		case 'm':
+			mix = optarg;
+			break;
+		case 's':
+			g_opts.seed = atoi(optarg);
+			break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	nphases = parse_mix(mix, phases);
+	if (nphases <= 0 || g_opts.tuples <= 0 || g_opts.block_size == 0) {
+		usage(argv[0]);
+		return 1;
+	}
+	if (g_opts.backend == BENCH_BACKEND_FLASH && !latency_set) {
+		g_opts.latency = g_flash_latency;
+	}
+
+	/* Keys are spread over 4 times the tuples, so some of them repeat */
+	g_key_space = g_opts.tuples * 4;
+	if (g_opts.width == 0) {
+		g_opts.width = g_key_space / 100 + 1;
+	}
+	g_rand = g_opts.seed ? g_opts.seed : 1;
+	g_keys = (long *)calloc(g_opts.tuples, sizeof(long));
+	if (g_keys == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	if (bench_storage_setup(g_opts.backend, g_opts.dir, &g_opts.latency, g_opts.block_size) != 0) {
+		fprintf(stderr, "failed to set up storage\n");
+		free(g_keys);
+		return 1;
+	}
+	bench_storage_teardown();
+
+	if (DB_ERROR(db_init()) || DB_ERROR(db_exec("CREATE RELATION bench;"))
+		|| DB_ERROR(db_exec("CREATE ATTRIBUTE id DOMAIN long IN bench;"))
+		|| DB_ERROR(db_exec("CREATE ATTRIBUTE val DOMAIN long IN bench;"))
+		|| DB_ERROR(db_exec("CREATE INDEX bench.val TYPE bplustree;"))) {
+		fprintf(stderr, "failed to create relation\n");
+		db_deinit();
+		bench_storage_teardown();
+		free(g_keys);
+		return 1;
+	}
+	g_indexed = 1;
+
+	printf("%s backend, %ld tuples, tree cache %d nodes, NODE_LIMIT %d, BUCKETS_LIMIT %d, BRANCH_FACTOR %d\n",
+		   g_opts.backend == BENCH_BACKEND_POSIX ? "posix" : g_opts.backend == BENCH_BACKEND_RAM ? "ram" : "flash",
+		   g_opts.tuples, CONFIG_ARASTORAGE_TREE_CACHE_SIZE, CONFIG_NODE_LIMIT, CONFIG_BUCKETS_LIMIT, CONFIG_BRANCH_FACTOR);
+	printf("%-7s %7s %5s %10s %10s %7s %7s %6s %8s %8s %8s %8s\n", "phase", "ops", "fail", "ops/s",
+		   "dev ops/s", "reads", "writes", "syncs", "KiB rd", "KiB wr", "node hit", "bkt hit");
+	for (i = 0; i < nphases; i++) {
+		run_phase(phases[i]);
+	}
+	printf("storage used: %.1f KiB\n", bench_storage_used_bytes() / 1024.0);
+
+	db_exec("REMOVE RELATION bench;");
+	db_deinit();
+	bench_storage_teardown();
+	free(g_keys);
+	return 0;
+}
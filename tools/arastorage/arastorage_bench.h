@@ -0,0 +1,67 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/arastorage/arastorage_bench.h
+ *
+ * Storage backends of arastorage_bench. bench_storage.c implements the
+ * storage abstraction of framework/src/arastorage/storage.h on top of them.
+ ****************************************************************************/
+
+#ifndef __TOOLS_ARASTORAGE_ARASTORAGE_BENCH_H
+#define __TOOLS_ARASTORAGE_ARASTORAGE_BENCH_H
+
+#include <stdint.h>
+
+enum bench_backend_e {
+	BENCH_BACKEND_POSIX,		/* Files in a host directory */
+	BENCH_BACKEND_RAM,			/* Files in memory */
+	BENCH_BACKEND_FLASH			/* Files in memory with the latency of a flash device */
+};
+
+/* Simulated cost of each storage operation, added to a virtual clock */
+struct bench_latency_s {
+	unsigned int open_us;
+	unsigned int read_us;
+	unsigned int write_us;
+	unsigned int sync_us;
+	unsigned int remove_us;
+	unsigned int read_kb_us;	/* Per KiB read */
+	unsigned int write_kb_us;	/* Per KiB written */
+};
+
+struct bench_io_stats_s {
+	unsigned long opens;
+	unsigned long reads;
+	unsigned long writes;
+	unsigned long seeks;
+	unsigned long syncs;
+	unsigned long removes;
+	unsigned long renames;
+	uint64_t bytes_read;
+	uint64_t bytes_written;
+	uint64_t sim_ns;			/* Time spent by the simulated device */
+};
+
+int bench_storage_setup(enum bench_backend_e backend, const char *dir, const struct bench_latency_s *latency, unsigned int block_size);
+void bench_storage_teardown(void);
+void bench_storage_get_stats(struct bench_io_stats_s *stats);
+void bench_storage_reset_stats(void);
+uint64_t bench_storage_used_bytes(void);
+
+#endif /* __TOOLS_ARASTORAGE_ARASTORAGE_BENCH_H */
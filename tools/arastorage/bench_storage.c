@@ -0,0 +1,506 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/arastorage/bench_storage.c
+ *
+ * Storage abstraction of arastorage for host benchmarks, it replaces
+ * framework/src/arastorage/storage_abstraction.c in the host build.
+ * Files are kept in a host directory or in memory, every operation is
+ * counted and, when a latency is configured, charged to a virtual clock
+ * so that a flash device can be simulated without sleeping.
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "storage.h"
+#include "arastorage_bench.h"
+
+#define BENCH_MAX_FILES 32
+
+/* A file in memory, it's freed when removed and not open anymore */
+struct ram_file_s {
+	struct ram_file_s *next;
+	char *name;					/* NULL once removed */
+	unsigned char *data;
+	size_t size;
+	size_t capacity;
+	int refs;
+};
+
+struct ram_fd_s {
+	struct ram_file_s *file;	/* NULL if the descriptor is free */
+	size_t pos;
+	int oflag;
+};
+
+static enum bench_backend_e g_backend;
+static char g_dir[PATH_MAX];
+static struct bench_latency_s g_latency;
+static unsigned int g_block_size;
+static struct bench_io_stats_s g_stats;
+static struct ram_file_s *g_files;
+static struct ram_fd_s g_fds[BENCH_MAX_FILES];
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void charge(unsigned int op_us, unsigned int kb_us, size_t bytes)
+{
+	g_stats.sim_ns += (uint64_t)op_us * 1000 + (uint64_t)bytes * kb_us * 1000 / 1024;
+}
+
+static void host_path(char *path, const char *filename)
+{
+	/* g_dir leaves room for a file name, a longer one fails to be opened */
+	if (snprintf(path, PATH_MAX, "%s/%s", g_dir, filename) >= PATH_MAX) {
+		path[0] = '\0';
+	}
+}
+
+static struct ram_file_s *ram_find(const char *name)
+{
+	struct ram_file_s *file;
+
+	for (file = g_files; file != NULL; file = file->next) {
+		if (strcmp(file->name, name) == 0) {
+			return file;
+		}
+	}
+	return NULL;
+}
+
+static void ram_put(struct ram_file_s *file)
+{
+	if (--file->refs == 0 && file->name == NULL) {
+		free(file->data);
+		free(file);
+	}
+}
+
+/* Takes a file out of the directory, its data is kept while it's open */
+static void ram_unlink(struct ram_file_s *file)
+{
+	struct ram_file_s **link = &g_files;
+
+	while (*link != file) {
+		link = &(*link)->next;
+	}
+	*link = file->next;
+	free(file->name);
+	file->name = NULL;
+	file->refs++;
+	ram_put(file);
+}
+
+static struct ram_fd_s *ram_fd(db_storage_id_t fd)
+{
+	if (fd < 0 || fd >= BENCH_MAX_FILES || g_fds[fd].file == NULL) {
+		return NULL;
+	}
+	return &g_fds[fd];
+}
+
+static db_storage_id_t ram_open(const char *name, int oflag)
+{
+	struct ram_file_s *file;
+	db_storage_id_t fd;
+
+	for (fd = 0; fd < BENCH_MAX_FILES && g_fds[fd].file != NULL; fd++) ;
+	if (fd == BENCH_MAX_FILES) {
+		fprintf(stderr, "bench_storage: too many open files\n");
+		return INVALID_STORAGE_ID;
+	}
+
+	file = ram_find(name);
+	if (file == NULL) {
+		if (!(oflag & O_CREAT)) {
+			return INVALID_STORAGE_ID;
+		}
+		file = (struct ram_file_s *)calloc(1, sizeof(struct ram_file_s));
+		if (file == NULL) {
+			return INVALID_STORAGE_ID;
+		}
+		file->name = strdup(name);
+		if (file->name == NULL) {
+			free(file);
+			return INVALID_STORAGE_ID;
+		}
+		file->next = g_files;
+		g_files = file;
+	} else if ((oflag & O_TRUNC) && (oflag & O_ACCMODE) != O_RDONLY) {
+		file->size = 0;
+	}
+
+	file->refs++;
+	g_fds[fd].file = file;
+	g_fds[fd].pos = 0;
+	g_fds[fd].oflag = oflag;
+	return fd;
+}
+
+static ssize_t ram_write(struct ram_fd_s *rfd, const void *buffer, size_t length)
+{
+	struct ram_file_s *file = rfd->file;
+	size_t end;
+
+	if ((rfd->oflag & O_ACCMODE) == O_RDONLY) {
+		return -1;
+	}
+	if (rfd->oflag & O_APPEND) {
+		rfd->pos = file->size;
+	}
+
+	end = rfd->pos + length;
+	if (end > file->capacity) {
+		size_t capacity = file->capacity ? file->capacity : 256;
+		unsigned char *data;
+
+		while (capacity < end) {
+			capacity *= 2;
+		}
+		data = (unsigned char *)realloc(file->data, capacity);
+		if (data == NULL) {
+			return -1;
+		}
+		file->data = data;
+		file->capacity = capacity;
+	}
+	if (rfd->pos > file->size) {
+		memset(file->data + file->size, 0, rfd->pos - file->size);
+	}
+	memcpy(file->data + rfd->pos, buffer, length);
+	rfd->pos = end;
+	if (end > file->size) {
+		file->size = end;
+	}
+	return length;
+}
+
+static ssize_t ram_read(struct ram_fd_s *rfd, void *buffer, size_t length)
+{
+	struct ram_file_s *file = rfd->file;
+
+	if ((rfd->oflag & O_ACCMODE) == O_WRONLY) {
+		return -1;
+	}
+	if (rfd->pos >= file->size) {
+		return 0;
+	}
+	if (length > file->size - rfd->pos) {
+		length = file->size - rfd->pos;
+	}
+	memcpy(buffer, file->data + rfd->pos, length);
+	rfd->pos += length;
+	return length;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int bench_storage_setup(enum bench_backend_e backend, const char *dir, const struct bench_latency_s *latency, unsigned int block_size)
+{
+	g_backend = backend;
+	g_block_size = block_size;
+	memset(&g_latency, 0, sizeof(g_latency));
+	if (latency != NULL) {
+		g_latency = *latency;
+	}
+	if (backend == BENCH_BACKEND_POSIX) {
+		if (dir == NULL || strlen(dir) >= sizeof(g_dir) - NAME_MAX) {
+			return -1;
+		}
+		strcpy(g_dir, dir);
+		mkdir(g_dir, 0755);
+	}
+	bench_storage_reset_stats();
+	return 0;
+}
+
+/* Removes the files left by the benchmark */
+void bench_storage_teardown(void)
+{
+	pthread_mutex_lock(&g_lock);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		DIR *d = opendir(g_dir);
+		struct dirent *entry;
+		char path[PATH_MAX];
+
+		while (d != NULL && (entry = readdir(d)) != NULL) {
+			if (entry->d_name[0] != '.') {
+				host_path(path, entry->d_name);
+				unlink(path);
+			}
+		}
+		if (d != NULL) {
+			closedir(d);
+		}
+	} else {
+		while (g_files != NULL) {
+			ram_unlink(g_files);
+		}
+	}
+	pthread_mutex_unlock(&g_lock);
+}
+
+void bench_storage_get_stats(struct bench_io_stats_s *stats)
+{
+	pthread_mutex_lock(&g_lock);
+	*stats = g_stats;
+	pthread_mutex_unlock(&g_lock);
+}
+
+void bench_storage_reset_stats(void)
+{
+	pthread_mutex_lock(&g_lock);
+	memset(&g_stats, 0, sizeof(g_stats));
+	pthread_mutex_unlock(&g_lock);
+}
+
+/* Bytes of all the files, i.e. the space taken on the device */
+uint64_t bench_storage_used_bytes(void)
+{
+	uint64_t total = 0;
+
+	pthread_mutex_lock(&g_lock);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		DIR *d = opendir(g_dir);
+		struct dirent *entry;
+		struct stat st;
+		char path[PATH_MAX];
+
+		while (d != NULL && (entry = readdir(d)) != NULL) {
+			host_path(path, entry->d_name);
+			if (entry->d_name[0] != '.' && stat(path, &st) == 0) {
+				total += st.st_size;
+			}
+		}
+		if (d != NULL) {
+			closedir(d);
+		}
+	} else {
+		struct ram_file_s *file;
+
+		for (file = g_files; file != NULL; file = file->next) {
+			total += file->size;
+		}
+	}
+	pthread_mutex_unlock(&g_lock);
+	return total;
+}
+
+/*
+ * Storage abstraction of arastorage, see storage_abstraction.c
+ */
+
+db_storage_id_t storage_open(const char *filename, int oflag)
+{
+	db_storage_id_t fd;
+	char path[PATH_MAX];
+
+	pthread_mutex_lock(&g_lock);
+	g_stats.opens++;
+	charge(g_latency.open_us, 0, 0);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		host_path(path, filename);
+		fd = open(path, oflag, 0644);
+	} else {
+		fd = ram_open(filename, oflag);
+	}
+	pthread_mutex_unlock(&g_lock);
+	return fd;
+}
+
+db_storage_id_t storage_close(db_storage_id_t fd)
+{
+	struct ram_fd_s *rfd;
+	int ret = 0;
+
+	pthread_mutex_lock(&g_lock);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		ret = close(fd);
+	} else if ((rfd = ram_fd(fd)) != NULL) {
+		ram_put(rfd->file);
+		rfd->file = NULL;
+	} else {
+		ret = -1;
+	}
+	pthread_mutex_unlock(&g_lock);
+	return ret;
+}
+
+db_result_t storage_remove(const char *filename)
+{
+	struct ram_file_s *file;
+	char path[PATH_MAX];
+	db_result_t res = DB_STORAGE_ERROR;
+
+	pthread_mutex_lock(&g_lock);
+	g_stats.removes++;
+	charge(g_latency.remove_us, 0, 0);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		host_path(path, filename);
+		if (unlink(path) == OK) {
+			res = DB_OK;
+		}
+	} else if ((file = ram_find(filename)) != NULL) {
+		ram_unlink(file);
+		res = DB_OK;
+	}
+	pthread_mutex_unlock(&g_lock);
+	return res;
+}
+
+db_result_t storage_rename(const char *old_name, const char *new_name)
+{
+	struct ram_file_s *file;
+	struct ram_file_s *target;
+	char old_path[PATH_MAX];
+	char new_path[PATH_MAX];
+	char *name;
+	db_result_t res = DB_STORAGE_ERROR;
+
+	pthread_mutex_lock(&g_lock);
+	g_stats.renames++;
+	charge(g_latency.write_us, 0, 0);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		host_path(old_path, old_name);
+		host_path(new_path, new_name);
+		if (rename(old_path, new_path) == OK) {
+			res = DB_OK;
+		}
+	} else if ((file = ram_find(old_name)) != NULL && (name = strdup(new_name)) != NULL) {
+		target = ram_find(new_name);
+		if (target != NULL && target != file) {
+			ram_unlink(target);
+		}
+		free(file->name);
+		file->name = name;
+		res = DB_OK;
+	}
+	pthread_mutex_unlock(&g_lock);
+	return res;
+}
+
+off_t storage_seek(db_storage_id_t fd, unsigned long offset, int whence)
+{
+	struct ram_fd_s *rfd;
+	off_t pos = -1;
+
+	pthread_mutex_lock(&g_lock);
+	g_stats.seeks++;
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		pos = lseek(fd, offset, whence);
+	} else if ((rfd = ram_fd(fd)) != NULL) {
+		if (whence == SEEK_SET) {
+			rfd->pos = offset;
+		} else if (whence == SEEK_CUR) {
+			rfd->pos += offset;
+		} else {
+			rfd->pos = rfd->file->size + offset;
+		}
+		pos = rfd->pos;
+	}
+	pthread_mutex_unlock(&g_lock);
+	return pos;
+}
+
+ssize_t storage_read(db_storage_id_t fd, void *buffer, unsigned length)
+{
+	struct ram_fd_s *rfd;
+	ssize_t ret = -1;
+
+	pthread_mutex_lock(&g_lock);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		ret = read(fd, buffer, length);
+	} else if ((rfd = ram_fd(fd)) != NULL) {
+		ret = ram_read(rfd, buffer, length);
+	}
+	if (ret > 0) {
+		g_stats.reads++;
+		g_stats.bytes_read += ret;
+		charge(g_latency.read_us, g_latency.read_kb_us, ret);
+	}
+	pthread_mutex_unlock(&g_lock);
+	return ret;
+}
+
+ssize_t storage_write(db_storage_id_t fd, void *buffer, unsigned length)
+{
+	struct ram_fd_s *rfd;
+	ssize_t ret = -1;
+
+	pthread_mutex_lock(&g_lock);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		ret = write(fd, buffer, length);
+	} else if ((rfd = ram_fd(fd)) != NULL) {
+		ret = ram_write(rfd, buffer, length);
+	}
+	if (ret > 0) {
+		g_stats.writes++;
+		g_stats.bytes_written += ret;
+		charge(g_latency.write_us, g_latency.write_kb_us, ret);
+	}
+	pthread_mutex_unlock(&g_lock);
+	return ret;
+}
+
+db_result_t storage_sync(db_storage_id_t fd)
+{
+	db_result_t res = DB_OK;
+
+	pthread_mutex_lock(&g_lock);
+	g_stats.syncs++;
+	charge(g_latency.sync_us, 0, 0);
+	if (g_backend == BENCH_BACKEND_POSIX) {
+		if (fsync(fd) != OK) {
+			res = DB_STORAGE_ERROR;
+		}
+	} else if (ram_fd(fd) == NULL) {
+		res = DB_STORAGE_ERROR;
+	}
+	pthread_mutex_unlock(&g_lock);
+	return res;
+}
+
+#ifdef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+ssize_t storage_get_availbyte_size(void)
+{
+	struct stat st;
+
+	if (g_block_size != 0 || g_backend != BENCH_BACKEND_POSIX) {
+		return g_block_size;
+	}
+	if (stat(g_dir, &st) != OK) {
+		return 0;
+	}
+	return st.st_blksize;
+}
+#endif
@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/arastorage/host/debug.h
+ *
+ * arastorage logs through DB_LOG_* of db_debug.h, nothing is needed here.
+ ****************************************************************************/
+
+#ifndef __TOOLS_ARASTORAGE_HOST_DEBUG_H
+#define __TOOLS_ARASTORAGE_HOST_DEBUG_H
+
+#include <stdio.h>
+
+#endif /* __TOOLS_ARASTORAGE_HOST_DEBUG_H */
@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/arastorage/host/tinyara/config.h
+ *
+ * Configuration of arastorage sources built for host benchmarks.
+ * Any value can be overridden from the make command line, e.g.
+ *   make HOSTDEFS="-DCONFIG_ARASTORAGE_TREE_CACHE_SIZE=64 -DCONFIG_NODE_LIMIT=500"
+ ****************************************************************************/
+
+#ifndef __TOOLS_ARASTORAGE_HOST_TINYARA_CONFIG_H
+#define __TOOLS_ARASTORAGE_HOST_TINYARA_CONFIG_H
+
+/* TinyAra headers include these from sys/types.h, host ones don't */
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <fcntl.h>
+
+#ifndef CONFIG_NODE_LIMIT
+#define CONFIG_NODE_LIMIT 110
+#endif
+
+#ifndef CONFIG_BUCKETS_LIMIT
+#define CONFIG_BUCKETS_LIMIT 80
+#endif
+
+#ifndef CONFIG_BRANCH_FACTOR
+#define CONFIG_BRANCH_FACTOR 5
+#endif
+
+#ifndef CONFIG_DB_TUPLES_LIMIT
+#define CONFIG_DB_TUPLES_LIMIT 1000
+#endif
+
+#ifndef CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER
+#define CONFIG_ARASTORAGE_ENABLE_WRITE_BUFFER 1
+#endif
+
+#ifndef CONFIG_ARASTORAGE_TREE_CACHE_SIZE
+#define CONFIG_ARASTORAGE_TREE_CACHE_SIZE 16
+#endif
+
+#ifndef CONFIG_ARASTORAGE_TREE_CACHE_PARTITIONS
+#define CONFIG_ARASTORAGE_TREE_CACHE_PARTITIONS 2
+#endif
+
+#ifndef CONFIG_ARASTORAGE_CACHE_STATS
+#define CONFIG_ARASTORAGE_CACHE_STATS 1
+#endif
+
+/* Files are opened through the storage backends of the benchmark */
+#define CONFIG_MOUNT_POINT ""
+
+/* Definitions of TinyAra headers which the host ones don't have */
+#define OK 0
+#define TRUE 1
+#define FALSE 0
+#define O_RDOK O_RDONLY
+#define O_WROK O_WRONLY
+
+#endif /* __TOOLS_ARASTORAGE_HOST_TINYARA_CONFIG_H */
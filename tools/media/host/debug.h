@@ -0,0 +1,37 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/media/host/debug.h
+ *
+ * Debug macros of media framework sources built for host benchmarks.
+ * Errors go to stderr, verbose messages are compiled out.
+ ****************************************************************************/
+
+#ifndef __TOOLS_MEDIA_HOST_DEBUG_H
+#define __TOOLS_MEDIA_HOST_DEBUG_H
+
+#include <stdio.h>
+
+#define meddbg(...)  fprintf(stderr, __VA_ARGS__)
+#define medwdbg(...) fprintf(stderr, __VA_ARGS__)
+#define medvdbg(...) do { } while (0)
+#define auddbg(...)  fprintf(stderr, __VA_ARGS__)
+#define audvdbg(...) do { } while (0)
+
+#endif /* __TOOLS_MEDIA_HOST_DEBUG_H */
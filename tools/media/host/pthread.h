@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/media/host/pthread.h
+ *
+ * TinyAra extensions of pthread.h used by media framework sources.
+ ****************************************************************************/
+
+#ifndef __TOOLS_MEDIA_HOST_PTHREAD_H
+#define __TOOLS_MEDIA_HOST_PTHREAD_H
+
+#include_next <pthread.h>
+
+#ifndef PTHREAD_STACK_DEFAULT
+#define PTHREAD_STACK_DEFAULT (64 * 1024)
+#endif
+
+typedef void *(*pthread_startroutine_t)(void *);
+
+#endif /* __TOOLS_MEDIA_HOST_PTHREAD_H */
@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/media/host/tinyara/config.h
+ *
+ * Configuration of media framework sources built for host benchmarks.
+ * Any value can be overridden from the make command line, e.g.
+ *   make HOSTDEFS=-DCONFIG_AUDIO_CODEC_RINGBUFFER_SIZE=8192
+ ****************************************************************************/
+
+#ifndef __TOOLS_MEDIA_HOST_TINYARA_CONFIG_H
+#define __TOOLS_MEDIA_HOST_TINYARA_CONFIG_H
+
+#ifndef CONFIG_AUDIO_CODEC
+#define CONFIG_AUDIO_CODEC 1
+#endif
+
+#ifndef CONFIG_AUDIO_CODEC_RINGBUFFER_SIZE
+#define CONFIG_AUDIO_CODEC_RINGBUFFER_SIZE 16384
+#endif
+
+#ifndef CONFIG_AUDIO_RESAMPLER_BUFSIZE
+#define CONFIG_AUDIO_RESAMPLER_BUFSIZE 4096
+#endif
+
+#ifndef CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE
+#define CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE 4096
+#endif
+
+#ifndef CONFIG_FILE_DATASOURCE_STREAM_BUFFER_THRESHOLD
+#define CONFIG_FILE_DATASOURCE_STREAM_BUFFER_THRESHOLD 2048
+#endif
+
+/* Host threads need larger stacks than the target ones */
+#ifndef CONFIG_MEDIA_PLAYER_STACKSIZE
+#define CONFIG_MEDIA_PLAYER_STACKSIZE 65536
+#endif
+
+#ifndef CONFIG_MEDIA_PLAYER_OBSERVER_STACKSIZE
+#define CONFIG_MEDIA_PLAYER_OBSERVER_STACKSIZE 65536
+#endif
+
+#ifndef CONFIG_INPUT_DATASOURCE_STACKSIZE
+#define CONFIG_INPUT_DATASOURCE_STACKSIZE 65536
+#endif
+
+#ifndef CONFIG_FILE_DATASOURCE_READAHEAD_STACKSIZE
+#define CONFIG_FILE_DATASOURCE_READAHEAD_STACKSIZE 65536
+#endif
+
+#ifdef CONFIG_CODEC_LIBOPUS
+#ifndef CONFIG_OPUS_ENCODE_COMPLEXITY
+#define CONFIG_OPUS_ENCODE_COMPLEXITY 0
+#endif
+
+#ifndef CONFIG_OPUS_ENCODE_FRAMESIZE
+#define CONFIG_OPUS_ENCODE_FRAMESIZE 20
+#endif
+
+#ifndef CONFIG_OPUS_ENCODE_BITRATE
+#define CONFIG_OPUS_ENCODE_BITRATE 16000
+#endif
+#endif
+
+#define OK 0
+
+#endif /* __TOOLS_MEDIA_HOST_TINYARA_CONFIG_H */
@@ -0,0 +1,678 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/media/pipeline_bench.cpp
+ *
+ * Host benchmark of the media pipeline of framework/src/media, built from
+ * the same MediaPlayer, data source, Decoder, Encoder, StreamBuffer and
+ * resampler sources as the target.
+ *
+ * Playback runs MediaPlayer end to end: its InputDataSource worker reads the
+ * input in 1KB chunks and decodes it into the StreamBuffer, and the player
+ * worker hands periods to the output stream of audio_manager. On host, it's
+ * implemented by pipeline_output.cpp, which resamples them to the card rate
+ * and writes them to a null audio card, dropping them like audio_null.
+ * Recording runs a null capture card producing a tone, encodes it to Opus
+ * through the StreamBuffer, and saves it, then it's played back as well.
+ *
+ * Reported for each configuration:
+ *   frames/s   output frames per second of wall time
+ *   xRT        speed relative to real time
+ *   cpu-ms/s   CPU time of the process per second of audio
+ *   heap-KB    peak heap used by the pipeline
+ *   start-ms   time from MediaPlayer::start() until the first period reached the card
+ *   underruns  periods late to the card (only with -R)
+ * and with -v, latency histograms of each stage:
+ *   source     reading a chunk and decoding it into the StreamBuffer,
+ *              including the time blocked on a full StreamBuffer
+ *   resample   converting a period to the card rate
+ *   card       writing a period to the card, blocking with -R
+ * and wakeups and underruns counted by MediaPlayer::getStats().
+ *
+ * Build & run: make -C tools/media && ./tools/media/pipeline_bench -h
+ ****************************************************************************/
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <media/MediaPlayer.h>
+#include <media/MediaPlayerObserverInterface.h>
+#include <media/FileInputDataSource.h>
+#include "Decoder.h"
+#include "StreamBuffer.h"
+#include "utils/MediaUtils.h"
+#include "pipeline_bench.h"
+
+using namespace media;
+using namespace media::stream;
+
+#define BENCH_TONE_SECONDS   (10)
+#define BENCH_TONE_RATE      (44100)
+#define BENCH_TONE_CHANNELS  (2)
+#define BENCH_MAX_CONFIGS    (8)
+
+/****************************************************************************
+ * Heap accounting
+ *
+ * malloc family is wrapped by the linker (-Wl,--wrap=malloc,...), and C++
+ * allocations are routed to it, so every allocation of the pipeline is counted.
+ ****************************************************************************/
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+}
+
+static std::atomic<long long> g_heap_used(0);
+static std::atomic<long long> g_heap_peak(0);
+
+static void heap_add(void *ptr)
+{
+	if (ptr) {
+		long long used = g_heap_used += (long long)malloc_usable_size(ptr);
+		long long peak = g_heap_peak.load();
+		while (used > peak && !g_heap_peak.compare_exchange_weak(peak, used)) {
+		}
+	}
+}
+
+static void heap_sub(void *ptr)
+{
+	if (ptr) {
+		g_heap_used -= (long long)malloc_usable_size(ptr);
+	}
+}
+
+extern "C" {
+void *__wrap_malloc(size_t size)
+{
+	void *ptr = __real_malloc(size);
+	heap_add(ptr);
+	return ptr;
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+	void *ptr = __real_calloc(nmemb, size);
+	heap_add(ptr);
+	return ptr;
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+	heap_sub(ptr);
+	void *newptr = __real_realloc(ptr, size);
+	heap_add(newptr ? newptr : (size ? ptr : NULL));
+	return newptr;
+}
+
+void __wrap_free(void *ptr)
+{
+	heap_sub(ptr);
+	__real_free(ptr);
+}
+}
+
+void *operator new(size_t size)
+{
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+static const char *g_source_names[] = { "file", "buffer" };
+
+/****************************************************************************
+ * Playback
+ *
+ * MediaPlayer plays the input from a data source, the way applications do,
+ * and its output stream goes to the null card of pipeline_output.cpp.
+ ****************************************************************************/
+
+static std::shared_ptr<StreamBuffer> bench_stream_buffer(const bench_config &config)
+{
+	return StreamBuffer::Builder().setBufferSize(config.bufferSize).setThreshold(config.threshold).build();
+}
+
+/* FileInputDataSource with the StreamBuffer measured */
+class bench_file_source : public FileInputDataSource
+{
+public:
+	bench_file_source(const bench_config &config, bench_result &result)
+		: FileInputDataSource(config.path), mResult(result)
+	{
+		setStreamBuffer(bench_stream_buffer(config));
+	}
+
+protected:
+	ssize_t onStreamBufferWritable() override
+	{
+		bench_scope scope(mResult.source);
+		return FileInputDataSource::onStreamBufferWritable();
+	}
+
+private:
+	bench_result &mResult;
+};
+
+/* Serves the input from memory in chunks, like FileInputDataSource does from the file */
+class bench_memory_source : public InputDataSource
+{
+public:
+	bench_memory_source(const bench_config &config, const std::vector<unsigned char> &memory, bench_result &result)
+		: mPath(config.path), mMemory(memory), mResult(result), mPosition(0), mOpened(false)
+	{
+		setStreamBuffer(bench_stream_buffer(config));
+	}
+
+	virtual ~bench_memory_source()
+	{
+		close();
+	}
+
+	bool open() override
+	{
+		if (!mOpened) {
+			setAudioType(utils::getAudioTypeFromPath(mPath));
+			registerDecoder(getAudioType(), getChannels(), getSampleRate());
+			mPosition = 0;
+			mOpened = true;
+			start();
+		}
+		return true;
+	}
+
+	bool close() override
+	{
+		if (!mOpened) {
+			return false;
+		}
+		stop();
+		unregisterDecoder();
+		mOpened = false;
+		return true;
+	}
+
+	bool isPrepare() override
+	{
+		return mOpened;
+	}
+
+	int seek(long offset, int origin) override
+	{
+		long position = offset;
+		if (origin == SEEK_CUR) {
+			position += (long)mPosition;
+		} else if (origin == SEEK_END) {
+			position += (long)mMemory.size();
+		}
+		if (position < 0 || (size_t)position > mMemory.size()) {
+			return -1;
+		}
+		mPosition = (size_t)position;
+		return 0;
+	}
+
+protected:
+	ssize_t onStreamBufferWritable() override
+	{
+		bench_scope scope(mResult.source);
+		unsigned char buf[BENCH_CHUNK_SIZE];
+
+		size_t rlen = mMemory.size() - mPosition;
+		if (rlen > sizeof(buf)) {
+			rlen = sizeof(buf);
+		}
+		if (rlen == 0) {
+			completeFrameIndex();
+			return 0;
+		}
+
+		// Decoder may use the data as scratch buffer, so it's copied like a read
+		memcpy(buf, mMemory.data() + mPosition, rlen);
+		mPosition += rlen;
+		return writeToStreamBuffer(buf, rlen);
+	}
+
+private:
+	std::string mPath;
+	const std::vector<unsigned char> &mMemory;
+	bench_result &mResult;
+	size_t mPosition;
+	bool mOpened;
+};
+
+class bench_observer : public MediaPlayerObserverInterface
+{
+public:
+	bench_observer() : mDone(false), mFailed(false) {}
+
+	void onPlaybackStarted(MediaPlayer &mediaPlayer) override {}
+	void onPlaybackFinished(MediaPlayer &mediaPlayer) override { finish(false); }
+	void onPlaybackError(MediaPlayer &mediaPlayer, player_error_t error) override { finish(true); }
+	void onStartError(MediaPlayer &mediaPlayer, player_error_t error) override { finish(true); }
+	void onStopError(MediaPlayer &mediaPlayer, player_error_t error) override { finish(true); }
+	void onPauseError(MediaPlayer &mediaPlayer, player_error_t error) override {}
+	void onPlaybackPaused(MediaPlayer &mediaPlayer) override {}
+
+	/* Wait until playback finishes, returns false on errors */
+	bool wait()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mCondv.wait(lock, [this] { return mDone; });
+		return !mFailed;
+	}
+
+private:
+	void finish(bool failed)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (!mDone) {
+			mDone = true;
+			mFailed = failed;
+			mCondv.notify_one();
+		}
+	}
+
+	std::mutex mMutex;
+	std::condition_variable mCondv;
+	bool mDone;
+	bool mFailed;
+};
+
+/* Format of the decoded input, which an application knows from its content */
+static bool bench_probe_format(const std::vector<unsigned char> &memory, unsigned int &rate, unsigned int &channels)
+{
+	Decoder decoder(channels, rate);
+	std::vector<unsigned char> chunk;
+	std::vector<unsigned char> pcm(CONFIG_AUDIO_CODEC_RINGBUFFER_SIZE);
+	size_t position = 0;
+
+	while (position < memory.size()) {
+		size_t len = memory.size() - position;
+		if (len > BENCH_CHUNK_SIZE) {
+			len = BENCH_CHUNK_SIZE;
+		}
+		chunk.assign(memory.begin() + position, memory.begin() + position + len);
+		size_t pushed = decoder.pushData(chunk.data(), len);
+		if (pushed == 0) {
+			return false;
+		}
+		position += pushed;
+
+		size_t size = pcm.size();
+		unsigned int sampleRate;
+		unsigned short frameChannels;
+		if (decoder.getFrame(pcm.data(), &size, &sampleRate, &frameChannels)) {
+			rate = sampleRate;
+			channels = frameChannels;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool bench_play(const bench_config &config, const std::vector<unsigned char> &memory, bench_result &result)
+{
+	std::unique_ptr<InputDataSource> source;
+	if (config.source == BENCH_SOURCE_FILE) {
+		source.reset(new bench_file_source(config, result));
+	} else {
+		source.reset(new bench_memory_source(config, memory, result));
+	}
+	source->setSampleRate(config.pcmRate);
+	source->setChannels(config.pcmChannels);
+	source->setPcmFormat(AUDIO_FORMAT_TYPE_S16_LE);
+
+	auto observer = std::make_shared<bench_observer>();
+	MediaPlayer mp;
+	bench_output_setup(config, result);
+	if (mp.create() != PLAYER_OK) {
+		return false;
+	}
+	mp.setObserver(observer);
+
+	bool ok = mp.setDataSource(std::move(source)) == PLAYER_OK && mp.prepare() == PLAYER_OK;
+	if (ok) {
+		uint64_t begin = bench_now_ns();
+		ok = mp.start() == PLAYER_OK && observer->wait();
+		if (result.startNs != 0) {
+			result.startNs -= begin;
+		}
+
+		player_stats_t stats;
+		if (mp.getStats(&stats) == PLAYER_OK) {
+			result.wakeups = stats.wakeups;
+			result.inputUnderruns = stats.inputUnderruns;
+			result.deviceUnderruns = stats.deviceUnderruns;
+		}
+		mp.unprepare();
+	}
+	mp.destroy();
+
+	return ok;
+}
+
+/****************************************************************************
+ * Main
+ ****************************************************************************/
+
+static void bench_print_header(void)
+{
+	printf("%-8s %-6s %-7s %6s %6s %6s %10s %7s %8s %8s %8s %9s\n", "mode", "codec", "source", "buffer", "thresh",
+		   "card", "frames/s", "xRT", "cpu-ms/s", "heap-KB", "start-ms", "underruns");
+}
+
+static void bench_print_result(const char *mode, const char *codec, const char *source, const bench_config &config,
+							   const bench_result &result, unsigned int rate, bool verbose)
+{
+	double wall = result.wallNs / 1e9;
+	double audio = result.sourceRate ? (double)result.sourceFrames / result.sourceRate : 0.0;
+
+	if (result.failed || audio == 0.0) {
+		printf("%-8s %-6s %-7s %6zu %6zu %6u %10s\n", mode, codec, source, config.bufferSize, config.threshold, rate, "failed");
+		return;
+	}
+
+	printf("%-8s %-6s %-7s %6zu %6zu %6u %10.0f %7.1f %8.2f %8.1f %8.2f %9u\n", mode, codec, source,
+		   config.bufferSize, config.threshold, rate, result.cardFrames / wall, audio / wall,
+		   result.cpuNs / 1e6 / audio, result.heapPeak / 1024.0, result.startNs / 1e6, result.xruns);
+
+	if (verbose) {
+		printf("    %-9s %8s %10s %10s %10s %10s\n", "stage(us)", "count", "avg", "p50", "p99", "max");
+		result.read.print();
+		result.decode.print();
+		result.full.print();
+		result.source.print();
+		result.resample.print();
+		result.card.print();
+		if (result.wakeups > 0) {
+			printf("    player wakeups %u, input underruns %u, device underruns %u\n", result.wakeups,
+				   result.inputUnderruns, result.deviceUnderruns);
+		}
+	}
+}
+
+/* Parse comma separated list of numbers */
+static std::vector<unsigned long> bench_parse_list(const char *arg)
+{
+	std::vector<unsigned long> list;
+	char *end;
+
+	while (*arg && list.size() < BENCH_MAX_CONFIGS) {
+		list.push_back(strtoul(arg, &end, 0));
+		if (*end != ',') {
+			break;
+		}
+		arg = end + 1;
+	}
+
+	return list;
+}
+
+static void bench_usage(const char *prog)
+{
+	fprintf(stderr,
+			"usage: %s [options] [input]\n"
+			"  input            mp3/aac/opus file, or raw 16bit PCM; a generated tone if omitted\n"
+			"  -s file,buffer   data sources, 'buffer' serves the input from memory\n"
+			"  -b SIZES         StreamBuffer sizes in bytes (default %d)\n"
+			"  -t SIZES         StreamBuffer thresholds in bytes (default %d)\n"
+			"  -r RATES         null card sample rates (default 48000)\n"
+			"  -p FRAMES        period size in frames (default 1024)\n"
+			"  -f RATE -c CH    format of raw PCM input, or decoded Opus (default %d, %d)\n"
+			"  -e SECONDS       record Opus for the duration, then play it back\n"
+			"  -R               pace the null cards in real time, count underruns\n"
+			"  -v               print latency histograms of stages\n",
+			prog, CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE, CONFIG_FILE_DATASOURCE_STREAM_BUFFER_THRESHOLD,
+			BENCH_TONE_RATE, BENCH_TONE_CHANNELS);
+}
+
+int main(int argc, char **argv)
+{
+	std::vector<unsigned long> sizes = { CONFIG_FILE_DATASOURCE_STREAM_BUFFER_SIZE };
+	std::vector<unsigned long> thresholds = { CONFIG_FILE_DATASOURCE_STREAM_BUFFER_THRESHOLD };
+	std::vector<unsigned long> rates = { 48000 };
+	std::vector<bench_source_e> sources = { BENCH_SOURCE_FILE, BENCH_SOURCE_BUFFER };
+	bench_config config;
+	unsigned int recordSeconds = 0;
+	bool verbose = false;
+	bool formatSet = false;
+	char tonePath[] = "/tmp/pipeline_bench_XXXXXX";
+	std::string recordPath;
+	int opt;
+
+	config.periodFrames = 1024;
+	config.realtime = false;
+	config.pcmRate = BENCH_TONE_RATE;
+	config.pcmChannels = BENCH_TONE_CHANNELS;
+
+	while ((opt = getopt(argc, argv, "s:b:t:r:p:f:c:e:Rvh")) != -1) {
+		switch (opt) {
+		case 's':
+			sources.clear();
+			if (strstr(optarg, "file")) {
+				sources.push_back(BENCH_SOURCE_FILE);
+			}
+			if (strstr(optarg, "buffer")) {
+				sources.push_back(BENCH_SOURCE_BUFFER);
+			}
+			break;
+		case 'b':
+			sizes = bench_parse_list(optarg);
+			break;
+		case 't':
+			thresholds = bench_parse_list(optarg);
+			break;
+		case 'r':
+			rates = bench_parse_list(optarg);
+			break;
+		case 'p':
+			config.periodFrames = atoi(optarg);
+			break;
+		case 'f':
+			config.pcmRate = atoi(optarg);
+			formatSet = true;
+			break;
+		case 'c':
+			config.pcmChannels = atoi(optarg);
+			formatSet = true;
+			break;
+		case 'e':
+			recordSeconds = atoi(optarg);
+			break;
+		case 'R':
+			config.realtime = true;
+			break;
+		case 'v':
+			verbose = true;
+			break;
+		default:
+			bench_usage(argv[0]);
+			return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (sources.empty() || sizes.empty() || thresholds.empty() || rates.empty() || config.periodFrames == 0 ||
+		config.pcmRate == 0 || config.pcmChannels == 0) {
+		bench_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	bench_print_header();
+
+	if (optind < argc) {
+		config.path = argv[optind];
+	} else if (recordSeconds > 0) {
+#ifdef CONFIG_CODEC_LIBOPUS
+		bench_result result;
+		config.bufferSize = sizes[0];
+		config.threshold = thresholds[0];
+		int fd = mkstemp(tonePath);
+		if (fd < 0) {
+			fprintf(stderr, "can't create %s\n", tonePath);
+			return EXIT_FAILURE;
+		}
+		close(fd);
+		recordPath = std::string(tonePath) + ".opus";
+		rename(tonePath, recordPath.c_str());
+		g_heap_peak = g_heap_used.load();
+		long long base = g_heap_used;
+		uint64_t cpu = bench_now_ns(CLOCK_PROCESS_CPUTIME_ID);
+		uint64_t wall = bench_now_ns();
+		bench_record(recordPath.c_str(), recordSeconds, config, result);
+		result.wallNs = bench_now_ns() - wall;
+		result.cpuNs = bench_now_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+		result.heapPeak = g_heap_peak - base;
+		bench_print_result("record", "opus", "null", config, result, BENCH_RECORD_RATE, verbose);
+		config.path = recordPath;
+#else
+		fprintf(stderr, "recording needs Opus, build with 'make OPUS=1'\n");
+		return EXIT_FAILURE;
+#endif
+	} else {
+		// Generated tone as raw PCM
+		int fd = mkstemp(tonePath);
+		FILE *fp = fd >= 0 ? fdopen(fd, "wb") : NULL;
+		if (!fp) {
+			fprintf(stderr, "can't create %s\n", tonePath);
+			return EXIT_FAILURE;
+		}
+		null_card tone(config.pcmRate, config.pcmChannels, false);
+		std::vector<int16_t> period(config.pcmRate * config.pcmChannels);
+		for (int i = 0; i < BENCH_TONE_SECONDS; i++) {
+			tone.read(period.data(), config.pcmRate);
+			fwrite(period.data(), sizeof(int16_t), period.size(), fp);
+		}
+		fclose(fp);
+		config.path = std::string(tonePath) + ".pcm";
+		rename(tonePath, config.path.c_str());
+		recordPath = config.path;
+	}
+
+	// Input is loaded to memory before measuring buffer source
+	std::vector<unsigned char> memory;
+	FILE *fp = fopen(config.path.c_str(), "rb");
+	if (!fp) {
+		fprintf(stderr, "can't open %s\n", config.path.c_str());
+		return EXIT_FAILURE;
+	}
+	unsigned char chunk[4096];
+	size_t n;
+	while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+		memory.insert(memory.end(), chunk, chunk + n);
+	}
+	fclose(fp);
+
+	std::string ext = config.path.substr(config.path.find_last_of('.') + 1);
+	audio_type_t type = utils::getAudioTypeFromPath(config.path);
+	const char *codec = (type == AUDIO_TYPE_MP3 || type == AUDIO_TYPE_AAC || type == AUDIO_TYPE_OPUS) ? ext.c_str() : "pcm";
+	if (type == AUDIO_TYPE_OPUS && !formatSet) {
+		// Opus is decoded to the format requested, its native rate by default
+		config.pcmRate = 48000;
+	}
+	if ((type == AUDIO_TYPE_MP3 || type == AUDIO_TYPE_AAC || type == AUDIO_TYPE_OPUS) &&
+		!bench_probe_format(memory, config.pcmRate, config.pcmChannels)) {
+		fprintf(stderr, "can't decode %s\n", config.path.c_str());
+		return EXIT_FAILURE;
+	}
+
+	int ret = EXIT_SUCCESS;
+	for (auto source : sources) {
+		for (auto size : sizes) {
+			for (auto threshold : thresholds) {
+				for (auto rate : rates) {
+					bench_result result;
+					config.source = source;
+					config.bufferSize = size;
+					config.threshold = threshold < size ? threshold : size;
+					config.cardRate = rate;
+
+					g_heap_peak = g_heap_used.load();
+					long long base = g_heap_used;
+					uint64_t cpu = bench_now_ns(CLOCK_PROCESS_CPUTIME_ID);
+					uint64_t wall = bench_now_ns();
+					if (!bench_play(config, memory, result)) {
+						result.failed = true;
+						ret = EXIT_FAILURE;
+					}
+					result.wallNs = bench_now_ns() - wall;
+					result.cpuNs = bench_now_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu;
+					result.heapPeak = g_heap_peak - base;
+					bench_print_result("play", codec, g_source_names[source], config, result, rate, verbose);
+				}
+			}
+		}
+	}
+
+	if (!recordPath.empty()) {
+		unlink(recordPath.c_str());
+	}
+	return ret;
+}
@@ -0,0 +1,267 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/media/pipeline_bench.h
+ *
+ * Definitions shared by playback and recording of pipeline_bench.
+ ****************************************************************************/
+
+#ifndef __TOOLS_MEDIA_PIPELINE_BENCH_H
+#define __TOOLS_MEDIA_PIPELINE_BENCH_H
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <string>
+
+#define BENCH_CHUNK_SIZE     (1024)
+#define BENCH_RECORD_RATE    (16000)
+#define BENCH_RECORD_CH      (1)
+#define BENCH_HIST_BUCKETS   (40)
+
+/****************************************************************************
+ * Timing and latency histograms
+ ****************************************************************************/
+
+static inline uint64_t bench_now_ns(clockid_t clk = CLOCK_MONOTONIC)
+{
+	struct timespec ts;
+	clock_gettime(clk, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Latency histogram in power of 2 nanoseconds, each one is updated by one thread only */
+struct bench_hist {
+	const char *name;
+	uint64_t bucket[BENCH_HIST_BUCKETS];
+	uint64_t count;
+	uint64_t sum;
+	uint64_t max;
+
+	explicit bench_hist(const char *n) : name(n), count(0), sum(0), max(0)
+	{
+		memset(bucket, 0, sizeof(bucket));
+	}
+
+	void add(uint64_t ns)
+	{
+		int b = 0;
+		while (b < BENCH_HIST_BUCKETS - 1 && (ns >> b) > 1) {
+			b++;
+		}
+		bucket[b]++;
+		count++;
+		sum += ns;
+		if (ns > max) {
+			max = ns;
+		}
+	}
+
+	/* Upper bound of the bucket holding the percentile, at most the maximum */
+	double percentileUs(unsigned int pct) const
+	{
+		uint64_t target = (count * pct + 99) / 100;
+		uint64_t seen = 0;
+		for (int b = 0; b < BENCH_HIST_BUCKETS; b++) {
+			seen += bucket[b];
+			if (seen >= target && seen > 0) {
+				uint64_t bound = 2ULL << b;
+				return (double)(bound < max ? bound : max) / 1000.0;
+			}
+		}
+		return 0.0;
+	}
+
+	void print() const
+	{
+		if (count == 0) {
+			return;
+		}
+		printf("    %-9s %8llu %10.1f %10.1f %10.1f %10.1f\n", name, (unsigned long long)count,
+			   (double)sum / count / 1000.0, percentileUs(50), percentileUs(99), (double)max / 1000.0);
+	}
+};
+
+/* Measures the scope it's declared in */
+class bench_scope
+{
+public:
+	explicit bench_scope(bench_hist &hist) : mHist(hist), mStart(bench_now_ns()) {}
+	~bench_scope() { mHist.add(bench_now_ns() - mStart); }
+
+private:
+	bench_hist &mHist;
+	uint64_t mStart;
+};
+
+/* Measures the scope it's declared in, time blocked within it is counted apart */
+class bench_split_scope
+{
+public:
+	bench_split_scope(bench_hist &busy, bench_hist &blocked)
+		: mBusy(busy), mBlocked(blocked), mStart(bench_now_ns()), mBlockStart(0), mBlockedNs(0) {}
+	~bench_split_scope()
+	{
+		mBusy.add(bench_now_ns() - mStart - mBlockedNs);
+		mBlocked.add(mBlockedNs);
+	}
+
+	void block() { mBlockStart = bench_now_ns(); }
+	void unblock() { mBlockedNs += bench_now_ns() - mBlockStart; }
+
+private:
+	bench_hist &mBusy;
+	bench_hist &mBlocked;
+	uint64_t mStart;
+	uint64_t mBlockStart;
+	uint64_t mBlockedNs;
+};
+
+/****************************************************************************
+ * Null audio cards
+ *
+ * Like audio_null, data written is dropped and capture gives generated data.
+ * In real time mode, periods are paced at the card rate, so late periods
+ * are counted as underruns/overruns.
+ ****************************************************************************/
+
+class null_card
+{
+public:
+	null_card(unsigned int rate, unsigned int channels, bool realtime)
+		: mRate(rate), mChannels(channels), mRealtime(realtime), mFrames(0), mStartNs(0), mXruns(0), mPhase(0.0) {}
+
+	unsigned int rate() const { return mRate; }
+	unsigned int channels() const { return mChannels; }
+	uint64_t frames() const { return mFrames; }
+	unsigned int xruns() const { return mXruns; }
+
+	/* Playback, returns frames consumed */
+	unsigned int write(const int16_t *data, unsigned int frames)
+	{
+		(void)data;
+		pace(frames);
+		return frames;
+	}
+
+	/* Capture of a 1KHz tone */
+	unsigned int read(int16_t *data, unsigned int frames)
+	{
+		double w = 2.0 * M_PI * 1000.0 / mRate;
+		for (unsigned int i = 0; i < frames; i++) {
+			int16_t v = (int16_t)lrint(16000.0 * sin(mPhase));
+			for (unsigned int ch = 0; ch < mChannels; ch++) {
+				data[i * mChannels + ch] = v;
+			}
+			mPhase += w;
+		}
+		mPhase = fmod(mPhase, 2.0 * M_PI);
+		pace(frames);
+		return frames;
+	}
+
+private:
+	void pace(unsigned int frames)
+	{
+		uint64_t now = bench_now_ns();
+		if (mStartNs == 0) {
+			mStartNs = now;
+		}
+
+		if (mRealtime) {
+			// Device position of the first frame of this period
+			uint64_t due = mStartNs + mFrames * 1000000000ULL / mRate;
+			if (now > due + 1000000000ULL * frames / mRate) {
+				// The whole period is late, device ran out of data.
+				mXruns++;
+				mStartNs = now - mFrames * 1000000000ULL / mRate;
+			} else if (due > now) {
+				struct timespec ts = { (time_t)(due / 1000000000ULL), (long)(due % 1000000000ULL) };
+				clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+			}
+		}
+
+		mFrames += frames;
+	}
+
+	unsigned int mRate;
+	unsigned int mChannels;
+	bool mRealtime;
+	uint64_t mFrames;
+	uint64_t mStartNs;
+	unsigned int mXruns;
+	double mPhase;
+};
+/****************************************************************************
+ * Benchmark configuration and result
+ ****************************************************************************/
+
+enum bench_source_e {
+	BENCH_SOURCE_FILE,
+	BENCH_SOURCE_BUFFER,
+};
+
+struct bench_config {
+	std::string path;            // input file, empty for a generated tone
+	bench_source_e source;
+	size_t bufferSize;
+	size_t threshold;
+	unsigned int cardRate;
+	unsigned int periodFrames;
+	bool realtime;
+	// Format of raw PCM input
+	unsigned int pcmRate;
+	unsigned int pcmChannels;
+};
+
+struct bench_result {
+	bench_hist read;
+	bench_hist decode;
+	bench_hist full;
+	bench_hist source;
+	bench_hist resample;
+	bench_hist card;
+	uint64_t sourceFrames;
+	unsigned int sourceRate;
+	uint64_t cardFrames;
+	uint64_t wallNs;
+	uint64_t cpuNs;
+	uint64_t startNs;
+	long long heapPeak;
+	unsigned int xruns;
+	// Statistics of MediaPlayer
+	unsigned int wakeups;
+	unsigned int inputUnderruns;
+	unsigned int deviceUnderruns;
+	bool failed;
+
+	bench_result() : read("read"), decode("decode"), full("full"), source("source"), resample("resample"), card("card"),
+		sourceFrames(0), sourceRate(0), cardFrames(0), wallNs(0), cpuNs(0), startNs(0), heapPeak(0), xruns(0),
+		wakeups(0), inputUnderruns(0), deviceUnderruns(0), failed(false) {}
+};
+
+/* Set up the null card of audio_manager output stream for a playback */
+void bench_output_setup(const bench_config &config, bench_result &result);
+
+/* Record a tone to an Opus file, histograms: read is capture, decode is encode, card is saving */
+bool bench_record(const char *path, unsigned int seconds, const bench_config &config, bench_result &result);
+
+#endif /* __TOOLS_MEDIA_PIPELINE_BENCH_H */
@@ -0,0 +1,226 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/media/pipeline_output.cpp
+ *
+ * Output stream of audio_manager.h for pipeline_bench. MediaPlayer writes
+ * its periods here instead of to tinyalsa: they are resampled to the card
+ * rate the way audio_manager.c does, and written to a null card. The card
+ * is set up by the benchmark before each playback.
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdlib.h>
+#include <memory>
+
+#include "audio/audio_manager.h"
+#include "samplerate.h"
+#include "pipeline_bench.h"
+
+#ifdef CONFIG_AUDIO_RESAMPLER_POLYPHASE
+#define BENCH_RESAMPLER_TYPE SRC_TYPE_POLYPHASE
+#else
+#define BENCH_RESAMPLER_TYPE SRC_TYPE_LINEAR
+#endif
+
+struct bench_output {
+	const bench_config *config;
+	bench_result *result;
+	std::unique_ptr<null_card> card;
+	unsigned int channels;
+	unsigned int rate;
+	src_handle_t src;
+	int16_t *buffer;
+	size_t bufferSize;
+	uint8_t volume;
+};
+
+static bench_output g_output;
+
+void bench_output_setup(const bench_config &config, bench_result &result)
+{
+	g_output.config = &config;
+	g_output.result = &result;
+}
+
+/* Same as resample_stream_out() of audio_manager.c */
+static int bench_output_resample(const void *data, unsigned int frames)
+{
+	unsigned int used = 0;
+	unsigned int resampled = 0;
+	src_data_t srcData;
+
+	memset(&srcData, 0, sizeof(srcData));
+	srcData.channels_num = g_output.channels;
+	srcData.origin_sample_rate = g_output.rate;
+	srcData.origin_sample_width = SAMPLE_WIDTH_16BITS;
+	srcData.desired_sample_rate = g_output.card->rate();
+	srcData.desired_sample_width = SAMPLE_WIDTH_16BITS;
+
+	while (frames > used) {
+		srcData.data_in = (void *)((const int16_t *)data + used * g_output.channels);
+		srcData.input_frames = frames - used;
+		srcData.data_out = g_output.buffer + resampled * g_output.channels;
+		srcData.out_buf_length = g_output.bufferSize - get_output_frames_to_byte(resampled);
+		if (src_simple(g_output.src, &srcData) != SRC_ERR_NO_ERROR) {
+			fprintf(stderr, "resampling %u to %u isn't supported\n", g_output.rate, g_output.card->rate());
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+		if (srcData.output_frames_gen == 0 && srcData.input_frames_used == 0) {
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+		resampled += srcData.output_frames_gen;
+		used += srcData.input_frames_used;
+	}
+
+	return (int)resampled;
+}
+
+audio_manager_result_t init_audio_stream_out(void)
+{
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t set_audio_stream_out(unsigned int channels, unsigned int sample_rate, int format)
+{
+	(void)format;
+
+	if (!g_output.config || channels == 0 || sample_rate == 0) {
+		return AUDIO_MANAGER_INVALID_PARAM;
+	}
+
+	g_output.channels = channels > 2 ? 2 : channels;
+	g_output.rate = sample_rate;
+	g_output.card.reset(new null_card(g_output.config->cardRate, g_output.channels, g_output.config->realtime));
+
+	if (g_output.rate != g_output.card->rate()) {
+		g_output.src = src_init_ex(CONFIG_AUDIO_RESAMPLER_BUFSIZE, BENCH_RESAMPLER_TYPE);
+		// Room for a period at the card rate, and the frames the resampler keeps
+		g_output.bufferSize = get_output_frames_to_byte(
+			(unsigned int)((uint64_t)get_output_frame_count() * g_output.card->rate() / g_output.rate) + 64);
+		g_output.buffer = (int16_t *)malloc(g_output.bufferSize);
+		if (!g_output.src || !g_output.buffer) {
+			reset_audio_stream_out();
+			return AUDIO_MANAGER_RESAMPLE_FAIL;
+		}
+	}
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+int start_audio_stream_out(void *data, unsigned int frames)
+{
+	bench_result &result = *g_output.result;
+
+	if (!g_output.card) {
+		return AUDIO_MANAGER_NO_AVAIL_CARD;
+	}
+
+	result.sourceFrames += frames;
+	result.sourceRate = g_output.rate;
+
+	const int16_t *out = (const int16_t *)data;
+	int outFrames = (int)frames;
+	if (g_output.src) {
+		bench_scope scope(result.resample);
+		outFrames = bench_output_resample(data, frames);
+		if (outFrames < 0) {
+			return outFrames;
+		}
+		out = g_output.buffer;
+	}
+
+	{
+		bench_scope scope(result.card);
+		g_output.card->write(out, (unsigned int)outFrames);
+	}
+	if (result.startNs == 0) {
+		// Time of the first period, the benchmark makes it relative to start()
+		result.startNs = bench_now_ns();
+	}
+
+	return (int)frames;
+}
+
+audio_manager_result_t pause_audio_stream_out(void)
+{
+	return g_output.card ? AUDIO_MANAGER_SUCCESS : AUDIO_MANAGER_NO_AVAIL_CARD;
+}
+
+audio_manager_result_t stop_audio_stream_out(void)
+{
+	return g_output.card ? AUDIO_MANAGER_SUCCESS : AUDIO_MANAGER_NO_AVAIL_CARD;
+}
+
+audio_manager_result_t reset_audio_stream_out(void)
+{
+	if (g_output.card) {
+		g_output.result->cardFrames = g_output.card->frames();
+		g_output.result->xruns = g_output.card->xruns();
+		g_output.card.reset();
+	}
+	if (g_output.src) {
+		src_destroy(g_output.src);
+		g_output.src = NULL;
+	}
+	free(g_output.buffer);
+	g_output.buffer = NULL;
+	g_output.bufferSize = 0;
+
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+unsigned int get_output_frame_count(void)
+{
+	return g_output.config ? g_output.config->periodFrames : 0;
+}
+
+int get_output_avail_frames(void)
+{
+	// Writing blocks in the card instead, like pcm_writei()
+	return (int)get_output_frame_count();
+}
+
+unsigned int get_output_frames_to_byte(unsigned int frames)
+{
+	return frames * g_output.channels * sizeof(int16_t);
+}
+
+unsigned int get_output_bytes_to_frame(unsigned int bytes)
+{
+	unsigned int frameSize = g_output.channels * sizeof(int16_t);
+	return frameSize ? bytes / frameSize : 0;
+}
+
+audio_manager_result_t get_max_audio_volume(uint8_t *volume)
+{
+	*volume = 10;
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t get_output_audio_volume(uint8_t *volume)
+{
+	*volume = g_output.volume;
+	return AUDIO_MANAGER_SUCCESS;
+}
+
+audio_manager_result_t set_output_audio_volume(uint8_t volume)
+{
+	g_output.volume = volume;
+	return AUDIO_MANAGER_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+/****************************************************************************
+ * tools/media/pipeline_record.cpp
+ *
+ * Recording of pipeline_bench, it's apart from playback as the encoder
+ * and decoder headers can't be included together.
+ ****************************************************************************/
+
+#include <tinyara/config.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <memory>
+#include <vector>
+
+#include "Encoder.h"
+#include "StreamBuffer.h"
+#include "StreamBufferReader.h"
+#include "StreamBufferWriter.h"
+#include "pipeline_bench.h"
+
+using namespace media;
+using namespace media::stream;
+
+#ifdef CONFIG_CODEC_LIBOPUS
+struct bench_recorder {
+	std::shared_ptr<StreamBuffer> streamBuffer;
+	std::shared_ptr<StreamBufferReader> reader;
+	std::shared_ptr<StreamBufferWriter> writer;
+	FILE *fp;
+	bench_hist *save;
+};
+
+/* Output data source worker: save encoded data to the file */
+static void *bench_record_save(void *arg)
+{
+	auto recorder = static_cast<bench_recorder *>(arg);
+	unsigned char buf[BENCH_CHUNK_SIZE];
+
+	while (true) {
+		size_t rlen = recorder->reader->read(buf, sizeof(buf));
+		if (rlen == 0) {
+			break;
+		}
+		bench_scope scope(*recorder->save);
+		fwrite(buf, 1, rlen, recorder->fp);
+	}
+
+	return NULL;
+}
+
+bool bench_record(const char *path, unsigned int seconds, const bench_config &config, bench_result &result)
+{
+	null_card card(BENCH_RECORD_RATE, BENCH_RECORD_CH, config.realtime);
+	std::vector<int16_t> period(config.periodFrames * BENCH_RECORD_CH);
+	bench_recorder recorder;
+	uint64_t total = (uint64_t)BENCH_RECORD_RATE * seconds;
+
+	result.read.name = "capture";
+	result.decode.name = "encode";
+	result.card.name = "save";
+
+	recorder.fp = fopen(path, "wb");
+	if (!recorder.fp) {
+		fprintf(stderr, "can't create %s\n", path);
+		return false;
+	}
+	recorder.save = &result.card;
+	recorder.streamBuffer = StreamBuffer::Builder().setBufferSize(config.bufferSize).setThreshold(config.threshold).build();
+	recorder.reader = std::make_shared<StreamBufferReader>(recorder.streamBuffer);
+	recorder.writer = std::make_shared<StreamBufferWriter>(recorder.streamBuffer);
+	auto encoder = std::make_shared<Encoder>(AUDIO_TYPE_OPUS, BENCH_RECORD_CH, BENCH_RECORD_RATE);
+
+	pthread_t worker;
+	pthread_create(&worker, NULL, bench_record_save, &recorder);
+
+	while (card.frames() < total) {
+		{
+			bench_scope scope(result.read);
+			card.read(period.data(), config.periodFrames);
+		}
+
+		// Same as OutputDataSource::write()
+		bench_split_scope scope(result.decode, result.full);
+		unsigned char *buf = (unsigned char *)period.data();
+		size_t size = period.size() * sizeof(int16_t);
+		size_t wlen = 0;
+		while (wlen < size) {
+			size_t pushed = encoder->pushData(buf + wlen, size - wlen);
+			if (pushed == 0) {
+				result.failed = true;
+				break;
+			}
+			wlen += pushed;
+
+			while (1) {
+				size_t ret = wlen;
+				if (!encoder->getFrame(buf, &ret)) {
+					break;
+				}
+				scope.block();
+				recorder.writer->write(buf, ret);
+				scope.unblock();
+			}
+		}
+		if (result.failed) {
+			break;
+		}
+	}
+
+	recorder.writer->setEndOfStream();
+	pthread_join(worker, NULL);
+	fclose(recorder.fp);
+
+	result.sourceFrames = card.frames();
+	result.sourceRate = BENCH_RECORD_RATE;
+	result.cardFrames = card.frames();
+	result.xruns = card.xruns();
+	return !result.failed;
+}
+#endif
\ No newline at end of file
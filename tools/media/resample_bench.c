@@ -0,0 +1,261 @@
+/****************************************************************************
+ *
+ * Copyright 2018 Samsung Electronics All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * tools/media/resample_bench.c
+ *
+ * Host benchmark of framework/src/media/audio/resample, compares quality
+ * (SNR of a resampled sine tone) and cost (cycles per output frame) of the
+ * SRC algorithms. Input is fed in periods through src_simple(), the same way
+ * audio_manager does.
+ *
+ * Build & run: make -C tools/media && ./tools/media/resample_bench
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "samplerate.h"
+
+#define BENCH_SECONDS       (2)
+#define BENCH_PERIOD_FRAMES (512)
+#define BENCH_BUFSIZE       (4096)
+#define BENCH_AMPLITUDE     (0.5 * 32767.0)
+#define BENCH_MAX_CH        (2)
+
+struct bench_case_s {
+	int from;
+	int to;
+};
+
+static const struct bench_case_s g_cases[] = {
+	{44100, 48000},
+	{48000, 44100},
+	{16000, 48000},
+	{48000, 16000},
+	{44100, 32000},
+	{44100, 16000},
+	{22050, 44100},
+	{8000, 44100},
+	{48000, 8000},
+};
+
+static const char *g_type_names[] = { "linear", "polyphase" };
+
+/* Cycle counter, falls back to nanoseconds where there's no portable counter */
+static uint64_t bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/*
+ * Least square fit of a*sin + b*cos + c at the tone frequency over the middle
+ * of the output, everything else is counted as noise and distortion.
+ */
+static double bench_snr(const int16_t *out, int frames, int channels, double freq, int rate)
+{
+	double w = 2.0 * M_PI * freq / rate;
+	int start = frames / 8;
+	int end = frames - frames / 8;
+	double snr_sum = 0.0;
+	int ch;
+
+	for (ch = 0; ch < channels; ch++) {
+		double m[3][4] = { { 0 } };
+		double coef[3];
+		double sig = 0.0;
+		double err = 0.0;
+		int i;
+		int r;
+		int c;
+
+		for (i = start; i < end; i++) {
+			double v[3] = { sin(w * i), cos(w * i), 1.0 };
+			double y = out[i * channels + ch];
+			for (r = 0; r < 3; r++) {
+				for (c = 0; c < 3; c++) {
+					m[r][c] += v[r] * v[c];
+				}
+				m[r][3] += v[r] * y;
+			}
+		}
+
+		/* Gauss-Jordan elimination of the 3x3 normal equations */
+		for (r = 0; r < 3; r++) {
+			double pivot = m[r][r];
+			int k;
+			for (c = r; c < 4; c++) {
+				m[r][c] /= pivot;
+			}
+			for (k = 0; k < 3; k++) {
+				if (k != r) {
+					double f = m[k][r];
+					for (c = r; c < 4; c++) {
+						m[k][c] -= f * m[r][c];
+					}
+				}
+			}
+		}
+		for (r = 0; r < 3; r++) {
+			coef[r] = m[r][3];
+		}
+
+		for (i = start; i < end; i++) {
+			double fit = coef[0] * sin(w * i) + coef[1] * cos(w * i) + coef[2];
+			double e = out[i * channels + ch] - fit;
+			sig += fit * fit;
+			err += e * e;
+		}
+		snr_sum += 10.0 * log10(sig / (err > 0.0 ? err : 1e-20));
+	}
+
+	return snr_sum / channels;
+}
+
+/*
+ * Resample a tone and report SNR and cycles per output frame.
+ * Returns -1 if the algorithm doesn't support the case.
+ */
+static int bench_run(src_type_t type, const struct bench_case_s *bc, int channels, double freq, double *snr, double *cycles)
+{
+	int in_frames = bc->from * BENCH_SECONDS;
+	int out_cap = (int)((double)in_frames * bc->to / bc->from) + BENCH_PERIOD_FRAMES * 4;
+	int16_t *in = malloc(in_frames * channels * sizeof(int16_t));
+	int16_t *out = malloc(out_cap * channels * sizeof(int16_t));
+	src_handle_t handle = src_init_ex(BENCH_BUFSIZE, type);
+	uint64_t elapsed = 0;
+	int used = 0;
+	int gen = 0;
+	int ret = 0;
+	int i;
+	int ch;
+
+	if (!in || !out || !handle) {
+		fprintf(stderr, "out of memory\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < in_frames; i++) {
+		for (ch = 0; ch < channels; ch++) {
+			double phase = (ch & 1) ? M_PI / 3.0 : 0.0;
+			in[i * channels + ch] = (int16_t)lrint(BENCH_AMPLITUDE * sin(2.0 * M_PI * freq * i / bc->from + phase));
+		}
+	}
+
+	while (used < in_frames) {
+		int period_end = (used + BENCH_PERIOD_FRAMES < in_frames) ? used + BENCH_PERIOD_FRAMES : in_frames;
+		while (used < period_end) {
+			src_data_t data;
+			uint64_t t;
+
+			memset(&data, 0, sizeof(data));
+			data.data_in = in + used * channels;
+			data.input_frames = period_end - used;
+			data.channels_num = channels;
+			data.origin_sample_rate = bc->from;
+			data.origin_sample_width = SAMPLE_WIDTH_16BITS;
+			data.desired_sample_rate = bc->to;
+			data.desired_sample_width = SAMPLE_WIDTH_16BITS;
+			data.data_out = out + gen * channels;
+			data.out_buf_length = (out_cap - gen) * channels * sizeof(int16_t);
+
+			t = bench_cycles();
+			if (src_simple(handle, &data) != SRC_ERR_NO_ERROR) {
+				ret = -1;
+				goto done;
+			}
+			elapsed += bench_cycles() - t;
+
+			if (data.input_frames_used == 0 && data.output_frames_gen == 0) {
+				ret = -1;
+				goto done;
+			}
+			used += data.input_frames_used;
+			gen += data.output_frames_gen;
+		}
+	}
+
+	*snr = bench_snr(out, gen, channels, freq, bc->to);
+	*cycles = gen > 0 ? (double)elapsed / gen : 0.0;
+
+done:
+	src_destroy(handle);
+	free(in);
+	free(out);
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int i;
+	int channels = 2;
+	int type;
+
+	if (argc > 1) {
+		channels = atoi(argv[1]);
+		if (channels <= 0 || channels > BENCH_MAX_CH * 4) {
+			fprintf(stderr, "usage: %s [channels]\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+#if defined(__x86_64__) || defined(__i386__)
+	printf("cost unit: TSC cycles per output frame, %d channel(s)\n", channels);
+#else
+	printf("cost unit: ns per output frame, %d channel(s)\n", channels);
+#endif
+	printf("%-13s %-10s %9s %9s %10s\n", "ratio", "type", "SNR@1k", "SNR@hi", "cost");
+
+	for (i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++) {
+		const struct bench_case_s *bc = &g_cases[i];
+		int low = bc->from < bc->to ? bc->from : bc->to;
+		/* high tone at 40% of the lower rate, inside the pass band of both rates */
+		double hi = 0.4 * low;
+
+		for (type = SRC_TYPE_LINEAR; type <= SRC_TYPE_POLYPHASE; type++) {
+			double snr_lo;
+			double snr_hi;
+			double cost;
+			double unused;
+			char ratio[16];
+
+			snprintf(ratio, sizeof(ratio), "%d>%d", bc->from, bc->to);
+			if (bench_run((src_type_t)type, bc, channels, 1000.0, &snr_lo, &cost) < 0 ||
+				bench_run((src_type_t)type, bc, channels, hi, &snr_hi, &unused) < 0) {
+				printf("%-13s %-10s %9s %9s %10s\n", ratio, g_type_names[type], "n/a", "n/a", "n/a");
+				continue;
+			}
+			printf("%-13s %-10s %8.1fdB %8.1fdB %10.1f\n", ratio, g_type_names[type], snr_lo, snr_hi, cost);
+		}
+	}
+
+	return EXIT_SUCCESS;
+}